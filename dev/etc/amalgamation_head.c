@@ -42,6 +42,7 @@ typedef char               int8_t;
 typedef unsigned char      uint8_t;
 typedef long               ptrdiff_t;
 typedef unsigned long      size_t;
+typedef unsigned long long uint64_t;
 typedef unsigned long long uintmax_t;
 
 #define true 1
@@ -77,6 +78,7 @@ int isnan(double const x)
 #include <stdlib.h>
 
 #include <string.h>
+#include <time.h>
 #include <assert.h>
 #include <limits.h>
 #include <inttypes.h>
@@ -211,6 +211,20 @@ int main(int argc, char **argv)
     RUN_SUITE(octaspire_semver_suite);
     RUN_SUITE(octaspire_pair_suite);
     RUN_SUITE(octaspire_map_suite);
+    RUN_SUITE(octaspire_hamt_suite);
+    RUN_SUITE(octaspire_btree_suite);
+    RUN_SUITE(octaspire_radix_tree_suite);
+    RUN_SUITE(octaspire_atom_table_suite);
+    RUN_SUITE(octaspire_lru_cache_suite);
+    RUN_SUITE(octaspire_bloom_filter_suite);
+    RUN_SUITE(octaspire_xor_filter_suite);
+    RUN_SUITE(octaspire_flat_map_suite);
+    RUN_SUITE(octaspire_static_map_suite);
+    RUN_SUITE(octaspire_rope_suite);
+    RUN_SUITE(octaspire_string_view_suite);
+    RUN_SUITE(octaspire_aho_corasick_suite);
+    RUN_SUITE(octaspire_bk_tree_suite);
+    RUN_SUITE(octaspire_utf16_suite);
     GREATEST_MAIN_END();
 }
 
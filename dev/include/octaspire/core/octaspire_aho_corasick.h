@@ -0,0 +1,109 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_AHO_CORASICK_H
+#define OCTASPIRE_AHO_CORASICK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_string.h"
+#include "octaspire_vector.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Matcher that finds all occurrences of many patterns in one pass over a
+// text, in time linear in the length of the text plus the number of
+// matches, whatever the number of patterns. The patterns are compiled
+// into a deterministic Aho-Corasick automaton over UTF-8 octets. Octets
+// that do not occur in any pattern share one column of the transition
+// table, which keeps the table small also for thousands of patterns.
+typedef struct octaspire_aho_corasick_t octaspire_aho_corasick_t;
+
+typedef struct octaspire_aho_corasick_match_t
+{
+    size_t patternIndex;
+    size_t octetIndex;
+    size_t ucsIndex;
+}
+octaspire_aho_corasick_match_t;
+
+// 'patterns' is a vector of pointers to octaspire_string_t; the index of
+// a pattern in it is reported with its matches. The patterns are not
+// needed after this call. The same pattern can be given more than once.
+// Returns NULL if a pattern is empty or on allocation failure.
+octaspire_aho_corasick_t *octaspire_aho_corasick_new(
+    octaspire_vector_t const * const patterns,
+    octaspire_allocator_t *allocator);
+
+void octaspire_aho_corasick_release(octaspire_aho_corasick_t *self);
+
+size_t octaspire_aho_corasick_get_number_of_patterns(
+    octaspire_aho_corasick_t const * const self);
+
+size_t octaspire_aho_corasick_get_number_of_states(
+    octaspire_aho_corasick_t const * const self);
+
+// Iterates over the matches in a text without allocating. Matches are
+// returned in order of their end; matches that end at the same octet are
+// returned longest first. Overlapping matches are all returned. The
+// automaton and the text are borrowed.
+typedef struct octaspire_aho_corasick_iterator_t
+{
+    octaspire_aho_corasick_t const *automaton;
+    char const                     *text;
+    size_t                          lengthInOctets;
+    size_t                          octetIndex;
+    size_t                          ucsIndex;
+    uint32_t                        state;
+    uint32_t                        outputState;
+    uint32_t                        patternIndex;
+    char                            padding[4];
+}
+octaspire_aho_corasick_iterator_t;
+
+void octaspire_aho_corasick_iterator_init(
+    octaspire_aho_corasick_iterator_t * const self,
+    octaspire_aho_corasick_t const * const automaton,
+    char const * const text,
+    size_t const lengthInOctets);
+
+// 'octetIndex' and 'ucsIndex' of the match tell where the match starts in
+// the text, counted in octets and in UCS characters.
+bool octaspire_aho_corasick_iterator_next(
+    octaspire_aho_corasick_iterator_t * const self,
+    octaspire_aho_corasick_match_t * const match);
+
+// Returns a new vector of octaspire_aho_corasick_match_t, or NULL on
+// allocation failure.
+octaspire_vector_t *octaspire_aho_corasick_find_all_in_buffer(
+    octaspire_aho_corasick_t const * const self,
+    char const * const buffer,
+    size_t const lengthInOctets);
+
+octaspire_vector_t *octaspire_aho_corasick_find_all_in_string(
+    octaspire_aho_corasick_t const * const self,
+    octaspire_string_t const * const str);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
@@ -0,0 +1,94 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_ATOM_TABLE_H
+#define OCTASPIRE_ATOM_TABLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_string.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// String interning table. Every distinct octet sequence is stored once and
+// gets a stable atom: a small integer (0, 1, 2, ... in order of interning)
+// and a canonical '\0' terminated copy of the octets. Two atoms from the
+// same table are equal exactly when their octets are equal, so atoms (or
+// their canonical pointers) can be compared and hashed as integers, for
+// example as keys of octaspire_map_new_with_size_t_keys.
+//
+// The copies are stored in large blocks that are freed all at once when
+// the table is released; atoms and canonical pointers stay valid until
+// then.
+typedef size_t octaspire_atom_t;
+
+#define OCTASPIRE_ATOM_TABLE_INVALID_ATOM SIZE_MAX
+
+typedef struct octaspire_atom_table_t octaspire_atom_table_t;
+
+octaspire_atom_table_t *octaspire_atom_table_new(
+    octaspire_allocator_t *allocator);
+
+void octaspire_atom_table_release(octaspire_atom_table_t *self);
+
+// Returns the atom of the given octets, adding them to the table if
+// needed, or OCTASPIRE_ATOM_TABLE_INVALID_ATOM on allocation failure.
+octaspire_atom_t octaspire_atom_table_intern(
+    octaspire_atom_table_t * const self,
+    char const * const octets,
+    size_t const lengthInOctets);
+
+octaspire_atom_t octaspire_atom_table_intern_c_string(
+    octaspire_atom_table_t * const self,
+    char const * const str);
+
+octaspire_atom_t octaspire_atom_table_intern_string(
+    octaspire_atom_table_t * const self,
+    octaspire_string_t const * const str);
+
+// Returns the atom of the given octets without adding them, or
+// OCTASPIRE_ATOM_TABLE_INVALID_ATOM if they have not been interned.
+octaspire_atom_t octaspire_atom_table_find(
+    octaspire_atom_table_t const * const self,
+    char const * const octets,
+    size_t const lengthInOctets);
+
+// Canonical copy of the octets of 'atom'
+char const *octaspire_atom_table_get_c_string(
+    octaspire_atom_table_t const * const self,
+    octaspire_atom_t const atom);
+
+size_t octaspire_atom_table_get_length_in_octets(
+    octaspire_atom_table_t const * const self,
+    octaspire_atom_t const atom);
+
+uint32_t octaspire_atom_table_get_hash(
+    octaspire_atom_table_t const * const self,
+    octaspire_atom_t const atom);
+
+size_t octaspire_atom_table_get_number_of_atoms(
+    octaspire_atom_table_t const * const self);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
@@ -0,0 +1,83 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_BK_TREE_H
+#define OCTASPIRE_BK_TREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_string.h"
+#include "octaspire_vector.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Index for finding the strings of a collection that are close to a
+// query string in Levenshtein distance, like the identifiers closest to
+// a typo. The strings are kept in a Burkhard-Keller tree, where the
+// triangle inequality lets a query skip whole subtrees, so usually only
+// a small part of the collection is compared against the query.
+typedef struct octaspire_bk_tree_t octaspire_bk_tree_t;
+
+typedef struct octaspire_bk_tree_match_t
+{
+    size_t stringIndex;
+    size_t distance;
+}
+octaspire_bk_tree_match_t;
+
+// 'strings' is a vector of pointers to octaspire_string_t; the index of
+// a string in it is reported with its matches. The strings are copied.
+// The same string can be given more than once.
+// Returns NULL on allocation failure.
+octaspire_bk_tree_t *octaspire_bk_tree_new(
+    octaspire_vector_t const * const strings,
+    octaspire_allocator_t *allocator);
+
+void octaspire_bk_tree_release(octaspire_bk_tree_t *self);
+
+size_t octaspire_bk_tree_get_number_of_strings(
+    octaspire_bk_tree_t const * const self);
+
+octaspire_string_t const *octaspire_bk_tree_get_string_at_index(
+    octaspire_bk_tree_t const * const self,
+    size_t const stringIndex);
+
+// Returns a new vector of octaspire_bk_tree_match_t for all the strings
+// whose distance to 'query' is at most 'maxDistance', ordered by distance
+// and then by index. Returns NULL on allocation failure.
+octaspire_vector_t *octaspire_bk_tree_find_within_distance(
+    octaspire_bk_tree_t const * const self,
+    octaspire_string_t const * const query,
+    size_t const maxDistance);
+
+// Like octaspire_bk_tree_find_within_distance, but returns only the
+// 'maxNumMatches' strings closest to 'query'; of equally distant strings
+// the ones with smaller index are preferred.
+octaspire_vector_t *octaspire_bk_tree_find_nearest(
+    octaspire_bk_tree_t const * const self,
+    octaspire_string_t const * const query,
+    size_t const maxNumMatches);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
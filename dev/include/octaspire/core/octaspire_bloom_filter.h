@@ -0,0 +1,90 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_BLOOM_FILTER_H
+#define OCTASPIRE_BLOOM_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_vector.h"
+#include "octaspire_map.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Blocked (split block) Bloom filter. Elements are given as 32 bit hashes,
+// for example from octaspire_helpers_calculate_hash_for_* or the hash
+// function of an octaspire_map_t. Every hash selects one 32 octet block,
+// aligned so that it never crosses a cache line, and sets one bit in each
+// of its eight words; adding and testing touch that block only.
+//
+// There are no false negatives. With 10 bits per element the false
+// positive rate is about one percent.
+typedef struct octaspire_bloom_filter_t octaspire_bloom_filter_t;
+
+octaspire_bloom_filter_t *octaspire_bloom_filter_new(
+    size_t const numExpectedElements,
+    size_t const numBitsPerElement,
+    octaspire_allocator_t *allocator);
+
+// Builds a filter holding every element of 'keys'. 'hashFunction' is called
+// with the elements as returned by octaspire_vector_get_element_at_const.
+octaspire_bloom_filter_t *octaspire_bloom_filter_new_from_vector(
+    octaspire_vector_t const * const keys,
+    octaspire_map_key_hash_function_t hashFunction,
+    size_t const numBitsPerElement,
+    octaspire_allocator_t *allocator);
+
+// Reads a filter written by octaspire_bloom_filter_serialize. Returns NULL
+// if the buffer is malformed or on allocation failure.
+octaspire_bloom_filter_t *octaspire_bloom_filter_new_from_buffer(
+    void const * const buffer,
+    size_t const lengthInOctets,
+    octaspire_allocator_t *allocator);
+
+void octaspire_bloom_filter_release(octaspire_bloom_filter_t *self);
+
+void octaspire_bloom_filter_add(
+    octaspire_bloom_filter_t * const self,
+    uint32_t const hash);
+
+// Returns false if the element has certainly not been added.
+bool octaspire_bloom_filter_may_contain(
+    octaspire_bloom_filter_t const * const self,
+    uint32_t const hash);
+
+void octaspire_bloom_filter_clear(
+    octaspire_bloom_filter_t * const self);
+
+// Size of the bit array
+size_t octaspire_bloom_filter_get_length_in_octets(
+    octaspire_bloom_filter_t const * const self);
+
+// Returns a new vector of uint8_t holding a portable (little endian)
+// copy of the filter, or NULL on allocation failure.
+octaspire_vector_t *octaspire_bloom_filter_serialize(
+    octaspire_bloom_filter_t const * const self,
+    octaspire_allocator_t *allocator);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
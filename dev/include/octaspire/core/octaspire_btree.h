@@ -0,0 +1,154 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_BTREE_H
+#define OCTASPIRE_BTREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_map.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Ordered map implemented as a B-tree. Keys and values are stored by value
+// in the nodes, so every node is a few contiguous arrays. Key and value
+// conventions and release callbacks are the same as in octaspire_map_t,
+// but keys are ordered with a three-way compare function instead of
+// hashed. Keys are unique; put with an existing key replaces the value.
+typedef struct octaspire_btree_node_t octaspire_btree_node_t;
+
+typedef struct octaspire_btree_t octaspire_btree_t;
+
+typedef int (*octaspire_btree_key_compare_function_t)(
+    void const * const key1,
+    void const * const key2);
+
+octaspire_btree_t *octaspire_btree_new(
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_btree_key_compare_function_t keyCompareFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
+octaspire_btree_t *octaspire_btree_new_with_octaspire_string_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
+octaspire_btree_t *octaspire_btree_new_with_size_t_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
+void octaspire_btree_release(octaspire_btree_t *self);
+
+// Takes ownership of 'key' and 'value'. If 'key' is already present,
+// the stored key is kept, 'key' is released and the old value is
+// replaced. Returns false on allocation failure (ownership not taken).
+bool octaspire_btree_put(
+    octaspire_btree_t * const self,
+    void const * const key,
+    void const * const value);
+
+// Bulk load 'numElements' keys and values from arrays of elements of
+// key and value size. Keys must be in strictly ascending order and the
+// tree must be empty. Builds the tree bottom-up in linear time without
+// comparing keys against the tree. Returns false (and takes no
+// ownership) if the tree is not empty, the keys are not sorted or
+// allocation fails.
+bool octaspire_btree_load_sorted(
+    octaspire_btree_t * const self,
+    void const * const keys,
+    void const * const values,
+    size_t const numElements);
+
+bool octaspire_btree_remove(
+    octaspire_btree_t * const self,
+    void const * const key);
+
+void octaspire_btree_clear(
+    octaspire_btree_t * const self);
+
+void *octaspire_btree_get(
+    octaspire_btree_t * const self,
+    void const * const key);
+
+void const *octaspire_btree_get_const(
+    octaspire_btree_t const * const self,
+    void const * const key);
+
+bool octaspire_btree_is_empty(
+    octaspire_btree_t const * const self);
+
+size_t octaspire_btree_get_number_of_elements(
+    octaspire_btree_t const * const self);
+
+
+
+// Tree height is at most 1 + log16(n/2), so this is enough for any
+// number of elements that fits in memory.
+#define OCTASPIRE_BTREE_ITERATOR_MAX_DEPTH 16
+
+// Iterates elements in ascending key order. 'key' and 'value' point
+// to the current element, or are NULL when the iteration is done.
+typedef struct octaspire_btree_element_const_iterator_t
+{
+    octaspire_btree_t const      *btree;
+    void const                   *key;
+    void const                   *value;
+    void const                   *upperBoundKey;
+    octaspire_btree_node_t const *nodes[OCTASPIRE_BTREE_ITERATOR_MAX_DEPTH];
+    size_t                        indices[OCTASPIRE_BTREE_ITERATOR_MAX_DEPTH];
+    size_t                        depth;
+}
+octaspire_btree_element_const_iterator_t;
+
+octaspire_btree_element_const_iterator_t
+octaspire_btree_element_const_iterator_init(
+    octaspire_btree_t const * const self);
+
+// Starts from the first element whose key is not less than 'key'.
+octaspire_btree_element_const_iterator_t
+octaspire_btree_element_const_iterator_init_lower_bound(
+    octaspire_btree_t const * const self,
+    void const * const key);
+
+// Iterates keys in the half-open range ['lowerKey', 'upperKey').
+// 'upperKey' must stay valid while the iterator is in use.
+octaspire_btree_element_const_iterator_t
+octaspire_btree_element_const_iterator_init_range(
+    octaspire_btree_t const * const self,
+    void const * const lowerKey,
+    void const * const upperKey);
+
+bool octaspire_btree_element_const_iterator_next(
+    octaspire_btree_element_const_iterator_t * const self);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
@@ -0,0 +1,138 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_FLAT_MAP_H
+#define OCTASPIRE_FLAT_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_string.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Read-only hash table stored as one flat image of octets. The image uses
+// only offsets relative to its start, so it can be written to a file and
+// later used in place from any address: read into a buffer, embedded in
+// the program, or memory mapped and shared between processes. Opening an
+// image only checks its header; lookups read the image directly and never
+// allocate.
+//
+// Keys and values are octet sequences. Integer keys are stored as their
+// eight little endian octets. The image is the same on every platform.
+//
+// Image layout (all numbers little endian):
+//
+//   header   "OFM1", uint32 0, uint64 number of elements, uint64 number of
+//            slots, uint64 offset of slots, uint64 length of image
+//   slots    uint32 hash, uint32 0, uint64 offset of entry (0 when empty);
+//            open addressing with linear probing, at most half full
+//   entries  uint64 key length, uint64 value length, key, value; the value
+//            and the next entry start at multiples of eight octets
+typedef struct octaspire_flat_map_builder_t octaspire_flat_map_builder_t;
+
+octaspire_flat_map_builder_t *octaspire_flat_map_builder_new(
+    octaspire_allocator_t *allocator);
+
+void octaspire_flat_map_builder_release(octaspire_flat_map_builder_t *self);
+
+// Copies the key and the value into the builder
+bool octaspire_flat_map_builder_add(
+    octaspire_flat_map_builder_t * const self,
+    void const * const key,
+    size_t const keyLengthInOctets,
+    void const * const value,
+    size_t const valueLengthInOctets);
+
+bool octaspire_flat_map_builder_add_with_string_key(
+    octaspire_flat_map_builder_t * const self,
+    octaspire_string_t const * const key,
+    void const * const value,
+    size_t const valueLengthInOctets);
+
+bool octaspire_flat_map_builder_add_with_integer_key(
+    octaspire_flat_map_builder_t * const self,
+    uint64_t const key,
+    void const * const value,
+    size_t const valueLengthInOctets);
+
+size_t octaspire_flat_map_builder_get_number_of_elements(
+    octaspire_flat_map_builder_t const * const self);
+
+// Returns a new image allocated with 'allocator' and stores its length in
+// 'lengthInOctets'. Returns NULL on allocation failure or if the same key
+// was added more than once.
+char *octaspire_flat_map_builder_build(
+    octaspire_flat_map_builder_t const * const self,
+    size_t * const lengthInOctets,
+    octaspire_allocator_t *allocator);
+
+
+
+// View of an image. It does not own the image, which must stay valid and
+// unmodified while the view is used.
+typedef struct octaspire_flat_map_t
+{
+    uint8_t const *octets;
+    size_t         lengthInOctets;
+    size_t         numElements;
+    size_t         numSlots;
+    size_t         slotsOffset;
+}
+octaspire_flat_map_t;
+
+// Checks the header of the image in O(1). Returns false if it is not an
+// image or if it is too large for this platform. Lookups check the bounds
+// of every entry they read, so a damaged image is never read outside of
+// 'lengthInOctets'.
+bool octaspire_flat_map_init(
+    octaspire_flat_map_t * const self,
+    void const * const octets,
+    size_t const lengthInOctets);
+
+size_t octaspire_flat_map_get_number_of_elements(
+    octaspire_flat_map_t const * const self);
+
+// On success 'value' points into the image. Values are aligned to eight
+// octets relative to the start of the image.
+bool octaspire_flat_map_get(
+    octaspire_flat_map_t const * const self,
+    void const * const key,
+    size_t const keyLengthInOctets,
+    void const ** const value,
+    size_t * const valueLengthInOctets);
+
+bool octaspire_flat_map_get_with_string_key(
+    octaspire_flat_map_t const * const self,
+    octaspire_string_t const * const key,
+    void const ** const value,
+    size_t * const valueLengthInOctets);
+
+bool octaspire_flat_map_get_with_integer_key(
+    octaspire_flat_map_t const * const self,
+    uint64_t const key,
+    void const ** const value,
+    size_t * const valueLengthInOctets);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
@@ -0,0 +1,141 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_HAMT_H
+#define OCTASPIRE_HAMT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_map.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Persistent (immutable) hash array mapped trie. Every put and remove
+// returns a new version that shares all unchanged nodes with the version
+// it was made from; the old version stays valid and unchanged until it is
+// released. Versions are never modified after creation, so they can be
+// read without locking. Creating and releasing versions updates
+// (non-atomic) reference counts and must not race with each other.
+//
+// Key and value conventions and callbacks are the same as in
+// octaspire_map_t. Every successful put takes ownership of the given key
+// and value; the release callbacks are called when the last version
+// referring to them is released.
+
+// Hash array mapped trie node. Lookups and iterators return the leaf nodes
+// that hold the elements.
+typedef struct octaspire_hamt_node_t octaspire_hamt_node_t;
+
+uint32_t octaspire_hamt_node_get_hash(
+    octaspire_hamt_node_t const * const self);
+
+void const *octaspire_hamt_node_get_key_const(
+    octaspire_hamt_node_t const * const self);
+
+void const *octaspire_hamt_node_get_value_const(
+    octaspire_hamt_node_t const * const self);
+
+
+
+typedef struct octaspire_hamt_t octaspire_hamt_t;
+
+octaspire_hamt_t *octaspire_hamt_new(
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_key_compare_function_t keyCompareFunction,
+    octaspire_map_key_hash_function_t keyHashFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
+octaspire_hamt_t *octaspire_hamt_new_with_octaspire_string_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
+octaspire_hamt_t *octaspire_hamt_new_with_size_t_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
+// O(1) snapshot sharing the whole trie with 'self'.
+octaspire_hamt_t *octaspire_hamt_new_snapshot(
+    octaspire_hamt_t const * const self);
+
+void octaspire_hamt_release(octaspire_hamt_t *self);
+
+// Returns a new version with 'key' mapped to 'value', or NULL on
+// allocation failure (in which case ownership is not taken).
+octaspire_hamt_t *octaspire_hamt_put(
+    octaspire_hamt_t const * const self,
+    uint32_t const hash,
+    void const * const key,
+    void const * const value);
+
+// Returns a new version without 'key', or NULL on allocation failure.
+// If 'key' is not present, the returned version is a snapshot of 'self'.
+octaspire_hamt_t *octaspire_hamt_remove(
+    octaspire_hamt_t const * const self,
+    uint32_t const hash,
+    void const * const key);
+
+octaspire_hamt_node_t const *octaspire_hamt_get_const(
+    octaspire_hamt_t const * const self,
+    uint32_t const hash,
+    void const * const key);
+
+bool octaspire_hamt_is_empty(
+    octaspire_hamt_t const * const self);
+
+size_t octaspire_hamt_get_number_of_elements(
+    octaspire_hamt_t const * const self);
+
+
+
+// Trie has at most seven branch levels for 32 bit hashes, then a
+// collision node and a leaf.
+#define OCTASPIRE_HAMT_ITERATOR_MAX_DEPTH 9
+
+typedef struct octaspire_hamt_element_const_iterator_t
+{
+    octaspire_hamt_t const      *hamt;
+    octaspire_hamt_node_t const *element;
+    octaspire_hamt_node_t const *nodes[OCTASPIRE_HAMT_ITERATOR_MAX_DEPTH];
+    size_t                       indices[OCTASPIRE_HAMT_ITERATOR_MAX_DEPTH];
+    size_t                       depth;
+}
+octaspire_hamt_element_const_iterator_t;
+
+octaspire_hamt_element_const_iterator_t
+octaspire_hamt_element_const_iterator_init(
+    octaspire_hamt_t const * const self);
+
+bool octaspire_hamt_element_const_iterator_next(
+    octaspire_hamt_element_const_iterator_t * const self);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
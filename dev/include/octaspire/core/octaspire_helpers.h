@@ -47,6 +47,19 @@ uint32_t octaspire_helpers_calculate_hash_for_memory_buffer_argument(
     void const * const value,
     size_t const lengthInOctets);
 
+// SipHash-1-3 keyed with the 16 octets at 'key'. Unlike the unkeyed
+// hashes above, collisions cannot be found without knowing the key.
+uint64_t octaspire_helpers_calculate_siphash13(
+    void const * const value,
+    size_t const lengthInOctets,
+    uint8_t const * const key);
+
+// SipHash-1-3 folded into 32 bits
+uint32_t octaspire_helpers_calculate_keyed_hash_for_memory_buffer_argument(
+    void const * const value,
+    size_t const lengthInOctets,
+    uint8_t const * const key);
+
 size_t octaspire_helpers_character_digit_to_number(uint32_t const c);
 
 size_t octaspire_helpers_min_size_t(size_t const a, size_t const b);
@@ -0,0 +1,170 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_LRU_CACHE_H
+#define OCTASPIRE_LRU_CACHE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_map.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Bounded cache. Every element has a charge (1 by default, or for example
+// its size in octets) and the sum of the charges never exceeds the
+// capacity: putting a new element evicts old ones until it fits. Get, put,
+// remove and evict are O(1).
+//
+// Keys, hashes and release callbacks follow the conventions of
+// octaspire_map_t. The value release callback is called whenever a value
+// leaves the cache, also when it is evicted, so it doubles as the eviction
+// callback.
+typedef enum octaspire_lru_cache_policy_t
+{
+    // Evict the least recently used element. Every hit moves the element
+    // to the front of the recency list.
+    OCTASPIRE_LRU_CACHE_POLICY_LRU,
+
+    // CLOCK (second chance) approximation of LRU. A hit only sets a
+    // reference bit; eviction skips, and clears, referenced elements.
+    // Hits are cheaper, which matters for caches with high hit rates.
+    OCTASPIRE_LRU_CACHE_POLICY_CLOCK
+}
+octaspire_lru_cache_policy_t;
+
+typedef struct octaspire_lru_cache_statistics_t
+{
+    size_t numHits;
+    size_t numMisses;
+    size_t numInsertions;
+    size_t numEvictions;
+}
+octaspire_lru_cache_statistics_t;
+
+typedef struct octaspire_lru_cache_t octaspire_lru_cache_t;
+
+octaspire_lru_cache_t *octaspire_lru_cache_new(
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_key_compare_function_t keyCompareFunction,
+    octaspire_map_key_hash_function_t keyHashFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    size_t const capacity,
+    octaspire_lru_cache_policy_t const policy,
+    octaspire_allocator_t *allocator);
+
+octaspire_lru_cache_t *octaspire_lru_cache_new_with_octaspire_string_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    size_t const capacity,
+    octaspire_lru_cache_policy_t const policy,
+    octaspire_allocator_t *allocator);
+
+octaspire_lru_cache_t *octaspire_lru_cache_new_with_size_t_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    size_t const capacity,
+    octaspire_lru_cache_policy_t const policy,
+    octaspire_allocator_t *allocator);
+
+void octaspire_lru_cache_release(octaspire_lru_cache_t *self);
+
+// Same as octaspire_lru_cache_put_with_charge with charge 1.
+bool octaspire_lru_cache_put(
+    octaspire_lru_cache_t * const self,
+    uint32_t const hash,
+    void const * const key,
+    void const * const value);
+
+// Takes ownership of 'key' and 'value'. If 'key' is already present, the
+// old value is released and replaced. Returns false, without taking
+// ownership, on allocation failure or if 'charge' exceeds the capacity.
+bool octaspire_lru_cache_put_with_charge(
+    octaspire_lru_cache_t * const self,
+    uint32_t const hash,
+    void const * const key,
+    void const * const value,
+    size_t const charge);
+
+// Returns the value of 'key' and marks it used, or NULL on a miss.
+void *octaspire_lru_cache_get(
+    octaspire_lru_cache_t * const self,
+    uint32_t const hash,
+    void const * const key);
+
+// Returns the value of 'key' without marking it used or counting a hit.
+void const *octaspire_lru_cache_peek_const(
+    octaspire_lru_cache_t const * const self,
+    uint32_t const hash,
+    void const * const key);
+
+bool octaspire_lru_cache_remove(
+    octaspire_lru_cache_t * const self,
+    uint32_t const hash,
+    void const * const key);
+
+// Evicts the element the policy would evict next. Returns false if the
+// cache is empty.
+bool octaspire_lru_cache_evict(
+    octaspire_lru_cache_t * const self);
+
+void octaspire_lru_cache_clear(
+    octaspire_lru_cache_t * const self);
+
+// Evicts elements until the total charge fits into 'capacity'.
+void octaspire_lru_cache_set_capacity(
+    octaspire_lru_cache_t * const self,
+    size_t const capacity);
+
+size_t octaspire_lru_cache_get_capacity(
+    octaspire_lru_cache_t const * const self);
+
+size_t octaspire_lru_cache_get_total_charge(
+    octaspire_lru_cache_t const * const self);
+
+bool octaspire_lru_cache_is_empty(
+    octaspire_lru_cache_t const * const self);
+
+size_t octaspire_lru_cache_get_number_of_elements(
+    octaspire_lru_cache_t const * const self);
+
+// Counters of gets, puts and evictions since creation or the last reset.
+// Throughput can be derived by sampling them periodically.
+octaspire_lru_cache_statistics_t octaspire_lru_cache_get_statistics(
+    octaspire_lru_cache_t const * const self);
+
+void octaspire_lru_cache_reset_statistics(
+    octaspire_lru_cache_t * const self);
+
+// Hits divided by gets, or 0 if there have been no gets.
+double octaspire_lru_cache_get_hit_ratio(
+    octaspire_lru_cache_t const * const self);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
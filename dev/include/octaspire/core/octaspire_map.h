@@ -71,6 +71,16 @@ typedef uint32_t (*octaspire_map_key_hash_function_t)(
 typedef void (*octaspire_map_element_callback_t)(
     void * element);
 
+// Maps with untrusted keys hash the keys themselves, with a hash function
+// keyed by a per-map random seed of OCTASPIRE_MAP_SEED_LENGTH_IN_OCTETS
+// octets. An attacker choosing the keys cannot then predict which keys
+// collide, and lookups stay O(1) on average.
+#define OCTASPIRE_MAP_SEED_LENGTH_IN_OCTETS 16
+
+typedef uint32_t (*octaspire_map_key_keyed_hash_function_t)(
+    void const * const key,
+    uint8_t const * const seed);
+
 octaspire_map_t *octaspire_map_new(
     size_t const keySizeInOctets,
     bool const keyIsPointer,
@@ -82,28 +92,100 @@ octaspire_map_t *octaspire_map_new(
     octaspire_map_element_callback_t valueReleaseCallback,
     octaspire_allocator_t *allocator);
 
+// Builds a map from 'numElements' keys and values stored back to back in
+// 'keys' and 'values', in the layout octaspire_map_put expects them. The
+// table is sized once and filled bucket by bucket, which is much faster
+// than repeated puts. 'hashes' holds the hash of every key, or is NULL if
+// 'keyHashFunction' should be called for every key instead.
+//
+// Takes ownership of the keys and values on success. Returns NULL on
+// allocation failure or if two keys are equal; ownership is not taken then.
+octaspire_map_t *octaspire_map_new_from_arrays(
+    void const * const keys,
+    void const * const values,
+    uint32_t const * const hashes,
+    size_t const numElements,
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_key_compare_function_t keyCompareFunction,
+    octaspire_map_key_hash_function_t keyHashFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
 octaspire_map_t *octaspire_map_new_with_octaspire_string_keys(
     size_t const valueSizeInOctets,
     bool const valueIsPointer,
     octaspire_map_element_callback_t valueReleaseCallback,
     octaspire_allocator_t *allocator);
 
+// The key hash function of the map is
+// octaspire_map_helper_size_t_get_hash_of_key, so the hash of a key is
+// octaspire_map_helper_size_t_get_hash of its value.
 octaspire_map_t *octaspire_map_new_with_size_t_keys(
     size_t const valueSizeInOctets,
     bool const valueIsPointer,
     octaspire_map_element_callback_t valueReleaseCallback,
     octaspire_allocator_t *allocator);
 
+// Map for untrusted keys. The 'hash' arguments of put, get and remove are
+// ignored; the map hashes the keys with 'keyKeyedHashFunction' and a
+// random seed instead.
+octaspire_map_t *octaspire_map_new_for_untrusted_keys(
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_key_compare_function_t keyCompareFunction,
+    octaspire_map_key_keyed_hash_function_t keyKeyedHashFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
+octaspire_map_t *octaspire_map_new_with_untrusted_octaspire_string_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
+octaspire_map_t *octaspire_map_new_with_untrusted_size_t_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
 void octaspire_map_release(octaspire_map_t *self);
 
+bool octaspire_map_is_for_untrusted_keys(
+    octaspire_map_t const * const self);
+
+// The seed is generated from the clocks and addresses. Callers
+// with a better source of entropy can replace it while the map is empty.
+// Returns false if the map is not empty or not for untrusted keys.
+bool octaspire_map_set_seed(
+    octaspire_map_t * const self,
+    uint8_t const * const seed);
+
 bool octaspire_map_remove(
     octaspire_map_t *self,
     uint32_t const hash,
     void const * const key);
 
+// Removes all elements, calling the release callbacks, but keeps the
+// buckets and their capacity for reuse. Does not allocate.
 bool octaspire_map_clear(
     octaspire_map_t * const self);
 
+// Like octaspire_map_clear, but if 'shrink' is true, the buckets are
+// also replaced with the smallest set of buckets to return memory.
+// Returns false if the new buckets cannot be allocated; the map is
+// still cleared.
+bool octaspire_map_clear_with_shrink(
+    octaspire_map_t * const self,
+    bool const shrink);
+
 bool octaspire_map_add_hash_map(
     octaspire_map_t * const self,
     octaspire_map_t * const other);
@@ -172,6 +254,15 @@ bool octaspire_map_element_const_iterator_next(
 uint32_t octaspire_map_helper_size_t_get_hash(
     size_t const value);
 
+// Hash function for size_t keys; gives the same hash as
+// octaspire_map_helper_size_t_get_hash for the value that 'key' points to.
+uint32_t octaspire_map_helper_size_t_get_hash_of_key(
+    void const * const key);
+
+uint32_t octaspire_map_helper_size_t_get_keyed_hash(
+    size_t const * const value,
+    uint8_t const * const seed);
+
 #ifdef __cplusplus
 /* extern "C" */ }
 #endif
@@ -0,0 +1,129 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_RADIX_TREE_H
+#define OCTASPIRE_RADIX_TREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_string.h"
+#include "octaspire_map.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Adaptive radix tree keyed by the UTF-8 octets of octaspire_string_t
+// keys. Inner nodes grow and shrink between 4, 16, 48 and 256 children,
+// and single-child paths are compressed. Lookups and prefix queries cost
+// O(key length) regardless of the number of elements. Elements iterate in
+// lexicographic octet order.
+//
+// Keys are copied into the tree; the caller keeps ownership of the key
+// strings. Values follow the conventions of octaspire_map_t.
+
+// Radix tree node. Lookups and iterators return the leaf nodes that hold
+// the elements.
+typedef struct octaspire_radix_tree_node_t octaspire_radix_tree_node_t;
+
+// Key of a leaf as '\0' terminated UTF-8 octets.
+char const *octaspire_radix_tree_node_get_key_const(
+    octaspire_radix_tree_node_t const * const self);
+
+size_t octaspire_radix_tree_node_get_key_length_in_octets(
+    octaspire_radix_tree_node_t const * const self);
+
+void const *octaspire_radix_tree_node_get_value_const(
+    octaspire_radix_tree_node_t const * const self);
+
+
+
+typedef struct octaspire_radix_tree_t octaspire_radix_tree_t;
+
+octaspire_radix_tree_t *octaspire_radix_tree_new(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator);
+
+void octaspire_radix_tree_release(octaspire_radix_tree_t *self);
+
+// Takes ownership of 'value'. If 'key' is already present, the old value
+// is replaced. Returns false on allocation failure (ownership not taken).
+bool octaspire_radix_tree_put(
+    octaspire_radix_tree_t * const self,
+    octaspire_string_t const * const key,
+    void const * const value);
+
+bool octaspire_radix_tree_remove(
+    octaspire_radix_tree_t * const self,
+    octaspire_string_t const * const key);
+
+void octaspire_radix_tree_clear(
+    octaspire_radix_tree_t * const self);
+
+octaspire_radix_tree_node_t const *octaspire_radix_tree_get_const(
+    octaspire_radix_tree_t const * const self,
+    octaspire_string_t const * const key);
+
+// Returns the element with the longest key that is a prefix of 'key'
+// (including 'key' itself), or NULL if there is none.
+octaspire_radix_tree_node_t const *octaspire_radix_tree_get_longest_prefix_const(
+    octaspire_radix_tree_t const * const self,
+    octaspire_string_t const * const key);
+
+bool octaspire_radix_tree_is_empty(
+    octaspire_radix_tree_t const * const self);
+
+size_t octaspire_radix_tree_get_number_of_elements(
+    octaspire_radix_tree_t const * const self);
+
+
+
+// Iterators do not allocate. Each step looks up the successor of the
+// current key from the root, so the tree must not be modified during
+// iteration.
+typedef struct octaspire_radix_tree_element_const_iterator_t
+{
+    octaspire_radix_tree_t const      *radixTree;
+    octaspire_radix_tree_node_t const *element;
+    char const                        *prefix;
+    size_t                             prefixLengthInOctets;
+}
+octaspire_radix_tree_element_const_iterator_t;
+
+octaspire_radix_tree_element_const_iterator_t
+octaspire_radix_tree_element_const_iterator_init(
+    octaspire_radix_tree_t const * const self);
+
+// Iterates the elements whose keys start with 'prefix'. 'prefix' must not
+// be modified or released while the iterator is in use.
+octaspire_radix_tree_element_const_iterator_t
+octaspire_radix_tree_element_const_iterator_init_with_prefix(
+    octaspire_radix_tree_t const * const self,
+    octaspire_string_t const * const prefix);
+
+bool octaspire_radix_tree_element_const_iterator_next(
+    octaspire_radix_tree_element_const_iterator_t * const self);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
@@ -0,0 +1,112 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_ROPE_H
+#define OCTASPIRE_ROPE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_string.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Rope for large texts that are edited in place, like editor buffers.
+// The text is kept as UTF-8 in chunks of at most a few hundred octets, in
+// a balanced tree (treap) where every node also counts the UCS characters
+// and newlines below it. Inserting, removing and indexing by UCS character
+// and by line cost O(log n) plus the length of one chunk, instead of O(n)
+// as with octaspire_string_t.
+typedef struct octaspire_rope_t octaspire_rope_t;
+
+octaspire_rope_t *octaspire_rope_new(
+    octaspire_allocator_t *allocator);
+
+octaspire_rope_t *octaspire_rope_new_from_string(
+    octaspire_string_t const * const str,
+    octaspire_allocator_t *allocator);
+
+void octaspire_rope_release(octaspire_rope_t *self);
+
+// Inserts UTF-8 text so that its first character gets index 'ucsIndex'.
+// Returns false if the index is larger than the length, if the text is
+// not valid UTF-8 or on allocation failure; the rope is then unchanged.
+bool octaspire_rope_insert_buffer_at(
+    octaspire_rope_t * const self,
+    size_t const ucsIndex,
+    char const * const buffer,
+    size_t const lengthInOctets);
+
+bool octaspire_rope_insert_c_string_at(
+    octaspire_rope_t * const self,
+    size_t const ucsIndex,
+    char const * const str);
+
+bool octaspire_rope_insert_string_at(
+    octaspire_rope_t * const self,
+    size_t const ucsIndex,
+    octaspire_string_t const * const str);
+
+// Returns false if the range does not fit in the rope, or on allocation
+// failure; the rope is then unchanged.
+bool octaspire_rope_remove_ucs_characters_at(
+    octaspire_rope_t * const self,
+    size_t const ucsIndex,
+    size_t const numUcsCharacters);
+
+size_t octaspire_rope_get_length_in_ucs_characters(
+    octaspire_rope_t const * const self);
+
+size_t octaspire_rope_get_length_in_octets(
+    octaspire_rope_t const * const self);
+
+bool octaspire_rope_is_empty(
+    octaspire_rope_t const * const self);
+
+// Aborts if 'ucsIndex' is not a valid index
+uint32_t octaspire_rope_get_ucs_character_at_index(
+    octaspire_rope_t const * const self,
+    size_t const ucsIndex);
+
+// Lines are separated by '\n'; a text with n newlines has n + 1 lines.
+size_t octaspire_rope_get_number_of_lines(
+    octaspire_rope_t const * const self);
+
+// Index of the first UCS character of line 'line' (counting from zero).
+// Aborts if there is no such line.
+size_t octaspire_rope_get_ucs_index_of_line(
+    octaspire_rope_t const * const self,
+    size_t const line);
+
+// Line of the UCS character at 'ucsIndex'. 'ucsIndex' can also be the
+// length of the rope.
+size_t octaspire_rope_get_line_of_ucs_index(
+    octaspire_rope_t const * const self,
+    size_t const ucsIndex);
+
+octaspire_string_t *octaspire_rope_to_string(
+    octaspire_rope_t const * const self,
+    octaspire_allocator_t *allocator);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
@@ -0,0 +1,107 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_STATIC_MAP_H
+#define OCTASPIRE_STATIC_MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_vector.h"
+#include "octaspire_string.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Read-only map for a fixed set of keys, built with a minimal perfect hash
+// function (hash and displace with a pilot for every bucket of about four
+// keys, as in PTHash). Every key gets its own index in 0..n-1, so keys and
+// values are stored densely with no empty slots. A lookup is one hash and
+// one key comparison.
+//
+// The tables can be emitted as C source and compiled into a program; the
+// emitted tables are used with the octaspire_static_map_tables_* functions
+// without building anything at run time. Builds are deterministic, so the
+// same keys always give the same tables.
+typedef struct octaspire_static_map_tables_t
+{
+    size_t                 numElements;
+    size_t                 numBuckets;
+    size_t                 valueSizeInOctets;
+    uint8_t const         *seed;
+    uint32_t const        *pilots;
+    char const * const    *keys;
+    size_t const          *keyLengthsInOctets;
+    uint8_t const         *values;
+}
+octaspire_static_map_tables_t;
+
+// Returns the index of 'key', or -1 if it is not one of the keys.
+ptrdiff_t octaspire_static_map_tables_get_index(
+    octaspire_static_map_tables_t const * const self,
+    void const * const key,
+    size_t const keyLengthInOctets);
+
+// Returns the value of 'key', or NULL if it is not one of the keys or
+// there are no values.
+void const *octaspire_static_map_tables_get_value_const(
+    octaspire_static_map_tables_t const * const self,
+    void const * const key,
+    size_t const keyLengthInOctets);
+
+
+
+typedef struct octaspire_static_map_t octaspire_static_map_t;
+
+// 'keys' holds octaspire_string_t pointers. 'values' can be NULL; otherwise
+// it must have as many elements as 'keys' and its elements are copied.
+// Returns NULL on allocation failure or if a key is repeated.
+octaspire_static_map_t *octaspire_static_map_new(
+    octaspire_vector_t const * const keys,
+    octaspire_vector_t const * const values,
+    octaspire_allocator_t *allocator);
+
+void octaspire_static_map_release(octaspire_static_map_t *self);
+
+size_t octaspire_static_map_get_number_of_elements(
+    octaspire_static_map_t const * const self);
+
+octaspire_static_map_tables_t const *octaspire_static_map_get_tables(
+    octaspire_static_map_t const * const self);
+
+ptrdiff_t octaspire_static_map_get_index(
+    octaspire_static_map_t const * const self,
+    octaspire_string_t const * const key);
+
+void const *octaspire_static_map_get_value_const(
+    octaspire_static_map_t const * const self,
+    octaspire_string_t const * const key);
+
+// Emits the tables as C source that defines a static
+// octaspire_static_map_tables_t called 'name' and the arrays it uses.
+octaspire_string_t *octaspire_static_map_to_c_source(
+    octaspire_static_map_t const * const self,
+    char const * const name,
+    octaspire_allocator_t *allocator);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
@@ -92,6 +92,20 @@ uint32_t octaspire_string_get_ucs_character_at_index(
 char const * octaspire_string_get_c_string(
     octaspire_string_t const * const self);
 
+// Writes the string as UTF-8 into 'buffer', which has room for
+// 'bufferLengthInOctets' octets, and ends it with a null octet. If the
+// buffer is too small, the string is cut before the first character that
+// does not fit. Stores in 'lengthInOctets' the number of octets the whole
+// string needs, without the null octet. Unlike
+// octaspire_string_get_c_string, this does not store the encoding in the
+// string. Returns false if the string has a character that cannot be
+// encoded.
+bool octaspire_string_encode_to_buffer(
+    octaspire_string_t const * const self,
+    char * const buffer,
+    size_t const bufferLengthInOctets,
+    size_t * const lengthInOctets);
+
 bool octaspire_string_is_error(
     octaspire_string_t const * const self);
 
@@ -117,6 +131,14 @@ bool octaspire_string_concatenate_format(
     char const * const fmt,
     ...);
 
+// Formats directly onto the end of the string, without a temporary string.
+// Returns false on allocation failure, or if vsnprintf fails; the error
+// status is then OCTASPIRE_STRING_ERROR_STATUS_ENCODING_ERROR.
+bool octaspire_string_concatenate_vformat(
+    octaspire_string_t * const self,
+    char const * const fmt,
+    va_list arguments);
+
 ptrdiff_t octaspire_string_find_first_substring(
     octaspire_string_t const * const self,
     ptrdiff_t const startFromIndexPossiblyNegative,
@@ -150,6 +172,17 @@ size_t octaspire_string_levenshtein_distance(
     octaspire_string_t const * const self,
     octaspire_string_t const * const other);
 
+// Returns the distance if it is at most 'maxDistance', and otherwise
+// maxDistance + 1. Stops as soon as the distance is known to be too large,
+// so small bounds are cheap also for long strings.
+size_t octaspire_string_levenshtein_distance_bounded(
+    octaspire_string_t const * const self,
+    octaspire_string_t const * const other,
+    size_t const maxDistance);
+
+// Orders the strings by their UCS characters, which is the same order that
+// strcmp gives for UTF-8. Characters with value zero are compared like any
+// other character.
 int octaspire_string_compare(
     octaspire_string_t const * const self,
     octaspire_string_t const * const other);
@@ -177,6 +210,12 @@ bool octaspire_string_ends_with_c_string(
 uint32_t octaspire_string_get_hash(
     octaspire_string_t const * const self);
 
+// Hash keyed with the 16 octets at 'seed' (SipHash-1-3), for tables that
+// hold untrusted keys.
+uint32_t octaspire_string_get_keyed_hash(
+    octaspire_string_t const * const self,
+    uint8_t const * const seed);
+
 bool octaspire_string_push_back_ucs_character(
     octaspire_string_t *self,
     uint32_t const character);
@@ -197,6 +236,8 @@ bool octaspire_string_overwrite_with_string_at(
     octaspire_string_t const * const str,
     ptrdiff_t const indexToPutFirstCharacterPossiblyNegative);
 
+// Returns a vector of new strings. Empty parts are left out. To go through
+// the parts without allocating, see octaspire_string_view_split_iterator_t.
 octaspire_vector_t *octaspire_string_split(
     octaspire_string_t *self,
     char const * const delimiter);
@@ -225,9 +266,66 @@ octaspire_vector_t *octaspire_string_find_string(
     ptrdiff_t const strStartIndexPossiblyNegative,
     size_t const strLength);
 
+// Builder for assembling a string from many small pieces. Everything is
+// appended as UTF-8 into one growing octet buffer; the UCS characters are
+// decoded only once, when the result is finished.
+typedef struct octaspire_string_builder_t octaspire_string_builder_t;
+
+octaspire_string_builder_t *octaspire_string_builder_new(
+    octaspire_allocator_t *allocator);
+
+void octaspire_string_builder_release(octaspire_string_builder_t *self);
+
+bool octaspire_string_builder_append_buffer(
+    octaspire_string_builder_t * const self,
+    char const * const buffer,
+    size_t const lengthInOctets);
+
+bool octaspire_string_builder_append_c_string(
+    octaspire_string_builder_t * const self,
+    char const * const str);
+
+bool octaspire_string_builder_append_string(
+    octaspire_string_builder_t * const self,
+    octaspire_string_t const * const str);
+
+bool octaspire_string_builder_append_format(
+    octaspire_string_builder_t * const self,
+    char const * const fmt,
+    ...);
+
+bool octaspire_string_builder_append_vformat(
+    octaspire_string_builder_t * const self,
+    char const * const fmt,
+    va_list arguments);
+
+bool octaspire_string_builder_append_int64(
+    octaspire_string_builder_t * const self,
+    int64_t const value);
+
+bool octaspire_string_builder_append_uint64(
+    octaspire_string_builder_t * const self,
+    uint64_t const value);
+
+bool octaspire_string_builder_append_ucs_character(
+    octaspire_string_builder_t * const self,
+    uint32_t const character);
+
+size_t octaspire_string_builder_get_length_in_octets(
+    octaspire_string_builder_t const * const self);
+
+bool octaspire_string_builder_clear(octaspire_string_builder_t * const self);
+
+// Returns a new string that takes over the octets appended so far without
+// copying them, and leaves the builder empty for reuse. As with
+// octaspire_string_new_from_buffer, invalid UTF-8 is reported through the
+// error status of the returned string. Returns 0 on allocation failure;
+// the builder is then unchanged.
+octaspire_string_t *octaspire_string_builder_finish(
+    octaspire_string_builder_t * const self);
+
 #ifdef __cplusplus
 }
 #endif
 
 #endif
-
@@ -0,0 +1,236 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_STRING_VIEW_H
+#define OCTASPIRE_STRING_VIEW_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_string.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Non-owning view of UTF-8 text: a pointer and a length in octets. The
+// viewed octets do not need to end with '\0' and must stay valid and
+// unmodified while the view is used. No function here allocates, except
+// octaspire_string_view_to_string. Views are small values; copy them
+// freely.
+typedef struct octaspire_string_view_t
+{
+    char const *octets;
+    size_t      lengthInOctets;
+    size_t      lengthInUcsCharacters;
+    bool        isLengthInUcsCharactersKnown;
+    char        padding[7];
+}
+octaspire_string_view_t;
+
+void octaspire_string_view_init(
+    octaspire_string_view_t * const self,
+    char const * const octets,
+    size_t const lengthInOctets);
+
+void octaspire_string_view_init_from_c_string(
+    octaspire_string_view_t * const self,
+    char const * const str);
+
+// The view is valid until 'str' is modified or released
+void octaspire_string_view_init_from_string(
+    octaspire_string_view_t * const self,
+    octaspire_string_t const * const str);
+
+char const *octaspire_string_view_get_octets(
+    octaspire_string_view_t const * const self);
+
+size_t octaspire_string_view_get_length_in_octets(
+    octaspire_string_view_t const * const self);
+
+// Counts the characters on the first call and remembers the count.
+// Assumes that the viewed octets are valid UTF-8.
+size_t octaspire_string_view_get_length_in_ucs_characters(
+    octaspire_string_view_t * const self);
+
+bool octaspire_string_view_is_empty(
+    octaspire_string_view_t const * const self);
+
+// Sets 'result' to view 'lengthInOctets' octets starting from octet
+// 'octetIndex'. Returns false if the range does not fit in the view.
+bool octaspire_string_view_get_subview(
+    octaspire_string_view_t const * const self,
+    size_t const octetIndex,
+    size_t const lengthInOctets,
+    octaspire_string_view_t * const result);
+
+// Compares octet by octet, which for UTF-8 is the same as comparing by
+// UCS characters. Returns a negative number, zero or a positive number.
+int octaspire_string_view_compare(
+    octaspire_string_view_t const * const self,
+    octaspire_string_view_t const * const other);
+
+bool octaspire_string_view_is_equal(
+    octaspire_string_view_t const * const self,
+    octaspire_string_view_t const * const other);
+
+bool octaspire_string_view_is_equal_to_c_string(
+    octaspire_string_view_t const * const self,
+    char const * const str);
+
+bool octaspire_string_view_is_equal_to_string(
+    octaspire_string_view_t const * const self,
+    octaspire_string_t const * const str);
+
+// Same value as octaspire_string_get_hash for the same text, so views can
+// be used to look up maps that have octaspire_string_t keys.
+uint32_t octaspire_string_view_get_hash(
+    octaspire_string_view_t const * const self);
+
+// Same value as octaspire_string_get_keyed_hash for the same text
+uint32_t octaspire_string_view_get_keyed_hash(
+    octaspire_string_view_t const * const self,
+    uint8_t const * const seed);
+
+// Returns the octet index of the first occurrence of 'needle' starting at
+// or after octet 'startOctetIndex', or -1 if there is none. To search for
+// the same needle many times, prepare a searcher once instead.
+ptrdiff_t octaspire_string_view_find(
+    octaspire_string_view_t const * const self,
+    octaspire_string_view_t const * const needle,
+    size_t const startOctetIndex);
+
+ptrdiff_t octaspire_string_view_find_octet(
+    octaspire_string_view_t const * const self,
+    char const octet,
+    size_t const startOctetIndex);
+
+bool octaspire_string_view_starts_with(
+    octaspire_string_view_t const * const self,
+    octaspire_string_view_t const * const prefix);
+
+bool octaspire_string_view_ends_with(
+    octaspire_string_view_t const * const self,
+    octaspire_string_view_t const * const suffix);
+
+// The whole view must be a decimal number with an optional sign and no
+// surrounding white space. Returns false otherwise, or if the number does
+// not fit in the result type.
+bool octaspire_string_view_to_int64(
+    octaspire_string_view_t const * const self,
+    int64_t * const result);
+
+bool octaspire_string_view_to_uint64(
+    octaspire_string_view_t const * const self,
+    uint64_t * const result);
+
+// Accepts what strtod accepts, except for surrounding white space.
+// Views longer than 63 octets are not accepted.
+bool octaspire_string_view_to_double(
+    octaspire_string_view_t const * const self,
+    double * const result);
+
+octaspire_string_t *octaspire_string_view_to_string(
+    octaspire_string_view_t const * const self,
+    octaspire_allocator_t *allocator);
+
+
+
+// Prepared search for one needle. The algorithm is picked by the length
+// of the needle: memchr for one octet, memchr on the first octet checked
+// against the last octet for short needles, Boyer-Moore-Horspool for
+// needles up to 256 octets and Two-Way for longer ones, so that the time
+// stays linear in the length of the haystack also in the worst case.
+// The needle is borrowed. No allocation is done.
+typedef enum
+{
+    OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_EMPTY,
+    OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_OCTET,
+    OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_SHORT,
+    OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_HORSPOOL,
+    OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_TWO_WAY
+}
+octaspire_string_view_search_algorithm_t;
+
+typedef struct octaspire_string_view_searcher_t
+{
+    char const                               *needle;
+    size_t                                    needleLengthInOctets;
+    ptrdiff_t                                 criticalPosition;
+    size_t                                    period;
+    octaspire_string_view_search_algorithm_t  algorithm;
+    bool                                      isPeriodic;
+    char                                      padding[3];
+    uint16_t                                  shifts[256];
+}
+octaspire_string_view_searcher_t;
+
+void octaspire_string_view_searcher_init(
+    octaspire_string_view_searcher_t * const self,
+    octaspire_string_view_t const * const needle);
+
+// Same as octaspire_string_view_find with the needle of the searcher
+ptrdiff_t octaspire_string_view_searcher_find(
+    octaspire_string_view_searcher_t const * const self,
+    octaspire_string_view_t const * const haystack,
+    size_t const startOctetIndex);
+
+
+
+// Iterates over the parts of a view that are separated by a delimiter,
+// without allocating. Both the view and the delimiter are borrowed.
+typedef struct octaspire_string_view_split_iterator_t
+{
+    char const *next;
+    char const *end;
+    size_t      delimiterLengthInOctets;
+    bool        skipEmptyParts;
+    bool        isFinished;
+    char        padding[6];
+    octaspire_string_view_searcher_t searcher;
+}
+octaspire_string_view_split_iterator_t;
+
+// With 'skipEmptyParts' set, empty parts (between adjacent delimiters or
+// at either end) are not returned, like with octaspire_string_split. An
+// empty delimiter splits the view into its UTF-8 characters.
+void octaspire_string_view_split_iterator_init(
+    octaspire_string_view_split_iterator_t * const self,
+    octaspire_string_view_t const * const view,
+    octaspire_string_view_t const * const delimiter,
+    bool const skipEmptyParts);
+
+// Gives the same parts as octaspire_string_split, but one at a time as
+// views into 'str', so memory use does not depend on the length of 'str'.
+// 'str' must not be modified while the iterator is used.
+void octaspire_string_view_split_iterator_init_from_string(
+    octaspire_string_view_split_iterator_t * const self,
+    octaspire_string_t const * const str,
+    char const * const delimiter);
+
+// Sets 'part' to the next part and returns true, or returns false when
+// there are no more parts.
+bool octaspire_string_view_split_iterator_next(
+    octaspire_string_view_split_iterator_t * const self,
+    octaspire_string_view_t * const part);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
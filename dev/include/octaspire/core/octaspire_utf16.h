@@ -0,0 +1,100 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_UTF16_H
+#define OCTASPIRE_UTF16_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Conversions between UTF-16, UTF-32 (arrays of UCS characters) and UTF-8.
+// UTF-16 code units are in the byte order of the machine. All functions
+// write into buffers given by the caller, and the length functions tell
+// how large the buffers must be. Conversions stop before a character that
+// does not fit in the result; the numbers of code units consumed and
+// written tell how far they got.
+
+typedef enum octaspire_utf16_status_t
+{
+    OCTASPIRE_UTF16_STATUS_OK = 0,
+    OCTASPIRE_UTF16_STATUS_UNPAIRED_SURROGATE,
+    OCTASPIRE_UTF16_STATUS_ILLEGAL_CHARACTER_NUMBER,
+    OCTASPIRE_UTF16_STATUS_ILLEGAL_UTF8
+}
+octaspire_utf16_status_t;
+
+// 'result' must have room for 'numUnits' characters.
+octaspire_utf16_status_t octaspire_utf16_decode_buffer(
+    uint16_t const * const units,
+    size_t const numUnits,
+    uint32_t * const result,
+    size_t * const numUnitsDecoded,
+    size_t * const numUcsCharactersDecoded);
+
+octaspire_utf16_status_t octaspire_utf16_get_encoded_length(
+    uint32_t const * const characters,
+    size_t const numCharacters,
+    size_t * const numUnits);
+
+octaspire_utf16_status_t octaspire_utf16_encode_buffer(
+    uint32_t const * const characters,
+    size_t const numCharacters,
+    uint16_t * const result,
+    size_t const resultLengthInUnits,
+    size_t * const numUnitsEncoded,
+    size_t * const numUcsCharactersEncoded);
+
+// Number of octets that UTF-16 'units' take as UTF-8
+octaspire_utf16_status_t octaspire_utf16_get_length_in_utf8(
+    uint16_t const * const units,
+    size_t const numUnits,
+    size_t * const lengthInOctets);
+
+octaspire_utf16_status_t octaspire_utf16_to_utf8(
+    uint16_t const * const units,
+    size_t const numUnits,
+    char * const result,
+    size_t const resultLengthInOctets,
+    size_t * const numUnitsConverted,
+    size_t * const numOctetsWritten);
+
+// Number of UTF-16 code units that UTF-8 'buffer' takes. Null octets are
+// not valid UTF-8 here, and characters that UTF-16 cannot encode, like
+// encoded surrogates, give OCTASPIRE_UTF16_STATUS_ILLEGAL_CHARACTER_NUMBER.
+octaspire_utf16_status_t octaspire_utf16_get_length_of_utf8(
+    char const * const buffer,
+    size_t const lengthInOctets,
+    size_t * const numUnits);
+
+octaspire_utf16_status_t octaspire_utf16_from_utf8(
+    char const * const buffer,
+    size_t const lengthInOctets,
+    uint16_t * const result,
+    size_t const resultLengthInUnits,
+    size_t * const numOctetsConverted,
+    size_t * const numUnitsWritten);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
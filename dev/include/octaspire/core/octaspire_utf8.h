@@ -67,6 +67,89 @@ octaspire_utf8_decode_status_t octaspire_utf8_decode_character_from_buffer(
     uint32_t *result,
     int *numoctets);
 
+// Decodes the UTF-8 octets of 'buffer' into 'result', which must have room
+// for 'lengthInOctets' characters. Runs of ASCII are decoded eight octets
+// at a time. Stops at the first octet that does not start a valid
+// character and returns the status that octaspire_utf8_decode_character
+// would give there; null octets are not valid characters. The number of
+// octets and characters decoded before that are stored in
+// 'numOctetsDecoded' and 'numUcsCharactersDecoded'.
+octaspire_utf8_decode_status_t octaspire_utf8_decode_buffer(
+    char const * const buffer,
+    size_t const lengthInOctets,
+    uint32_t * const result,
+    size_t * const numOctetsDecoded,
+    size_t * const numUcsCharactersDecoded);
+
+// Number of characters in valid UTF-8; every octet that is not a
+// continuation octet starts a character. For any input, this is at least
+// the number of characters octaspire_utf8_decode_buffer gives.
+size_t octaspire_utf8_count_ucs_characters(
+    char const * const buffer,
+    size_t const lengthInOctets);
+
+// Stores in 'lengthInOctets' the number of octets needed to encode the
+// characters. Fails, like octaspire_utf8_encode_character, if one of them
+// is not a valid character number.
+octaspire_utf8_encode_status_t octaspire_utf8_get_encoded_length(
+    uint32_t const * const characters,
+    size_t const numCharacters,
+    size_t * const lengthInOctets);
+
+// Encodes the characters into 'result', which has room for
+// 'resultLengthInOctets' octets; no null octet is added. Runs of ASCII
+// are encoded four characters at a time. Stops before a character that
+// does not fit, or at one that is not valid. The number of octets and
+// characters encoded are stored in 'numOctetsEncoded' and
+// 'numUcsCharactersEncoded'.
+octaspire_utf8_encode_status_t octaspire_utf8_encode_buffer(
+    uint32_t const * const characters,
+    size_t const numCharacters,
+    char * const result,
+    size_t const resultLengthInOctets,
+    size_t * const numOctetsEncoded,
+    size_t * const numUcsCharactersEncoded);
+
+// Decoder for UTF-8 that arrives in chunks, like from a socket or a pipe.
+// A character that is split between chunks is kept in the decoder until
+// the rest of it arrives. After an error the decoder stays in the error
+// state until it is initialized again.
+typedef struct octaspire_utf8_decoder_t
+{
+    size_t                         numOctetsDecoded;
+    size_t                         numPendingOctets;
+    octaspire_utf8_decode_status_t status;
+    uint8_t                        pendingOctets[4];
+}
+octaspire_utf8_decoder_t;
+
+void octaspire_utf8_decoder_init(
+    octaspire_utf8_decoder_t * const self);
+
+// Decodes the characters that end in 'chunk' into 'result', which must
+// have room for 'lengthInOctets' + 1 characters, and stores their number
+// in 'numUcsCharactersDecoded'. On error, returns the status that
+// octaspire_utf8_decode_character would give for the whole character;
+// null octets are errors too. The characters before the error are still
+// stored, and octaspire_utf8_decoder_get_number_of_octets_decoded tells
+// where in the whole input the bad character starts.
+octaspire_utf8_decode_status_t octaspire_utf8_decoder_decode(
+    octaspire_utf8_decoder_t * const self,
+    char const * const chunk,
+    size_t const lengthInOctets,
+    uint32_t * const result,
+    size_t * const numUcsCharactersDecoded);
+
+// To be called at the end of input. Fails if the input ended in the
+// middle of a character.
+octaspire_utf8_decode_status_t octaspire_utf8_decoder_finish(
+    octaspire_utf8_decoder_t * const self);
+
+// Number of octets of the input that have been decoded into characters
+// so far; octets of a character that is not complete yet are not counted.
+size_t octaspire_utf8_decoder_get_number_of_octets_decoded(
+    octaspire_utf8_decoder_t const * const self);
+
 #ifdef __cplusplus
 /* extern "C" */ }
 #endif
@@ -59,6 +59,12 @@ void octaspire_vector_set_compacting_limit_for_preallocated_elements(
     octaspire_vector_t * const self,
     size_t const numPreAllocatedElementsAtLeastPresentAtAnyMoment);
 
+// Allocates room for at least 'numElements' elements, so that the vector
+// does not need to grow until it has that many.
+bool octaspire_vector_reserve(
+    octaspire_vector_t * const self,
+    size_t const numElements);
+
 size_t octaspire_vector_get_length(
     octaspire_vector_t const * const self);
 
@@ -119,6 +125,13 @@ bool octaspire_vector_push_back_element(
     octaspire_vector_t * const self,
     void const * const element);
 
+// Copies 'numElements' elements from 'elements' to the end, growing
+// the storage at most once.
+bool octaspire_vector_push_back_elements(
+    octaspire_vector_t * const self,
+    void const * const elements,
+    size_t const numElements);
+
 bool octaspire_vector_push_back_char(
     octaspire_vector_t *self,
     char const element);
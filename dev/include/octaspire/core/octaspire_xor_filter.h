@@ -0,0 +1,80 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#ifndef OCTASPIRE_XOR_FILTER_H
+#define OCTASPIRE_XOR_FILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "octaspire_memory.h"
+#include "octaspire_vector.h"
+#include "octaspire_map.h"
+
+#ifdef __cplusplus
+extern "C"       {
+#endif
+
+// Static xor filter with 8 bit fingerprints. It is built once from a
+// complete set of 32 bit hashes and cannot be modified afterwards. It
+// uses about 9.9 bits per element, less than a Bloom filter of the same
+// false positive rate (about 0.4 percent), and a lookup reads exactly
+// three octets.
+typedef struct octaspire_xor_filter_t octaspire_xor_filter_t;
+
+// Duplicate hashes are allowed. Returns NULL on allocation failure.
+octaspire_xor_filter_t *octaspire_xor_filter_new_from_hashes(
+    uint32_t const * const hashes,
+    size_t const numHashes,
+    octaspire_allocator_t *allocator);
+
+// Builds a filter holding every element of 'keys'. 'hashFunction' is called
+// with the elements as returned by octaspire_vector_get_element_at_const.
+octaspire_xor_filter_t *octaspire_xor_filter_new_from_vector(
+    octaspire_vector_t const * const keys,
+    octaspire_map_key_hash_function_t hashFunction,
+    octaspire_allocator_t *allocator);
+
+// Reads a filter written by octaspire_xor_filter_serialize. Returns NULL
+// if the buffer is malformed or on allocation failure.
+octaspire_xor_filter_t *octaspire_xor_filter_new_from_buffer(
+    void const * const buffer,
+    size_t const lengthInOctets,
+    octaspire_allocator_t *allocator);
+
+void octaspire_xor_filter_release(octaspire_xor_filter_t *self);
+
+// Returns false if the element was certainly not in the set.
+bool octaspire_xor_filter_may_contain(
+    octaspire_xor_filter_t const * const self,
+    uint32_t const hash);
+
+// Size of the fingerprint array
+size_t octaspire_xor_filter_get_length_in_octets(
+    octaspire_xor_filter_t const * const self);
+
+// Returns a new vector of uint8_t holding a portable (little endian)
+// copy of the filter, or NULL on allocation failure.
+octaspire_vector_t *octaspire_xor_filter_serialize(
+    octaspire_xor_filter_t const * const self,
+    octaspire_allocator_t *allocator);
+
+#ifdef __cplusplus
+/* extern "C" */ }
+#endif
+
+#endif
+
@@ -0,0 +1,469 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_aho_corasick.h"
+#include <assert.h>
+#include <string.h>
+#include "octaspire/core/octaspire_helpers.h"
+
+static uint32_t const OCTASPIRE_AHO_CORASICK_PRIVATE_NONE = UINT32_MAX;
+
+typedef struct octaspire_aho_corasick_private_pattern_t
+{
+    size_t   lengthInOctets;
+    size_t   lengthInUcsCharacters;
+    uint32_t nextWithSameText;
+    char     padding[4];
+}
+octaspire_aho_corasick_private_pattern_t;
+
+// State 0 is the root. 'transitions' has 'numClasses' entries for every
+// state; octets map to columns through 'classes'. 'firstPatterns' has for
+// every state the first pattern that ends there (the rest are linked
+// through 'nextWithSameText'), and 'outputLinks' the nearest state on the
+// failure path that has patterns, or 0. The raw pointers point into the
+// vectors, which do not change after the automaton is built.
+struct octaspire_aho_corasick_t
+{
+    octaspire_allocator_t                          *allocator;
+    octaspire_vector_t                             *transitions;
+    octaspire_vector_t                             *firstPatterns;
+    octaspire_vector_t                             *outputLinks;
+    octaspire_vector_t                             *patterns;
+    uint32_t const                                 *transitionTable;
+    uint32_t const                                 *firstPatternTable;
+    uint32_t const                                 *outputLinkTable;
+    octaspire_aho_corasick_private_pattern_t const *patternTable;
+    size_t                                          numClasses;
+    uint8_t                                         classes[256];
+};
+
+static bool octaspire_aho_corasick_private_add_state(
+    octaspire_aho_corasick_t * const self)
+{
+    uint32_t const zero = 0;
+
+    for (size_t i = 0; i < self->numClasses; ++i)
+    {
+        if (!octaspire_vector_push_back_element(self->transitions, &zero))
+        {
+            return false;
+        }
+    }
+
+    return octaspire_vector_push_back_element(
+            self->firstPatterns,
+            &OCTASPIRE_AHO_CORASICK_PRIVATE_NONE) &&
+        octaspire_vector_push_back_element(self->outputLinks, &zero);
+}
+
+static uint32_t *octaspire_aho_corasick_private_get_transition(
+    octaspire_aho_corasick_t * const self,
+    uint32_t const state,
+    size_t const octetClass)
+{
+    return octaspire_vector_get_element_at(
+        self->transitions,
+        (ptrdiff_t)(state * self->numClasses + octetClass));
+}
+
+static bool octaspire_aho_corasick_private_add_pattern(
+    octaspire_aho_corasick_t * const self,
+    octaspire_string_t const * const pattern,
+    uint32_t const patternIndex)
+{
+    char const * const octets = octaspire_string_get_c_string(pattern);
+    size_t const lengthInOctets = octaspire_string_get_length_in_octets(pattern);
+
+    uint32_t state = 0;
+
+    for (size_t i = 0; i < lengthInOctets; ++i)
+    {
+        size_t const octetClass = self->classes[(uint8_t)octets[i]];
+
+        uint32_t next =
+            *octaspire_aho_corasick_private_get_transition(self, state, octetClass);
+
+        if (!next)
+        {
+            next = (uint32_t)octaspire_vector_get_length(self->firstPatterns);
+
+            if (!octaspire_aho_corasick_private_add_state(self))
+            {
+                return false;
+            }
+
+            *octaspire_aho_corasick_private_get_transition(self, state, octetClass) = next;
+        }
+
+        state = next;
+    }
+
+    uint32_t * const firstPattern =
+        octaspire_vector_get_element_at(self->firstPatterns, (ptrdiff_t)state);
+
+    octaspire_aho_corasick_private_pattern_t * const record =
+        octaspire_vector_get_element_at(self->patterns, (ptrdiff_t)patternIndex);
+
+    record->lengthInOctets        = lengthInOctets;
+    record->lengthInUcsCharacters = octaspire_string_get_length_in_ucs_characters(pattern);
+    record->nextWithSameText      = *firstPattern;
+
+    *firstPattern = patternIndex;
+
+    return true;
+}
+
+static bool octaspire_aho_corasick_private_link(
+    octaspire_aho_corasick_t * const self)
+{
+    // Breadth first, so that the failure state of a state, which is always
+    // closer to the root, is complete before the state itself. Missing
+    // transitions are filled in from the failure state, which turns the
+    // trie into a deterministic automaton.
+    size_t const numStates = octaspire_vector_get_length(self->firstPatterns);
+
+    uint32_t * const failures = octaspire_allocator_malloc(
+        self->allocator,
+        2 * numStates * sizeof(uint32_t));
+
+    if (!failures)
+    {
+        return false;
+    }
+
+    uint32_t * const queue = failures + numStates;
+    size_t queueHead = 0;
+    size_t queueTail = 0;
+
+    uint32_t * const transitions = octaspire_vector_get_element_at(self->transitions, 0);
+    uint32_t * const firstPatterns = octaspire_vector_get_element_at(self->firstPatterns, 0);
+    uint32_t * const outputLinks = octaspire_vector_get_element_at(self->outputLinks, 0);
+
+    for (size_t c = 0; c < self->numClasses; ++c)
+    {
+        uint32_t const child = transitions[c];
+
+        if (child)
+        {
+            failures[child]    = 0;
+            outputLinks[child] = 0;
+            queue[queueTail++] = child;
+        }
+    }
+
+    while (queueHead < queueTail)
+    {
+        uint32_t const state = queue[queueHead++];
+        uint32_t const failure = failures[state];
+
+        for (size_t c = 0; c < self->numClasses; ++c)
+        {
+            uint32_t * const transition = transitions + state * self->numClasses + c;
+            uint32_t const failureTransition = transitions[failure * self->numClasses + c];
+
+            if (*transition)
+            {
+                uint32_t const child = *transition;
+
+                failures[child] = failureTransition;
+
+                outputLinks[child] =
+                    (firstPatterns[failureTransition] != OCTASPIRE_AHO_CORASICK_PRIVATE_NONE)
+                        ? failureTransition
+                        : outputLinks[failureTransition];
+
+                queue[queueTail++] = child;
+            }
+            else
+            {
+                *transition = failureTransition;
+            }
+        }
+    }
+
+    octaspire_allocator_free(self->allocator, failures);
+    return true;
+}
+
+octaspire_aho_corasick_t *octaspire_aho_corasick_new(
+    octaspire_vector_t const * const patterns,
+    octaspire_allocator_t *allocator)
+{
+    octaspire_aho_corasick_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_aho_corasick_t));
+
+    if (!self)
+    {
+        return 0;
+    }
+
+    self->allocator = allocator;
+
+    size_t const numPatterns = octaspire_vector_get_length(patterns);
+
+    octaspire_helpers_verify_true(numPatterns < OCTASPIRE_AHO_CORASICK_PRIVATE_NONE);
+
+    // Octets that occur in the patterns get columns of their own; all the
+    // others share column 0.
+    bool isUsed[256];
+    memset(isUsed, 0, sizeof(isUsed));
+
+    for (size_t i = 0; i < numPatterns; ++i)
+    {
+        octaspire_string_t const * const pattern =
+            octaspire_vector_get_element_at_const(patterns, (ptrdiff_t)i);
+
+        size_t const lengthInOctets = octaspire_string_get_length_in_octets(pattern);
+
+        if (!lengthInOctets)
+        {
+            octaspire_aho_corasick_release(self);
+            self = 0;
+            return 0;
+        }
+
+        char const * const octets = octaspire_string_get_c_string(pattern);
+
+        for (size_t j = 0; j < lengthInOctets; ++j)
+        {
+            isUsed[(uint8_t)octets[j]] = true;
+        }
+    }
+
+    self->numClasses = 1;
+
+    for (size_t c = 0; c < 256; ++c)
+    {
+        self->classes[c] = isUsed[c] ? (uint8_t)self->numClasses++ : 0;
+    }
+
+    self->transitions   = octaspire_vector_new(sizeof(uint32_t), false, 0, allocator);
+    self->firstPatterns = octaspire_vector_new(sizeof(uint32_t), false, 0, allocator);
+    self->outputLinks   = octaspire_vector_new(sizeof(uint32_t), false, 0, allocator);
+
+    self->patterns = octaspire_vector_new_with_preallocated_elements(
+        sizeof(octaspire_aho_corasick_private_pattern_t),
+        false,
+        numPatterns,
+        0,
+        allocator);
+
+    if (!self->transitions || !self->firstPatterns || !self->outputLinks || !self->patterns ||
+        !octaspire_aho_corasick_private_add_state(self))
+    {
+        octaspire_aho_corasick_release(self);
+        self = 0;
+        return 0;
+    }
+
+    octaspire_aho_corasick_private_pattern_t const emptyRecord =
+    {
+        0,
+        0,
+        OCTASPIRE_AHO_CORASICK_PRIVATE_NONE,
+        {0}
+    };
+
+    for (size_t i = 0; i < numPatterns; ++i)
+    {
+        if (!octaspire_vector_push_back_element(self->patterns, &emptyRecord))
+        {
+            octaspire_aho_corasick_release(self);
+            self = 0;
+            return 0;
+        }
+    }
+
+    // Patterns are added last to first, so that patterns with the same
+    // text end up linked in the order of their indices.
+    for (size_t i = numPatterns; i-- > 0;)
+    {
+        if (!octaspire_aho_corasick_private_add_pattern(
+                self,
+                octaspire_vector_get_element_at_const(patterns, (ptrdiff_t)i),
+                (uint32_t)i))
+        {
+            octaspire_aho_corasick_release(self);
+            self = 0;
+            return 0;
+        }
+    }
+
+    octaspire_helpers_verify_true(
+        octaspire_vector_get_length(self->firstPatterns) < OCTASPIRE_AHO_CORASICK_PRIVATE_NONE);
+
+    if (!octaspire_aho_corasick_private_link(self))
+    {
+        octaspire_aho_corasick_release(self);
+        self = 0;
+        return 0;
+    }
+
+    self->transitionTable   = octaspire_vector_get_element_at_const(self->transitions, 0);
+    self->firstPatternTable = octaspire_vector_get_element_at_const(self->firstPatterns, 0);
+    self->outputLinkTable   = octaspire_vector_get_element_at_const(self->outputLinks, 0);
+
+    self->patternTable = numPatterns
+        ? octaspire_vector_get_element_at_const(self->patterns, 0)
+        : 0;
+
+    return self;
+}
+
+void octaspire_aho_corasick_release(octaspire_aho_corasick_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    octaspire_vector_release(self->transitions);
+    octaspire_vector_release(self->firstPatterns);
+    octaspire_vector_release(self->outputLinks);
+    octaspire_vector_release(self->patterns);
+
+    octaspire_allocator_free(self->allocator, self);
+}
+
+size_t octaspire_aho_corasick_get_number_of_patterns(
+    octaspire_aho_corasick_t const * const self)
+{
+    return octaspire_vector_get_length(self->patterns);
+}
+
+size_t octaspire_aho_corasick_get_number_of_states(
+    octaspire_aho_corasick_t const * const self)
+{
+    return octaspire_vector_get_length(self->firstPatterns);
+}
+
+void octaspire_aho_corasick_iterator_init(
+    octaspire_aho_corasick_iterator_t * const self,
+    octaspire_aho_corasick_t const * const automaton,
+    char const * const text,
+    size_t const lengthInOctets)
+{
+    assert(self && automaton);
+    assert(text || !lengthInOctets);
+
+    memset(self, 0, sizeof(octaspire_aho_corasick_iterator_t));
+
+    self->automaton      = automaton;
+    self->text           = text;
+    self->lengthInOctets = lengthInOctets;
+    self->octetIndex     = 0;
+    self->ucsIndex       = 0;
+    self->state          = 0;
+    self->outputState    = 0;
+    self->patternIndex   = OCTASPIRE_AHO_CORASICK_PRIVATE_NONE;
+}
+
+bool octaspire_aho_corasick_iterator_next(
+    octaspire_aho_corasick_iterator_t * const self,
+    octaspire_aho_corasick_match_t * const match)
+{
+    octaspire_aho_corasick_t const * const automaton = self->automaton;
+
+    while (self->patternIndex == OCTASPIRE_AHO_CORASICK_PRIVATE_NONE)
+    {
+        if (self->octetIndex == self->lengthInOctets)
+        {
+            return false;
+        }
+
+        uint8_t const octet = (uint8_t)self->text[self->octetIndex];
+
+        self->state = automaton->transitionTable[
+            self->state * automaton->numClasses + automaton->classes[octet]];
+
+        ++(self->octetIndex);
+
+        if ((octet & 0xC0) != 0x80)
+        {
+            ++(self->ucsIndex);
+        }
+
+        self->outputState =
+            (automaton->firstPatternTable[self->state] != OCTASPIRE_AHO_CORASICK_PRIVATE_NONE)
+                ? self->state
+                : automaton->outputLinkTable[self->state];
+
+        self->patternIndex = automaton->firstPatternTable[self->outputState];
+    }
+
+    octaspire_aho_corasick_private_pattern_t const * const pattern =
+        &(automaton->patternTable[self->patternIndex]);
+
+    match->patternIndex = self->patternIndex;
+    match->octetIndex   = self->octetIndex - pattern->lengthInOctets;
+    match->ucsIndex     = self->ucsIndex - pattern->lengthInUcsCharacters;
+
+    self->patternIndex = pattern->nextWithSameText;
+
+    if (self->patternIndex == OCTASPIRE_AHO_CORASICK_PRIVATE_NONE)
+    {
+        self->outputState  = automaton->outputLinkTable[self->outputState];
+        self->patternIndex = automaton->firstPatternTable[self->outputState];
+    }
+
+    return true;
+}
+
+octaspire_vector_t *octaspire_aho_corasick_find_all_in_buffer(
+    octaspire_aho_corasick_t const * const self,
+    char const * const buffer,
+    size_t const lengthInOctets)
+{
+    octaspire_vector_t *result = octaspire_vector_new(
+        sizeof(octaspire_aho_corasick_match_t),
+        false,
+        0,
+        self->allocator);
+
+    if (!result)
+    {
+        return 0;
+    }
+
+    octaspire_aho_corasick_iterator_t iterator;
+    octaspire_aho_corasick_iterator_init(&iterator, self, buffer, lengthInOctets);
+
+    octaspire_aho_corasick_match_t match;
+
+    while (octaspire_aho_corasick_iterator_next(&iterator, &match))
+    {
+        if (!octaspire_vector_push_back_element(result, &match))
+        {
+            octaspire_vector_release(result);
+            result = 0;
+            return 0;
+        }
+    }
+
+    return result;
+}
+
+octaspire_vector_t *octaspire_aho_corasick_find_all_in_string(
+    octaspire_aho_corasick_t const * const self,
+    octaspire_string_t const * const str)
+{
+    return octaspire_aho_corasick_find_all_in_buffer(
+        self,
+        octaspire_string_get_c_string(str),
+        octaspire_string_get_length_in_octets(str));
+}
+
@@ -0,0 +1,377 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_atom_table.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "octaspire/core/octaspire_vector.h"
+#include "octaspire/core/octaspire_helpers.h"
+
+typedef struct octaspire_atom_table_private_entry_t
+{
+    char const *octets;
+    size_t      lengthInOctets;
+    uint32_t    hash;
+    char        padding[4];
+}
+octaspire_atom_table_private_entry_t;
+
+// 'entries' is indexed by atom. 'slots' is an open addressing index with
+// linear probing that stores atom + 1 for used slots and 0 for free ones.
+// Octets are copied into blocks that are never moved or freed before the
+// table itself.
+struct octaspire_atom_table_t
+{
+    octaspire_allocator_t *allocator;
+    octaspire_vector_t    *entries;
+    octaspire_vector_t    *blocks;
+    size_t                *slots;
+    size_t                 numSlots;
+    size_t                 numOctetsUsedInLastBlock;
+    size_t                 numOctetsInLastBlock;
+};
+
+static size_t const OCTASPIRE_ATOM_TABLE_PRIVATE_SMALLEST_NUM_SLOTS = 64;
+static size_t const OCTASPIRE_ATOM_TABLE_PRIVATE_BLOCK_SIZE         = 4096;
+
+static octaspire_atom_table_private_entry_t const *
+octaspire_atom_table_private_get_entry(
+    octaspire_atom_table_t const * const self,
+    octaspire_atom_t const atom)
+{
+    octaspire_atom_table_private_entry_t const * const entry =
+        octaspire_vector_get_element_at_const(self->entries, (ptrdiff_t)atom);
+
+    octaspire_helpers_verify_not_null(entry);
+
+    return entry;
+}
+
+// Returns the index of the slot holding the octets, or of the free slot
+// where they should be added.
+static size_t octaspire_atom_table_private_find_slot(
+    octaspire_atom_table_t const * const self,
+    char const * const octets,
+    size_t const lengthInOctets,
+    uint32_t const hash)
+{
+    size_t const mask = self->numSlots - 1;
+    size_t index      = hash & mask;
+
+    while (self->slots[index])
+    {
+        octaspire_atom_table_private_entry_t const * const entry =
+            octaspire_atom_table_private_get_entry(self, self->slots[index] - 1);
+
+        if (entry->hash == hash &&
+            entry->lengthInOctets == lengthInOctets &&
+            (!lengthInOctets || memcmp(entry->octets, octets, lengthInOctets) == 0))
+        {
+            return index;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return index;
+}
+
+static bool octaspire_atom_table_private_grow_slots(
+    octaspire_atom_table_t * const self)
+{
+    size_t const numSlots = self->numSlots * 2;
+
+    size_t * const slots =
+        octaspire_allocator_malloc(self->allocator, numSlots * sizeof(size_t));
+
+    if (!slots)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < octaspire_vector_get_length(self->entries); ++i)
+    {
+        octaspire_atom_table_private_entry_t const * const entry =
+            octaspire_atom_table_private_get_entry(self, i);
+
+        size_t index = entry->hash & (numSlots - 1);
+
+        while (slots[index])
+        {
+            index = (index + 1) & (numSlots - 1);
+        }
+
+        slots[index] = i + 1;
+    }
+
+    octaspire_allocator_free(self->allocator, self->slots);
+    self->slots    = slots;
+    self->numSlots = numSlots;
+
+    return true;
+}
+
+// Copies the octets and a '\0' into the last block, or into a new block
+// if they do not fit.
+static char *octaspire_atom_table_private_copy_octets(
+    octaspire_atom_table_t * const self,
+    char const * const octets,
+    size_t const lengthInOctets)
+{
+    size_t const numOctetsNeeded = lengthInOctets + 1;
+
+    if (self->numOctetsInLastBlock - self->numOctetsUsedInLastBlock < numOctetsNeeded)
+    {
+        size_t const blockSize =
+            (numOctetsNeeded > OCTASPIRE_ATOM_TABLE_PRIVATE_BLOCK_SIZE) ?
+            numOctetsNeeded : OCTASPIRE_ATOM_TABLE_PRIVATE_BLOCK_SIZE;
+
+        char *block = octaspire_allocator_malloc(self->allocator, blockSize);
+
+        if (!block)
+        {
+            return 0;
+        }
+
+        if (!octaspire_vector_push_back_element(self->blocks, &block))
+        {
+            octaspire_allocator_free(self->allocator, block);
+            return 0;
+        }
+
+        self->numOctetsInLastBlock     = blockSize;
+        self->numOctetsUsedInLastBlock = 0;
+    }
+
+    char * const block = octaspire_vector_peek_back_element(self->blocks);
+    char * const result = block + self->numOctetsUsedInLastBlock;
+
+    if (lengthInOctets)
+    {
+        memcpy(result, octets, lengthInOctets);
+    }
+
+    result[lengthInOctets] = '\0';
+    self->numOctetsUsedInLastBlock += numOctetsNeeded;
+
+    return result;
+}
+
+octaspire_atom_table_t *octaspire_atom_table_new(
+    octaspire_allocator_t *allocator)
+{
+    octaspire_atom_table_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_atom_table_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->allocator                = allocator;
+    self->numSlots                 = OCTASPIRE_ATOM_TABLE_PRIVATE_SMALLEST_NUM_SLOTS;
+    self->numOctetsUsedInLastBlock = 0;
+    self->numOctetsInLastBlock     = 0;
+
+    self->entries = octaspire_vector_new(
+        sizeof(octaspire_atom_table_private_entry_t),
+        false,
+        0,
+        self->allocator);
+
+    if (!self->entries)
+    {
+        octaspire_atom_table_release(self);
+        self = 0;
+        return 0;
+    }
+
+    self->blocks = octaspire_vector_new(sizeof(char*), true, 0, self->allocator);
+
+    if (!self->blocks)
+    {
+        octaspire_atom_table_release(self);
+        self = 0;
+        return 0;
+    }
+
+    self->slots = octaspire_allocator_malloc(
+        self->allocator,
+        self->numSlots * sizeof(size_t));
+
+    if (!self->slots)
+    {
+        octaspire_atom_table_release(self);
+        self = 0;
+        return 0;
+    }
+
+    return self;
+}
+
+void octaspire_atom_table_release(octaspire_atom_table_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    if (self->blocks)
+    {
+        for (size_t i = 0; i < octaspire_vector_get_length(self->blocks); ++i)
+        {
+            octaspire_allocator_free(
+                self->allocator,
+                octaspire_vector_get_element_at(self->blocks, (ptrdiff_t)i));
+        }
+    }
+
+    octaspire_vector_release(self->blocks);
+    self->blocks = 0;
+
+    octaspire_vector_release(self->entries);
+    self->entries = 0;
+
+    octaspire_allocator_free(self->allocator, self->slots);
+    self->slots = 0;
+
+    octaspire_allocator_free(self->allocator, self);
+}
+
+octaspire_atom_t octaspire_atom_table_intern(
+    octaspire_atom_table_t * const self,
+    char const * const octets,
+    size_t const lengthInOctets)
+{
+    assert(self);
+
+    uint32_t const hash =
+        octaspire_helpers_calculate_hash_for_memory_buffer_argument(octets, lengthInOctets);
+
+    size_t index =
+        octaspire_atom_table_private_find_slot(self, octets, lengthInOctets, hash);
+
+    if (self->slots[index])
+    {
+        return self->slots[index] - 1;
+    }
+
+    // Keep the load factor at most one half
+    size_t const numAtoms = octaspire_vector_get_length(self->entries);
+
+    if ((numAtoms + 1) * 2 > self->numSlots)
+    {
+        if (!octaspire_atom_table_private_grow_slots(self))
+        {
+            return OCTASPIRE_ATOM_TABLE_INVALID_ATOM;
+        }
+
+        index = octaspire_atom_table_private_find_slot(self, octets, lengthInOctets, hash);
+    }
+
+    size_t const numBlocks                = octaspire_vector_get_length(self->blocks);
+    size_t const numOctetsUsedInLastBlock = self->numOctetsUsedInLastBlock;
+
+    octaspire_atom_table_private_entry_t entry;
+
+    entry.octets =
+        octaspire_atom_table_private_copy_octets(self, octets, lengthInOctets);
+
+    entry.lengthInOctets = lengthInOctets;
+    entry.hash           = hash;
+
+    if (!entry.octets)
+    {
+        return OCTASPIRE_ATOM_TABLE_INVALID_ATOM;
+    }
+
+    if (!octaspire_vector_push_back_element(self->entries, &entry))
+    {
+        // A new block is kept for later atoms; otherwise undo the copy.
+        if (octaspire_vector_get_length(self->blocks) == numBlocks)
+        {
+            self->numOctetsUsedInLastBlock = numOctetsUsedInLastBlock;
+        }
+
+        return OCTASPIRE_ATOM_TABLE_INVALID_ATOM;
+    }
+
+    self->slots[index] = numAtoms + 1;
+    return numAtoms;
+}
+
+octaspire_atom_t octaspire_atom_table_intern_c_string(
+    octaspire_atom_table_t * const self,
+    char const * const str)
+{
+    return octaspire_atom_table_intern(self, str, strlen(str));
+}
+
+octaspire_atom_t octaspire_atom_table_intern_string(
+    octaspire_atom_table_t * const self,
+    octaspire_string_t const * const str)
+{
+    return octaspire_atom_table_intern(
+        self,
+        octaspire_string_get_c_string(str),
+        octaspire_string_get_length_in_octets(str));
+}
+
+octaspire_atom_t octaspire_atom_table_find(
+    octaspire_atom_table_t const * const self,
+    char const * const octets,
+    size_t const lengthInOctets)
+{
+    assert(self);
+
+    uint32_t const hash =
+        octaspire_helpers_calculate_hash_for_memory_buffer_argument(octets, lengthInOctets);
+
+    size_t const index =
+        octaspire_atom_table_private_find_slot(self, octets, lengthInOctets, hash);
+
+    return self->slots[index] ?
+        (self->slots[index] - 1) : OCTASPIRE_ATOM_TABLE_INVALID_ATOM;
+}
+
+char const *octaspire_atom_table_get_c_string(
+    octaspire_atom_table_t const * const self,
+    octaspire_atom_t const atom)
+{
+    return octaspire_atom_table_private_get_entry(self, atom)->octets;
+}
+
+size_t octaspire_atom_table_get_length_in_octets(
+    octaspire_atom_table_t const * const self,
+    octaspire_atom_t const atom)
+{
+    return octaspire_atom_table_private_get_entry(self, atom)->lengthInOctets;
+}
+
+uint32_t octaspire_atom_table_get_hash(
+    octaspire_atom_table_t const * const self,
+    octaspire_atom_t const atom)
+{
+    return octaspire_atom_table_private_get_entry(self, atom)->hash;
+}
+
+size_t octaspire_atom_table_get_number_of_atoms(
+    octaspire_atom_table_t const * const self)
+{
+    return octaspire_vector_get_length(self->entries);
+}
+
@@ -0,0 +1,376 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_bk_tree.h"
+#include <assert.h>
+#include "octaspire/core/octaspire_helpers.h"
+
+static uint32_t const OCTASPIRE_BK_TREE_PRIVATE_NONE = UINT32_MAX;
+
+// Node 'i' holds string 'i'; node 0 is the root. The children of a node
+// are linked through 'nextSibling' and every child has a different
+// 'distanceToParent'. 'maxChildDistance' is the largest of those, and
+// bounds how far a query can be from the node and still have matches
+// below it.
+typedef struct octaspire_bk_tree_private_node_t
+{
+    size_t   distanceToParent;
+    size_t   maxChildDistance;
+    uint32_t firstChild;
+    uint32_t nextSibling;
+}
+octaspire_bk_tree_private_node_t;
+
+struct octaspire_bk_tree_t
+{
+    octaspire_allocator_t            *allocator;
+    octaspire_vector_t               *strings;
+    octaspire_bk_tree_private_node_t *nodes;
+};
+
+static octaspire_string_t const *octaspire_bk_tree_private_get_string(
+    octaspire_bk_tree_t const * const self,
+    size_t const index)
+{
+    return octaspire_vector_get_element_at_const(self->strings, (ptrdiff_t)index);
+}
+
+static void octaspire_bk_tree_private_insert(
+    octaspire_bk_tree_t * const self,
+    uint32_t const index)
+{
+    octaspire_string_t const * const str =
+        octaspire_bk_tree_private_get_string(self, index);
+
+    uint32_t parent = 0;
+
+    while (true)
+    {
+        size_t const distance = octaspire_string_levenshtein_distance(
+            str,
+            octaspire_bk_tree_private_get_string(self, parent));
+
+        uint32_t child = self->nodes[parent].firstChild;
+
+        while (child != OCTASPIRE_BK_TREE_PRIVATE_NONE &&
+               self->nodes[child].distanceToParent != distance)
+        {
+            child = self->nodes[child].nextSibling;
+        }
+
+        if (child == OCTASPIRE_BK_TREE_PRIVATE_NONE)
+        {
+            octaspire_bk_tree_private_node_t * const node = &(self->nodes[index]);
+
+            node->distanceToParent = distance;
+            node->nextSibling      = self->nodes[parent].firstChild;
+
+            self->nodes[parent].firstChild = index;
+
+            self->nodes[parent].maxChildDistance = octaspire_helpers_max_size_t(
+                self->nodes[parent].maxChildDistance,
+                distance);
+
+            return;
+        }
+
+        parent = child;
+    }
+}
+
+octaspire_bk_tree_t *octaspire_bk_tree_new(
+    octaspire_vector_t const * const strings,
+    octaspire_allocator_t *allocator)
+{
+    size_t const numStrings = octaspire_vector_get_length(strings);
+
+    if (numStrings >= OCTASPIRE_BK_TREE_PRIVATE_NONE)
+    {
+        return 0;
+    }
+
+    octaspire_bk_tree_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_bk_tree_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->allocator = allocator;
+
+    self->strings = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        allocator);
+
+    self->nodes = octaspire_allocator_malloc(
+        allocator,
+        (numStrings ? numStrings : 1) * sizeof(octaspire_bk_tree_private_node_t));
+
+    if (!self->strings || !self->nodes)
+    {
+        octaspire_bk_tree_release(self);
+        return 0;
+    }
+
+    for (size_t i = 0; i < numStrings; ++i)
+    {
+        octaspire_string_t *copy = octaspire_string_new_copy(
+            octaspire_vector_get_element_at_const(strings, (ptrdiff_t)i),
+            allocator);
+
+        if (!copy)
+        {
+            octaspire_bk_tree_release(self);
+            return 0;
+        }
+
+        if (!octaspire_vector_push_back_element(self->strings, &copy))
+        {
+            octaspire_string_release(copy);
+            copy = 0;
+
+            octaspire_bk_tree_release(self);
+            return 0;
+        }
+
+        self->nodes[i].distanceToParent = 0;
+        self->nodes[i].maxChildDistance = 0;
+        self->nodes[i].firstChild       = OCTASPIRE_BK_TREE_PRIVATE_NONE;
+        self->nodes[i].nextSibling      = OCTASPIRE_BK_TREE_PRIVATE_NONE;
+
+        if (i > 0)
+        {
+            octaspire_bk_tree_private_insert(self, (uint32_t)i);
+        }
+    }
+
+    return self;
+}
+
+void octaspire_bk_tree_release(octaspire_bk_tree_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    octaspire_allocator_free(self->allocator, self->nodes);
+    self->nodes = 0;
+
+    octaspire_vector_release(self->strings);
+    self->strings = 0;
+
+    octaspire_allocator_free(self->allocator, self);
+}
+
+size_t octaspire_bk_tree_get_number_of_strings(
+    octaspire_bk_tree_t const * const self)
+{
+    return octaspire_vector_get_length(self->strings);
+}
+
+octaspire_string_t const *octaspire_bk_tree_get_string_at_index(
+    octaspire_bk_tree_t const * const self,
+    size_t const stringIndex)
+{
+    if (stringIndex >= octaspire_bk_tree_get_number_of_strings(self))
+    {
+        return 0;
+    }
+
+    return octaspire_bk_tree_private_get_string(self, stringIndex);
+}
+
+static int octaspire_bk_tree_private_compare_matches(
+    void const * const a,
+    void const * const b)
+{
+    octaspire_bk_tree_match_t const * const matchA = a;
+    octaspire_bk_tree_match_t const * const matchB = b;
+
+    if (matchA->distance != matchB->distance)
+    {
+        return (matchA->distance < matchB->distance) ? -1 : 1;
+    }
+
+    if (matchA->stringIndex != matchB->stringIndex)
+    {
+        return (matchA->stringIndex < matchB->stringIndex) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+// Keeps 'matches' ordered and at most 'maxNumMatches' long.
+static bool octaspire_bk_tree_private_add_nearest_match(
+    octaspire_vector_t * const matches,
+    octaspire_bk_tree_match_t const * const match,
+    size_t const maxNumMatches)
+{
+    size_t index = octaspire_vector_get_length(matches);
+
+    while (index > 0 &&
+           octaspire_bk_tree_private_compare_matches(
+               match,
+               octaspire_vector_get_element_at_const(matches, (ptrdiff_t)(index - 1))) < 0)
+    {
+        --index;
+    }
+
+    if (index >= maxNumMatches)
+    {
+        return true;
+    }
+
+    bool const result = (index == octaspire_vector_get_length(matches))
+        ? octaspire_vector_push_back_element(matches, match)
+        : octaspire_vector_insert_element_before_the_element_at_index(
+            matches,
+            match,
+            (ptrdiff_t)index);
+
+    if (result && octaspire_vector_get_length(matches) > maxNumMatches)
+    {
+        octaspire_helpers_verify_true(octaspire_vector_pop_back_element(matches));
+    }
+
+    return result;
+}
+
+// Visits the nodes whose subtrees can have strings at most 'radius' away
+// from 'query'. If 'isNearest' is true, only 'maxNumMatches' matches are
+// kept, and once that many have been found the radius shrinks to the
+// distance of the farthest of them.
+static octaspire_vector_t *octaspire_bk_tree_private_search(
+    octaspire_bk_tree_t const * const self,
+    octaspire_string_t const * const query,
+    size_t radius,
+    size_t const maxNumMatches,
+    bool const isNearest)
+{
+    octaspire_vector_t *matches = octaspire_vector_new(
+        sizeof(octaspire_bk_tree_match_t),
+        false,
+        0,
+        self->allocator);
+
+    octaspire_vector_t *stack = octaspire_vector_new(
+        sizeof(uint32_t),
+        false,
+        0,
+        self->allocator);
+
+    bool isOk = matches && stack;
+
+    if (isOk && maxNumMatches > 0 && octaspire_bk_tree_get_number_of_strings(self) > 0)
+    {
+        uint32_t const root = 0;
+        isOk = octaspire_vector_push_back_element(stack, &root);
+    }
+
+    while (isOk && !octaspire_vector_is_empty(stack))
+    {
+        uint32_t const index =
+            *(uint32_t const *)octaspire_vector_peek_back_element_const(stack);
+
+        octaspire_helpers_verify_true(octaspire_vector_pop_back_element(stack));
+
+        octaspire_bk_tree_private_node_t const * const node = &(self->nodes[index]);
+
+        // A larger distance can be neither a match nor have matches below
+        // this node, so it does not need to be computed exactly.
+        size_t const bound = (node->maxChildDistance > SIZE_MAX - radius)
+            ? SIZE_MAX
+            : node->maxChildDistance + radius;
+
+        size_t const distance = octaspire_string_levenshtein_distance_bounded(
+            query,
+            octaspire_bk_tree_private_get_string(self, index),
+            bound);
+
+        if (distance <= radius)
+        {
+            octaspire_bk_tree_match_t const match = { index, distance };
+
+            if (isNearest)
+            {
+                isOk = octaspire_bk_tree_private_add_nearest_match(
+                    matches,
+                    &match,
+                    maxNumMatches);
+
+                if (octaspire_vector_get_length(matches) == maxNumMatches)
+                {
+                    octaspire_bk_tree_match_t const * const farthest =
+                        octaspire_vector_peek_back_element_const(matches);
+
+                    radius = farthest->distance;
+                }
+            }
+            else
+            {
+                isOk = octaspire_vector_push_back_element(matches, &match);
+            }
+        }
+
+        for (uint32_t child = node->firstChild;
+             isOk && child != OCTASPIRE_BK_TREE_PRIVATE_NONE;
+             child = self->nodes[child].nextSibling)
+        {
+            size_t const edge = self->nodes[child].distanceToParent;
+
+            if (((edge > distance) ? (edge - distance) : (distance - edge)) <= radius)
+            {
+                isOk = octaspire_vector_push_back_element(stack, &child);
+            }
+        }
+    }
+
+    octaspire_vector_release(stack);
+    stack = 0;
+
+    if (!isOk)
+    {
+        octaspire_vector_release(matches);
+        return 0;
+    }
+
+    if (!isNearest && !octaspire_vector_is_empty(matches))
+    {
+        octaspire_vector_sort(matches, octaspire_bk_tree_private_compare_matches);
+    }
+
+    return matches;
+}
+
+octaspire_vector_t *octaspire_bk_tree_find_within_distance(
+    octaspire_bk_tree_t const * const self,
+    octaspire_string_t const * const query,
+    size_t const maxDistance)
+{
+    return octaspire_bk_tree_private_search(self, query, maxDistance, SIZE_MAX, false);
+}
+
+octaspire_vector_t *octaspire_bk_tree_find_nearest(
+    octaspire_bk_tree_t const * const self,
+    octaspire_string_t const * const query,
+    size_t const maxNumMatches)
+{
+    return octaspire_bk_tree_private_search(self, query, SIZE_MAX, maxNumMatches, true);
+}
@@ -0,0 +1,324 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_bloom_filter.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "octaspire/core/octaspire_helpers.h"
+
+#define OCTASPIRE_BLOOM_FILTER_PRIVATE_WORDS_PER_BLOCK 8
+
+struct octaspire_bloom_filter_t
+{
+    octaspire_allocator_t *allocator;
+    void                  *memory;
+    uint32_t              *words;
+    size_t                 numBlocks;
+};
+
+static size_t const OCTASPIRE_BLOOM_FILTER_PRIVATE_BLOCK_SIZE_IN_OCTETS =
+    OCTASPIRE_BLOOM_FILTER_PRIVATE_WORDS_PER_BLOCK * sizeof(uint32_t);
+
+static char const   OCTASPIRE_BLOOM_FILTER_PRIVATE_MAGIC[4] = {'O', 'B', 'F', '1'};
+static size_t const OCTASPIRE_BLOOM_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS = 8;
+
+// Odd constants that spread the bits of a hash over the eight words.
+static uint32_t const
+OCTASPIRE_BLOOM_FILTER_PRIVATE_SALTS[OCTASPIRE_BLOOM_FILTER_PRIVATE_WORDS_PER_BLOCK] =
+{
+    0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+    0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+};
+
+// Finalizer of MurmurHash3. The block is chosen with the hash as given
+// and the bits with the mixed hash, so that the two are independent.
+static uint32_t octaspire_bloom_filter_private_mix(uint32_t hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+static uint32_t *octaspire_bloom_filter_private_get_block(
+    octaspire_bloom_filter_t const * const self,
+    uint32_t const hash)
+{
+    return self->words +
+        (hash % self->numBlocks) * OCTASPIRE_BLOOM_FILTER_PRIVATE_WORDS_PER_BLOCK;
+}
+
+static void octaspire_bloom_filter_private_write_uint32(
+    uint8_t * const octets,
+    uint32_t const value)
+{
+    octets[0] = (uint8_t)(value);
+    octets[1] = (uint8_t)(value >> 8);
+    octets[2] = (uint8_t)(value >> 16);
+    octets[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t octaspire_bloom_filter_private_read_uint32(
+    uint8_t const * const octets)
+{
+    return (uint32_t)octets[0] |
+        ((uint32_t)octets[1] << 8) |
+        ((uint32_t)octets[2] << 16) |
+        ((uint32_t)octets[3] << 24);
+}
+
+static octaspire_bloom_filter_t *octaspire_bloom_filter_private_new_with_blocks(
+    size_t const numBlocks,
+    octaspire_allocator_t *allocator)
+{
+    octaspire_bloom_filter_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_bloom_filter_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->allocator = allocator;
+    self->numBlocks = numBlocks;
+
+    // Over allocate to align the blocks to their size, which divides the
+    // size of a cache line.
+    self->memory = octaspire_allocator_malloc(
+        self->allocator,
+        (numBlocks + 1) * OCTASPIRE_BLOOM_FILTER_PRIVATE_BLOCK_SIZE_IN_OCTETS);
+
+    if (!self->memory)
+    {
+        octaspire_bloom_filter_release(self);
+        self = 0;
+        return 0;
+    }
+
+    size_t const misalignment =
+        (size_t)self->memory % OCTASPIRE_BLOOM_FILTER_PRIVATE_BLOCK_SIZE_IN_OCTETS;
+
+    self->words = (uint32_t*)((char*)self->memory +
+        (misalignment ?
+            (OCTASPIRE_BLOOM_FILTER_PRIVATE_BLOCK_SIZE_IN_OCTETS - misalignment) : 0));
+
+    return self;
+}
+
+octaspire_bloom_filter_t *octaspire_bloom_filter_new(
+    size_t const numExpectedElements,
+    size_t const numBitsPerElement,
+    octaspire_allocator_t *allocator)
+{
+    size_t const numBitsPerBlock = 8 * OCTASPIRE_BLOOM_FILTER_PRIVATE_BLOCK_SIZE_IN_OCTETS;
+    size_t const numBits         = numExpectedElements * numBitsPerElement;
+    size_t       numBlocks       = (numBits + numBitsPerBlock - 1) / numBitsPerBlock;
+
+    if (!numBlocks)
+    {
+        numBlocks = 1;
+    }
+
+    return octaspire_bloom_filter_private_new_with_blocks(numBlocks, allocator);
+}
+
+octaspire_bloom_filter_t *octaspire_bloom_filter_new_from_vector(
+    octaspire_vector_t const * const keys,
+    octaspire_map_key_hash_function_t hashFunction,
+    size_t const numBitsPerElement,
+    octaspire_allocator_t *allocator)
+{
+    size_t const numKeys = octaspire_vector_get_length(keys);
+
+    octaspire_bloom_filter_t * const self =
+        octaspire_bloom_filter_new(numKeys, numBitsPerElement, allocator);
+
+    if (!self)
+    {
+        return self;
+    }
+
+    for (size_t i = 0; i < numKeys; ++i)
+    {
+        octaspire_bloom_filter_add(
+            self,
+            hashFunction(octaspire_vector_get_element_at_const(keys, (ptrdiff_t)i)));
+    }
+
+    return self;
+}
+
+octaspire_bloom_filter_t *octaspire_bloom_filter_new_from_buffer(
+    void const * const buffer,
+    size_t const lengthInOctets,
+    octaspire_allocator_t *allocator)
+{
+    uint8_t const * const octets = buffer;
+
+    if (lengthInOctets < OCTASPIRE_BLOOM_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS ||
+        memcmp(octets, OCTASPIRE_BLOOM_FILTER_PRIVATE_MAGIC, 4) != 0)
+    {
+        return 0;
+    }
+
+    size_t const numBlocks = octaspire_bloom_filter_private_read_uint32(octets + 4);
+
+    size_t const numWords =
+        (lengthInOctets - OCTASPIRE_BLOOM_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS) /
+            sizeof(uint32_t);
+
+    if (!numBlocks ||
+        (lengthInOctets - OCTASPIRE_BLOOM_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS) %
+            sizeof(uint32_t) != 0 ||
+        numWords / OCTASPIRE_BLOOM_FILTER_PRIVATE_WORDS_PER_BLOCK != numBlocks ||
+        numWords % OCTASPIRE_BLOOM_FILTER_PRIVATE_WORDS_PER_BLOCK != 0)
+    {
+        return 0;
+    }
+
+    octaspire_bloom_filter_t * const self =
+        octaspire_bloom_filter_private_new_with_blocks(numBlocks, allocator);
+
+    if (!self)
+    {
+        return self;
+    }
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        self->words[i] = octaspire_bloom_filter_private_read_uint32(
+            octets +
+            OCTASPIRE_BLOOM_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS +
+            i * sizeof(uint32_t));
+    }
+
+    return self;
+}
+
+void octaspire_bloom_filter_release(octaspire_bloom_filter_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    octaspire_allocator_free(self->allocator, self->memory);
+    self->memory = 0;
+    self->words  = 0;
+
+    octaspire_allocator_free(self->allocator, self);
+}
+
+void octaspire_bloom_filter_add(
+    octaspire_bloom_filter_t * const self,
+    uint32_t const hash)
+{
+    uint32_t * const block = octaspire_bloom_filter_private_get_block(self, hash);
+    uint32_t const   mixed = octaspire_bloom_filter_private_mix(hash);
+
+    for (size_t i = 0; i < OCTASPIRE_BLOOM_FILTER_PRIVATE_WORDS_PER_BLOCK; ++i)
+    {
+        block[i] |= (uint32_t)1 << ((mixed * OCTASPIRE_BLOOM_FILTER_PRIVATE_SALTS[i]) >> 27);
+    }
+}
+
+bool octaspire_bloom_filter_may_contain(
+    octaspire_bloom_filter_t const * const self,
+    uint32_t const hash)
+{
+    uint32_t const * const block = octaspire_bloom_filter_private_get_block(self, hash);
+    uint32_t const         mixed = octaspire_bloom_filter_private_mix(hash);
+
+    for (size_t i = 0; i < OCTASPIRE_BLOOM_FILTER_PRIVATE_WORDS_PER_BLOCK; ++i)
+    {
+        uint32_t const bit =
+            (uint32_t)1 << ((mixed * OCTASPIRE_BLOOM_FILTER_PRIVATE_SALTS[i]) >> 27);
+
+        if (!(block[i] & bit))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void octaspire_bloom_filter_clear(
+    octaspire_bloom_filter_t * const self)
+{
+    memset(self->words, 0, octaspire_bloom_filter_get_length_in_octets(self));
+}
+
+size_t octaspire_bloom_filter_get_length_in_octets(
+    octaspire_bloom_filter_t const * const self)
+{
+    return self->numBlocks * OCTASPIRE_BLOOM_FILTER_PRIVATE_BLOCK_SIZE_IN_OCTETS;
+}
+
+octaspire_vector_t *octaspire_bloom_filter_serialize(
+    octaspire_bloom_filter_t const * const self,
+    octaspire_allocator_t *allocator)
+{
+    size_t const numWords  = self->numBlocks * OCTASPIRE_BLOOM_FILTER_PRIVATE_WORDS_PER_BLOCK;
+
+    size_t const numOctets =
+        OCTASPIRE_BLOOM_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS + numWords * sizeof(uint32_t);
+
+    if (self->numBlocks > 0xFFFFFFFFU)
+    {
+        return 0;
+    }
+
+    octaspire_vector_t * const result = octaspire_vector_new_with_preallocated_elements(
+        sizeof(uint8_t),
+        false,
+        numOctets,
+        0,
+        allocator);
+
+    if (!result)
+    {
+        return result;
+    }
+
+    uint8_t header[8];
+    memcpy(header, OCTASPIRE_BLOOM_FILTER_PRIVATE_MAGIC, 4);
+    octaspire_bloom_filter_private_write_uint32(header + 4, (uint32_t)self->numBlocks);
+
+    for (size_t i = 0; i < sizeof(header); ++i)
+    {
+        octaspire_helpers_verify_true(
+            octaspire_vector_push_back_element(result, &header[i]));
+    }
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        uint8_t word[4];
+        octaspire_bloom_filter_private_write_uint32(word, self->words[i]);
+
+        for (size_t j = 0; j < sizeof(word); ++j)
+        {
+            octaspire_helpers_verify_true(
+                octaspire_vector_push_back_element(result, &word[j]));
+        }
+    }
+
+    return result;
+}
+
@@ -0,0 +1,1297 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_btree.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_helpers.h"
+
+// Nodes store their keys, values and (internal nodes only) children in
+// the same allocation, right after the node itself. Offsets of the
+// arrays depend on key and value sizes and are kept in the tree.
+struct octaspire_btree_node_t
+{
+    size_t numKeys;
+    bool   isLeaf;
+    char   padding[7];
+};
+
+struct octaspire_btree_t
+{
+    octaspire_allocator_t                  *allocator;
+    octaspire_btree_node_t                 *root;
+    octaspire_btree_key_compare_function_t  keyCompareFunction;
+    octaspire_map_element_callback_t        keyReleaseCallback;
+    octaspire_map_element_callback_t        valueReleaseCallback;
+    void                                   *scratch;
+    size_t                                  keySizeInOctets;
+    size_t                                  valueSizeInOctets;
+    size_t                                  valuesOffset;
+    size_t                                  childrenOffset;
+    size_t                                  scratchValuesOffset;
+    size_t                                  numElements;
+    bool                                    keyIsPointer;
+    bool                                    valueIsPointer;
+    char                                    padding[6];
+};
+
+// Every node except the root has between MIN_DEGREE - 1 and
+// 2 * MIN_DEGREE - 1 keys.
+static size_t const OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE = 16;
+static size_t const OCTASPIRE_BTREE_PRIVATE_MAX_KEYS   = 31;
+static size_t const OCTASPIRE_BTREE_PRIVATE_ALIGNMENT  = 16;
+
+static size_t octaspire_btree_private_align(size_t const size)
+{
+    return (size + OCTASPIRE_BTREE_PRIVATE_ALIGNMENT - 1) &
+        ~(OCTASPIRE_BTREE_PRIVATE_ALIGNMENT - 1);
+}
+
+static void *octaspire_btree_private_key_at(
+    octaspire_btree_t const * const self,
+    octaspire_btree_node_t const * const node,
+    size_t const index)
+{
+    return ((char*)node) +
+        octaspire_btree_private_align(sizeof(octaspire_btree_node_t)) +
+        (index * self->keySizeInOctets);
+}
+
+static void *octaspire_btree_private_value_at(
+    octaspire_btree_t const * const self,
+    octaspire_btree_node_t const * const node,
+    size_t const index)
+{
+    return ((char*)node) + self->valuesOffset + (index * self->valueSizeInOctets);
+}
+
+static octaspire_btree_node_t **octaspire_btree_private_get_children(
+    octaspire_btree_t const * const self,
+    octaspire_btree_node_t const * const node)
+{
+    assert(!node->isLeaf);
+    return (octaspire_btree_node_t**)(((char*)node) + self->childrenOffset);
+}
+
+static void const *octaspire_btree_private_get_user_key(
+    octaspire_btree_t const * const self,
+    void const * const key)
+{
+    return self->keyIsPointer ? *(void const * const *)key : key;
+}
+
+static void const *octaspire_btree_private_get_user_value(
+    octaspire_btree_t const * const self,
+    void const * const value)
+{
+    return self->valueIsPointer ? *(void const * const *)value : value;
+}
+
+// Binary search for the first key in 'node' that is not less than 'key'.
+static size_t octaspire_btree_private_lower_bound(
+    octaspire_btree_t const * const self,
+    octaspire_btree_node_t const * const node,
+    void const * const key,
+    bool * const found)
+{
+    void const * const userKey = octaspire_btree_private_get_user_key(self, key);
+
+    size_t first = 0;
+    size_t last  = node->numKeys;
+
+    *found = false;
+
+    while (first < last)
+    {
+        size_t const middle = first + ((last - first) / 2);
+
+        int const result = self->keyCompareFunction(
+            userKey,
+            octaspire_btree_private_get_user_key(
+                self,
+                octaspire_btree_private_key_at(self, node, middle)));
+
+        if (result > 0)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            if (result == 0)
+            {
+                *found = true;
+                return middle;
+            }
+
+            last = middle;
+        }
+    }
+
+    return first;
+}
+
+static octaspire_btree_node_t *octaspire_btree_private_node_new(
+    octaspire_btree_t * const self,
+    bool const isLeaf)
+{
+    size_t size = self->childrenOffset;
+
+    if (!isLeaf)
+    {
+        size += (OCTASPIRE_BTREE_PRIVATE_MAX_KEYS + 1) * sizeof(octaspire_btree_node_t*);
+    }
+
+    octaspire_btree_node_t * const node =
+        octaspire_allocator_malloc(self->allocator, size);
+
+    if (!node)
+    {
+        return 0;
+    }
+
+    node->numKeys = 0;
+    node->isLeaf  = isLeaf;
+
+    return node;
+}
+
+static void octaspire_btree_private_release_element(
+    octaspire_btree_t * const self,
+    void * const key,
+    void * const value)
+{
+    if (self->keyReleaseCallback)
+    {
+        self->keyReleaseCallback((void*)octaspire_btree_private_get_user_key(self, key));
+    }
+
+    if (self->valueReleaseCallback)
+    {
+        self->valueReleaseCallback(
+            (void*)octaspire_btree_private_get_user_value(self, value));
+    }
+}
+
+// Frees 'node' and its subtree. Elements are released only if
+// 'releaseElements' is true; otherwise their ownership stays elsewhere.
+static void octaspire_btree_private_node_release(
+    octaspire_btree_t * const self,
+    octaspire_btree_node_t * const node,
+    bool const releaseElements)
+{
+    if (!node->isLeaf)
+    {
+        octaspire_btree_node_t ** const children =
+            octaspire_btree_private_get_children(self, node);
+
+        for (size_t i = 0; i <= node->numKeys; ++i)
+        {
+            octaspire_btree_private_node_release(self, children[i], releaseElements);
+        }
+    }
+
+    if (releaseElements)
+    {
+        for (size_t i = 0; i < node->numKeys; ++i)
+        {
+            octaspire_btree_private_release_element(
+                self,
+                octaspire_btree_private_key_at(self, node, i),
+                octaspire_btree_private_value_at(self, node, i));
+        }
+    }
+
+    octaspire_allocator_free(self->allocator, node);
+}
+
+// Copies 'count' keys and values between (possibly same) nodes.
+static void octaspire_btree_private_move_elements(
+    octaspire_btree_t const * const self,
+    octaspire_btree_node_t * const target,
+    size_t const targetIndex,
+    octaspire_btree_node_t const * const source,
+    size_t const sourceIndex,
+    size_t const count)
+{
+    memmove(
+        octaspire_btree_private_key_at(self, target, targetIndex),
+        octaspire_btree_private_key_at(self, source, sourceIndex),
+        count * self->keySizeInOctets);
+
+    memmove(
+        octaspire_btree_private_value_at(self, target, targetIndex),
+        octaspire_btree_private_value_at(self, source, sourceIndex),
+        count * self->valueSizeInOctets);
+}
+
+static void octaspire_btree_private_move_children(
+    octaspire_btree_t const * const self,
+    octaspire_btree_node_t * const target,
+    size_t const targetIndex,
+    octaspire_btree_node_t const * const source,
+    size_t const sourceIndex,
+    size_t const count)
+{
+    memmove(
+        octaspire_btree_private_get_children(self, target) + targetIndex,
+        octaspire_btree_private_get_children(self, source) + sourceIndex,
+        count * sizeof(octaspire_btree_node_t*));
+}
+
+static void octaspire_btree_private_write_element(
+    octaspire_btree_t const * const self,
+    octaspire_btree_node_t * const node,
+    size_t const index,
+    void const * const key,
+    void const * const value)
+{
+    memcpy(
+        octaspire_btree_private_key_at(self, node, index),
+        key,
+        self->keySizeInOctets);
+
+    memcpy(
+        octaspire_btree_private_value_at(self, node, index),
+        value,
+        self->valueSizeInOctets);
+}
+
+static void octaspire_btree_private_read_element(
+    octaspire_btree_t const * const self,
+    octaspire_btree_node_t const * const node,
+    size_t const index,
+    void * const key,
+    void * const value)
+{
+    memcpy(
+        key,
+        octaspire_btree_private_key_at(self, node, index),
+        self->keySizeInOctets);
+
+    memcpy(
+        value,
+        octaspire_btree_private_value_at(self, node, index),
+        self->valueSizeInOctets);
+}
+
+// Splits the full child at 'index' of 'node' into two, moving the
+// median key up into 'node'. 'node' itself must not be full.
+static bool octaspire_btree_private_split_child(
+    octaspire_btree_t * const self,
+    octaspire_btree_node_t * const node,
+    size_t const index)
+{
+    size_t const degree = OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE;
+
+    octaspire_btree_node_t ** const children =
+        octaspire_btree_private_get_children(self, node);
+
+    octaspire_btree_node_t * const left = children[index];
+
+    assert(left->numKeys == OCTASPIRE_BTREE_PRIVATE_MAX_KEYS);
+    assert(node->numKeys < OCTASPIRE_BTREE_PRIVATE_MAX_KEYS);
+
+    octaspire_btree_node_t * const right =
+        octaspire_btree_private_node_new(self, left->isLeaf);
+
+    if (!right)
+    {
+        return false;
+    }
+
+    octaspire_btree_private_move_elements(self, right, 0, left, degree, degree - 1);
+
+    if (!left->isLeaf)
+    {
+        octaspire_btree_private_move_children(self, right, 0, left, degree, degree);
+    }
+
+    right->numKeys = degree - 1;
+    left->numKeys  = degree - 1;
+
+    octaspire_btree_private_move_elements(
+        self,
+        node,
+        index + 1,
+        node,
+        index,
+        node->numKeys - index);
+
+    octaspire_btree_private_move_children(
+        self,
+        node,
+        index + 2,
+        node,
+        index + 1,
+        node->numKeys - index);
+
+    octaspire_btree_private_move_elements(self, node, index, left, degree - 1, 1);
+    children[index + 1] = right;
+    ++(node->numKeys);
+
+    return true;
+}
+
+// Merges child 'index + 1' and the key between the children into child
+// 'index', and removes them from 'node'.
+static void octaspire_btree_private_merge_children(
+    octaspire_btree_t * const self,
+    octaspire_btree_node_t * const node,
+    size_t const index)
+{
+    octaspire_btree_node_t ** const children =
+        octaspire_btree_private_get_children(self, node);
+
+    octaspire_btree_node_t * const left  = children[index];
+    octaspire_btree_node_t * const right = children[index + 1];
+
+    assert(left->numKeys + right->numKeys < OCTASPIRE_BTREE_PRIVATE_MAX_KEYS);
+
+    octaspire_btree_private_move_elements(self, left, left->numKeys, node, index, 1);
+
+    octaspire_btree_private_move_elements(
+        self,
+        left,
+        left->numKeys + 1,
+        right,
+        0,
+        right->numKeys);
+
+    if (!left->isLeaf)
+    {
+        octaspire_btree_private_move_children(
+            self,
+            left,
+            left->numKeys + 1,
+            right,
+            0,
+            right->numKeys + 1);
+    }
+
+    left->numKeys += right->numKeys + 1;
+
+    octaspire_btree_private_move_elements(
+        self,
+        node,
+        index,
+        node,
+        index + 1,
+        node->numKeys - index - 1);
+
+    octaspire_btree_private_move_children(
+        self,
+        node,
+        index + 1,
+        node,
+        index + 2,
+        node->numKeys - index - 1);
+
+    --(node->numKeys);
+
+    octaspire_allocator_free(self->allocator, right);
+}
+
+// Makes sure child 'index' of 'node' has at least MIN_DEGREE keys by
+// borrowing from a sibling or merging with one. Returns the child that
+// now covers the keys of the original child.
+static octaspire_btree_node_t *octaspire_btree_private_fill_child(
+    octaspire_btree_t * const self,
+    octaspire_btree_node_t * const node,
+    size_t const index)
+{
+    octaspire_btree_node_t ** const children =
+        octaspire_btree_private_get_children(self, node);
+
+    octaspire_btree_node_t * const child = children[index];
+
+    if (child->numKeys >= OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE)
+    {
+        return child;
+    }
+
+    if (index > 0 && children[index - 1]->numKeys >= OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE)
+    {
+        octaspire_btree_node_t * const left = children[index - 1];
+
+        octaspire_btree_private_move_elements(self, child, 1, child, 0, child->numKeys);
+        octaspire_btree_private_move_elements(self, child, 0, node, index - 1, 1);
+
+        octaspire_btree_private_move_elements(
+            self,
+            node,
+            index - 1,
+            left,
+            left->numKeys - 1,
+            1);
+
+        if (!child->isLeaf)
+        {
+            octaspire_btree_private_move_children(
+                self,
+                child,
+                1,
+                child,
+                0,
+                child->numKeys + 1);
+
+            octaspire_btree_private_move_children(
+                self,
+                child,
+                0,
+                left,
+                left->numKeys,
+                1);
+        }
+
+        ++(child->numKeys);
+        --(left->numKeys);
+        return child;
+    }
+
+    if (index < node->numKeys &&
+        children[index + 1]->numKeys >= OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE)
+    {
+        octaspire_btree_node_t * const right = children[index + 1];
+
+        octaspire_btree_private_move_elements(self, child, child->numKeys, node, index, 1);
+        octaspire_btree_private_move_elements(self, node, index, right, 0, 1);
+
+        if (!child->isLeaf)
+        {
+            octaspire_btree_private_move_children(
+                self,
+                child,
+                child->numKeys + 1,
+                right,
+                0,
+                1);
+
+            octaspire_btree_private_move_children(
+                self,
+                right,
+                0,
+                right,
+                1,
+                right->numKeys);
+        }
+
+        octaspire_btree_private_move_elements(self, right, 0, right, 1, right->numKeys - 1);
+
+        ++(child->numKeys);
+        --(right->numKeys);
+        return child;
+    }
+
+    if (index < node->numKeys)
+    {
+        octaspire_btree_private_merge_children(self, node, index);
+        return child;
+    }
+
+    octaspire_btree_private_merge_children(self, node, index - 1);
+    return children[index - 1];
+}
+
+// Removes 'key' from the subtree of 'node' and copies the removed key
+// and value into 'removedKey' and 'removedValue'. Every node entered
+// below 'node' has at least MIN_DEGREE keys, so removal never needs to
+// walk back up.
+static bool octaspire_btree_private_remove(
+    octaspire_btree_t * const self,
+    octaspire_btree_node_t *node,
+    void const * const key,
+    void * const removedKey,
+    void * const removedValue)
+{
+    while (true)
+    {
+        bool found = false;
+
+        size_t const index =
+            octaspire_btree_private_lower_bound(self, node, key, &found);
+
+        if (node->isLeaf)
+        {
+            if (!found)
+            {
+                return false;
+            }
+
+            octaspire_btree_private_read_element(
+                self,
+                node,
+                index,
+                removedKey,
+                removedValue);
+
+            octaspire_btree_private_move_elements(
+                self,
+                node,
+                index,
+                node,
+                index + 1,
+                node->numKeys - index - 1);
+
+            --(node->numKeys);
+            return true;
+        }
+
+        octaspire_btree_node_t ** const children =
+            octaspire_btree_private_get_children(self, node);
+
+        if (!found)
+        {
+            node = octaspire_btree_private_fill_child(self, node, index);
+            continue;
+        }
+
+        octaspire_btree_node_t *left  = children[index];
+        octaspire_btree_node_t *right = children[index + 1];
+
+        if (left->numKeys < OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE &&
+            right->numKeys < OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE)
+        {
+            octaspire_btree_private_merge_children(self, node, index);
+            node = left;
+            continue;
+        }
+
+        // Replace the key with its predecessor or successor, taken from
+        // the child that can lose a key.
+        void * const tmpKey   = ((char*)self->scratch) + self->keySizeInOctets;
+
+        void * const tmpValue = ((char*)self->scratch) +
+            self->scratchValuesOffset + self->valueSizeInOctets;
+
+        octaspire_btree_private_read_element(
+            self,
+            node,
+            index,
+            removedKey,
+            removedValue);
+
+        octaspire_btree_node_t *child = 0;
+
+        if (left->numKeys >= OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE)
+        {
+            child = left;
+
+            octaspire_btree_node_t *iter = left;
+
+            while (!iter->isLeaf)
+            {
+                iter = octaspire_btree_private_get_children(self, iter)[iter->numKeys];
+            }
+
+            octaspire_btree_private_read_element(
+                self,
+                iter,
+                iter->numKeys - 1,
+                tmpKey,
+                tmpValue);
+        }
+        else
+        {
+            child = right;
+
+            octaspire_btree_node_t *iter = right;
+
+            while (!iter->isLeaf)
+            {
+                iter = octaspire_btree_private_get_children(self, iter)[0];
+            }
+
+            octaspire_btree_private_read_element(self, iter, 0, tmpKey, tmpValue);
+        }
+
+        bool const removed =
+            octaspire_btree_private_remove(self, child, tmpKey, tmpKey, tmpValue);
+
+        assert(removed);
+        OCTASPIRE_HELPERS_UNUSED_PARAMETER(removed);
+
+        octaspire_btree_private_write_element(self, node, index, tmpKey, tmpValue);
+        return true;
+    }
+}
+
+static int octaspire_btree_private_size_t_compare(
+    size_t const * const first,
+    size_t const * const second)
+{
+    return (*first > *second) - (*first < *second);
+}
+
+octaspire_btree_t *octaspire_btree_new(
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_btree_key_compare_function_t keyCompareFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    assert(keyCompareFunction);
+
+    octaspire_btree_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_btree_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->allocator            = allocator;
+    self->root                 = 0;
+    self->keyCompareFunction   = keyCompareFunction;
+    self->keyReleaseCallback   = keyReleaseCallback;
+    self->valueReleaseCallback = valueReleaseCallback;
+    self->keySizeInOctets      = keySizeInOctets;
+    self->valueSizeInOctets    = valueSizeInOctets;
+    self->keyIsPointer         = keyIsPointer;
+    self->valueIsPointer       = valueIsPointer;
+    self->numElements          = 0;
+
+    self->valuesOffset =
+        octaspire_btree_private_align(sizeof(octaspire_btree_node_t)) +
+        octaspire_btree_private_align(
+            OCTASPIRE_BTREE_PRIVATE_MAX_KEYS * keySizeInOctets);
+
+    self->childrenOffset = self->valuesOffset +
+        octaspire_btree_private_align(
+            OCTASPIRE_BTREE_PRIVATE_MAX_KEYS * valueSizeInOctets);
+
+    // Room for a removed element and a temporary element during removal
+    self->scratchValuesOffset = octaspire_btree_private_align(2 * keySizeInOctets);
+
+    self->scratch = octaspire_allocator_malloc(
+        self->allocator,
+        self->scratchValuesOffset +
+            octaspire_btree_private_align(2 * valueSizeInOctets) +
+            OCTASPIRE_BTREE_PRIVATE_ALIGNMENT);
+
+    if (!self->scratch)
+    {
+        octaspire_btree_release(self);
+        self = 0;
+        return 0;
+    }
+
+    return self;
+}
+
+octaspire_btree_t *octaspire_btree_new_with_octaspire_string_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    return octaspire_btree_new(
+        sizeof(octaspire_string_t*),
+        true,
+        valueSizeInOctets,
+        valueIsPointer,
+        (octaspire_btree_key_compare_function_t)octaspire_string_compare,
+        (octaspire_map_element_callback_t)octaspire_string_release,
+        valueReleaseCallback,
+        allocator);
+}
+
+octaspire_btree_t *octaspire_btree_new_with_size_t_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    return octaspire_btree_new(
+        sizeof(size_t),
+        false,
+        valueSizeInOctets,
+        valueIsPointer,
+        (octaspire_btree_key_compare_function_t)
+            octaspire_btree_private_size_t_compare,
+        (octaspire_map_element_callback_t)0,
+        valueReleaseCallback,
+        allocator);
+}
+
+void octaspire_btree_release(octaspire_btree_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    octaspire_btree_clear(self);
+
+    octaspire_allocator_free(self->allocator, self->scratch);
+    self->scratch = 0;
+
+    octaspire_allocator_free(self->allocator, self);
+}
+
+bool octaspire_btree_put(
+    octaspire_btree_t * const self,
+    void const * const key,
+    void const * const value)
+{
+    assert(self);
+
+    if (!self->root)
+    {
+        self->root = octaspire_btree_private_node_new(self, true);
+
+        if (!self->root)
+        {
+            return false;
+        }
+    }
+
+    if (self->root->numKeys == OCTASPIRE_BTREE_PRIVATE_MAX_KEYS)
+    {
+        octaspire_btree_node_t * const newRoot =
+            octaspire_btree_private_node_new(self, false);
+
+        if (!newRoot)
+        {
+            return false;
+        }
+
+        octaspire_btree_private_get_children(self, newRoot)[0] = self->root;
+
+        if (!octaspire_btree_private_split_child(self, newRoot, 0))
+        {
+            octaspire_allocator_free(self->allocator, newRoot);
+            return false;
+        }
+
+        self->root = newRoot;
+    }
+
+    octaspire_btree_node_t *node = self->root;
+
+    while (true)
+    {
+        bool found = false;
+
+        size_t const index =
+            octaspire_btree_private_lower_bound(self, node, key, &found);
+
+        if (!found && !node->isLeaf)
+        {
+            octaspire_btree_node_t ** const children =
+                octaspire_btree_private_get_children(self, node);
+
+            if (children[index]->numKeys < OCTASPIRE_BTREE_PRIVATE_MAX_KEYS)
+            {
+                node = children[index];
+                continue;
+            }
+
+            if (!octaspire_btree_private_split_child(self, node, index))
+            {
+                return false;
+            }
+
+            int const result = self->keyCompareFunction(
+                octaspire_btree_private_get_user_key(self, key),
+                octaspire_btree_private_get_user_key(
+                    self,
+                    octaspire_btree_private_key_at(self, node, index)));
+
+            if (result != 0)
+            {
+                node = children[result > 0 ? index + 1 : index];
+                continue;
+            }
+
+            found = true;
+        }
+
+        if (found)
+        {
+            void * const storedKey =
+                octaspire_btree_private_key_at(self, node, index);
+
+            void * const storedValue =
+                octaspire_btree_private_value_at(self, node, index);
+
+            if (self->keyReleaseCallback &&
+                memcmp(storedKey, key, self->keySizeInOctets) != 0)
+            {
+                self->keyReleaseCallback(
+                    (void*)octaspire_btree_private_get_user_key(self, key));
+            }
+
+            if (self->valueReleaseCallback &&
+                memcmp(storedValue, value, self->valueSizeInOctets) != 0)
+            {
+                self->valueReleaseCallback(
+                    (void*)octaspire_btree_private_get_user_value(self, storedValue));
+            }
+
+            memcpy(storedValue, value, self->valueSizeInOctets);
+            return true;
+        }
+
+        octaspire_btree_private_move_elements(
+            self,
+            node,
+            index + 1,
+            node,
+            index,
+            node->numKeys - index);
+
+        octaspire_btree_private_write_element(self, node, index, key, value);
+        ++(node->numKeys);
+        ++(self->numElements);
+        return true;
+    }
+}
+
+// Capacity of a tree of 'height' levels of full nodes.
+static size_t octaspire_btree_private_get_capacity(size_t const height)
+{
+    size_t result = 0;
+
+    for (size_t i = 0; i < height; ++i)
+    {
+        result = (result + 1) * (OCTASPIRE_BTREE_PRIVATE_MAX_KEYS + 1) - 1;
+    }
+
+    return result;
+}
+
+// Builds a subtree of exactly 'height' levels from 'numElements' sorted
+// elements starting at 'firstIndex'. Elements are spread evenly over the
+// smallest number of children that can hold them.
+static octaspire_btree_node_t *octaspire_btree_private_build(
+    octaspire_btree_t * const self,
+    char const * const keys,
+    char const * const values,
+    size_t const firstIndex,
+    size_t const numElements,
+    size_t const height,
+    bool const isRoot)
+{
+    octaspire_btree_node_t * const node =
+        octaspire_btree_private_node_new(self, height == 1);
+
+    if (!node)
+    {
+        return 0;
+    }
+
+    if (height == 1)
+    {
+        assert(numElements <= OCTASPIRE_BTREE_PRIVATE_MAX_KEYS);
+
+        memcpy(
+            octaspire_btree_private_key_at(self, node, 0),
+            keys + (firstIndex * self->keySizeInOctets),
+            numElements * self->keySizeInOctets);
+
+        memcpy(
+            octaspire_btree_private_value_at(self, node, 0),
+            values + (firstIndex * self->valueSizeInOctets),
+            numElements * self->valueSizeInOctets);
+
+        node->numKeys = numElements;
+        return node;
+    }
+
+    size_t const childCapacity =
+        octaspire_btree_private_get_capacity(height - 1);
+
+    size_t numChildren = (numElements + childCapacity + 1) / (childCapacity + 1);
+
+    if (!isRoot && numChildren < OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE)
+    {
+        numChildren = OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE;
+    }
+
+    assert(numChildren >= 2);
+    assert(numChildren <= OCTASPIRE_BTREE_PRIVATE_MAX_KEYS + 1);
+
+    octaspire_btree_node_t ** const children =
+        octaspire_btree_private_get_children(self, node);
+
+    size_t const base  = (numElements + 1) / numChildren;
+    size_t const extra = (numElements + 1) % numChildren;
+    size_t index       = firstIndex;
+
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+        size_t const numChildElements = base + ((i < extra) ? 1 : 0) - 1;
+
+        children[i] = octaspire_btree_private_build(
+            self,
+            keys,
+            values,
+            index,
+            numChildElements,
+            height - 1,
+            false);
+
+        if (!children[i])
+        {
+            for (size_t j = 0; j < i; ++j)
+            {
+                octaspire_btree_private_node_release(self, children[j], false);
+            }
+
+            octaspire_allocator_free(self->allocator, node);
+            return 0;
+        }
+
+        index += numChildElements;
+
+        if (i + 1 < numChildren)
+        {
+            octaspire_btree_private_write_element(
+                self,
+                node,
+                i,
+                keys   + (index * self->keySizeInOctets),
+                values + (index * self->valueSizeInOctets));
+
+            ++index;
+        }
+    }
+
+    node->numKeys = numChildren - 1;
+    return node;
+}
+
+bool octaspire_btree_load_sorted(
+    octaspire_btree_t * const self,
+    void const * const keys,
+    void const * const values,
+    size_t const numElements)
+{
+    assert(self);
+
+    if (self->numElements)
+    {
+        return false;
+    }
+
+    if (!numElements)
+    {
+        return true;
+    }
+
+    char const * const keyOctets = keys;
+
+    for (size_t i = 1; i < numElements; ++i)
+    {
+        int const result = self->keyCompareFunction(
+            octaspire_btree_private_get_user_key(
+                self,
+                keyOctets + ((i - 1) * self->keySizeInOctets)),
+            octaspire_btree_private_get_user_key(
+                self,
+                keyOctets + (i * self->keySizeInOctets)));
+
+        if (result >= 0)
+        {
+            return false;
+        }
+    }
+
+    size_t height = 1;
+
+    while (octaspire_btree_private_get_capacity(height) < numElements)
+    {
+        ++height;
+    }
+
+    octaspire_btree_node_t * const root = octaspire_btree_private_build(
+        self,
+        keys,
+        values,
+        0,
+        numElements,
+        height,
+        true);
+
+    if (!root)
+    {
+        return false;
+    }
+
+    if (self->root)
+    {
+        octaspire_btree_private_node_release(self, self->root, false);
+    }
+
+    self->root        = root;
+    self->numElements = numElements;
+    return true;
+}
+
+bool octaspire_btree_remove(
+    octaspire_btree_t * const self,
+    void const * const key)
+{
+    assert(self);
+
+    if (!self->root)
+    {
+        return false;
+    }
+
+    void * const removedKey   = self->scratch;
+    void * const removedValue = ((char*)self->scratch) + self->scratchValuesOffset;
+
+    bool const result = octaspire_btree_private_remove(
+        self,
+        self->root,
+        key,
+        removedKey,
+        removedValue);
+
+    if (!self->root->numKeys)
+    {
+        octaspire_btree_node_t * const oldRoot = self->root;
+
+        self->root = oldRoot->isLeaf ?
+            0 : octaspire_btree_private_get_children(self, oldRoot)[0];
+
+        octaspire_allocator_free(self->allocator, oldRoot);
+    }
+
+    if (!result)
+    {
+        return false;
+    }
+
+    --(self->numElements);
+    octaspire_btree_private_release_element(self, removedKey, removedValue);
+    return true;
+}
+
+void octaspire_btree_clear(
+    octaspire_btree_t * const self)
+{
+    assert(self);
+
+    if (self->root)
+    {
+        octaspire_btree_private_node_release(self, self->root, true);
+        self->root = 0;
+    }
+
+    self->numElements = 0;
+}
+
+void *octaspire_btree_get(
+    octaspire_btree_t * const self,
+    void const * const key)
+{
+    return (void*)octaspire_btree_get_const(self, key);
+}
+
+void const *octaspire_btree_get_const(
+    octaspire_btree_t const * const self,
+    void const * const key)
+{
+    assert(self);
+
+    octaspire_btree_node_t const *node = self->root;
+
+    while (node)
+    {
+        bool found = false;
+
+        size_t const index =
+            octaspire_btree_private_lower_bound(self, node, key, &found);
+
+        if (found)
+        {
+            return octaspire_btree_private_get_user_value(
+                self,
+                octaspire_btree_private_value_at(self, node, index));
+        }
+
+        node = node->isLeaf ?
+            0 : octaspire_btree_private_get_children(self, node)[index];
+    }
+
+    return 0;
+}
+
+bool octaspire_btree_is_empty(
+    octaspire_btree_t const * const self)
+{
+    return self->numElements == 0;
+}
+
+size_t octaspire_btree_get_number_of_elements(
+    octaspire_btree_t const * const self)
+{
+    return self->numElements;
+}
+
+
+
+static void octaspire_btree_element_const_iterator_private_push(
+    octaspire_btree_element_const_iterator_t * const self,
+    octaspire_btree_node_t const * const node,
+    size_t const index)
+{
+    assert(self->depth < OCTASPIRE_BTREE_ITERATOR_MAX_DEPTH);
+    self->nodes[self->depth]   = node;
+    self->indices[self->depth] = index;
+    ++(self->depth);
+}
+
+// Descends from 'node' to the first element not less than 'key', or to
+// the first element of the subtree if 'key' is NULL.
+static void octaspire_btree_element_const_iterator_private_descend(
+    octaspire_btree_element_const_iterator_t * const self,
+    octaspire_btree_node_t const *node,
+    void const * const key)
+{
+    while (node)
+    {
+        bool found = false;
+
+        size_t const index = key ?
+            octaspire_btree_private_lower_bound(self->btree, node, key, &found) : 0;
+
+        octaspire_btree_element_const_iterator_private_push(self, node, index);
+
+        if (found || node->isLeaf)
+        {
+            return;
+        }
+
+        node = octaspire_btree_private_get_children(self->btree, node)[index];
+    }
+}
+
+// Pops finished nodes and updates 'key' and 'value' to the element at
+// the top of the stack.
+static bool octaspire_btree_element_const_iterator_private_settle(
+    octaspire_btree_element_const_iterator_t * const self)
+{
+    while (self->depth > 0 &&
+           self->indices[self->depth - 1] == self->nodes[self->depth - 1]->numKeys)
+    {
+        --(self->depth);
+    }
+
+    if (self->depth > 0)
+    {
+        octaspire_btree_node_t const * const node = self->nodes[self->depth - 1];
+        size_t const index = self->indices[self->depth - 1];
+
+        void const * const key =
+            octaspire_btree_private_key_at(self->btree, node, index);
+
+        if (!self->upperBoundKey ||
+            self->btree->keyCompareFunction(
+                octaspire_btree_private_get_user_key(self->btree, key),
+                octaspire_btree_private_get_user_key(
+                    self->btree,
+                    self->upperBoundKey)) < 0)
+        {
+            self->key = octaspire_btree_private_get_user_key(self->btree, key);
+
+            self->value = octaspire_btree_private_get_user_value(
+                self->btree,
+                octaspire_btree_private_value_at(self->btree, node, index));
+
+            return true;
+        }
+
+        self->depth = 0;
+    }
+
+    self->key   = 0;
+    self->value = 0;
+    return false;
+}
+
+octaspire_btree_element_const_iterator_t
+octaspire_btree_element_const_iterator_init(
+    octaspire_btree_t const * const self)
+{
+    return octaspire_btree_element_const_iterator_init_range(self, 0, 0);
+}
+
+octaspire_btree_element_const_iterator_t
+octaspire_btree_element_const_iterator_init_lower_bound(
+    octaspire_btree_t const * const self,
+    void const * const key)
+{
+    return octaspire_btree_element_const_iterator_init_range(self, key, 0);
+}
+
+octaspire_btree_element_const_iterator_t
+octaspire_btree_element_const_iterator_init_range(
+    octaspire_btree_t const * const self,
+    void const * const lowerKey,
+    void const * const upperKey)
+{
+    assert(self);
+
+    octaspire_btree_element_const_iterator_t iterator;
+
+    iterator.btree         = self;
+    iterator.key           = 0;
+    iterator.value         = 0;
+    iterator.upperBoundKey = upperKey;
+    iterator.depth         = 0;
+
+    octaspire_btree_element_const_iterator_private_descend(
+        &iterator,
+        self->root,
+        lowerKey);
+
+    octaspire_btree_element_const_iterator_private_settle(&iterator);
+
+    return iterator;
+}
+
+bool octaspire_btree_element_const_iterator_next(
+    octaspire_btree_element_const_iterator_t * const self)
+{
+    assert(self);
+
+    if (!self->depth)
+    {
+        return false;
+    }
+
+    octaspire_btree_node_t const * const node = self->nodes[self->depth - 1];
+    size_t const index = ++(self->indices[self->depth - 1]);
+
+    if (!node->isLeaf)
+    {
+        octaspire_btree_element_const_iterator_private_descend(
+            self,
+            octaspire_btree_private_get_children(self->btree, node)[index],
+            0);
+    }
+
+    return octaspire_btree_element_const_iterator_private_settle(self);
+}
+
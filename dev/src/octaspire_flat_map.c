@@ -0,0 +1,532 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_flat_map.h"
+#include <assert.h>
+#include <string.h>
+#include "octaspire/core/octaspire_vector.h"
+#include "octaspire/core/octaspire_helpers.h"
+
+static size_t const OCTASPIRE_FLAT_MAP_PRIVATE_HEADER_LENGTH_IN_OCTETS      = 40;
+static size_t const OCTASPIRE_FLAT_MAP_PRIVATE_SLOT_LENGTH_IN_OCTETS        = 16;
+static size_t const OCTASPIRE_FLAT_MAP_PRIVATE_ENTRY_HEADER_LENGTH_IN_OCTETS = 16;
+static size_t const OCTASPIRE_FLAT_MAP_PRIVATE_SMALLEST_NUM_SLOTS           = 16;
+
+typedef struct octaspire_flat_map_builder_private_entry_t
+{
+    uint8_t  *octets;
+    size_t    keyLengthInOctets;
+    size_t    valueLengthInOctets;
+    uint32_t  hash;
+    char      padding[4];
+}
+octaspire_flat_map_builder_private_entry_t;
+
+struct octaspire_flat_map_builder_t
+{
+    octaspire_allocator_t *allocator;
+    octaspire_vector_t    *entries;
+};
+
+static void octaspire_flat_map_private_write_uint32(
+    uint8_t * const octets,
+    uint32_t const value)
+{
+    octets[0] = (uint8_t)(value);
+    octets[1] = (uint8_t)(value >> 8);
+    octets[2] = (uint8_t)(value >> 16);
+    octets[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t octaspire_flat_map_private_read_uint32(
+    uint8_t const * const octets)
+{
+    return (uint32_t)octets[0] |
+        ((uint32_t)octets[1] << 8) |
+        ((uint32_t)octets[2] << 16) |
+        ((uint32_t)octets[3] << 24);
+}
+
+static void octaspire_flat_map_private_write_uint64(
+    uint8_t * const octets,
+    uint64_t const value)
+{
+    octaspire_flat_map_private_write_uint32(octets, (uint32_t)value);
+    octaspire_flat_map_private_write_uint32(octets + 4, (uint32_t)(value >> 32));
+}
+
+static uint64_t octaspire_flat_map_private_read_uint64(
+    uint8_t const * const octets)
+{
+    return (uint64_t)octaspire_flat_map_private_read_uint32(octets) |
+        ((uint64_t)octaspire_flat_map_private_read_uint32(octets + 4) << 32);
+}
+
+static size_t octaspire_flat_map_private_round_up(size_t const lengthInOctets)
+{
+    return (lengthInOctets + 7) & ~(size_t)7;
+}
+
+static uint32_t octaspire_flat_map_private_get_hash(
+    void const * const key,
+    size_t const keyLengthInOctets)
+{
+    return octaspire_helpers_calculate_hash_for_memory_buffer_argument(
+        key,
+        keyLengthInOctets);
+}
+
+// Probes for 'key'. Returns the offset of its entry, or 0 if it is not in
+// the image. 'slotIndex' is set to the free slot that ended the probe, or
+// to 'numSlots' if there was none.
+static size_t octaspire_flat_map_private_find(
+    octaspire_flat_map_t const * const self,
+    void const * const key,
+    size_t const keyLengthInOctets,
+    uint32_t const hash,
+    size_t * const slotIndex)
+{
+    size_t const mask = self->numSlots - 1;
+    size_t index      = hash & mask;
+
+    for (size_t i = 0; i < self->numSlots; ++i)
+    {
+        uint8_t const * const slot = self->octets + self->slotsOffset +
+            index * OCTASPIRE_FLAT_MAP_PRIVATE_SLOT_LENGTH_IN_OCTETS;
+
+        uint64_t const entryOffset = octaspire_flat_map_private_read_uint64(slot + 8);
+
+        if (!entryOffset)
+        {
+            *slotIndex = index;
+            return 0;
+        }
+
+        if (octaspire_flat_map_private_read_uint32(slot) == hash &&
+            entryOffset < self->lengthInOctets &&
+            self->lengthInOctets - entryOffset >=
+                OCTASPIRE_FLAT_MAP_PRIVATE_ENTRY_HEADER_LENGTH_IN_OCTETS)
+        {
+            uint8_t const * const entry = self->octets + entryOffset;
+
+            uint64_t const entryKeyLengthInOctets =
+                octaspire_flat_map_private_read_uint64(entry);
+
+            if (entryKeyLengthInOctets == keyLengthInOctets &&
+                keyLengthInOctets <= self->lengthInOctets - entryOffset -
+                    OCTASPIRE_FLAT_MAP_PRIVATE_ENTRY_HEADER_LENGTH_IN_OCTETS &&
+                (!keyLengthInOctets ||
+                 memcmp(
+                     entry + OCTASPIRE_FLAT_MAP_PRIVATE_ENTRY_HEADER_LENGTH_IN_OCTETS,
+                     key,
+                     keyLengthInOctets) == 0))
+            {
+                return (size_t)entryOffset;
+            }
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    *slotIndex = self->numSlots;
+    return 0;
+}
+
+octaspire_flat_map_builder_t *octaspire_flat_map_builder_new(
+    octaspire_allocator_t *allocator)
+{
+    octaspire_flat_map_builder_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_flat_map_builder_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->allocator = allocator;
+
+    self->entries = octaspire_vector_new(
+        sizeof(octaspire_flat_map_builder_private_entry_t),
+        false,
+        0,
+        self->allocator);
+
+    if (!self->entries)
+    {
+        octaspire_flat_map_builder_release(self);
+        self = 0;
+        return 0;
+    }
+
+    return self;
+}
+
+void octaspire_flat_map_builder_release(octaspire_flat_map_builder_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    if (self->entries)
+    {
+        for (size_t i = 0; i < octaspire_vector_get_length(self->entries); ++i)
+        {
+            octaspire_flat_map_builder_private_entry_t * const entry =
+                octaspire_vector_get_element_at(self->entries, (ptrdiff_t)i);
+
+            octaspire_allocator_free(self->allocator, entry->octets);
+        }
+    }
+
+    octaspire_vector_release(self->entries);
+    self->entries = 0;
+
+    octaspire_allocator_free(self->allocator, self);
+}
+
+bool octaspire_flat_map_builder_add(
+    octaspire_flat_map_builder_t * const self,
+    void const * const key,
+    size_t const keyLengthInOctets,
+    void const * const value,
+    size_t const valueLengthInOctets)
+{
+    assert(self);
+
+    octaspire_flat_map_builder_private_entry_t entry;
+
+    entry.keyLengthInOctets   = keyLengthInOctets;
+    entry.valueLengthInOctets = valueLengthInOctets;
+    entry.hash = octaspire_flat_map_private_get_hash(key, keyLengthInOctets);
+    entry.octets = 0;
+
+    if (keyLengthInOctets + valueLengthInOctets)
+    {
+        entry.octets = octaspire_allocator_malloc(
+            self->allocator,
+            keyLengthInOctets + valueLengthInOctets);
+
+        if (!entry.octets)
+        {
+            return false;
+        }
+
+        if (keyLengthInOctets)
+        {
+            memcpy(entry.octets, key, keyLengthInOctets);
+        }
+
+        if (valueLengthInOctets)
+        {
+            memcpy(entry.octets + keyLengthInOctets, value, valueLengthInOctets);
+        }
+    }
+
+    if (!octaspire_vector_push_back_element(self->entries, &entry))
+    {
+        octaspire_allocator_free(self->allocator, entry.octets);
+        return false;
+    }
+
+    return true;
+}
+
+bool octaspire_flat_map_builder_add_with_string_key(
+    octaspire_flat_map_builder_t * const self,
+    octaspire_string_t const * const key,
+    void const * const value,
+    size_t const valueLengthInOctets)
+{
+    return octaspire_flat_map_builder_add(
+        self,
+        octaspire_string_get_c_string(key),
+        octaspire_string_get_length_in_octets(key),
+        value,
+        valueLengthInOctets);
+}
+
+bool octaspire_flat_map_builder_add_with_integer_key(
+    octaspire_flat_map_builder_t * const self,
+    uint64_t const key,
+    void const * const value,
+    size_t const valueLengthInOctets)
+{
+    uint8_t octets[8];
+    octaspire_flat_map_private_write_uint64(octets, key);
+
+    return octaspire_flat_map_builder_add(
+        self,
+        octets,
+        sizeof(octets),
+        value,
+        valueLengthInOctets);
+}
+
+size_t octaspire_flat_map_builder_get_number_of_elements(
+    octaspire_flat_map_builder_t const * const self)
+{
+    return octaspire_vector_get_length(self->entries);
+}
+
+char *octaspire_flat_map_builder_build(
+    octaspire_flat_map_builder_t const * const self,
+    size_t * const lengthInOctets,
+    octaspire_allocator_t *allocator)
+{
+    assert(self && lengthInOctets);
+
+    size_t const numElements = octaspire_vector_get_length(self->entries);
+
+    size_t numSlots = OCTASPIRE_FLAT_MAP_PRIVATE_SMALLEST_NUM_SLOTS;
+
+    while (numSlots < numElements * 2)
+    {
+        numSlots *= 2;
+    }
+
+    size_t const slotsOffset = OCTASPIRE_FLAT_MAP_PRIVATE_HEADER_LENGTH_IN_OCTETS;
+
+    size_t imageLengthInOctets =
+        slotsOffset + numSlots * OCTASPIRE_FLAT_MAP_PRIVATE_SLOT_LENGTH_IN_OCTETS;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        octaspire_flat_map_builder_private_entry_t const * const entry =
+            octaspire_vector_get_element_at_const(self->entries, (ptrdiff_t)i);
+
+        imageLengthInOctets +=
+            OCTASPIRE_FLAT_MAP_PRIVATE_ENTRY_HEADER_LENGTH_IN_OCTETS +
+            octaspire_flat_map_private_round_up(entry->keyLengthInOctets) +
+            octaspire_flat_map_private_round_up(entry->valueLengthInOctets);
+    }
+
+    uint8_t * const image =
+        octaspire_allocator_malloc(allocator, imageLengthInOctets);
+
+    if (!image)
+    {
+        return 0;
+    }
+
+    // Empty slots, the reserved words and the padding are all zero, also
+    // when a custom malloc function does not zero the memory.
+    memset(image, 0, imageLengthInOctets);
+
+    memcpy(image, "OFM1", 4);
+    octaspire_flat_map_private_write_uint64(image + 8,  numElements);
+    octaspire_flat_map_private_write_uint64(image + 16, numSlots);
+    octaspire_flat_map_private_write_uint64(image + 24, slotsOffset);
+    octaspire_flat_map_private_write_uint64(image + 32, imageLengthInOctets);
+
+    // The partially written image is probed with the same code as the
+    // finished one, which also finds duplicate keys.
+    octaspire_flat_map_t view;
+    view.octets         = image;
+    view.lengthInOctets = imageLengthInOctets;
+    view.numElements    = numElements;
+    view.numSlots       = numSlots;
+    view.slotsOffset    = slotsOffset;
+
+    size_t entryOffset =
+        slotsOffset + numSlots * OCTASPIRE_FLAT_MAP_PRIVATE_SLOT_LENGTH_IN_OCTETS;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        octaspire_flat_map_builder_private_entry_t const * const entry =
+            octaspire_vector_get_element_at_const(self->entries, (ptrdiff_t)i);
+
+        size_t slotIndex = numSlots;
+
+        if (octaspire_flat_map_private_find(
+                &view,
+                entry->octets,
+                entry->keyLengthInOctets,
+                entry->hash,
+                &slotIndex))
+        {
+            octaspire_allocator_free(allocator, image);
+            return 0;
+        }
+
+        assert(slotIndex < numSlots);
+
+        uint8_t * const slot = image + slotsOffset +
+            slotIndex * OCTASPIRE_FLAT_MAP_PRIVATE_SLOT_LENGTH_IN_OCTETS;
+
+        octaspire_flat_map_private_write_uint32(slot, entry->hash);
+        octaspire_flat_map_private_write_uint64(slot + 8, entryOffset);
+
+        uint8_t * const target = image + entryOffset;
+
+        octaspire_flat_map_private_write_uint64(target, entry->keyLengthInOctets);
+        octaspire_flat_map_private_write_uint64(target + 8, entry->valueLengthInOctets);
+
+        size_t const keyOffset =
+            OCTASPIRE_FLAT_MAP_PRIVATE_ENTRY_HEADER_LENGTH_IN_OCTETS;
+
+        size_t const valueOffset =
+            keyOffset + octaspire_flat_map_private_round_up(entry->keyLengthInOctets);
+
+        if (entry->keyLengthInOctets)
+        {
+            memcpy(target + keyOffset, entry->octets, entry->keyLengthInOctets);
+        }
+
+        if (entry->valueLengthInOctets)
+        {
+            memcpy(
+                target + valueOffset,
+                entry->octets + entry->keyLengthInOctets,
+                entry->valueLengthInOctets);
+        }
+
+        entryOffset += valueOffset +
+            octaspire_flat_map_private_round_up(entry->valueLengthInOctets);
+    }
+
+    assert(entryOffset == imageLengthInOctets);
+
+    *lengthInOctets = imageLengthInOctets;
+    return (char*)image;
+}
+
+bool octaspire_flat_map_init(
+    octaspire_flat_map_t * const self,
+    void const * const octets,
+    size_t const lengthInOctets)
+{
+    assert(self);
+
+    uint8_t const * const image = octets;
+
+    if (!image ||
+        lengthInOctets < OCTASPIRE_FLAT_MAP_PRIVATE_HEADER_LENGTH_IN_OCTETS ||
+        memcmp(image, "OFM1", 4) != 0)
+    {
+        return false;
+    }
+
+    uint64_t const numElements         = octaspire_flat_map_private_read_uint64(image + 8);
+    uint64_t const numSlots            = octaspire_flat_map_private_read_uint64(image + 16);
+    uint64_t const slotsOffset         = octaspire_flat_map_private_read_uint64(image + 24);
+    uint64_t const imageLengthInOctets = octaspire_flat_map_private_read_uint64(image + 32);
+
+    // The slots must fit in the image and there must be a free slot
+    // to end every probe.
+    if (imageLengthInOctets > lengthInOctets ||
+        slotsOffset < OCTASPIRE_FLAT_MAP_PRIVATE_HEADER_LENGTH_IN_OCTETS ||
+        slotsOffset > imageLengthInOctets ||
+        !numSlots ||
+        (numSlots & (numSlots - 1)) ||
+        numSlots > (imageLengthInOctets - slotsOffset) /
+            OCTASPIRE_FLAT_MAP_PRIVATE_SLOT_LENGTH_IN_OCTETS ||
+        numElements >= numSlots)
+    {
+        return false;
+    }
+
+    self->octets         = image;
+    self->lengthInOctets = (size_t)imageLengthInOctets;
+    self->numElements    = (size_t)numElements;
+    self->numSlots       = (size_t)numSlots;
+    self->slotsOffset    = (size_t)slotsOffset;
+
+    return true;
+}
+
+size_t octaspire_flat_map_get_number_of_elements(
+    octaspire_flat_map_t const * const self)
+{
+    return self->numElements;
+}
+
+bool octaspire_flat_map_get(
+    octaspire_flat_map_t const * const self,
+    void const * const key,
+    size_t const keyLengthInOctets,
+    void const ** const value,
+    size_t * const valueLengthInOctets)
+{
+    assert(self && value && valueLengthInOctets);
+
+    size_t slotIndex = 0;
+
+    size_t const entryOffset = octaspire_flat_map_private_find(
+        self,
+        key,
+        keyLengthInOctets,
+        octaspire_flat_map_private_get_hash(key, keyLengthInOctets),
+        &slotIndex);
+
+    if (!entryOffset)
+    {
+        return false;
+    }
+
+    uint8_t const * const entry = self->octets + entryOffset;
+
+    // The key was found inside of the image, so this does not overflow
+    size_t const valueOffset = entryOffset +
+        OCTASPIRE_FLAT_MAP_PRIVATE_ENTRY_HEADER_LENGTH_IN_OCTETS +
+        octaspire_flat_map_private_round_up(keyLengthInOctets);
+
+    uint64_t const entryValueLengthInOctets =
+        octaspire_flat_map_private_read_uint64(entry + 8);
+
+    if (valueOffset > self->lengthInOctets ||
+        entryValueLengthInOctets > self->lengthInOctets - valueOffset)
+    {
+        return false;
+    }
+
+    *value               = self->octets + valueOffset;
+    *valueLengthInOctets = (size_t)entryValueLengthInOctets;
+
+    return true;
+}
+
+bool octaspire_flat_map_get_with_string_key(
+    octaspire_flat_map_t const * const self,
+    octaspire_string_t const * const key,
+    void const ** const value,
+    size_t * const valueLengthInOctets)
+{
+    return octaspire_flat_map_get(
+        self,
+        octaspire_string_get_c_string(key),
+        octaspire_string_get_length_in_octets(key),
+        value,
+        valueLengthInOctets);
+}
+
+bool octaspire_flat_map_get_with_integer_key(
+    octaspire_flat_map_t const * const self,
+    uint64_t const key,
+    void const ** const value,
+    size_t * const valueLengthInOctets)
+{
+    uint8_t octets[8];
+    octaspire_flat_map_private_write_uint64(octets, key);
+
+    return octaspire_flat_map_get(
+        self,
+        octets,
+        sizeof(octets),
+        value,
+        valueLengthInOctets);
+}
+
@@ -0,0 +1,1171 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_hamt.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_helpers.h"
+
+typedef enum octaspire_hamt_private_node_kind_t
+{
+    OCTASPIRE_HAMT_PRIVATE_NODE_KIND_BRANCH,
+    OCTASPIRE_HAMT_PRIVATE_NODE_KIND_COLLISION,
+    OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF
+}
+octaspire_hamt_private_node_kind_t;
+
+// Branch nodes store their children, collision nodes their leaves and
+// leaf nodes their key and value in the same allocation, right after
+// the node itself.
+struct octaspire_hamt_node_t
+{
+    size_t                              refCount;
+    size_t                              numChildren;
+    size_t                              valueOffset;
+    uint32_t                            hash;
+    uint32_t                            bitmap;
+    octaspire_hamt_private_node_kind_t  kind;
+    bool                                keyIsPointer;
+    bool                                valueIsPointer;
+    char                                padding[2];
+};
+
+typedef struct octaspire_hamt_private_config_t
+{
+    octaspire_allocator_t                *allocator;
+    octaspire_map_key_compare_function_t  keyCompareFunction;
+    octaspire_map_key_hash_function_t     keyHashFunction;
+    octaspire_map_element_callback_t      keyReleaseCallback;
+    octaspire_map_element_callback_t      valueReleaseCallback;
+    size_t                                keySizeInOctets;
+    size_t                                valueSizeInOctets;
+    size_t                                refCount;
+    bool                                  keyIsPointer;
+    bool                                  valueIsPointer;
+    char                                  padding[6];
+}
+octaspire_hamt_private_config_t;
+
+struct octaspire_hamt_t
+{
+    octaspire_hamt_private_config_t *config;
+    octaspire_hamt_node_t           *root;
+    size_t                           numElements;
+};
+
+static size_t   const OCTASPIRE_HAMT_PRIVATE_BITS_PER_LEVEL = 5;
+static uint32_t const OCTASPIRE_HAMT_PRIVATE_LEVEL_MASK     = 0x1F;
+static size_t   const OCTASPIRE_HAMT_PRIVATE_MAX_SHIFT      = 30;
+static size_t   const OCTASPIRE_HAMT_PRIVATE_ALIGNMENT      = 16;
+
+static size_t octaspire_hamt_private_align(size_t const size)
+{
+    return (size + OCTASPIRE_HAMT_PRIVATE_ALIGNMENT - 1) &
+        ~(OCTASPIRE_HAMT_PRIVATE_ALIGNMENT - 1);
+}
+
+static size_t octaspire_hamt_private_popcount(uint32_t value)
+{
+    value = value - ((value >> 1) & 0x55555555);
+    value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+    value = (value + (value >> 4)) & 0x0F0F0F0F;
+    return (size_t)((value * 0x01010101) >> 24);
+}
+
+static octaspire_hamt_node_t **octaspire_hamt_private_node_get_children(
+    octaspire_hamt_node_t * const self)
+{
+    assert(self->kind != OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF);
+    return (octaspire_hamt_node_t**)(self + 1);
+}
+
+static octaspire_hamt_node_t * const *
+octaspire_hamt_private_node_get_children_const(
+    octaspire_hamt_node_t const * const self)
+{
+    assert(self->kind != OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF);
+    return (octaspire_hamt_node_t * const *)(self + 1);
+}
+
+static void *octaspire_hamt_private_leaf_get_key_storage(
+    octaspire_hamt_node_t const * const self)
+{
+    assert(self->kind == OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF);
+
+    return ((char*)self) +
+        octaspire_hamt_private_align(sizeof(octaspire_hamt_node_t));
+}
+
+static void *octaspire_hamt_private_leaf_get_value_storage(
+    octaspire_hamt_node_t const * const self)
+{
+    assert(self->kind == OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF);
+    return ((char*)self) + self->valueOffset;
+}
+
+uint32_t octaspire_hamt_node_get_hash(
+    octaspire_hamt_node_t const * const self)
+{
+    assert(self);
+    return self->hash;
+}
+
+void const *octaspire_hamt_node_get_key_const(
+    octaspire_hamt_node_t const * const self)
+{
+    assert(self);
+
+    void const * const key = octaspire_hamt_private_leaf_get_key_storage(self);
+
+    return self->keyIsPointer ? *(void const * const *)key : key;
+}
+
+void const *octaspire_hamt_node_get_value_const(
+    octaspire_hamt_node_t const * const self)
+{
+    assert(self);
+
+    void const * const value = octaspire_hamt_private_leaf_get_value_storage(self);
+
+    return self->valueIsPointer ? *(void const * const *)value : value;
+}
+
+static void octaspire_hamt_private_node_release(
+    octaspire_hamt_node_t * const self,
+    octaspire_hamt_private_config_t const * const config)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    assert(self->refCount);
+
+    --(self->refCount);
+
+    if (self->refCount)
+    {
+        return;
+    }
+
+    if (self->kind == OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF)
+    {
+        void * const key   = octaspire_hamt_private_leaf_get_key_storage(self);
+        void * const value = octaspire_hamt_private_leaf_get_value_storage(self);
+
+        if (config->valueReleaseCallback)
+        {
+            config->valueReleaseCallback(
+                config->valueIsPointer ? *(void**)value : value);
+        }
+
+        if (config->keyReleaseCallback)
+        {
+            config->keyReleaseCallback(
+                config->keyIsPointer ? *(void**)key : key);
+        }
+    }
+    else
+    {
+        octaspire_hamt_node_t ** const children =
+            octaspire_hamt_private_node_get_children(self);
+
+        for (size_t i = 0; i < self->numChildren; ++i)
+        {
+            octaspire_hamt_private_node_release(children[i], config);
+        }
+    }
+
+    octaspire_allocator_free(config->allocator, self);
+}
+
+static octaspire_hamt_node_t *octaspire_hamt_private_node_retain(
+    octaspire_hamt_node_t * const self)
+{
+    if (self)
+    {
+        ++(self->refCount);
+    }
+
+    return self;
+}
+
+static octaspire_hamt_node_t *octaspire_hamt_private_leaf_new(
+    octaspire_hamt_private_config_t const * const config,
+    uint32_t const hash,
+    void const * const key,
+    void const * const value)
+{
+    size_t const valueOffset =
+        octaspire_hamt_private_align(sizeof(octaspire_hamt_node_t)) +
+        octaspire_hamt_private_align(config->keySizeInOctets);
+
+    size_t const size = valueOffset + config->valueSizeInOctets;
+
+    octaspire_hamt_node_t * const self =
+        octaspire_allocator_malloc(config->allocator, size);
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->refCount       = 1;
+    self->numChildren    = 0;
+    self->valueOffset    = valueOffset;
+    self->hash           = hash;
+    self->bitmap         = 0;
+    self->kind           = OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF;
+    self->keyIsPointer   = config->keyIsPointer;
+    self->valueIsPointer = config->valueIsPointer;
+
+    memcpy(
+        octaspire_hamt_private_leaf_get_key_storage(self),
+        key,
+        config->keySizeInOctets);
+
+    memcpy(
+        octaspire_hamt_private_leaf_get_value_storage(self),
+        value,
+        config->valueSizeInOctets);
+
+    return self;
+}
+
+// Children are not retained here; callers fill them in.
+static octaspire_hamt_node_t *octaspire_hamt_private_node_new(
+    octaspire_hamt_private_config_t const * const config,
+    octaspire_hamt_private_node_kind_t const kind,
+    uint32_t const hash,
+    uint32_t const bitmap,
+    size_t const numChildren)
+{
+    assert(kind != OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF);
+
+    octaspire_hamt_node_t * const self = octaspire_allocator_malloc(
+        config->allocator,
+        sizeof(octaspire_hamt_node_t) +
+            (numChildren * sizeof(octaspire_hamt_node_t*)));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->refCount       = 1;
+    self->numChildren    = numChildren;
+    self->valueOffset    = 0;
+    self->hash           = hash;
+    self->bitmap         = bitmap;
+    self->kind           = kind;
+    self->keyIsPointer   = false;
+    self->valueIsPointer = false;
+
+    return self;
+}
+
+// Returns a copy of branch or collision node 'self' where child at
+// 'replaceIndex' is replaced with 'replacement' (if 'replacement' is not
+// NULL), or removed (if 'replacement' is NULL and 'removeBit' is set for
+// branches, or for collisions). All other children are retained.
+static octaspire_hamt_node_t *octaspire_hamt_private_node_new_copy_with(
+    octaspire_hamt_private_config_t const * const config,
+    octaspire_hamt_node_t const * const self,
+    size_t const replaceIndex,
+    octaspire_hamt_node_t * const replacement,
+    uint32_t const removeBit)
+{
+    size_t const numChildren =
+        replacement ? self->numChildren : (self->numChildren - 1);
+
+    octaspire_hamt_node_t * const result = octaspire_hamt_private_node_new(
+        config,
+        self->kind,
+        self->hash,
+        replacement ? self->bitmap : (self->bitmap & ~removeBit),
+        numChildren);
+
+    if (!result)
+    {
+        return result;
+    }
+
+    octaspire_hamt_node_t * const * const from =
+        octaspire_hamt_private_node_get_children_const(self);
+
+    octaspire_hamt_node_t ** const to =
+        octaspire_hamt_private_node_get_children(result);
+
+    size_t j = 0;
+
+    for (size_t i = 0; i < self->numChildren; ++i)
+    {
+        if (i == replaceIndex)
+        {
+            if (replacement)
+            {
+                to[j++] = replacement;
+            }
+        }
+        else
+        {
+            to[j++] = octaspire_hamt_private_node_retain(from[i]);
+        }
+    }
+
+    assert(j == numChildren);
+
+    return result;
+}
+
+// Returns a copy of branch 'self' with 'child' inserted at 'index'.
+// Other children are retained, 'child' is not.
+static octaspire_hamt_node_t *octaspire_hamt_private_node_new_copy_with_inserted(
+    octaspire_hamt_private_config_t const * const config,
+    octaspire_hamt_node_t const * const self,
+    size_t const index,
+    octaspire_hamt_node_t * const child,
+    uint32_t const bit)
+{
+    octaspire_hamt_node_t * const result = octaspire_hamt_private_node_new(
+        config,
+        self->kind,
+        self->hash,
+        self->bitmap | bit,
+        self->numChildren + 1);
+
+    if (!result)
+    {
+        return result;
+    }
+
+    octaspire_hamt_node_t * const * const from =
+        octaspire_hamt_private_node_get_children_const(self);
+
+    octaspire_hamt_node_t ** const to =
+        octaspire_hamt_private_node_get_children(result);
+
+    for (size_t i = 0; i < index; ++i)
+    {
+        to[i] = octaspire_hamt_private_node_retain(from[i]);
+    }
+
+    to[index] = child;
+
+    for (size_t i = index; i < self->numChildren; ++i)
+    {
+        to[i + 1] = octaspire_hamt_private_node_retain(from[i]);
+    }
+
+    return result;
+}
+
+static bool octaspire_hamt_private_leaf_has_key(
+    octaspire_hamt_node_t const * const leaf,
+    octaspire_hamt_private_config_t const * const config,
+    uint32_t const hash,
+    void const * const key)
+{
+    if (leaf->hash != hash)
+    {
+        return false;
+    }
+
+    void const * const key2 = octaspire_hamt_private_leaf_get_key_storage(leaf);
+
+    return config->keyCompareFunction(
+        config->keyIsPointer ? *(void const * const *)key  : key,
+        config->keyIsPointer ? *(void const * const *)key2 : key2);
+}
+
+static uint32_t octaspire_hamt_private_bit_at(
+    uint32_t const hash,
+    size_t const shift)
+{
+    return (uint32_t)1 << ((hash >> shift) & OCTASPIRE_HAMT_PRIVATE_LEVEL_MASK);
+}
+
+// Builds branches on top of 'existing' (retained) and 'leaf' (taken) that
+// have different hashes, starting at level 'shift'.
+static octaspire_hamt_node_t *octaspire_hamt_private_merge(
+    octaspire_hamt_private_config_t const * const config,
+    octaspire_hamt_node_t * const existing,
+    octaspire_hamt_node_t * const leaf,
+    size_t const shift)
+{
+    assert(existing->hash != leaf->hash);
+    assert(shift <= OCTASPIRE_HAMT_PRIVATE_MAX_SHIFT);
+
+    uint32_t const bit1 = octaspire_hamt_private_bit_at(existing->hash, shift);
+    uint32_t const bit2 = octaspire_hamt_private_bit_at(leaf->hash,     shift);
+
+    if (bit1 == bit2)
+    {
+        octaspire_hamt_node_t * const child = octaspire_hamt_private_merge(
+            config,
+            existing,
+            leaf,
+            shift + OCTASPIRE_HAMT_PRIVATE_BITS_PER_LEVEL);
+
+        if (!child)
+        {
+            return child;
+        }
+
+        octaspire_hamt_node_t * const self = octaspire_hamt_private_node_new(
+            config,
+            OCTASPIRE_HAMT_PRIVATE_NODE_KIND_BRANCH,
+            0,
+            bit1,
+            1);
+
+        if (!self)
+        {
+            // Release the branches built so far, but not 'leaf' that
+            // is still owned by the caller.
+            octaspire_hamt_private_node_retain(leaf);
+            octaspire_hamt_private_node_release(child, config);
+            return self;
+        }
+
+        octaspire_hamt_private_node_get_children(self)[0] = child;
+        return self;
+    }
+
+    octaspire_hamt_node_t * const self = octaspire_hamt_private_node_new(
+        config,
+        OCTASPIRE_HAMT_PRIVATE_NODE_KIND_BRANCH,
+        0,
+        bit1 | bit2,
+        2);
+
+    if (!self)
+    {
+        return self;
+    }
+
+    octaspire_hamt_node_t ** const children =
+        octaspire_hamt_private_node_get_children(self);
+
+    children[bit1 < bit2 ? 0 : 1] = octaspire_hamt_private_node_retain(existing);
+    children[bit1 < bit2 ? 1 : 0] = leaf;
+
+    return self;
+}
+
+// Returns a new node where 'leaf' (taken on success) is put into the
+// sub-trie 'self', or NULL on allocation failure.
+static octaspire_hamt_node_t *octaspire_hamt_private_put(
+    octaspire_hamt_private_config_t const * const config,
+    octaspire_hamt_node_t * const self,
+    octaspire_hamt_node_t * const leaf,
+    size_t const shift,
+    bool * const added)
+{
+    if (!self)
+    {
+        *added = true;
+        return leaf;
+    }
+
+    uint32_t const hash = leaf->hash;
+
+    void const * const key = octaspire_hamt_private_leaf_get_key_storage(leaf);
+
+    switch (self->kind)
+    {
+        case OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF:
+        {
+            if (octaspire_hamt_private_leaf_has_key(self, config, hash, key))
+            {
+                *added = false;
+                return leaf;
+            }
+
+            *added = true;
+
+            if (self->hash != hash)
+            {
+                return octaspire_hamt_private_merge(config, self, leaf, shift);
+            }
+
+            octaspire_hamt_node_t * const collision =
+                octaspire_hamt_private_node_new(
+                    config,
+                    OCTASPIRE_HAMT_PRIVATE_NODE_KIND_COLLISION,
+                    hash,
+                    0,
+                    2);
+
+            if (!collision)
+            {
+                return collision;
+            }
+
+            octaspire_hamt_node_t ** const children =
+                octaspire_hamt_private_node_get_children(collision);
+
+            children[0] = octaspire_hamt_private_node_retain(self);
+            children[1] = leaf;
+
+            return collision;
+        }
+
+        case OCTASPIRE_HAMT_PRIVATE_NODE_KIND_COLLISION:
+        {
+            if (self->hash != hash)
+            {
+                *added = true;
+                return octaspire_hamt_private_merge(config, self, leaf, shift);
+            }
+
+            octaspire_hamt_node_t * const * const children =
+                octaspire_hamt_private_node_get_children_const(self);
+
+            for (size_t i = 0; i < self->numChildren; ++i)
+            {
+                if (octaspire_hamt_private_leaf_has_key(
+                        children[i],
+                        config,
+                        hash,
+                        key))
+                {
+                    *added = false;
+
+                    return octaspire_hamt_private_node_new_copy_with(
+                        config,
+                        self,
+                        i,
+                        leaf,
+                        0);
+                }
+            }
+
+            *added = true;
+
+            return octaspire_hamt_private_node_new_copy_with_inserted(
+                config,
+                self,
+                self->numChildren,
+                leaf,
+                0);
+        }
+
+        case OCTASPIRE_HAMT_PRIVATE_NODE_KIND_BRANCH:
+        {
+            uint32_t const bit   = octaspire_hamt_private_bit_at(hash, shift);
+            size_t   const index =
+                octaspire_hamt_private_popcount(self->bitmap & (bit - 1));
+
+            if (!(self->bitmap & bit))
+            {
+                *added = true;
+
+                return octaspire_hamt_private_node_new_copy_with_inserted(
+                    config,
+                    self,
+                    index,
+                    leaf,
+                    bit);
+            }
+
+            octaspire_hamt_node_t * const child = octaspire_hamt_private_put(
+                config,
+                octaspire_hamt_private_node_get_children(self)[index],
+                leaf,
+                shift + OCTASPIRE_HAMT_PRIVATE_BITS_PER_LEVEL,
+                added);
+
+            if (!child)
+            {
+                return child;
+            }
+
+            octaspire_hamt_node_t * const result =
+                octaspire_hamt_private_node_new_copy_with(
+                    config,
+                    self,
+                    index,
+                    child,
+                    0);
+
+            if (!result && child != leaf)
+            {
+                // Keep 'leaf' alive for the caller while releasing
+                // the new nodes built below this level.
+                octaspire_hamt_private_node_retain(leaf);
+                octaspire_hamt_private_node_release(child, config);
+            }
+
+            return result;
+        }
+    }
+
+    abort();
+}
+
+// Sets '*result' to the sub-trie 'self' without the key, or NULL if it
+// becomes empty. Returns false on allocation failure.
+static bool octaspire_hamt_private_remove(
+    octaspire_hamt_private_config_t const * const config,
+    octaspire_hamt_node_t * const self,
+    uint32_t const hash,
+    void const * const key,
+    size_t const shift,
+    octaspire_hamt_node_t ** const result,
+    bool * const removed)
+{
+    *removed = false;
+    *result  = self;
+
+    if (!self)
+    {
+        return true;
+    }
+
+    switch (self->kind)
+    {
+        case OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF:
+        {
+            if (octaspire_hamt_private_leaf_has_key(self, config, hash, key))
+            {
+                *removed = true;
+                *result  = 0;
+                return true;
+            }
+
+            octaspire_hamt_private_node_retain(self);
+            return true;
+        }
+
+        case OCTASPIRE_HAMT_PRIVATE_NODE_KIND_COLLISION:
+        {
+            octaspire_hamt_node_t ** const children =
+                octaspire_hamt_private_node_get_children(self);
+
+            for (size_t i = 0; self->hash == hash && i < self->numChildren; ++i)
+            {
+                if (octaspire_hamt_private_leaf_has_key(
+                        children[i],
+                        config,
+                        hash,
+                        key))
+                {
+                    *removed = true;
+
+                    if (self->numChildren == 2)
+                    {
+                        *result = octaspire_hamt_private_node_retain(
+                            children[i == 0 ? 1 : 0]);
+
+                        return true;
+                    }
+
+                    *result = octaspire_hamt_private_node_new_copy_with(
+                        config,
+                        self,
+                        i,
+                        0,
+                        0);
+
+                    return *result != 0;
+                }
+            }
+
+            octaspire_hamt_private_node_retain(self);
+            return true;
+        }
+
+        case OCTASPIRE_HAMT_PRIVATE_NODE_KIND_BRANCH:
+        {
+            uint32_t const bit = octaspire_hamt_private_bit_at(hash, shift);
+
+            if (!(self->bitmap & bit))
+            {
+                octaspire_hamt_private_node_retain(self);
+                return true;
+            }
+
+            size_t const index =
+                octaspire_hamt_private_popcount(self->bitmap & (bit - 1));
+
+            octaspire_hamt_node_t ** const children =
+                octaspire_hamt_private_node_get_children(self);
+
+            octaspire_hamt_node_t *child = 0;
+
+            if (!octaspire_hamt_private_remove(
+                    config,
+                    children[index],
+                    hash,
+                    key,
+                    shift + OCTASPIRE_HAMT_PRIVATE_BITS_PER_LEVEL,
+                    &child,
+                    removed))
+            {
+                return false;
+            }
+
+            if (!*removed)
+            {
+                octaspire_hamt_private_node_release(child, config);
+                octaspire_hamt_private_node_retain(self);
+                return true;
+            }
+
+            if (!child)
+            {
+                if (self->numChildren == 1)
+                {
+                    *result = 0;
+                    return true;
+                }
+
+                if (self->numChildren == 2 &&
+                    children[index == 0 ? 1 : 0]->kind !=
+                        OCTASPIRE_HAMT_PRIVATE_NODE_KIND_BRANCH)
+                {
+                    // Lift the remaining leaf or collision up.
+                    *result = octaspire_hamt_private_node_retain(
+                        children[index == 0 ? 1 : 0]);
+
+                    return true;
+                }
+
+                *result = octaspire_hamt_private_node_new_copy_with(
+                    config,
+                    self,
+                    index,
+                    0,
+                    bit);
+
+                return *result != 0;
+            }
+
+            if (self->numChildren == 1 &&
+                child->kind != OCTASPIRE_HAMT_PRIVATE_NODE_KIND_BRANCH)
+            {
+                *result = child;
+                return true;
+            }
+
+            *result = octaspire_hamt_private_node_new_copy_with(
+                config,
+                self,
+                index,
+                child,
+                0);
+
+            if (!*result)
+            {
+                octaspire_hamt_private_node_release(child, config);
+                return false;
+            }
+
+            return true;
+        }
+    }
+
+    abort();
+}
+
+static octaspire_hamt_t *octaspire_hamt_private_new_version(
+    octaspire_hamt_private_config_t * const config,
+    octaspire_hamt_node_t * const root,
+    size_t const numElements)
+{
+    octaspire_hamt_t * const self =
+        octaspire_allocator_malloc(config->allocator, sizeof(octaspire_hamt_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    ++(config->refCount);
+
+    self->config      = config;
+    self->root        = root;
+    self->numElements = numElements;
+
+    return self;
+}
+
+octaspire_hamt_t *octaspire_hamt_new(
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_key_compare_function_t keyCompareFunction,
+    octaspire_map_key_hash_function_t keyHashFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    octaspire_hamt_private_config_t * const config = octaspire_allocator_malloc(
+        allocator,
+        sizeof(octaspire_hamt_private_config_t));
+
+    if (!config)
+    {
+        return 0;
+    }
+
+    config->allocator            = allocator;
+    config->keyCompareFunction   = keyCompareFunction;
+    config->keyHashFunction      = keyHashFunction;
+    config->keyReleaseCallback   = keyReleaseCallback;
+    config->valueReleaseCallback = valueReleaseCallback;
+    config->keySizeInOctets      = keySizeInOctets;
+    config->valueSizeInOctets    = valueSizeInOctets;
+    config->keyIsPointer         = keyIsPointer;
+    config->valueIsPointer       = valueIsPointer;
+    config->refCount             = 0;
+
+    octaspire_hamt_t * const self =
+        octaspire_hamt_private_new_version(config, 0, 0);
+
+    if (!self)
+    {
+        octaspire_allocator_free(allocator, config);
+        return 0;
+    }
+
+    return self;
+}
+
+octaspire_hamt_t *octaspire_hamt_new_with_octaspire_string_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    return octaspire_hamt_new(
+        sizeof(octaspire_string_t*),
+        true,
+        valueSizeInOctets,
+        valueIsPointer,
+        (octaspire_map_key_compare_function_t)octaspire_string_is_equal,
+        (octaspire_map_key_hash_function_t)octaspire_string_get_hash,
+        (octaspire_map_element_callback_t)octaspire_string_release,
+        valueReleaseCallback,
+        allocator);
+}
+
+static bool octaspire_hamt_private_size_t_is_equal(
+    size_t const * const first,
+    size_t const * const second)
+{
+    return *first == *second;
+}
+
+octaspire_hamt_t *octaspire_hamt_new_with_size_t_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    return octaspire_hamt_new(
+        sizeof(size_t),
+        false,
+        valueSizeInOctets,
+        valueIsPointer,
+        (octaspire_map_key_compare_function_t)
+            octaspire_hamt_private_size_t_is_equal,
+        octaspire_map_helper_size_t_get_hash_of_key,
+        (octaspire_map_element_callback_t)0,
+        valueReleaseCallback,
+        allocator);
+}
+
+octaspire_hamt_t *octaspire_hamt_new_snapshot(
+    octaspire_hamt_t const * const self)
+{
+    assert(self);
+
+    octaspire_hamt_t * const result = octaspire_hamt_private_new_version(
+        self->config,
+        self->root,
+        self->numElements);
+
+    if (!result)
+    {
+        return result;
+    }
+
+    octaspire_hamt_private_node_retain(self->root);
+
+    return result;
+}
+
+void octaspire_hamt_release(octaspire_hamt_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    octaspire_hamt_private_config_t * const config = self->config;
+    octaspire_allocator_t           * const allocator = config->allocator;
+
+    octaspire_hamt_private_node_release(self->root, config);
+    self->root = 0;
+
+    octaspire_allocator_free(allocator, self);
+
+    assert(config->refCount);
+    --(config->refCount);
+
+    if (!config->refCount)
+    {
+        octaspire_allocator_free(allocator, config);
+    }
+}
+
+octaspire_hamt_t *octaspire_hamt_put(
+    octaspire_hamt_t const * const self,
+    uint32_t const hash,
+    void const * const key,
+    void const * const value)
+{
+    assert(self);
+
+    octaspire_hamt_node_t * const leaf =
+        octaspire_hamt_private_leaf_new(self->config, hash, key, value);
+
+    if (!leaf)
+    {
+        return 0;
+    }
+
+    bool added = false;
+
+    octaspire_hamt_node_t * const root = octaspire_hamt_private_put(
+        self->config,
+        self->root,
+        leaf,
+        0,
+        &added);
+
+    if (!root)
+    {
+        // Free the leaf without calling the release callbacks,
+        // because ownership was not taken.
+        octaspire_allocator_free(self->config->allocator, leaf);
+        return 0;
+    }
+
+    octaspire_hamt_t * const result = octaspire_hamt_private_new_version(
+        self->config,
+        root,
+        self->numElements + (added ? 1 : 0));
+
+    if (!result)
+    {
+        octaspire_hamt_private_node_retain(leaf);
+        octaspire_hamt_private_node_release(root, self->config);
+        octaspire_allocator_free(self->config->allocator, leaf);
+        return 0;
+    }
+
+    return result;
+}
+
+octaspire_hamt_t *octaspire_hamt_remove(
+    octaspire_hamt_t const * const self,
+    uint32_t const hash,
+    void const * const key)
+{
+    assert(self);
+
+    octaspire_hamt_node_t *root = 0;
+    bool removed = false;
+
+    if (!octaspire_hamt_private_remove(
+            self->config,
+            self->root,
+            hash,
+            key,
+            0,
+            &root,
+            &removed))
+    {
+        return 0;
+    }
+
+    octaspire_hamt_t * const result = octaspire_hamt_private_new_version(
+        self->config,
+        root,
+        self->numElements - (removed ? 1 : 0));
+
+    if (!result)
+    {
+        octaspire_hamt_private_node_release(root, self->config);
+        return 0;
+    }
+
+    return result;
+}
+
+octaspire_hamt_node_t const *octaspire_hamt_get_const(
+    octaspire_hamt_t const * const self,
+    uint32_t const hash,
+    void const * const key)
+{
+    assert(self);
+
+    octaspire_hamt_node_t const *node  = self->root;
+    size_t                       shift = 0;
+
+    while (node)
+    {
+        switch (node->kind)
+        {
+            case OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF:
+            {
+                return octaspire_hamt_private_leaf_has_key(
+                    node,
+                    self->config,
+                    hash,
+                    key) ? node : 0;
+            }
+
+            case OCTASPIRE_HAMT_PRIVATE_NODE_KIND_COLLISION:
+            {
+                if (node->hash != hash)
+                {
+                    return 0;
+                }
+
+                octaspire_hamt_node_t * const * const children =
+                    octaspire_hamt_private_node_get_children_const(node);
+
+                for (size_t i = 0; i < node->numChildren; ++i)
+                {
+                    if (octaspire_hamt_private_leaf_has_key(
+                            children[i],
+                            self->config,
+                            hash,
+                            key))
+                    {
+                        return children[i];
+                    }
+                }
+
+                return 0;
+            }
+
+            case OCTASPIRE_HAMT_PRIVATE_NODE_KIND_BRANCH:
+            {
+                uint32_t const bit = octaspire_hamt_private_bit_at(hash, shift);
+
+                if (!(node->bitmap & bit))
+                {
+                    return 0;
+                }
+
+                node = octaspire_hamt_private_node_get_children_const(node)[
+                    octaspire_hamt_private_popcount(node->bitmap & (bit - 1))];
+
+                shift += OCTASPIRE_HAMT_PRIVATE_BITS_PER_LEVEL;
+            }
+            break;
+        }
+    }
+
+    return 0;
+}
+
+bool octaspire_hamt_is_empty(
+    octaspire_hamt_t const * const self)
+{
+    return octaspire_hamt_get_number_of_elements(self) == 0;
+}
+
+size_t octaspire_hamt_get_number_of_elements(
+    octaspire_hamt_t const * const self)
+{
+    assert(self);
+    return self->numElements;
+}
+
+static void octaspire_hamt_private_iterator_advance(
+    octaspire_hamt_element_const_iterator_t * const self)
+{
+    self->element = 0;
+
+    while (self->depth > 0)
+    {
+        octaspire_hamt_node_t const * const node = self->nodes[self->depth - 1];
+
+        if (node->kind == OCTASPIRE_HAMT_PRIVATE_NODE_KIND_LEAF)
+        {
+            --(self->depth);
+            self->element = node;
+            return;
+        }
+
+        size_t const index = self->indices[self->depth - 1];
+
+        if (index >= node->numChildren)
+        {
+            --(self->depth);
+            continue;
+        }
+
+        ++(self->indices[self->depth - 1]);
+
+        assert(self->depth < OCTASPIRE_HAMT_ITERATOR_MAX_DEPTH);
+
+        self->nodes[self->depth] =
+            octaspire_hamt_private_node_get_children_const(node)[index];
+
+        self->indices[self->depth] = 0;
+        ++(self->depth);
+    }
+}
+
+octaspire_hamt_element_const_iterator_t
+octaspire_hamt_element_const_iterator_init(
+    octaspire_hamt_t const * const self)
+{
+    octaspire_hamt_element_const_iterator_t iterator;
+
+    memset(&iterator, 0, sizeof(iterator));
+
+    iterator.hamt = self;
+
+    if (self->root)
+    {
+        iterator.nodes[0]   = self->root;
+        iterator.indices[0] = 0;
+        iterator.depth      = 1;
+    }
+
+    octaspire_hamt_private_iterator_advance(&iterator);
+
+    return iterator;
+}
+
+bool octaspire_hamt_element_const_iterator_next(
+    octaspire_hamt_element_const_iterator_t * const self)
+{
+    octaspire_hamt_private_iterator_advance(self);
+    return self->element != 0;
+}
+
@@ -127,6 +127,126 @@ uint32_t octaspire_helpers_calculate_hash_for_memory_buffer_argument(
     return jenkins_one_at_a_time_hash(value, lengthInOctets);
 }
 
+static uint64_t octaspire_helpers_private_read_uint64(uint8_t const * const octets)
+{
+    uint64_t result = 0;
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+        result |= (uint64_t)octets[i] << (8 * i);
+    }
+
+    return result;
+}
+
+static uint64_t octaspire_helpers_private_rotate_left_uint64(
+    uint64_t const value,
+    unsigned int const count)
+{
+    return (value << count) | (value >> (64 - count));
+}
+
+static void octaspire_helpers_private_sipround(uint64_t v[4])
+{
+    v[0] += v[1];
+    v[1]  = octaspire_helpers_private_rotate_left_uint64(v[1], 13);
+    v[1] ^= v[0];
+    v[0]  = octaspire_helpers_private_rotate_left_uint64(v[0], 32);
+    v[2] += v[3];
+    v[3]  = octaspire_helpers_private_rotate_left_uint64(v[3], 16);
+    v[3] ^= v[2];
+    v[0] += v[3];
+    v[3]  = octaspire_helpers_private_rotate_left_uint64(v[3], 21);
+    v[3] ^= v[0];
+    v[2] += v[1];
+    v[1]  = octaspire_helpers_private_rotate_left_uint64(v[1], 17);
+    v[1] ^= v[2];
+    v[2]  = octaspire_helpers_private_rotate_left_uint64(v[2], 32);
+}
+
+// SipHash with 'numCompressionRounds' rounds per message block and
+// 'numFinalizationRounds' rounds at the end.
+static uint64_t octaspire_helpers_private_siphash(
+    void const * const value,
+    size_t const lengthInOctets,
+    uint8_t const * const key,
+    size_t const numCompressionRounds,
+    size_t const numFinalizationRounds)
+{
+    uint8_t const * const octets = value;
+
+    uint64_t const k0 = octaspire_helpers_private_read_uint64(key);
+    uint64_t const k1 = octaspire_helpers_private_read_uint64(key + 8);
+
+    uint64_t v[4] =
+    {
+        k0 ^ 0x736f6d6570736575ULL,
+        k1 ^ 0x646f72616e646f6dULL,
+        k0 ^ 0x6c7967656e657261ULL,
+        k1 ^ 0x7465646279746573ULL
+    };
+
+    size_t const numFullBlocks = lengthInOctets / 8;
+
+    for (size_t i = 0; i < numFullBlocks; ++i)
+    {
+        uint64_t const m = octaspire_helpers_private_read_uint64(octets + 8 * i);
+
+        v[3] ^= m;
+
+        for (size_t r = 0; r < numCompressionRounds; ++r)
+        {
+            octaspire_helpers_private_sipround(v);
+        }
+
+        v[0] ^= m;
+    }
+
+    // The last block holds the remaining octets and the length.
+    uint64_t last = (uint64_t)lengthInOctets << 56;
+
+    for (size_t i = 0; i < lengthInOctets % 8; ++i)
+    {
+        last |= (uint64_t)octets[8 * numFullBlocks + i] << (8 * i);
+    }
+
+    v[3] ^= last;
+
+    for (size_t r = 0; r < numCompressionRounds; ++r)
+    {
+        octaspire_helpers_private_sipround(v);
+    }
+
+    v[0] ^= last;
+    v[2] ^= 0xff;
+
+    for (size_t r = 0; r < numFinalizationRounds; ++r)
+    {
+        octaspire_helpers_private_sipround(v);
+    }
+
+    return v[0] ^ v[1] ^ v[2] ^ v[3];
+}
+
+uint64_t octaspire_helpers_calculate_siphash13(
+    void const * const value,
+    size_t const lengthInOctets,
+    uint8_t const * const key)
+{
+    return octaspire_helpers_private_siphash(value, lengthInOctets, key, 1, 3);
+}
+
+uint32_t octaspire_helpers_calculate_keyed_hash_for_memory_buffer_argument(
+    void const * const value,
+    size_t const lengthInOctets,
+    uint8_t const * const key)
+{
+    uint64_t const hash =
+        octaspire_helpers_calculate_siphash13(value, lengthInOctets, key);
+
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
 size_t octaspire_helpers_character_digit_to_number(uint32_t const c)
 {
     return c - '0';
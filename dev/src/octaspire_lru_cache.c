@@ -0,0 +1,569 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_lru_cache.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_helpers.h"
+
+// Entries form a doubly linked recency list, most recently used at the
+// front. The value of an entry is stored right after the entry. The map
+// maps keys to entries and owns the keys.
+typedef struct octaspire_lru_cache_private_entry_t
+{
+    struct octaspire_lru_cache_private_entry_t *previous;
+    struct octaspire_lru_cache_private_entry_t *next;
+    octaspire_map_element_t                    *element;
+    size_t                                      charge;
+    bool                                        isReferenced;
+    char                                        padding[7];
+}
+octaspire_lru_cache_private_entry_t;
+
+struct octaspire_lru_cache_t
+{
+    octaspire_allocator_t                *allocator;
+    octaspire_map_t                      *map;
+    octaspire_lru_cache_private_entry_t  *front;
+    octaspire_lru_cache_private_entry_t  *back;
+    octaspire_map_element_callback_t      keyReleaseCallback;
+    octaspire_map_element_callback_t      valueReleaseCallback;
+    octaspire_lru_cache_statistics_t      statistics;
+    size_t                                keySizeInOctets;
+    size_t                                valueSizeInOctets;
+    size_t                                capacity;
+    size_t                                totalCharge;
+    octaspire_lru_cache_policy_t          policy;
+    bool                                  keyIsPointer;
+    bool                                  valueIsPointer;
+    char                                  padding[2];
+};
+
+static void *octaspire_lru_cache_private_entry_get_value(
+    octaspire_lru_cache_t const * const self,
+    octaspire_lru_cache_private_entry_t * const entry)
+{
+    void * const storage = entry + 1;
+    return self->valueIsPointer ? *(void**)storage : storage;
+}
+
+static void octaspire_lru_cache_private_unlink(
+    octaspire_lru_cache_t * const self,
+    octaspire_lru_cache_private_entry_t * const entry)
+{
+    if (entry->previous)
+    {
+        entry->previous->next = entry->next;
+    }
+    else
+    {
+        self->front = entry->next;
+    }
+
+    if (entry->next)
+    {
+        entry->next->previous = entry->previous;
+    }
+    else
+    {
+        self->back = entry->previous;
+    }
+
+    entry->previous = 0;
+    entry->next     = 0;
+}
+
+static void octaspire_lru_cache_private_push_front(
+    octaspire_lru_cache_t * const self,
+    octaspire_lru_cache_private_entry_t * const entry)
+{
+    entry->previous = 0;
+    entry->next     = self->front;
+
+    if (self->front)
+    {
+        self->front->previous = entry;
+    }
+    else
+    {
+        self->back = entry;
+    }
+
+    self->front = entry;
+}
+
+static octaspire_lru_cache_private_entry_t *octaspire_lru_cache_private_find(
+    octaspire_lru_cache_t const * const self,
+    uint32_t const hash,
+    void const * const key)
+{
+    octaspire_map_element_t const * const element =
+        octaspire_map_get_const(self->map, hash, key);
+
+    if (!element)
+    {
+        return 0;
+    }
+
+    return (octaspire_lru_cache_private_entry_t*)
+        octaspire_map_element_get_value_const(element);
+}
+
+// Releases the value, removes the key from the map and frees the entry,
+// that must be unlinked already.
+static void octaspire_lru_cache_private_release_entry(
+    octaspire_lru_cache_t * const self,
+    octaspire_lru_cache_private_entry_t * const entry)
+{
+    if (self->valueReleaseCallback)
+    {
+        self->valueReleaseCallback(
+            octaspire_lru_cache_private_entry_get_value(self, entry));
+    }
+
+    void * const key = octaspire_map_element_get_key(entry->element);
+
+    octaspire_helpers_verify_true(
+        octaspire_map_remove(
+            self->map,
+            octaspire_map_element_get_hash(entry->element),
+            self->keyIsPointer ? (void const*)&key : key));
+
+    self->totalCharge -= entry->charge;
+    octaspire_allocator_free(self->allocator, entry);
+}
+
+// The element the policy evicts next. CLOCK gives referenced elements a
+// second chance by moving them to the front with the bit cleared.
+static octaspire_lru_cache_private_entry_t *octaspire_lru_cache_private_get_victim(
+    octaspire_lru_cache_t * const self)
+{
+    if (self->policy == OCTASPIRE_LRU_CACHE_POLICY_CLOCK)
+    {
+        while (self->back && self->back->isReferenced)
+        {
+            octaspire_lru_cache_private_entry_t * const entry = self->back;
+            entry->isReferenced = false;
+            octaspire_lru_cache_private_unlink(self, entry);
+            octaspire_lru_cache_private_push_front(self, entry);
+        }
+    }
+
+    return self->back;
+}
+
+// Evicts elements until 'charge' more fits into the capacity.
+static void octaspire_lru_cache_private_make_room(
+    octaspire_lru_cache_t * const self,
+    size_t const charge)
+{
+    assert(charge <= self->capacity);
+
+    while (self->totalCharge > self->capacity - charge)
+    {
+        octaspire_helpers_verify_true(octaspire_lru_cache_evict(self));
+    }
+}
+
+octaspire_lru_cache_t *octaspire_lru_cache_new(
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_key_compare_function_t keyCompareFunction,
+    octaspire_map_key_hash_function_t keyHashFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    size_t const capacity,
+    octaspire_lru_cache_policy_t const policy,
+    octaspire_allocator_t *allocator)
+{
+    octaspire_lru_cache_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_lru_cache_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->allocator            = allocator;
+    self->front                = 0;
+    self->back                 = 0;
+    self->keyReleaseCallback   = keyReleaseCallback;
+    self->valueReleaseCallback = valueReleaseCallback;
+    self->keySizeInOctets      = keySizeInOctets;
+    self->valueSizeInOctets    = valueSizeInOctets;
+    self->capacity             = capacity;
+    self->totalCharge          = 0;
+    self->policy               = policy;
+    self->keyIsPointer         = keyIsPointer;
+    self->valueIsPointer       = valueIsPointer;
+
+    octaspire_lru_cache_reset_statistics(self);
+
+    self->map = octaspire_map_new(
+        keySizeInOctets,
+        keyIsPointer,
+        sizeof(octaspire_lru_cache_private_entry_t*),
+        true,
+        keyCompareFunction,
+        keyHashFunction,
+        keyReleaseCallback,
+        0,
+        self->allocator);
+
+    if (!self->map)
+    {
+        octaspire_lru_cache_release(self);
+        self = 0;
+        return 0;
+    }
+
+    return self;
+}
+
+octaspire_lru_cache_t *octaspire_lru_cache_new_with_octaspire_string_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    size_t const capacity,
+    octaspire_lru_cache_policy_t const policy,
+    octaspire_allocator_t *allocator)
+{
+    return octaspire_lru_cache_new(
+        sizeof(octaspire_string_t*),
+        true,
+        valueSizeInOctets,
+        valueIsPointer,
+        (octaspire_map_key_compare_function_t)octaspire_string_is_equal,
+        (octaspire_map_key_hash_function_t)octaspire_string_get_hash,
+        (octaspire_map_element_callback_t)octaspire_string_release,
+        valueReleaseCallback,
+        capacity,
+        policy,
+        allocator);
+}
+
+static bool octaspire_lru_cache_helper_private_size_t_is_equal(
+    size_t const * const first,
+    size_t const * const second)
+{
+    return *first == *second;
+}
+
+octaspire_lru_cache_t *octaspire_lru_cache_new_with_size_t_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    size_t const capacity,
+    octaspire_lru_cache_policy_t const policy,
+    octaspire_allocator_t *allocator)
+{
+    return octaspire_lru_cache_new(
+        sizeof(size_t),
+        false,
+        valueSizeInOctets,
+        valueIsPointer,
+        (octaspire_map_key_compare_function_t)
+            octaspire_lru_cache_helper_private_size_t_is_equal,
+        octaspire_map_helper_size_t_get_hash_of_key,
+        (octaspire_map_element_callback_t)0,
+        valueReleaseCallback,
+        capacity,
+        policy,
+        allocator);
+}
+
+void octaspire_lru_cache_release(octaspire_lru_cache_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    // The map releases the keys.
+    while (self->front)
+    {
+        octaspire_lru_cache_private_entry_t * const entry = self->front;
+        self->front = entry->next;
+
+        if (self->valueReleaseCallback)
+        {
+            self->valueReleaseCallback(
+                octaspire_lru_cache_private_entry_get_value(self, entry));
+        }
+
+        octaspire_allocator_free(self->allocator, entry);
+    }
+
+    octaspire_map_release(self->map);
+    self->map = 0;
+
+    octaspire_allocator_free(self->allocator, self);
+}
+
+bool octaspire_lru_cache_put(
+    octaspire_lru_cache_t * const self,
+    uint32_t const hash,
+    void const * const key,
+    void const * const value)
+{
+    return octaspire_lru_cache_put_with_charge(self, hash, key, value, 1);
+}
+
+bool octaspire_lru_cache_put_with_charge(
+    octaspire_lru_cache_t * const self,
+    uint32_t const hash,
+    void const * const key,
+    void const * const value,
+    size_t const charge)
+{
+    assert(self);
+
+    if (charge > self->capacity)
+    {
+        return false;
+    }
+
+    octaspire_lru_cache_private_entry_t *entry =
+        octaspire_lru_cache_private_find(self, hash, key);
+
+    if (entry)
+    {
+        void const * const storedKey =
+            octaspire_map_element_get_key_const(entry->element);
+
+        bool const isSameKey = self->keyIsPointer ?
+            (storedKey == *(void const * const *)key) :
+            (memcmp(storedKey, key, self->keySizeInOctets) == 0);
+
+        if (self->keyReleaseCallback && !isSameKey)
+        {
+            self->keyReleaseCallback(
+                self->keyIsPointer ? *(void * const *)key : (void*)key);
+        }
+
+        void * const storedValue = entry + 1;
+
+        if (self->valueReleaseCallback &&
+            memcmp(storedValue, value, self->valueSizeInOctets) != 0)
+        {
+            self->valueReleaseCallback(
+                octaspire_lru_cache_private_entry_get_value(self, entry));
+        }
+
+        memcpy(storedValue, value, self->valueSizeInOctets);
+
+        // Keep the entry out of the list while making room, so that it
+        // is not evicted itself.
+        octaspire_lru_cache_private_unlink(self, entry);
+        self->totalCharge -= entry->charge;
+        entry->charge       = 0;
+
+        octaspire_lru_cache_private_make_room(self, charge);
+
+        entry->charge       = charge;
+        entry->isReferenced = false;
+        self->totalCharge  += charge;
+        octaspire_lru_cache_private_push_front(self, entry);
+        return true;
+    }
+
+    entry = octaspire_allocator_malloc(
+        self->allocator,
+        sizeof(octaspire_lru_cache_private_entry_t) + self->valueSizeInOctets);
+
+    if (!entry)
+    {
+        return false;
+    }
+
+    if (!octaspire_map_put(self->map, hash, key, &entry))
+    {
+        octaspire_allocator_free(self->allocator, entry);
+        return false;
+    }
+
+    entry->element = octaspire_map_get(self->map, hash, key);
+    octaspire_helpers_verify_not_null(entry->element);
+
+    memcpy(entry + 1, value, self->valueSizeInOctets);
+    entry->charge       = charge;
+    entry->isReferenced = false;
+
+    octaspire_lru_cache_private_make_room(self, charge);
+
+    self->totalCharge += charge;
+    octaspire_lru_cache_private_push_front(self, entry);
+    ++(self->statistics.numInsertions);
+    return true;
+}
+
+void *octaspire_lru_cache_get(
+    octaspire_lru_cache_t * const self,
+    uint32_t const hash,
+    void const * const key)
+{
+    octaspire_lru_cache_private_entry_t * const entry =
+        octaspire_lru_cache_private_find(self, hash, key);
+
+    if (!entry)
+    {
+        ++(self->statistics.numMisses);
+        return 0;
+    }
+
+    ++(self->statistics.numHits);
+
+    if (self->policy == OCTASPIRE_LRU_CACHE_POLICY_CLOCK)
+    {
+        entry->isReferenced = true;
+    }
+    else if (self->front != entry)
+    {
+        octaspire_lru_cache_private_unlink(self, entry);
+        octaspire_lru_cache_private_push_front(self, entry);
+    }
+
+    return octaspire_lru_cache_private_entry_get_value(self, entry);
+}
+
+void const *octaspire_lru_cache_peek_const(
+    octaspire_lru_cache_t const * const self,
+    uint32_t const hash,
+    void const * const key)
+{
+    octaspire_lru_cache_private_entry_t * const entry =
+        octaspire_lru_cache_private_find(self, hash, key);
+
+    if (!entry)
+    {
+        return 0;
+    }
+
+    return octaspire_lru_cache_private_entry_get_value(self, entry);
+}
+
+bool octaspire_lru_cache_remove(
+    octaspire_lru_cache_t * const self,
+    uint32_t const hash,
+    void const * const key)
+{
+    octaspire_lru_cache_private_entry_t * const entry =
+        octaspire_lru_cache_private_find(self, hash, key);
+
+    if (!entry)
+    {
+        return false;
+    }
+
+    octaspire_lru_cache_private_unlink(self, entry);
+    octaspire_lru_cache_private_release_entry(self, entry);
+    return true;
+}
+
+bool octaspire_lru_cache_evict(
+    octaspire_lru_cache_t * const self)
+{
+    octaspire_lru_cache_private_entry_t * const entry =
+        octaspire_lru_cache_private_get_victim(self);
+
+    if (!entry)
+    {
+        return false;
+    }
+
+    octaspire_lru_cache_private_unlink(self, entry);
+    octaspire_lru_cache_private_release_entry(self, entry);
+    ++(self->statistics.numEvictions);
+    return true;
+}
+
+void octaspire_lru_cache_clear(
+    octaspire_lru_cache_t * const self)
+{
+    while (self->front)
+    {
+        octaspire_lru_cache_private_entry_t * const entry = self->front;
+        octaspire_lru_cache_private_unlink(self, entry);
+        octaspire_lru_cache_private_release_entry(self, entry);
+    }
+
+    assert(self->totalCharge == 0);
+}
+
+void octaspire_lru_cache_set_capacity(
+    octaspire_lru_cache_t * const self,
+    size_t const capacity)
+{
+    self->capacity = capacity;
+    octaspire_lru_cache_private_make_room(self, 0);
+}
+
+size_t octaspire_lru_cache_get_capacity(
+    octaspire_lru_cache_t const * const self)
+{
+    return self->capacity;
+}
+
+size_t octaspire_lru_cache_get_total_charge(
+    octaspire_lru_cache_t const * const self)
+{
+    return self->totalCharge;
+}
+
+bool octaspire_lru_cache_is_empty(
+    octaspire_lru_cache_t const * const self)
+{
+    return octaspire_map_is_empty(self->map);
+}
+
+size_t octaspire_lru_cache_get_number_of_elements(
+    octaspire_lru_cache_t const * const self)
+{
+    return octaspire_map_get_number_of_elements(self->map);
+}
+
+octaspire_lru_cache_statistics_t octaspire_lru_cache_get_statistics(
+    octaspire_lru_cache_t const * const self)
+{
+    return self->statistics;
+}
+
+void octaspire_lru_cache_reset_statistics(
+    octaspire_lru_cache_t * const self)
+{
+    self->statistics.numHits       = 0;
+    self->statistics.numMisses     = 0;
+    self->statistics.numInsertions = 0;
+    self->statistics.numEvictions  = 0;
+}
+
+double octaspire_lru_cache_get_hit_ratio(
+    octaspire_lru_cache_t const * const self)
+{
+    size_t const numGets = self->statistics.numHits + self->statistics.numMisses;
+
+    if (!numGets)
+    {
+        return 0;
+    }
+
+    return (double)self->statistics.numHits / (double)numGets;
+}
+
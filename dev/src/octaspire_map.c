@@ -20,9 +20,11 @@ limitations under the License.
 #include <inttypes.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 #include "octaspire/core/octaspire_string.h"
 #include "octaspire/core/octaspire_vector.h"
 #include "octaspire/core/octaspire_pair.h"
+#include "octaspire/core/octaspire_helpers.h"
 
 #include <stdio.h>
 
@@ -175,10 +177,12 @@ struct octaspire_map_t
     octaspire_vector_t                            *buckets;
     octaspire_map_key_compare_function_t      keyCompareFunction;
     octaspire_map_key_hash_function_t         keyHashFunction;
+    octaspire_map_key_keyed_hash_function_t   keyKeyedHashFunction;
     octaspire_map_element_callback_t     keyReleaseCallback;
     octaspire_map_element_callback_t     valueReleaseCallback;
     size_t                                                   numBucketsInUse;
     size_t                                                   numElements;
+    uint8_t                                                  seed[OCTASPIRE_MAP_SEED_LENGTH_IN_OCTETS];
     bool                                                     keyIsPointer;
     bool                                                     valueIsPointer;
     char                                                     padding[6];
@@ -203,6 +207,63 @@ static void octaspire_map_private_release_given_buckets(
     octaspire_map_t *self,
     octaspire_vector_t **bucketsPtr);
 
+static void octaspire_map_private_release_element(
+    octaspire_map_t *self,
+    octaspire_map_element_t *element);
+
+static octaspire_map_element_t *octaspire_map_private_find(
+    octaspire_map_t const * const self,
+    uint32_t const hash,
+    void const * const key);
+
+// Maps for untrusted keys replace the hash given by the caller with a
+// keyed hash of the key.
+static uint32_t octaspire_map_private_get_hash(
+    octaspire_map_t const * const self,
+    uint32_t const hash,
+    void const * const key)
+{
+    if (!self->keyKeyedHashFunction)
+    {
+        return hash;
+    }
+
+    return self->keyKeyedHashFunction(
+        self->keyIsPointer ? *(void const * const *)key : key,
+        self->seed);
+}
+
+// Not cryptographically strong, but unpredictable enough from the outside
+// to make keys that collide in one map unlikely to collide in another.
+// Uses no global state, so that maps can be created from many threads;
+// maps that exist at the same time differ at least by their address.
+static void octaspire_map_private_generate_seed(
+    octaspire_map_t * const self)
+{
+    uint64_t material[4] =
+    {
+        (uint64_t)time(0),
+        (uint64_t)clock(),
+        (uint64_t)(size_t)self,
+        (uint64_t)(size_t)&material
+    };
+
+    uint8_t const key[OCTASPIRE_MAP_SEED_LENGTH_IN_OCTETS] = {0};
+
+    for (size_t i = 0; i < OCTASPIRE_MAP_SEED_LENGTH_IN_OCTETS; i += 8)
+    {
+        uint64_t const hash =
+            octaspire_helpers_calculate_siphash13(material, sizeof(material), key);
+
+        for (size_t j = 0; j < 8; ++j)
+        {
+            self->seed[i + j] = (uint8_t)(hash >> (8 * j));
+        }
+
+        material[0] ^= hash;
+    }
+}
+
 
 static bool octaspire_map_private_rehash(
     octaspire_map_t * const self)
@@ -308,31 +369,7 @@ static void octaspire_map_private_release_given_buckets(
             octaspire_map_element_t *element = (octaspire_map_element_t*)
                 octaspire_vector_get_element_at(bucket, (ptrdiff_t)j);
 
-            if (self->valueReleaseCallback)
-            {
-                for (size_t k = 0; k < octaspire_vector_get_length(element->values); ++k)
-                {
-                    //self->valueReleaseCallback(*(void**)element->value);
-                    self->valueReleaseCallback(
-                        octaspire_vector_get_element_at(
-                            element->values,
-                            (ptrdiff_t)k));
-                }
-            }
-
-            if (self->keyReleaseCallback)
-            {
-                if (element->keyIsPointer)
-                {
-                    self->keyReleaseCallback(*(void**)element->key);
-                }
-                else
-                {
-                    self->keyReleaseCallback(element->key);
-                }
-            }
-
-            octaspire_map_element_release(element);
+            octaspire_map_private_release_element(self, element);
         }
 
         //octaspire_vector_clear(bucket);
@@ -345,6 +382,39 @@ static void octaspire_map_private_release_given_buckets(
     *bucketsPtr = 0;
 }
 
+// Calls the release callbacks for the key and values of 'element' and
+// releases it.
+static void octaspire_map_private_release_element(
+    octaspire_map_t *self,
+    octaspire_map_element_t *element)
+{
+    if (self->valueReleaseCallback)
+    {
+        for (size_t k = 0; k < octaspire_vector_get_length(element->values); ++k)
+        {
+            //self->valueReleaseCallback(*(void**)element->value);
+            self->valueReleaseCallback(
+                octaspire_vector_get_element_at(
+                    element->values,
+                    (ptrdiff_t)k));
+        }
+    }
+
+    if (self->keyReleaseCallback)
+    {
+        if (element->keyIsPointer)
+        {
+            self->keyReleaseCallback(*(void**)element->key);
+        }
+        else
+        {
+            self->keyReleaseCallback(element->key);
+        }
+    }
+
+    octaspire_map_element_release(element);
+}
+
 static octaspire_vector_t *octaspire_map_private_build_new_buckets(
     octaspire_map_t *self,
     size_t const numBuckets,
@@ -393,7 +463,7 @@ static octaspire_vector_t *octaspire_map_private_build_new_buckets(
     return buckets;
 }
 
-octaspire_map_t *octaspire_map_new(
+static octaspire_map_t *octaspire_map_private_new_with_buckets(
     size_t const keySizeInOctets,
     bool const keyIsPointer,
     size_t const valueSizeInOctets,
@@ -402,6 +472,7 @@ octaspire_map_t *octaspire_map_new(
     octaspire_map_key_hash_function_t keyHashFunction,
     octaspire_map_element_callback_t keyReleaseCallback,
     octaspire_map_element_callback_t valueReleaseCallback,
+    size_t const numBuckets,
     octaspire_allocator_t *allocator)
 {
     octaspire_map_t *self =
@@ -419,6 +490,7 @@ octaspire_map_t *octaspire_map_new(
     self->allocator            = allocator;
     self->keyCompareFunction   = keyCompareFunction;
     self->keyHashFunction      = keyHashFunction;
+    self->keyKeyedHashFunction = 0;
     self->keyReleaseCallback   = keyReleaseCallback;
     self->valueReleaseCallback = valueReleaseCallback;
     self->numBucketsInUse      = 0;
@@ -426,7 +498,7 @@ octaspire_map_t *octaspire_map_new(
 
     self->buckets = octaspire_map_private_build_new_buckets(
         self,
-        OCTASPIRE_MAP_SMALLEST_SIZE,
+        numBuckets,
         self->allocator);
 
     if (!self->buckets)
@@ -439,6 +511,303 @@ octaspire_map_t *octaspire_map_new(
     return self;
 }
 
+octaspire_map_t *octaspire_map_new(
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_key_compare_function_t keyCompareFunction,
+    octaspire_map_key_hash_function_t keyHashFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    return octaspire_map_private_new_with_buckets(
+        keySizeInOctets,
+        keyIsPointer,
+        valueSizeInOctets,
+        valueIsPointer,
+        keyCompareFunction,
+        keyHashFunction,
+        keyReleaseCallback,
+        valueReleaseCallback,
+        OCTASPIRE_MAP_SMALLEST_SIZE,
+        allocator);
+}
+
+// Adds the elements bucket by bucket. Returns false on allocation failure
+// or if there are duplicate keys. Release callbacks must not be set yet,
+// so that a failure does not release anything owned by the caller.
+static bool octaspire_map_private_load_arrays(
+    octaspire_map_t * const self,
+    char const * const keys,
+    char const * const values,
+    uint32_t const * const hashes,
+    size_t const numElements,
+    size_t * const bucketStarts,
+    size_t * const order)
+{
+    size_t const numBuckets = octaspire_vector_get_length(self->buckets);
+
+    // Counting sort of the element indices by bucket; 'bucketStarts' holds
+    // the size of bucket 'b' at 'b + 1' already.
+    for (size_t i = 0; i < numBuckets; ++i)
+    {
+        bucketStarts[i + 1] += bucketStarts[i];
+    }
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        order[bucketStarts[hashes[i] % numBuckets]++] = i;
+    }
+
+    // Every start was moved to the end of its bucket; the start of bucket
+    // 'b' is now the value at 'b - 1'.
+    size_t start = 0;
+
+    for (size_t b = 0; b < numBuckets; ++b)
+    {
+        size_t const end = bucketStarts[b];
+
+        octaspire_vector_t * const bucket =
+            octaspire_vector_get_element_at(self->buckets, (ptrdiff_t)b);
+
+        for (size_t i = start; i < end; ++i)
+        {
+            size_t const index   = order[i];
+            void const * const key = keys + index * self->keySizeInOctets;
+
+            void const * const userKey =
+                self->keyIsPointer ? *(void const * const *)key : key;
+
+            for (size_t j = start; j < i; ++j)
+            {
+                void const * const otherKey = keys + order[j] * self->keySizeInOctets;
+
+                if (hashes[order[j]] == hashes[index] &&
+                    self->keyCompareFunction(
+                        self->keyIsPointer ? *(void const * const *)otherKey : otherKey,
+                        userKey))
+                {
+                    return false;
+                }
+            }
+
+            octaspire_map_element_t *element = octaspire_map_element_new(
+                hashes[index],
+                self->keySizeInOctets,
+                self->keyIsPointer,
+                key,
+                self->valueSizeInOctets,
+                self->valueIsPointer,
+                values + index * self->valueSizeInOctets,
+                self->allocator);
+
+            if (!element)
+            {
+                return false;
+            }
+
+            if (!octaspire_vector_push_back_element(bucket, &element))
+            {
+                octaspire_map_element_release(element);
+                return false;
+            }
+
+            ++(self->numElements);
+        }
+
+        if (end > start)
+        {
+            ++(self->numBucketsInUse);
+        }
+
+        start = end;
+    }
+
+    return true;
+}
+
+octaspire_map_t *octaspire_map_new_from_arrays(
+    void const * const keys,
+    void const * const values,
+    uint32_t const * const hashes,
+    size_t const numElements,
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_key_compare_function_t keyCompareFunction,
+    octaspire_map_key_hash_function_t keyHashFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    assert(hashes || keyHashFunction);
+
+    uint32_t *calculatedHashes = 0;
+
+    if (!hashes && numElements)
+    {
+        calculatedHashes =
+            octaspire_allocator_malloc(allocator, numElements * sizeof(uint32_t));
+
+        if (calculatedHashes)
+        {
+            for (size_t i = 0; i < numElements; ++i)
+            {
+                void const * const key = (char const *)keys + i * keySizeInOctets;
+
+                calculatedHashes[i] = keyHashFunction(
+                    keyIsPointer ? *(void const * const *)key : key);
+            }
+        }
+    }
+
+    uint32_t const * const hashesToUse = hashes ? hashes : calculatedHashes;
+
+    size_t numBuckets = OCTASPIRE_MAP_SMALLEST_SIZE;
+
+    while (numBuckets < numElements)
+    {
+        numBuckets *= 2;
+    }
+
+    // Size the table once, to the number of buckets that puts would have
+    // grown it to: the smallest one that is used below the load factor.
+    size_t *bucketStarts = 0;
+
+    while (hashesToUse || !numElements)
+    {
+        bucketStarts =
+            octaspire_allocator_malloc(allocator, (numBuckets + 1) * sizeof(size_t));
+
+        if (!bucketStarts)
+        {
+            break;
+        }
+
+        // A custom malloc function does not zero the memory
+        if (bucketStarts != memset(bucketStarts, 0, (numBuckets + 1) * sizeof(size_t)))
+        {
+            abort();
+        }
+
+        size_t numBucketsInUse = 0;
+
+        for (size_t i = 0; i < numElements; ++i)
+        {
+            size_t * const count = &bucketStarts[hashesToUse[i] % numBuckets + 1];
+            numBucketsInUse += (*count)++ ? 0 : 1;
+        }
+
+        if ((float)numBucketsInUse / numBuckets < OCTASPIRE_MAP_MAX_LOAD_FACTOR)
+        {
+            break;
+        }
+
+        octaspire_allocator_free(allocator, bucketStarts);
+        bucketStarts = 0;
+        numBuckets *= 2;
+    }
+
+    octaspire_map_t *self = octaspire_map_private_new_with_buckets(
+        keySizeInOctets,
+        keyIsPointer,
+        valueSizeInOctets,
+        valueIsPointer,
+        keyCompareFunction,
+        keyHashFunction,
+        0,
+        0,
+        numBuckets,
+        allocator);
+
+    size_t *order = numElements ?
+        octaspire_allocator_malloc(allocator, numElements * sizeof(size_t)) : 0;
+
+    bool const isLoaded =
+        self &&
+        bucketStarts &&
+        (order || !numElements) &&
+        octaspire_map_private_load_arrays(
+            self,
+            keys,
+            values,
+            hashesToUse,
+            numElements,
+            bucketStarts,
+            order);
+
+    octaspire_allocator_free(allocator, order);
+    octaspire_allocator_free(allocator, bucketStarts);
+    octaspire_allocator_free(allocator, calculatedHashes);
+
+    if (!isLoaded)
+    {
+        octaspire_map_release(self);
+        return 0;
+    }
+
+    self->keyReleaseCallback   = keyReleaseCallback;
+    self->valueReleaseCallback = valueReleaseCallback;
+
+    return self;
+}
+
+octaspire_map_t *octaspire_map_new_for_untrusted_keys(
+    size_t const keySizeInOctets,
+    bool const keyIsPointer,
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_key_compare_function_t keyCompareFunction,
+    octaspire_map_key_keyed_hash_function_t keyKeyedHashFunction,
+    octaspire_map_element_callback_t keyReleaseCallback,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    assert(keyKeyedHashFunction);
+
+    octaspire_map_t * const self = octaspire_map_new(
+        keySizeInOctets,
+        keyIsPointer,
+        valueSizeInOctets,
+        valueIsPointer,
+        keyCompareFunction,
+        0,
+        keyReleaseCallback,
+        valueReleaseCallback,
+        allocator);
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->keyKeyedHashFunction = keyKeyedHashFunction;
+    octaspire_map_private_generate_seed(self);
+
+    return self;
+}
+
+octaspire_map_t *octaspire_map_new_with_untrusted_octaspire_string_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    return octaspire_map_new_for_untrusted_keys(
+        sizeof(octaspire_string_t*),
+        true,
+        valueSizeInOctets,
+        valueIsPointer,
+        (octaspire_map_key_compare_function_t)octaspire_string_is_equal,
+        (octaspire_map_key_keyed_hash_function_t)octaspire_string_get_keyed_hash,
+        (octaspire_map_element_callback_t)octaspire_string_release,
+        valueReleaseCallback,
+        allocator);
+}
+
 octaspire_map_t *octaspire_map_new_with_octaspire_string_keys(
     size_t const valueSizeInOctets,
     bool const valueIsPointer,
@@ -470,6 +839,42 @@ uint32_t octaspire_map_helper_size_t_get_hash(
     return jenkins_one_at_a_time_hash(&value, sizeof(value));
 }
 
+uint32_t octaspire_map_helper_size_t_get_hash_of_key(
+    void const * const key)
+{
+    return octaspire_map_helper_size_t_get_hash(*(size_t const *)key);
+}
+
+uint32_t octaspire_map_helper_size_t_get_keyed_hash(
+    size_t const * const value,
+    uint8_t const * const seed)
+{
+    return octaspire_helpers_calculate_keyed_hash_for_memory_buffer_argument(
+        value,
+        sizeof(size_t),
+        seed);
+}
+
+octaspire_map_t *octaspire_map_new_with_untrusted_size_t_keys(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    return octaspire_map_new_for_untrusted_keys(
+        sizeof(size_t),
+        false,
+        valueSizeInOctets,
+        valueIsPointer,
+        (octaspire_map_key_compare_function_t)
+            octaspire_map_helper_private_size_t_is_equal,
+        (octaspire_map_key_keyed_hash_function_t)
+            octaspire_map_helper_size_t_get_keyed_hash,
+        (octaspire_map_element_callback_t)0,
+        valueReleaseCallback,
+        allocator);
+}
+
 octaspire_map_t *octaspire_map_new_with_size_t_keys(
     size_t const valueSizeInOctets,
     bool const valueIsPointer,
@@ -483,7 +888,7 @@ octaspire_map_t *octaspire_map_new_with_size_t_keys(
         valueIsPointer,
         (octaspire_map_key_compare_function_t)
             octaspire_map_helper_private_size_t_is_equal,
-        (octaspire_map_key_hash_function_t)octaspire_map_helper_size_t_get_hash,
+        octaspire_map_helper_size_t_get_hash_of_key,
         (octaspire_map_element_callback_t)0,
         valueReleaseCallback,
         allocator);
@@ -507,11 +912,31 @@ void octaspire_map_release(octaspire_map_t *self)
     octaspire_allocator_free(self->allocator, self);
 }
 
+bool octaspire_map_is_for_untrusted_keys(
+    octaspire_map_t const * const self)
+{
+    return self->keyKeyedHashFunction != 0;
+}
+
+bool octaspire_map_set_seed(
+    octaspire_map_t * const self,
+    uint8_t const * const seed)
+{
+    if (!self->keyKeyedHashFunction || !octaspire_map_is_empty(self))
+    {
+        return false;
+    }
+
+    memcpy(self->seed, seed, OCTASPIRE_MAP_SEED_LENGTH_IN_OCTETS);
+    return true;
+}
+
 bool octaspire_map_remove(
     octaspire_map_t *self,
-    uint32_t const hash,
+    uint32_t const givenHash,
     void const * const key)
 {
+    uint32_t const hash = octaspire_map_private_get_hash(self, givenHash, key);
     size_t const bucketIndex = hash % octaspire_vector_get_length(self->buckets);
 
     octaspire_vector_t *bucket =
@@ -582,7 +1007,45 @@ bool octaspire_map_remove(
 bool octaspire_map_clear(
     octaspire_map_t * const self)
 {
-    // TODO XXX how to this in best way?
+    return octaspire_map_clear_with_shrink(self, false);
+}
+
+bool octaspire_map_clear_with_shrink(
+    octaspire_map_t * const self,
+    bool const shrink)
+{
+    assert(self && self->buckets);
+
+    if (self->numElements)
+    {
+        size_t const numBuckets = octaspire_vector_get_length(self->buckets);
+
+        for (size_t i = 0; i < numBuckets; ++i)
+        {
+            octaspire_vector_t * const bucket =
+                octaspire_vector_get_element_at(self->buckets, (ptrdiff_t)i);
+
+            // Removing from the back neither moves elements nor compacts,
+            // so the bucket keeps its capacity.
+            while (!octaspire_vector_is_empty(bucket))
+            {
+                octaspire_map_private_release_element(
+                    self,
+                    octaspire_vector_peek_back_element(bucket));
+
+                octaspire_vector_remove_element_at(bucket, -1);
+            }
+        }
+
+        self->numBucketsInUse = 0;
+        self->numElements     = 0;
+    }
+
+    if (!shrink ||
+        octaspire_vector_get_length(self->buckets) <= OCTASPIRE_MAP_SMALLEST_SIZE)
+    {
+        return true;
+    }
 
     octaspire_vector_t *buckets = octaspire_map_private_build_new_buckets(
         self,
@@ -591,20 +1054,15 @@ bool octaspire_map_clear(
 
     if (!buckets)
     {
+        // The map is empty and usable with its old buckets
         return false;
     }
 
-    if (self->buckets)
-    {
-        octaspire_map_private_release_given_buckets(self, &(self->buckets));
-        assert(!(self->buckets));
-    }
+    octaspire_map_private_release_given_buckets(self, &(self->buckets));
+    assert(!(self->buckets));
 
     self->buckets = buckets;
 
-    self->numBucketsInUse = 0;
-    self->numElements     = 0;
-
     return true;
 }
 
@@ -642,15 +1100,17 @@ bool octaspire_map_add_hash_map(
 
 bool octaspire_map_put(
     octaspire_map_t *self,
-    uint32_t const hash,
+    uint32_t const givenHash,
     void const * const key,
     void const * const value)
 {
     assert(self);
     assert(octaspire_vector_get_length(self->buckets));
 
+    uint32_t const hash = octaspire_map_private_get_hash(self, givenHash, key);
+
     octaspire_map_element_t *element =
-        octaspire_map_get(self, hash, key);
+        octaspire_map_private_find(self, hash, key);
 
     if (element)
     {
@@ -704,7 +1164,7 @@ bool octaspire_map_put(
     }
 }
 
-octaspire_map_element_t const * octaspire_map_get_const(
+static octaspire_map_element_t *octaspire_map_private_find(
     octaspire_map_t const * const self,
     uint32_t const hash,
     void const * const key)
@@ -757,55 +1217,24 @@ octaspire_map_element_t const * octaspire_map_get_const(
     return 0;
 }
 
+octaspire_map_element_t const * octaspire_map_get_const(
+    octaspire_map_t const * const self,
+    uint32_t const hash,
+    void const * const key)
+{
+    return octaspire_map_private_find(
+        self,
+        octaspire_map_private_get_hash(self, hash, key),
+        key);
+}
+
 octaspire_map_element_t *octaspire_map_get(
     octaspire_map_t *self, uint32_t const hash, void const * const key)
 {
-    size_t const bucketIndex = hash % octaspire_vector_get_length(self->buckets);
-
-    octaspire_vector_t *bucket =
-        (octaspire_vector_t*)octaspire_vector_get_element_at(
-            self->buckets,
-            (ptrdiff_t)bucketIndex);
-
-    assert(bucket);
-
-    size_t const numElementsInBucket = octaspire_vector_get_length(bucket);
-
-    if (numElementsInBucket == 1)
-    {
-        octaspire_map_element_t *element = (octaspire_map_element_t*)
-            octaspire_vector_peek_front_element(bucket);
-
-        assert(element);
-
-        void const * key2 = octaspire_map_element_get_key(element);
-
-        if (self->keyCompareFunction(element->keyIsPointer ? *(void const * const *)key : key, key2))
-        {
-            return element;
-        }
-
-        return 0;
-    }
-
-    for (size_t i = 0; i < numElementsInBucket; ++i)
-    {
-        octaspire_map_element_t *element =
-            (octaspire_map_element_t*)octaspire_vector_get_element_at(
-                bucket,
-                (ptrdiff_t)i);
-
-        assert(element);
-
-        void const * key2 = octaspire_map_element_get_key(element);
-
-        if (self->keyCompareFunction(element->keyIsPointer ? *(void const * const *)key : key, key2))
-        {
-            return element;
-        }
-    }
-
-    return 0;
+    return octaspire_map_private_find(
+        self,
+        octaspire_map_private_get_hash(self, hash, key),
+        key);
 }
 
 bool octaspire_map_is_empty(octaspire_map_t const * const self)
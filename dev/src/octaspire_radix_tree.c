@@ -0,0 +1,1447 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_radix_tree.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "octaspire/core/octaspire_helpers.h"
+
+typedef enum octaspire_radix_tree_private_node_kind_t
+{
+    OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF,
+    OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4,
+    OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_16,
+    OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48,
+    OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_256
+}
+octaspire_radix_tree_private_node_kind_t;
+
+// Inner nodes store their child octets and children right after the node:
+// node 4 and node 16 keep sorted octets and children side by side, node 48
+// maps each octet to a child slot (slot + 1, zero for none) and node 256
+// indexes children directly. Inner nodes own 'octets', the compressed path
+// below their parent, and 'leaf' holds the element whose key ends at the
+// node.
+//
+// Leaves store their value and whole key (with a '\0') right after the
+// node; 'octets' points into that storage.
+struct octaspire_radix_tree_node_t
+{
+    octaspire_radix_tree_node_t              *leaf;
+    char                                     *octets;
+    size_t                                    numOctets;
+    size_t                                    numChildren;
+    octaspire_radix_tree_private_node_kind_t  kind;
+    bool                                      valueIsPointer;
+    char                                      padding[3];
+};
+
+struct octaspire_radix_tree_t
+{
+    octaspire_allocator_t            *allocator;
+    octaspire_radix_tree_node_t      *root;
+    octaspire_map_element_callback_t  valueReleaseCallback;
+    size_t                            valueSizeInOctets;
+    size_t                            numElements;
+    bool                              valueIsPointer;
+    char                              padding[7];
+};
+
+typedef enum octaspire_radix_tree_private_put_result_t
+{
+    OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_FAILURE,
+    OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_INSERTED,
+    OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_REPLACED
+}
+octaspire_radix_tree_private_put_result_t;
+
+static size_t const OCTASPIRE_RADIX_TREE_PRIVATE_ALIGNMENT = 16;
+
+static size_t octaspire_radix_tree_private_align(size_t const size)
+{
+    return (size + OCTASPIRE_RADIX_TREE_PRIVATE_ALIGNMENT - 1) &
+        ~(OCTASPIRE_RADIX_TREE_PRIVATE_ALIGNMENT - 1);
+}
+
+static size_t octaspire_radix_tree_private_get_capacity(
+    octaspire_radix_tree_private_node_kind_t const kind)
+{
+    switch (kind)
+    {
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4:   return 4;
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_16:  return 16;
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48:  return 48;
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_256: return 256;
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF: break;
+    }
+
+    abort();
+}
+
+// Size of the octet array before the children, padded to pointer size.
+static size_t octaspire_radix_tree_private_get_octets_size(
+    octaspire_radix_tree_private_node_kind_t const kind)
+{
+    switch (kind)
+    {
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4:   return 8;
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_16:  return 16;
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48:  return 256;
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_256: return 0;
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF: break;
+    }
+
+    abort();
+}
+
+static uint8_t *octaspire_radix_tree_private_get_child_octets(
+    octaspire_radix_tree_node_t const * const node)
+{
+    assert(node->kind != OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF);
+    return (uint8_t*)(node + 1);
+}
+
+static octaspire_radix_tree_node_t **octaspire_radix_tree_private_get_children(
+    octaspire_radix_tree_node_t const * const node)
+{
+    assert(node->kind != OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF);
+
+    return (octaspire_radix_tree_node_t**)(
+        ((char*)(node + 1)) + octaspire_radix_tree_private_get_octets_size(node->kind));
+}
+
+static void *octaspire_radix_tree_private_leaf_get_value(
+    octaspire_radix_tree_node_t const * const node)
+{
+    assert(node->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF);
+
+    return ((char*)node) +
+        octaspire_radix_tree_private_align(sizeof(octaspire_radix_tree_node_t));
+}
+
+static bool octaspire_radix_tree_private_leaf_has_key(
+    octaspire_radix_tree_node_t const * const node,
+    char const * const octets,
+    size_t const numOctets)
+{
+    return node->numOctets == numOctets &&
+        memcmp(node->octets, octets, numOctets) == 0;
+}
+
+static octaspire_radix_tree_node_t *octaspire_radix_tree_private_leaf_new(
+    octaspire_radix_tree_t * const self,
+    char const * const octets,
+    size_t const numOctets,
+    void const * const value)
+{
+    size_t const keyOffset =
+        octaspire_radix_tree_private_align(sizeof(octaspire_radix_tree_node_t)) +
+        octaspire_radix_tree_private_align(self->valueSizeInOctets);
+
+    octaspire_radix_tree_node_t * const node = octaspire_allocator_malloc(
+        self->allocator,
+        keyOffset + numOctets + 1);
+
+    if (!node)
+    {
+        return 0;
+    }
+
+    node->leaf        = 0;
+    node->octets      = ((char*)node) + keyOffset;
+    node->numOctets   = numOctets;
+    node->numChildren = 0;
+    node->kind        = OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF;
+
+    node->valueIsPointer = self->valueIsPointer;
+
+    memcpy(
+        octaspire_radix_tree_private_leaf_get_value(node),
+        value,
+        self->valueSizeInOctets);
+
+    if (numOctets)
+    {
+        memcpy(node->octets, octets, numOctets);
+    }
+
+    node->octets[numOctets] = '\0';
+
+    return node;
+}
+
+static void octaspire_radix_tree_private_leaf_release(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t * const node,
+    bool const releaseValue)
+{
+    if (releaseValue && self->valueReleaseCallback)
+    {
+        void * const value = octaspire_radix_tree_private_leaf_get_value(node);
+        self->valueReleaseCallback(self->valueIsPointer ? *(void**)value : value);
+    }
+
+    octaspire_allocator_free(self->allocator, node);
+}
+
+static void octaspire_radix_tree_private_leaf_replace_value(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t * const node,
+    void const * const value)
+{
+    void * const storedValue = octaspire_radix_tree_private_leaf_get_value(node);
+
+    if (self->valueReleaseCallback &&
+        memcmp(storedValue, value, self->valueSizeInOctets) != 0)
+    {
+        self->valueReleaseCallback(
+            self->valueIsPointer ? *(void**)storedValue : storedValue);
+    }
+
+    memcpy(storedValue, value, self->valueSizeInOctets);
+}
+
+static octaspire_radix_tree_node_t *octaspire_radix_tree_private_inner_new(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_private_node_kind_t const kind)
+{
+    octaspire_radix_tree_node_t * const node = octaspire_allocator_malloc(
+        self->allocator,
+        sizeof(octaspire_radix_tree_node_t) +
+            octaspire_radix_tree_private_get_octets_size(kind) +
+            (octaspire_radix_tree_private_get_capacity(kind) *
+                sizeof(octaspire_radix_tree_node_t*)));
+
+    if (!node)
+    {
+        return 0;
+    }
+
+    node->leaf        = 0;
+    node->octets      = 0;
+    node->numOctets   = 0;
+    node->numChildren = 0;
+    node->kind        = kind;
+
+    octaspire_radix_tree_node_t ** const children =
+        octaspire_radix_tree_private_get_children(node);
+
+    for (size_t i = 0; i < octaspire_radix_tree_private_get_capacity(kind); ++i)
+    {
+        children[i] = 0;
+    }
+
+    if (kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48)
+    {
+        memset(octaspire_radix_tree_private_get_child_octets(node), 0, 256);
+    }
+
+    return node;
+}
+
+// Frees an inner node, but not its leaf or children.
+static void octaspire_radix_tree_private_inner_free(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t * const node)
+{
+    octaspire_allocator_free(self->allocator, node->octets);
+    node->octets = 0;
+    octaspire_allocator_free(self->allocator, node);
+}
+
+// Returns the child for 'octet', or NULL if there is none.
+static octaspire_radix_tree_node_t **octaspire_radix_tree_private_find_child(
+    octaspire_radix_tree_node_t const * const node,
+    uint8_t const octet)
+{
+    uint8_t * const octets = octaspire_radix_tree_private_get_child_octets(node);
+
+    octaspire_radix_tree_node_t ** const children =
+        octaspire_radix_tree_private_get_children(node);
+
+    switch (node->kind)
+    {
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4:
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_16:
+        {
+            for (size_t i = 0; i < node->numChildren; ++i)
+            {
+                if (octets[i] == octet)
+                {
+                    return &children[i];
+                }
+
+                if (octets[i] > octet)
+                {
+                    break;
+                }
+            }
+
+            return 0;
+        }
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48:
+        {
+            return octets[octet] ? &children[octets[octet] - 1] : 0;
+        }
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_256:
+        {
+            return children[octet] ? &children[octet] : 0;
+        }
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF: break;
+    }
+
+    abort();
+}
+
+// Returns the child with the smallest octet not less than 'firstOctet'
+// and stores its octet into 'octet', or returns NULL if there is none.
+static octaspire_radix_tree_node_t *octaspire_radix_tree_private_find_child_from(
+    octaspire_radix_tree_node_t const * const node,
+    size_t const firstOctet,
+    uint8_t * const octet)
+{
+    uint8_t * const octets = octaspire_radix_tree_private_get_child_octets(node);
+
+    octaspire_radix_tree_node_t ** const children =
+        octaspire_radix_tree_private_get_children(node);
+
+    switch (node->kind)
+    {
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4:
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_16:
+        {
+            for (size_t i = 0; i < node->numChildren; ++i)
+            {
+                if (octets[i] >= firstOctet)
+                {
+                    *octet = octets[i];
+                    return children[i];
+                }
+            }
+
+            return 0;
+        }
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48:
+        {
+            for (size_t i = firstOctet; i < 256; ++i)
+            {
+                if (octets[i])
+                {
+                    *octet = (uint8_t)i;
+                    return children[octets[i] - 1];
+                }
+            }
+
+            return 0;
+        }
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_256:
+        {
+            for (size_t i = firstOctet; i < 256; ++i)
+            {
+                if (children[i])
+                {
+                    *octet = (uint8_t)i;
+                    return children[i];
+                }
+            }
+
+            return 0;
+        }
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF: break;
+    }
+
+    abort();
+}
+
+// Adds a child to a node that has room for it.
+static void octaspire_radix_tree_private_insert_child(
+    octaspire_radix_tree_node_t * const node,
+    uint8_t const octet,
+    octaspire_radix_tree_node_t * const child)
+{
+    assert(node->numChildren < octaspire_radix_tree_private_get_capacity(node->kind));
+
+    uint8_t * const octets = octaspire_radix_tree_private_get_child_octets(node);
+
+    octaspire_radix_tree_node_t ** const children =
+        octaspire_radix_tree_private_get_children(node);
+
+    switch (node->kind)
+    {
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4:
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_16:
+        {
+            size_t index = 0;
+
+            while (index < node->numChildren && octets[index] < octet)
+            {
+                ++index;
+            }
+
+            memmove(octets + index + 1, octets + index, node->numChildren - index);
+
+            memmove(
+                children + index + 1,
+                children + index,
+                (node->numChildren - index) * sizeof(octaspire_radix_tree_node_t*));
+
+            octets[index]   = octet;
+            children[index] = child;
+        }
+        break;
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48:
+        {
+            size_t slot = 0;
+
+            while (children[slot])
+            {
+                ++slot;
+            }
+
+            octets[octet]  = (uint8_t)(slot + 1);
+            children[slot] = child;
+        }
+        break;
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_256:
+        {
+            children[octet] = child;
+        }
+        break;
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF:
+        {
+            abort();
+        }
+    }
+
+    ++(node->numChildren);
+}
+
+static void octaspire_radix_tree_private_remove_child(
+    octaspire_radix_tree_node_t * const node,
+    uint8_t const octet)
+{
+    uint8_t * const octets = octaspire_radix_tree_private_get_child_octets(node);
+
+    octaspire_radix_tree_node_t ** const children =
+        octaspire_radix_tree_private_get_children(node);
+
+    switch (node->kind)
+    {
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4:
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_16:
+        {
+            size_t index = 0;
+
+            while (octets[index] != octet)
+            {
+                ++index;
+                assert(index < node->numChildren);
+            }
+
+            memmove(octets + index, octets + index + 1, node->numChildren - index - 1);
+
+            memmove(
+                children + index,
+                children + index + 1,
+                (node->numChildren - index - 1) * sizeof(octaspire_radix_tree_node_t*));
+        }
+        break;
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48:
+        {
+            assert(octets[octet]);
+            children[octets[octet] - 1] = 0;
+            octets[octet] = 0;
+        }
+        break;
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_256:
+        {
+            children[octet] = 0;
+        }
+        break;
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF:
+        {
+            abort();
+        }
+    }
+
+    --(node->numChildren);
+}
+
+// Moves the contents of 'node' into a new node of another size class and
+// frees 'node'. Returns NULL (leaving 'node' intact) on allocation failure.
+static octaspire_radix_tree_node_t *octaspire_radix_tree_private_change_kind(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t * const node,
+    octaspire_radix_tree_private_node_kind_t const kind)
+{
+    assert(node->numChildren <= octaspire_radix_tree_private_get_capacity(kind));
+
+    octaspire_radix_tree_node_t * const result =
+        octaspire_radix_tree_private_inner_new(self, kind);
+
+    if (!result)
+    {
+        return 0;
+    }
+
+    result->leaf      = node->leaf;
+    result->octets    = node->octets;
+    result->numOctets = node->numOctets;
+
+    uint8_t octet = 0;
+    size_t  next  = 0;
+
+    octaspire_radix_tree_node_t *child = 0;
+
+    while ((child = octaspire_radix_tree_private_find_child_from(node, next, &octet)))
+    {
+        octaspire_radix_tree_private_insert_child(result, octet, child);
+        next = (size_t)octet + 1;
+    }
+
+    node->octets = 0;
+    octaspire_radix_tree_private_inner_free(self, node);
+
+    return result;
+}
+
+static bool octaspire_radix_tree_private_add_child(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t ** const nodeRef,
+    uint8_t const octet,
+    octaspire_radix_tree_node_t * const child)
+{
+    octaspire_radix_tree_node_t *node = *nodeRef;
+
+    if (node->numChildren == octaspire_radix_tree_private_get_capacity(node->kind))
+    {
+        assert(node->kind != OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_256);
+
+        node = octaspire_radix_tree_private_change_kind(
+            self,
+            node,
+            (octaspire_radix_tree_private_node_kind_t)(node->kind + 1));
+
+        if (!node)
+        {
+            return false;
+        }
+
+        *nodeRef = node;
+    }
+
+    octaspire_radix_tree_private_insert_child(node, octet, child);
+    return true;
+}
+
+// After a removal, replaces a node that has no children with its leaf,
+// merges a node that has only one child into that child and moves nodes
+// with few children to a smaller size class. Allocation failures only
+// leave the tree less compact.
+static void octaspire_radix_tree_private_compact(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t ** const nodeRef)
+{
+    octaspire_radix_tree_node_t * const node = *nodeRef;
+
+    if (!node->numChildren)
+    {
+        *nodeRef = node->leaf;
+        octaspire_radix_tree_private_inner_free(self, node);
+        return;
+    }
+
+    if (node->numChildren == 1 && !node->leaf)
+    {
+        uint8_t octet = 0;
+
+        octaspire_radix_tree_node_t * const child =
+            octaspire_radix_tree_private_find_child_from(node, 0, &octet);
+
+        if (child->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF)
+        {
+            *nodeRef = child;
+            octaspire_radix_tree_private_inner_free(self, node);
+            return;
+        }
+
+        size_t const numOctets = node->numOctets + 1 + child->numOctets;
+        char * const octets = octaspire_allocator_malloc(self->allocator, numOctets);
+
+        if (!octets)
+        {
+            return;
+        }
+
+        if (node->numOctets)
+        {
+            memcpy(octets, node->octets, node->numOctets);
+        }
+
+        octets[node->numOctets] = (char)octet;
+
+        if (child->numOctets)
+        {
+            memcpy(octets + node->numOctets + 1, child->octets, child->numOctets);
+        }
+
+        octaspire_allocator_free(self->allocator, child->octets);
+        child->octets    = octets;
+        child->numOctets = numOctets;
+
+        *nodeRef = child;
+        octaspire_radix_tree_private_inner_free(self, node);
+        return;
+    }
+
+    octaspire_radix_tree_private_node_kind_t smallerKind = node->kind;
+
+    if (node->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_16 && node->numChildren <= 3)
+    {
+        smallerKind = OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4;
+    }
+    else if (node->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48 &&
+             node->numChildren <= 12)
+    {
+        smallerKind = OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_16;
+    }
+    else if (node->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_256 &&
+             node->numChildren <= 40)
+    {
+        smallerKind = OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48;
+    }
+
+    if (smallerKind != node->kind)
+    {
+        octaspire_radix_tree_node_t * const result =
+            octaspire_radix_tree_private_change_kind(self, node, smallerKind);
+
+        if (result)
+        {
+            *nodeRef = result;
+        }
+    }
+}
+
+static void octaspire_radix_tree_private_node_release(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t * const node)
+{
+    if (node->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF)
+    {
+        octaspire_radix_tree_private_leaf_release(self, node, true);
+        return;
+    }
+
+    if (node->leaf)
+    {
+        octaspire_radix_tree_private_leaf_release(self, node->leaf, true);
+        node->leaf = 0;
+    }
+
+    uint8_t octet = 0;
+    size_t  next  = 0;
+
+    octaspire_radix_tree_node_t *child = 0;
+
+    while ((child = octaspire_radix_tree_private_find_child_from(node, next, &octet)))
+    {
+        octaspire_radix_tree_private_node_release(self, child);
+        next = (size_t)octet + 1;
+    }
+
+    octaspire_radix_tree_private_inner_free(self, node);
+}
+
+// Replaces the leaf in 'nodeRef' with an inner node holding both it and
+// a new leaf for 'octets'.
+static octaspire_radix_tree_private_put_result_t
+octaspire_radix_tree_private_split_leaf(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t ** const nodeRef,
+    char const * const octets,
+    size_t const numOctets,
+    size_t const depth,
+    void const * const value)
+{
+    octaspire_radix_tree_node_t * const oldLeaf = *nodeRef;
+
+    size_t const maxCommon =
+        (oldLeaf->numOctets < numOctets) ? oldLeaf->numOctets : numOctets;
+
+    size_t common = depth;
+
+    while (common < maxCommon && oldLeaf->octets[common] == octets[common])
+    {
+        ++common;
+    }
+
+    octaspire_radix_tree_node_t * const newLeaf =
+        octaspire_radix_tree_private_leaf_new(self, octets, numOctets, value);
+
+    octaspire_radix_tree_node_t * const node = octaspire_radix_tree_private_inner_new(
+        self,
+        OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4);
+
+    if (common > depth && node)
+    {
+        node->numOctets = common - depth;
+        node->octets    = octaspire_allocator_malloc(self->allocator, node->numOctets);
+
+        if (node->octets)
+        {
+            memcpy(node->octets, octets + depth, node->numOctets);
+        }
+    }
+
+    if (!newLeaf || !node || (node->numOctets && !node->octets))
+    {
+        if (newLeaf)
+        {
+            octaspire_radix_tree_private_leaf_release(self, newLeaf, false);
+        }
+
+        if (node)
+        {
+            octaspire_radix_tree_private_inner_free(self, node);
+        }
+
+        return OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_FAILURE;
+    }
+
+    octaspire_radix_tree_node_t * const leaves[] = {oldLeaf, newLeaf};
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        if (leaves[i]->numOctets == common)
+        {
+            node->leaf = leaves[i];
+        }
+        else
+        {
+            octaspire_radix_tree_private_insert_child(
+                node,
+                (uint8_t)leaves[i]->octets[common],
+                leaves[i]);
+        }
+    }
+
+    *nodeRef = node;
+    return OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_INSERTED;
+}
+
+// Splits the compressed path of the inner node in 'nodeRef' after
+// 'numMatching' octets and adds a new leaf for 'octets' to the new node.
+static octaspire_radix_tree_private_put_result_t
+octaspire_radix_tree_private_split_path(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t ** const nodeRef,
+    char const * const octets,
+    size_t const numOctets,
+    size_t const depth,
+    size_t const numMatching,
+    void const * const value)
+{
+    octaspire_radix_tree_node_t * const oldNode = *nodeRef;
+
+    assert(numMatching < oldNode->numOctets);
+
+    octaspire_radix_tree_node_t * const newLeaf =
+        octaspire_radix_tree_private_leaf_new(self, octets, numOctets, value);
+
+    octaspire_radix_tree_node_t * const node = octaspire_radix_tree_private_inner_new(
+        self,
+        OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4);
+
+    if (numMatching && node)
+    {
+        node->numOctets = numMatching;
+        node->octets    = octaspire_allocator_malloc(self->allocator, numMatching);
+
+        if (node->octets)
+        {
+            memcpy(node->octets, oldNode->octets, numMatching);
+        }
+    }
+
+    if (!newLeaf || !node || (node->numOctets && !node->octets))
+    {
+        if (newLeaf)
+        {
+            octaspire_radix_tree_private_leaf_release(self, newLeaf, false);
+        }
+
+        if (node)
+        {
+            octaspire_radix_tree_private_inner_free(self, node);
+        }
+
+        return OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_FAILURE;
+    }
+
+    uint8_t const oldOctet = (uint8_t)oldNode->octets[numMatching];
+
+    oldNode->numOctets -= numMatching + 1;
+
+    if (oldNode->numOctets)
+    {
+        memmove(
+            oldNode->octets,
+            oldNode->octets + numMatching + 1,
+            oldNode->numOctets);
+    }
+    else
+    {
+        octaspire_allocator_free(self->allocator, oldNode->octets);
+        oldNode->octets = 0;
+    }
+
+    octaspire_radix_tree_private_insert_child(node, oldOctet, oldNode);
+
+    size_t const newDepth = depth + numMatching;
+
+    if (numOctets == newDepth)
+    {
+        node->leaf = newLeaf;
+    }
+    else
+    {
+        octaspire_radix_tree_private_insert_child(
+            node,
+            (uint8_t)octets[newDepth],
+            newLeaf);
+    }
+
+    *nodeRef = node;
+    return OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_INSERTED;
+}
+
+static octaspire_radix_tree_private_put_result_t octaspire_radix_tree_private_put(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t ** const nodeRef,
+    char const * const octets,
+    size_t const numOctets,
+    size_t depth,
+    void const * const value)
+{
+    octaspire_radix_tree_node_t * const node = *nodeRef;
+
+    if (node->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF)
+    {
+        if (octaspire_radix_tree_private_leaf_has_key(node, octets, numOctets))
+        {
+            octaspire_radix_tree_private_leaf_replace_value(self, node, value);
+            return OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_REPLACED;
+        }
+
+        return octaspire_radix_tree_private_split_leaf(
+            self,
+            nodeRef,
+            octets,
+            numOctets,
+            depth,
+            value);
+    }
+
+    size_t numMatching = 0;
+
+    while (numMatching < node->numOctets &&
+           depth + numMatching < numOctets &&
+           node->octets[numMatching] == octets[depth + numMatching])
+    {
+        ++numMatching;
+    }
+
+    if (numMatching < node->numOctets)
+    {
+        return octaspire_radix_tree_private_split_path(
+            self,
+            nodeRef,
+            octets,
+            numOctets,
+            depth,
+            numMatching,
+            value);
+    }
+
+    depth += node->numOctets;
+
+    if (depth == numOctets)
+    {
+        if (node->leaf)
+        {
+            octaspire_radix_tree_private_leaf_replace_value(self, node->leaf, value);
+            return OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_REPLACED;
+        }
+
+        node->leaf = octaspire_radix_tree_private_leaf_new(self, octets, numOctets, value);
+
+        return node->leaf ?
+            OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_INSERTED :
+            OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_FAILURE;
+    }
+
+    uint8_t const octet = (uint8_t)octets[depth];
+
+    octaspire_radix_tree_node_t ** const child =
+        octaspire_radix_tree_private_find_child(node, octet);
+
+    if (child)
+    {
+        return octaspire_radix_tree_private_put(
+            self,
+            child,
+            octets,
+            numOctets,
+            depth + 1,
+            value);
+    }
+
+    octaspire_radix_tree_node_t * const leaf =
+        octaspire_radix_tree_private_leaf_new(self, octets, numOctets, value);
+
+    if (!leaf)
+    {
+        return OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_FAILURE;
+    }
+
+    if (!octaspire_radix_tree_private_add_child(self, nodeRef, octet, leaf))
+    {
+        octaspire_radix_tree_private_leaf_release(self, leaf, false);
+        return OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_FAILURE;
+    }
+
+    return OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_INSERTED;
+}
+
+static bool octaspire_radix_tree_private_remove(
+    octaspire_radix_tree_t * const self,
+    octaspire_radix_tree_node_t ** const nodeRef,
+    char const * const octets,
+    size_t const numOctets,
+    size_t depth)
+{
+    octaspire_radix_tree_node_t * const node = *nodeRef;
+
+    if (node->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF)
+    {
+        if (!octaspire_radix_tree_private_leaf_has_key(node, octets, numOctets))
+        {
+            return false;
+        }
+
+        *nodeRef = 0;
+        octaspire_radix_tree_private_leaf_release(self, node, true);
+        return true;
+    }
+
+    if (node->numOctets > numOctets - depth ||
+        (node->numOctets && memcmp(node->octets, octets + depth, node->numOctets) != 0))
+    {
+        return false;
+    }
+
+    depth += node->numOctets;
+
+    if (depth == numOctets)
+    {
+        if (!node->leaf)
+        {
+            return false;
+        }
+
+        octaspire_radix_tree_private_leaf_release(self, node->leaf, true);
+        node->leaf = 0;
+        octaspire_radix_tree_private_compact(self, nodeRef);
+        return true;
+    }
+
+    uint8_t const octet = (uint8_t)octets[depth];
+
+    octaspire_radix_tree_node_t ** const child =
+        octaspire_radix_tree_private_find_child(node, octet);
+
+    if (!child ||
+        !octaspire_radix_tree_private_remove(self, child, octets, numOctets, depth + 1))
+    {
+        return false;
+    }
+
+    if (!*child)
+    {
+        octaspire_radix_tree_private_remove_child(node, octet);
+        octaspire_radix_tree_private_compact(self, nodeRef);
+    }
+
+    return true;
+}
+
+static octaspire_radix_tree_node_t const *octaspire_radix_tree_private_get_minimum(
+    octaspire_radix_tree_node_t const *node)
+{
+    while (node && node->kind != OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF)
+    {
+        if (node->leaf)
+        {
+            return node->leaf;
+        }
+
+        uint8_t octet = 0;
+        node = octaspire_radix_tree_private_find_child_from(node, 0, &octet);
+    }
+
+    return node;
+}
+
+static int octaspire_radix_tree_private_compare_keys(
+    char const * const octets1,
+    size_t const numOctets1,
+    char const * const octets2,
+    size_t const numOctets2)
+{
+    size_t const numOctets = (numOctets1 < numOctets2) ? numOctets1 : numOctets2;
+
+    int const result = numOctets ? memcmp(octets1, octets2, numOctets) : 0;
+
+    if (result)
+    {
+        return result;
+    }
+
+    return (numOctets1 > numOctets2) - (numOctets1 < numOctets2);
+}
+
+// Returns the element with the smallest key greater than (or if
+// 'inclusive' is true, equal to) the given key.
+static octaspire_radix_tree_node_t const *octaspire_radix_tree_private_get_successor(
+    octaspire_radix_tree_node_t const * const node,
+    char const * const octets,
+    size_t const numOctets,
+    size_t depth,
+    bool const inclusive)
+{
+    if (node->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF)
+    {
+        int const result = octaspire_radix_tree_private_compare_keys(
+            node->octets,
+            node->numOctets,
+            octets,
+            numOctets);
+
+        return (result > 0 || (inclusive && result == 0)) ? node : 0;
+    }
+
+    for (size_t i = 0; i < node->numOctets; ++i)
+    {
+        if (depth + i == numOctets)
+        {
+            return octaspire_radix_tree_private_get_minimum(node);
+        }
+
+        uint8_t const nodeOctet = (uint8_t)node->octets[i];
+        uint8_t const keyOctet  = (uint8_t)octets[depth + i];
+
+        if (nodeOctet < keyOctet)
+        {
+            return 0;
+        }
+
+        if (nodeOctet > keyOctet)
+        {
+            return octaspire_radix_tree_private_get_minimum(node);
+        }
+    }
+
+    depth += node->numOctets;
+
+    uint8_t octet = 0;
+
+    if (depth == numOctets)
+    {
+        if (inclusive && node->leaf)
+        {
+            return node->leaf;
+        }
+
+        return octaspire_radix_tree_private_get_minimum(
+            octaspire_radix_tree_private_find_child_from(node, 0, &octet));
+    }
+
+    uint8_t const keyOctet = (uint8_t)octets[depth];
+
+    octaspire_radix_tree_node_t * const * const child =
+        octaspire_radix_tree_private_find_child(node, keyOctet);
+
+    if (child)
+    {
+        octaspire_radix_tree_node_t const * const result =
+            octaspire_radix_tree_private_get_successor(
+                *child,
+                octets,
+                numOctets,
+                depth + 1,
+                inclusive);
+
+        if (result)
+        {
+            return result;
+        }
+    }
+
+    return octaspire_radix_tree_private_get_minimum(
+        octaspire_radix_tree_private_find_child_from(
+            node,
+            (size_t)keyOctet + 1,
+            &octet));
+}
+
+static octaspire_radix_tree_node_t const *octaspire_radix_tree_private_get(
+    octaspire_radix_tree_t const * const self,
+    char const * const octets,
+    size_t const numOctets,
+    bool const longestPrefix)
+{
+    octaspire_radix_tree_node_t const *node   = self->root;
+    octaspire_radix_tree_node_t const *result = 0;
+    size_t                             depth  = 0;
+
+    while (node)
+    {
+        if (node->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF)
+        {
+            if (node->numOctets <= numOctets &&
+                (!node->numOctets || memcmp(node->octets, octets, node->numOctets) == 0) &&
+                (longestPrefix || node->numOctets == numOctets))
+            {
+                return node;
+            }
+
+            return result;
+        }
+
+        if (node->numOctets > numOctets - depth ||
+            (node->numOctets &&
+             memcmp(node->octets, octets + depth, node->numOctets) != 0))
+        {
+            return result;
+        }
+
+        depth += node->numOctets;
+
+        if (depth == numOctets)
+        {
+            return node->leaf ? node->leaf : result;
+        }
+
+        if (longestPrefix && node->leaf)
+        {
+            result = node->leaf;
+        }
+
+        octaspire_radix_tree_node_t * const * const child =
+            octaspire_radix_tree_private_find_child(node, (uint8_t)octets[depth]);
+
+        node = child ? *child : 0;
+        ++depth;
+    }
+
+    return result;
+}
+
+char const *octaspire_radix_tree_node_get_key_const(
+    octaspire_radix_tree_node_t const * const self)
+{
+    assert(self);
+    assert(self->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF);
+    return self->octets;
+}
+
+size_t octaspire_radix_tree_node_get_key_length_in_octets(
+    octaspire_radix_tree_node_t const * const self)
+{
+    assert(self);
+    assert(self->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF);
+    return self->numOctets;
+}
+
+void const *octaspire_radix_tree_node_get_value_const(
+    octaspire_radix_tree_node_t const * const self)
+{
+    assert(self);
+
+    void const * const value = octaspire_radix_tree_private_leaf_get_value(self);
+
+    return self->valueIsPointer ? *(void const * const *)value : value;
+}
+
+octaspire_radix_tree_t *octaspire_radix_tree_new(
+    size_t const valueSizeInOctets,
+    bool const valueIsPointer,
+    octaspire_map_element_callback_t valueReleaseCallback,
+    octaspire_allocator_t *allocator)
+{
+    octaspire_radix_tree_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_radix_tree_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->allocator            = allocator;
+    self->root                 = 0;
+    self->valueReleaseCallback = valueReleaseCallback;
+    self->valueSizeInOctets    = valueSizeInOctets;
+    self->numElements          = 0;
+    self->valueIsPointer       = valueIsPointer;
+
+    return self;
+}
+
+void octaspire_radix_tree_release(octaspire_radix_tree_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    octaspire_radix_tree_clear(self);
+    octaspire_allocator_free(self->allocator, self);
+}
+
+bool octaspire_radix_tree_put(
+    octaspire_radix_tree_t * const self,
+    octaspire_string_t const * const key,
+    void const * const value)
+{
+    assert(self && key);
+
+    char const * const octets    = octaspire_string_get_c_string(key);
+    size_t       const numOctets = octaspire_string_get_length_in_octets(key);
+
+    if (!self->root)
+    {
+        self->root =
+            octaspire_radix_tree_private_leaf_new(self, octets, numOctets, value);
+
+        if (!self->root)
+        {
+            return false;
+        }
+
+        ++(self->numElements);
+        return true;
+    }
+
+    switch (octaspire_radix_tree_private_put(
+        self,
+        &(self->root),
+        octets,
+        numOctets,
+        0,
+        value))
+    {
+        case OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_FAILURE:
+        {
+            return false;
+        }
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_INSERTED:
+        {
+            ++(self->numElements);
+            return true;
+        }
+
+        case OCTASPIRE_RADIX_TREE_PRIVATE_PUT_RESULT_REPLACED:
+        {
+            return true;
+        }
+    }
+
+    abort();
+}
+
+bool octaspire_radix_tree_remove(
+    octaspire_radix_tree_t * const self,
+    octaspire_string_t const * const key)
+{
+    assert(self && key);
+
+    if (!self->root)
+    {
+        return false;
+    }
+
+    if (!octaspire_radix_tree_private_remove(
+            self,
+            &(self->root),
+            octaspire_string_get_c_string(key),
+            octaspire_string_get_length_in_octets(key),
+            0))
+    {
+        return false;
+    }
+
+    --(self->numElements);
+    return true;
+}
+
+void octaspire_radix_tree_clear(
+    octaspire_radix_tree_t * const self)
+{
+    assert(self);
+
+    if (self->root)
+    {
+        octaspire_radix_tree_private_node_release(self, self->root);
+        self->root = 0;
+    }
+
+    self->numElements = 0;
+}
+
+octaspire_radix_tree_node_t const *octaspire_radix_tree_get_const(
+    octaspire_radix_tree_t const * const self,
+    octaspire_string_t const * const key)
+{
+    assert(self && key);
+
+    return octaspire_radix_tree_private_get(
+        self,
+        octaspire_string_get_c_string(key),
+        octaspire_string_get_length_in_octets(key),
+        false);
+}
+
+octaspire_radix_tree_node_t const *octaspire_radix_tree_get_longest_prefix_const(
+    octaspire_radix_tree_t const * const self,
+    octaspire_string_t const * const key)
+{
+    assert(self && key);
+
+    return octaspire_radix_tree_private_get(
+        self,
+        octaspire_string_get_c_string(key),
+        octaspire_string_get_length_in_octets(key),
+        true);
+}
+
+bool octaspire_radix_tree_is_empty(
+    octaspire_radix_tree_t const * const self)
+{
+    return self->numElements == 0;
+}
+
+size_t octaspire_radix_tree_get_number_of_elements(
+    octaspire_radix_tree_t const * const self)
+{
+    return self->numElements;
+}
+
+
+
+static void octaspire_radix_tree_element_const_iterator_private_check_prefix(
+    octaspire_radix_tree_element_const_iterator_t * const self)
+{
+    if (self->element &&
+        self->prefixLengthInOctets &&
+        (self->element->numOctets < self->prefixLengthInOctets ||
+         memcmp(self->element->octets, self->prefix, self->prefixLengthInOctets) != 0))
+    {
+        self->element = 0;
+    }
+}
+
+octaspire_radix_tree_element_const_iterator_t
+octaspire_radix_tree_element_const_iterator_init(
+    octaspire_radix_tree_t const * const self)
+{
+    assert(self);
+
+    octaspire_radix_tree_element_const_iterator_t iterator;
+
+    iterator.radixTree            = self;
+    iterator.element              = octaspire_radix_tree_private_get_minimum(self->root);
+    iterator.prefix               = "";
+    iterator.prefixLengthInOctets = 0;
+
+    return iterator;
+}
+
+octaspire_radix_tree_element_const_iterator_t
+octaspire_radix_tree_element_const_iterator_init_with_prefix(
+    octaspire_radix_tree_t const * const self,
+    octaspire_string_t const * const prefix)
+{
+    assert(self && prefix);
+
+    octaspire_radix_tree_element_const_iterator_t iterator;
+
+    iterator.radixTree            = self;
+    iterator.element              = 0;
+    iterator.prefix               = octaspire_string_get_c_string(prefix);
+    iterator.prefixLengthInOctets = octaspire_string_get_length_in_octets(prefix);
+
+    if (self->root)
+    {
+        iterator.element = octaspire_radix_tree_private_get_successor(
+            self->root,
+            iterator.prefix,
+            iterator.prefixLengthInOctets,
+            0,
+            true);
+    }
+
+    octaspire_radix_tree_element_const_iterator_private_check_prefix(&iterator);
+
+    return iterator;
+}
+
+bool octaspire_radix_tree_element_const_iterator_next(
+    octaspire_radix_tree_element_const_iterator_t * const self)
+{
+    assert(self);
+
+    if (!self->element)
+    {
+        return false;
+    }
+
+    self->element = octaspire_radix_tree_private_get_successor(
+        self->radixTree->root,
+        self->element->octets,
+        self->element->numOctets,
+        0,
+        false);
+
+    octaspire_radix_tree_element_const_iterator_private_check_prefix(self);
+
+    return self->element != 0;
+}
+
@@ -0,0 +1,897 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_rope.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "octaspire/core/octaspire_utf8.h"
+
+#define OCTASPIRE_ROPE_PRIVATE_NODE_CAPACITY_IN_OCTETS 512
+
+// Every node holds one chunk of the text. The text of a subtree is the
+// text of the left child, then the chunk, then the text of the right
+// child. Priorities keep the tree balanced: a parent never has a lower
+// priority than its children.
+typedef struct octaspire_rope_private_node_t
+{
+    struct octaspire_rope_private_node_t *left;
+    struct octaspire_rope_private_node_t *right;
+    size_t                                numOctets;
+    size_t                                numUcsCharacters;
+    size_t                                numNewlines;
+    size_t                                totalNumOctets;
+    size_t                                totalNumUcsCharacters;
+    size_t                                totalNumNewlines;
+    uint32_t                              priority;
+    char                                  octets[OCTASPIRE_ROPE_PRIVATE_NODE_CAPACITY_IN_OCTETS];
+    char                                  padding[4];
+}
+octaspire_rope_private_node_t;
+
+struct octaspire_rope_t
+{
+    octaspire_allocator_t         *allocator;
+    octaspire_rope_private_node_t *root;
+    uint32_t                       randomState;
+    char                           padding[4];
+};
+
+static bool octaspire_rope_private_is_continuation_octet(char const c)
+{
+    return ((unsigned char)c & 0xC0) == 0x80;
+}
+
+static void octaspire_rope_private_count(
+    char const * const octets,
+    size_t const lengthInOctets,
+    size_t * const numUcsCharacters,
+    size_t * const numNewlines)
+{
+    *numUcsCharacters = 0;
+    *numNewlines      = 0;
+
+    for (size_t i = 0; i < lengthInOctets; ++i)
+    {
+        if (!octaspire_rope_private_is_continuation_octet(octets[i]))
+        {
+            ++(*numUcsCharacters);
+        }
+
+        if (octets[i] == '\n')
+        {
+            ++(*numNewlines);
+        }
+    }
+}
+
+static bool octaspire_rope_private_is_valid_utf8(
+    char const * const buffer,
+    size_t const lengthInOctets)
+{
+    size_t index = 0;
+
+    while (index < lengthInOctets)
+    {
+        uint32_t ucsCharacter = 0;
+        int numOctets         = 0;
+
+        if (octaspire_utf8_decode_character(
+                buffer + index,
+                lengthInOctets - index,
+                &ucsCharacter,
+                &numOctets) != OCTASPIRE_UTF8_DECODE_STATUS_OK ||
+            numOctets <= 0)
+        {
+            return false;
+        }
+
+        index += (size_t)numOctets;
+    }
+
+    return true;
+}
+
+static size_t octaspire_rope_private_get_total_num_octets(
+    octaspire_rope_private_node_t const * const node)
+{
+    return node ? node->totalNumOctets : 0;
+}
+
+static size_t octaspire_rope_private_get_total_num_ucs_characters(
+    octaspire_rope_private_node_t const * const node)
+{
+    return node ? node->totalNumUcsCharacters : 0;
+}
+
+static size_t octaspire_rope_private_get_total_num_newlines(
+    octaspire_rope_private_node_t const * const node)
+{
+    return node ? node->totalNumNewlines : 0;
+}
+
+static void octaspire_rope_private_update(
+    octaspire_rope_private_node_t * const node)
+{
+    node->totalNumOctets = node->numOctets +
+        octaspire_rope_private_get_total_num_octets(node->left) +
+        octaspire_rope_private_get_total_num_octets(node->right);
+
+    node->totalNumUcsCharacters = node->numUcsCharacters +
+        octaspire_rope_private_get_total_num_ucs_characters(node->left) +
+        octaspire_rope_private_get_total_num_ucs_characters(node->right);
+
+    node->totalNumNewlines = node->numNewlines +
+        octaspire_rope_private_get_total_num_newlines(node->left) +
+        octaspire_rope_private_get_total_num_newlines(node->right);
+}
+
+// Offset of the UCS character 'ucsIndex' of the chunk, or the length of
+// the chunk if 'ucsIndex' is the number of its characters.
+static size_t octaspire_rope_private_get_octet_offset(
+    octaspire_rope_private_node_t const * const node,
+    size_t const ucsIndex)
+{
+    size_t numStarts = 0;
+
+    for (size_t i = 0; i < node->numOctets; ++i)
+    {
+        if (!octaspire_rope_private_is_continuation_octet(node->octets[i]))
+        {
+            if (numStarts == ucsIndex)
+            {
+                return i;
+            }
+
+            ++numStarts;
+        }
+    }
+
+    return node->numOctets;
+}
+
+static uint32_t octaspire_rope_private_next_priority(
+    octaspire_rope_t * const self)
+{
+    // xorshift32
+    uint32_t x = self->randomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    self->randomState = x;
+    return x;
+}
+
+static octaspire_rope_private_node_t *octaspire_rope_private_node_new(
+    octaspire_rope_t * const self,
+    char const * const octets,
+    size_t const lengthInOctets,
+    uint32_t const priority)
+{
+    assert(lengthInOctets <= OCTASPIRE_ROPE_PRIVATE_NODE_CAPACITY_IN_OCTETS);
+
+    octaspire_rope_private_node_t * const node = octaspire_allocator_malloc(
+        self->allocator,
+        sizeof(octaspire_rope_private_node_t));
+
+    if (!node)
+    {
+        return node;
+    }
+
+    node->left      = 0;
+    node->right     = 0;
+    node->numOctets = lengthInOctets;
+    node->priority  = priority;
+
+    memcpy(node->octets, octets, lengthInOctets);
+
+    octaspire_rope_private_count(
+        node->octets,
+        node->numOctets,
+        &(node->numUcsCharacters),
+        &(node->numNewlines));
+
+    octaspire_rope_private_update(node);
+
+    return node;
+}
+
+static void octaspire_rope_private_node_release(
+    octaspire_rope_t * const self,
+    octaspire_rope_private_node_t * const node)
+{
+    if (!node)
+    {
+        return;
+    }
+
+    octaspire_rope_private_node_release(self, node->left);
+    octaspire_rope_private_node_release(self, node->right);
+    octaspire_allocator_free(self->allocator, node);
+}
+
+// Joins two trees; all of the text of 'left' comes before 'right'
+static octaspire_rope_private_node_t *octaspire_rope_private_merge(
+    octaspire_rope_private_node_t * const left,
+    octaspire_rope_private_node_t * const right)
+{
+    if (!left)
+    {
+        return right;
+    }
+
+    if (!right)
+    {
+        return left;
+    }
+
+    if (left->priority >= right->priority)
+    {
+        left->right = octaspire_rope_private_merge(left->right, right);
+        octaspire_rope_private_update(left);
+        return left;
+    }
+
+    right->left = octaspire_rope_private_merge(left, right->left);
+    octaspire_rope_private_update(right);
+    return right;
+}
+
+// Splits the tree so that 'left' gets the first 'ucsIndex' UCS characters.
+// A chunk may have to be split in two, which needs one allocation. On
+// failure nothing has been changed yet.
+static bool octaspire_rope_private_split(
+    octaspire_rope_t * const self,
+    octaspire_rope_private_node_t * const node,
+    size_t const ucsIndex,
+    octaspire_rope_private_node_t ** const left,
+    octaspire_rope_private_node_t ** const right)
+{
+    if (!node)
+    {
+        *left  = 0;
+        *right = 0;
+        return true;
+    }
+
+    size_t const numLeft =
+        octaspire_rope_private_get_total_num_ucs_characters(node->left);
+
+    if (ucsIndex <= numLeft)
+    {
+        octaspire_rope_private_node_t *subtreeRight = 0;
+
+        if (!octaspire_rope_private_split(self, node->left, ucsIndex, left, &subtreeRight))
+        {
+            return false;
+        }
+
+        node->left = subtreeRight;
+        octaspire_rope_private_update(node);
+        *right = node;
+        return true;
+    }
+
+    if (ucsIndex >= numLeft + node->numUcsCharacters)
+    {
+        octaspire_rope_private_node_t *subtreeLeft = 0;
+
+        if (!octaspire_rope_private_split(
+                self,
+                node->right,
+                ucsIndex - numLeft - node->numUcsCharacters,
+                &subtreeLeft,
+                right))
+        {
+            return false;
+        }
+
+        node->right = subtreeLeft;
+        octaspire_rope_private_update(node);
+        *left = node;
+        return true;
+    }
+
+    // The split point is inside of this chunk. The new node takes the
+    // same priority, so it can take the place of 'node' above its right
+    // subtree.
+    size_t const offset =
+        octaspire_rope_private_get_octet_offset(node, ucsIndex - numLeft);
+
+    octaspire_rope_private_node_t * const tail = octaspire_rope_private_node_new(
+        self,
+        node->octets + offset,
+        node->numOctets - offset,
+        node->priority);
+
+    if (!tail)
+    {
+        return false;
+    }
+
+    tail->right = node->right;
+    octaspire_rope_private_update(tail);
+
+    node->right     = 0;
+    node->numOctets = offset;
+
+    octaspire_rope_private_count(
+        node->octets,
+        node->numOctets,
+        &(node->numUcsCharacters),
+        &(node->numNewlines));
+
+    octaspire_rope_private_update(node);
+
+    *left  = node;
+    *right = tail;
+    return true;
+}
+
+// Inserts into the chunk that contains 'ucsIndex', if the text fits there
+static bool octaspire_rope_private_insert_into_chunk(
+    octaspire_rope_private_node_t * const node,
+    size_t const ucsIndex,
+    char const * const buffer,
+    size_t const lengthInOctets)
+{
+    if (!node)
+    {
+        return false;
+    }
+
+    size_t const numLeft =
+        octaspire_rope_private_get_total_num_ucs_characters(node->left);
+
+    bool isInserted = false;
+
+    if (ucsIndex < numLeft)
+    {
+        isInserted = octaspire_rope_private_insert_into_chunk(
+            node->left,
+            ucsIndex,
+            buffer,
+            lengthInOctets);
+    }
+    else if (ucsIndex > numLeft + node->numUcsCharacters)
+    {
+        isInserted = octaspire_rope_private_insert_into_chunk(
+            node->right,
+            ucsIndex - numLeft - node->numUcsCharacters,
+            buffer,
+            lengthInOctets);
+    }
+    else if (node->numOctets + lengthInOctets <= OCTASPIRE_ROPE_PRIVATE_NODE_CAPACITY_IN_OCTETS)
+    {
+        size_t const offset =
+            octaspire_rope_private_get_octet_offset(node, ucsIndex - numLeft);
+
+        memmove(
+            node->octets + offset + lengthInOctets,
+            node->octets + offset,
+            node->numOctets - offset);
+
+        memcpy(node->octets + offset, buffer, lengthInOctets);
+        node->numOctets += lengthInOctets;
+
+        size_t numUcsCharacters = 0;
+        size_t numNewlines      = 0;
+
+        octaspire_rope_private_count(buffer, lengthInOctets, &numUcsCharacters, &numNewlines);
+
+        node->numUcsCharacters += numUcsCharacters;
+        node->numNewlines      += numNewlines;
+
+        isInserted = true;
+    }
+
+    if (isInserted)
+    {
+        octaspire_rope_private_update(node);
+    }
+
+    return isInserted;
+}
+
+// Removes from the chunk that contains the whole range, if there is one
+// and it does not become empty.
+static bool octaspire_rope_private_remove_from_chunk(
+    octaspire_rope_private_node_t * const node,
+    size_t const ucsIndex,
+    size_t const numUcsCharacters)
+{
+    if (!node)
+    {
+        return false;
+    }
+
+    size_t const numLeft =
+        octaspire_rope_private_get_total_num_ucs_characters(node->left);
+
+    bool isRemoved = false;
+
+    if (ucsIndex < numLeft)
+    {
+        isRemoved = octaspire_rope_private_remove_from_chunk(
+            node->left,
+            ucsIndex,
+            numUcsCharacters);
+    }
+    else if (ucsIndex >= numLeft + node->numUcsCharacters)
+    {
+        isRemoved = octaspire_rope_private_remove_from_chunk(
+            node->right,
+            ucsIndex - numLeft - node->numUcsCharacters,
+            numUcsCharacters);
+    }
+    else if (ucsIndex + numUcsCharacters <= numLeft + node->numUcsCharacters &&
+             numUcsCharacters < node->numUcsCharacters)
+    {
+        size_t const start =
+            octaspire_rope_private_get_octet_offset(node, ucsIndex - numLeft);
+
+        size_t const end = octaspire_rope_private_get_octet_offset(
+            node,
+            ucsIndex - numLeft + numUcsCharacters);
+
+        memmove(node->octets + start, node->octets + end, node->numOctets - end);
+        node->numOctets -= end - start;
+
+        octaspire_rope_private_count(
+            node->octets,
+            node->numOctets,
+            &(node->numUcsCharacters),
+            &(node->numNewlines));
+
+        isRemoved = true;
+    }
+
+    if (isRemoved)
+    {
+        octaspire_rope_private_update(node);
+    }
+
+    return isRemoved;
+}
+
+// Builds a tree of chunks from valid UTF-8. Chunks end on character
+// boundaries. Returns false on allocation failure.
+static bool octaspire_rope_private_new_tree(
+    octaspire_rope_t * const self,
+    char const * const buffer,
+    size_t const lengthInOctets,
+    octaspire_rope_private_node_t ** const result)
+{
+    *result = 0;
+
+    size_t index = 0;
+
+    while (index < lengthInOctets)
+    {
+        size_t length = lengthInOctets - index;
+
+        if (length > OCTASPIRE_ROPE_PRIVATE_NODE_CAPACITY_IN_OCTETS)
+        {
+            length = OCTASPIRE_ROPE_PRIVATE_NODE_CAPACITY_IN_OCTETS;
+
+            while (octaspire_rope_private_is_continuation_octet(buffer[index + length]))
+            {
+                --length;
+            }
+        }
+
+        octaspire_rope_private_node_t * const node = octaspire_rope_private_node_new(
+            self,
+            buffer + index,
+            length,
+            octaspire_rope_private_next_priority(self));
+
+        if (!node)
+        {
+            octaspire_rope_private_node_release(self, *result);
+            *result = 0;
+            return false;
+        }
+
+        *result = octaspire_rope_private_merge(*result, node);
+        index += length;
+    }
+
+    return true;
+}
+
+octaspire_rope_t *octaspire_rope_new(
+    octaspire_allocator_t *allocator)
+{
+    octaspire_rope_t * const self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_rope_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->allocator   = allocator;
+    self->root        = 0;
+    self->randomState = 2463534242u;
+
+    return self;
+}
+
+octaspire_rope_t *octaspire_rope_new_from_string(
+    octaspire_string_t const * const str,
+    octaspire_allocator_t *allocator)
+{
+    octaspire_rope_t *self = octaspire_rope_new(allocator);
+
+    if (!self)
+    {
+        return self;
+    }
+
+    if (!octaspire_rope_insert_string_at(self, 0, str))
+    {
+        octaspire_rope_release(self);
+        self = 0;
+        return 0;
+    }
+
+    return self;
+}
+
+void octaspire_rope_release(octaspire_rope_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    octaspire_rope_private_node_release(self, self->root);
+    self->root = 0;
+
+    octaspire_allocator_free(self->allocator, self);
+}
+
+bool octaspire_rope_insert_buffer_at(
+    octaspire_rope_t * const self,
+    size_t const ucsIndex,
+    char const * const buffer,
+    size_t const lengthInOctets)
+{
+    assert(self);
+
+    if (ucsIndex > octaspire_rope_get_length_in_ucs_characters(self) ||
+        !octaspire_rope_private_is_valid_utf8(buffer, lengthInOctets))
+    {
+        return false;
+    }
+
+    if (!lengthInOctets)
+    {
+        return true;
+    }
+
+    if (octaspire_rope_private_insert_into_chunk(self->root, ucsIndex, buffer, lengthInOctets))
+    {
+        return true;
+    }
+
+    octaspire_rope_private_node_t *middle = 0;
+
+    if (!octaspire_rope_private_new_tree(self, buffer, lengthInOctets, &middle))
+    {
+        return false;
+    }
+
+    octaspire_rope_private_node_t *left  = 0;
+    octaspire_rope_private_node_t *right = 0;
+
+    if (!octaspire_rope_private_split(self, self->root, ucsIndex, &left, &right))
+    {
+        octaspire_rope_private_node_release(self, middle);
+        return false;
+    }
+
+    self->root = octaspire_rope_private_merge(
+        octaspire_rope_private_merge(left, middle),
+        right);
+
+    return true;
+}
+
+bool octaspire_rope_insert_c_string_at(
+    octaspire_rope_t * const self,
+    size_t const ucsIndex,
+    char const * const str)
+{
+    return octaspire_rope_insert_buffer_at(self, ucsIndex, str, strlen(str));
+}
+
+bool octaspire_rope_insert_string_at(
+    octaspire_rope_t * const self,
+    size_t const ucsIndex,
+    octaspire_string_t const * const str)
+{
+    return octaspire_rope_insert_buffer_at(
+        self,
+        ucsIndex,
+        octaspire_string_get_c_string(str),
+        octaspire_string_get_length_in_octets(str));
+}
+
+bool octaspire_rope_remove_ucs_characters_at(
+    octaspire_rope_t * const self,
+    size_t const ucsIndex,
+    size_t const numUcsCharacters)
+{
+    assert(self);
+
+    size_t const length = octaspire_rope_get_length_in_ucs_characters(self);
+
+    if (ucsIndex > length || numUcsCharacters > length - ucsIndex)
+    {
+        return false;
+    }
+
+    if (!numUcsCharacters)
+    {
+        return true;
+    }
+
+    if (octaspire_rope_private_remove_from_chunk(self->root, ucsIndex, numUcsCharacters))
+    {
+        return true;
+    }
+
+    octaspire_rope_private_node_t *left   = 0;
+    octaspire_rope_private_node_t *rest   = 0;
+    octaspire_rope_private_node_t *middle = 0;
+    octaspire_rope_private_node_t *right  = 0;
+
+    if (!octaspire_rope_private_split(self, self->root, ucsIndex, &left, &rest))
+    {
+        return false;
+    }
+
+    if (!octaspire_rope_private_split(self, rest, numUcsCharacters, &middle, &right))
+    {
+        self->root = octaspire_rope_private_merge(left, rest);
+        return false;
+    }
+
+    octaspire_rope_private_node_release(self, middle);
+    self->root = octaspire_rope_private_merge(left, right);
+
+    return true;
+}
+
+size_t octaspire_rope_get_length_in_ucs_characters(
+    octaspire_rope_t const * const self)
+{
+    return octaspire_rope_private_get_total_num_ucs_characters(self->root);
+}
+
+size_t octaspire_rope_get_length_in_octets(
+    octaspire_rope_t const * const self)
+{
+    return octaspire_rope_private_get_total_num_octets(self->root);
+}
+
+bool octaspire_rope_is_empty(
+    octaspire_rope_t const * const self)
+{
+    return !self->root || !self->root->totalNumOctets;
+}
+
+uint32_t octaspire_rope_get_ucs_character_at_index(
+    octaspire_rope_t const * const self,
+    size_t const ucsIndex)
+{
+    if (ucsIndex >= octaspire_rope_get_length_in_ucs_characters(self))
+    {
+        abort();
+    }
+
+    octaspire_rope_private_node_t const *node = self->root;
+    size_t index = ucsIndex;
+
+    while (true)
+    {
+        size_t const numLeft =
+            octaspire_rope_private_get_total_num_ucs_characters(node->left);
+
+        if (index < numLeft)
+        {
+            node = node->left;
+        }
+        else if (index >= numLeft + node->numUcsCharacters)
+        {
+            index -= numLeft + node->numUcsCharacters;
+            node = node->right;
+        }
+        else
+        {
+            size_t const offset =
+                octaspire_rope_private_get_octet_offset(node, index - numLeft);
+
+            uint32_t ucsCharacter = 0;
+            int numOctets         = 0;
+
+            octaspire_utf8_decode_character(
+                node->octets + offset,
+                node->numOctets - offset,
+                &ucsCharacter,
+                &numOctets);
+
+            return ucsCharacter;
+        }
+    }
+}
+
+size_t octaspire_rope_get_number_of_lines(
+    octaspire_rope_t const * const self)
+{
+    return octaspire_rope_private_get_total_num_newlines(self->root) + 1;
+}
+
+size_t octaspire_rope_get_ucs_index_of_line(
+    octaspire_rope_t const * const self,
+    size_t const line)
+{
+    if (line >= octaspire_rope_get_number_of_lines(self))
+    {
+        abort();
+    }
+
+    if (!line)
+    {
+        return 0;
+    }
+
+    // Line 'line' starts after the newline number 'line' (counting from one)
+    octaspire_rope_private_node_t const *node = self->root;
+    size_t numNewlinesToSkip = line;
+    size_t result            = 0;
+
+    while (true)
+    {
+        size_t const numLeftNewlines =
+            octaspire_rope_private_get_total_num_newlines(node->left);
+
+        size_t const numLeft =
+            octaspire_rope_private_get_total_num_ucs_characters(node->left);
+
+        if (numNewlinesToSkip <= numLeftNewlines)
+        {
+            node = node->left;
+        }
+        else if (numNewlinesToSkip > numLeftNewlines + node->numNewlines)
+        {
+            numNewlinesToSkip -= numLeftNewlines + node->numNewlines;
+            result += numLeft + node->numUcsCharacters;
+            node = node->right;
+        }
+        else
+        {
+            numNewlinesToSkip -= numLeftNewlines;
+            result += numLeft;
+
+            for (size_t i = 0; i < node->numOctets; ++i)
+            {
+                if (!octaspire_rope_private_is_continuation_octet(node->octets[i]))
+                {
+                    ++result;
+                }
+
+                if (node->octets[i] == '\n' && !--numNewlinesToSkip)
+                {
+                    return result;
+                }
+            }
+
+            abort();
+        }
+    }
+}
+
+size_t octaspire_rope_get_line_of_ucs_index(
+    octaspire_rope_t const * const self,
+    size_t const ucsIndex)
+{
+    assert(ucsIndex <= octaspire_rope_get_length_in_ucs_characters(self));
+
+    octaspire_rope_private_node_t const *node = self->root;
+    size_t index  = ucsIndex;
+    size_t result = 0;
+
+    while (node)
+    {
+        size_t const numLeft =
+            octaspire_rope_private_get_total_num_ucs_characters(node->left);
+
+        if (index < numLeft)
+        {
+            node = node->left;
+        }
+        else if (index >= numLeft + node->numUcsCharacters)
+        {
+            index  -= numLeft + node->numUcsCharacters;
+            result += octaspire_rope_private_get_total_num_newlines(node->left) +
+                node->numNewlines;
+            node = node->right;
+        }
+        else
+        {
+            result += octaspire_rope_private_get_total_num_newlines(node->left);
+
+            size_t const offset =
+                octaspire_rope_private_get_octet_offset(node, index - numLeft);
+
+            for (size_t i = 0; i < offset; ++i)
+            {
+                if (node->octets[i] == '\n')
+                {
+                    ++result;
+                }
+            }
+
+            return result;
+        }
+    }
+
+    return result;
+}
+
+static char *octaspire_rope_private_copy_octets(
+    octaspire_rope_private_node_t const * const node,
+    char *target)
+{
+    if (!node)
+    {
+        return target;
+    }
+
+    target = octaspire_rope_private_copy_octets(node->left, target);
+    memcpy(target, node->octets, node->numOctets);
+    target += node->numOctets;
+    return octaspire_rope_private_copy_octets(node->right, target);
+}
+
+octaspire_string_t *octaspire_rope_to_string(
+    octaspire_rope_t const * const self,
+    octaspire_allocator_t *allocator)
+{
+    size_t const lengthInOctets = octaspire_rope_get_length_in_octets(self);
+
+    char * const buffer =
+        octaspire_allocator_malloc(allocator, lengthInOctets ? lengthInOctets : 1);
+
+    if (!buffer)
+    {
+        return 0;
+    }
+
+    octaspire_rope_private_copy_octets(self->root, buffer);
+
+    octaspire_string_t * const result =
+        octaspire_string_new_from_buffer(buffer, lengthInOctets, allocator);
+
+    octaspire_allocator_free(allocator, buffer);
+
+    return result;
+}
+
@@ -0,0 +1,826 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_static_map.h"
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include "octaspire/core/octaspire_helpers.h"
+
+static size_t const OCTASPIRE_STATIC_MAP_PRIVATE_KEYS_PER_BUCKET   = 4;
+static size_t const OCTASPIRE_STATIC_MAP_PRIVATE_MAX_NUM_ATTEMPTS  = 32;
+static size_t const OCTASPIRE_STATIC_MAP_PRIVATE_MIN_NUM_PILOTS    = 65536;
+static size_t const OCTASPIRE_STATIC_MAP_PRIVATE_NUMBERS_PER_LINE  = 8;
+static size_t const OCTASPIRE_STATIC_MAP_PRIVATE_OCTETS_PER_CHUNK  = 32;
+
+typedef enum octaspire_static_map_private_status_t
+{
+    OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_OK,
+    OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_TRY_NEXT_SEED,
+    OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_DUPLICATE_KEY,
+    OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_ALLOCATION_FAILURE
+}
+octaspire_static_map_private_status_t;
+
+struct octaspire_static_map_t
+{
+    octaspire_allocator_t         *allocator;
+    octaspire_static_map_tables_t  tables;
+    uint32_t                      *pilots;
+    char                         **keys;
+    size_t                        *keyLengthsInOctets;
+    char                          *keyOctets;
+    uint8_t                       *values;
+    uint8_t                        seed[16];
+};
+
+static uint64_t octaspire_static_map_private_mix(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+static size_t octaspire_static_map_private_get_bucket(
+    uint64_t const hash,
+    size_t const numBuckets)
+{
+    return (size_t)((hash >> 32) % numBuckets);
+}
+
+static size_t octaspire_static_map_private_get_position(
+    uint64_t const hash,
+    uint32_t const pilot,
+    size_t const numElements)
+{
+    return (size_t)(octaspire_static_map_private_mix(
+        hash ^ ((uint64_t)pilot * 0x9e3779b97f4a7c15ULL)) % numElements);
+}
+
+static uint64_t octaspire_static_map_private_get_hash(
+    octaspire_string_t const * const key,
+    uint8_t const * const seed)
+{
+    return octaspire_helpers_calculate_siphash13(
+        octaspire_string_get_c_string(key),
+        octaspire_string_get_length_in_octets(key),
+        seed);
+}
+
+static bool octaspire_static_map_private_is_same_key(
+    octaspire_string_t const * const a,
+    octaspire_string_t const * const b)
+{
+    size_t const lengthInOctets = octaspire_string_get_length_in_octets(a);
+
+    return lengthInOctets == octaspire_string_get_length_in_octets(b) &&
+        memcmp(
+            octaspire_string_get_c_string(a),
+            octaspire_string_get_c_string(b),
+            lengthInOctets) == 0;
+}
+
+// Finds a pilot for every bucket so that the keys land on distinct
+// positions, placing the largest buckets first while the table is still
+// empty. On success 'indices' maps every position to its key. The other
+// arrays are scratch space; 'bucketStarts' and 'positions' must be zeroed.
+static octaspire_static_map_private_status_t octaspire_static_map_private_place_buckets(
+    octaspire_static_map_t * const self,
+    octaspire_vector_t const * const keys,
+    uint64_t const * const hashes,
+    size_t * const bucketStarts,
+    size_t * const order,
+    size_t * const bucketsBySize,
+    size_t * const positions,
+    size_t * const indices)
+{
+    size_t const numElements = self->tables.numElements;
+    size_t const numBuckets  = self->tables.numBuckets;
+
+    size_t const maxPilot =
+        (numElements * 8 > OCTASPIRE_STATIC_MAP_PRIVATE_MIN_NUM_PILOTS) ?
+        numElements * 8 : OCTASPIRE_STATIC_MAP_PRIVATE_MIN_NUM_PILOTS;
+
+    // Counting sort of the keys by bucket
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        ++bucketStarts[octaspire_static_map_private_get_bucket(hashes[i], numBuckets) + 1];
+    }
+
+    size_t maxBucketSize = 0;
+
+    for (size_t b = 0; b < numBuckets; ++b)
+    {
+        if (bucketStarts[b + 1] > maxBucketSize)
+        {
+            maxBucketSize = bucketStarts[b + 1];
+        }
+
+        bucketStarts[b + 1] += bucketStarts[b];
+    }
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        size_t const b = octaspire_static_map_private_get_bucket(hashes[i], numBuckets);
+        order[bucketStarts[b]++] = i;
+    }
+
+    // Every start was moved to the end of its bucket; shift them back
+    for (size_t b = numBuckets; b > 0; --b)
+    {
+        bucketStarts[b] = bucketStarts[b - 1];
+    }
+
+    bucketStarts[0] = 0;
+
+    // Keys with the same hash can never be separated by a pilot
+    for (size_t b = 0; b < numBuckets; ++b)
+    {
+        for (size_t i = bucketStarts[b]; i < bucketStarts[b + 1]; ++i)
+        {
+            for (size_t j = bucketStarts[b]; j < i; ++j)
+            {
+                if (hashes[order[i]] != hashes[order[j]])
+                {
+                    continue;
+                }
+
+                return octaspire_static_map_private_is_same_key(
+                    octaspire_vector_get_element_at_const(keys, (ptrdiff_t)order[i]),
+                    octaspire_vector_get_element_at_const(keys, (ptrdiff_t)order[j])) ?
+                    OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_DUPLICATE_KEY :
+                    OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_TRY_NEXT_SEED;
+            }
+        }
+    }
+
+    // Buckets from the largest to the smallest
+    size_t numSorted = 0;
+
+    for (size_t size = maxBucketSize; size > 0; --size)
+    {
+        for (size_t b = 0; b < numBuckets; ++b)
+        {
+            if (bucketStarts[b + 1] - bucketStarts[b] == size)
+            {
+                bucketsBySize[numSorted++] = b;
+            }
+        }
+    }
+
+    // 'positions' holds the key at every taken position as index + 1
+    for (size_t i = 0; i < numSorted; ++i)
+    {
+        size_t const b     = bucketsBySize[i];
+        size_t const start = bucketStarts[b];
+        size_t const end   = bucketStarts[b + 1];
+
+        size_t pilot = 0;
+
+        for (; pilot < maxPilot; ++pilot)
+        {
+            size_t k = start;
+
+            for (; k < end; ++k)
+            {
+                size_t const position = octaspire_static_map_private_get_position(
+                    hashes[order[k]],
+                    (uint32_t)pilot,
+                    numElements);
+
+                if (positions[position])
+                {
+                    break;
+                }
+
+                positions[position] = order[k] + 1;
+            }
+
+            if (k == end)
+            {
+                break;
+            }
+
+            // Undo the positions taken with this pilot
+            for (size_t j = start; j < k; ++j)
+            {
+                positions[octaspire_static_map_private_get_position(
+                    hashes[order[j]],
+                    (uint32_t)pilot,
+                    numElements)] = 0;
+            }
+        }
+
+        if (pilot == maxPilot)
+        {
+            return OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_TRY_NEXT_SEED;
+        }
+
+        self->pilots[b] = (uint32_t)pilot;
+    }
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        assert(positions[i]);
+        indices[i] = positions[i] - 1;
+    }
+
+    return OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_OK;
+}
+
+static octaspire_static_map_private_status_t octaspire_static_map_private_find_pilots(
+    octaspire_static_map_t * const self,
+    octaspire_vector_t const * const keys,
+    uint64_t const * const hashes,
+    size_t * const indices)
+{
+    size_t const numElements = self->tables.numElements;
+    size_t const numBuckets  = self->tables.numBuckets;
+
+    size_t * const bucketStarts = octaspire_allocator_malloc(
+        self->allocator,
+        (numBuckets + 1) * sizeof(size_t));
+
+    size_t * const order = octaspire_allocator_malloc(
+        self->allocator,
+        numElements * sizeof(size_t));
+
+    size_t * const bucketsBySize = octaspire_allocator_malloc(
+        self->allocator,
+        numBuckets * sizeof(size_t));
+
+    size_t * const positions = octaspire_allocator_malloc(
+        self->allocator,
+        numElements * sizeof(size_t));
+
+    octaspire_static_map_private_status_t status =
+        OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_ALLOCATION_FAILURE;
+
+    if (bucketStarts && order && bucketsBySize && positions)
+    {
+        memset(bucketStarts, 0, (numBuckets + 1) * sizeof(size_t));
+        memset(positions, 0, numElements * sizeof(size_t));
+
+        status = octaspire_static_map_private_place_buckets(
+            self,
+            keys,
+            hashes,
+            bucketStarts,
+            order,
+            bucketsBySize,
+            positions,
+            indices);
+    }
+
+    octaspire_allocator_free(self->allocator, positions);
+    octaspire_allocator_free(self->allocator, bucketsBySize);
+    octaspire_allocator_free(self->allocator, order);
+    octaspire_allocator_free(self->allocator, bucketStarts);
+
+    return status;
+}
+
+// Copies the keys and values in the order of their positions
+static bool octaspire_static_map_private_copy_elements(
+    octaspire_static_map_t * const self,
+    octaspire_vector_t const * const keys,
+    octaspire_vector_t const * const values,
+    size_t const * const indices)
+{
+    size_t const numElements = self->tables.numElements;
+
+    size_t numKeyOctets = 0;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        numKeyOctets += octaspire_string_get_length_in_octets(
+            octaspire_vector_get_element_at_const(keys, (ptrdiff_t)i)) + 1;
+    }
+
+    self->keyOctets = octaspire_allocator_malloc(self->allocator, numKeyOctets);
+
+    if (!self->keyOctets)
+    {
+        return false;
+    }
+
+    size_t offset = 0;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        octaspire_string_t const * const key =
+            octaspire_vector_get_element_at_const(keys, (ptrdiff_t)indices[i]);
+
+        size_t const lengthInOctets = octaspire_string_get_length_in_octets(key);
+
+        memcpy(
+            self->keyOctets + offset,
+            octaspire_string_get_c_string(key),
+            lengthInOctets);
+
+        self->keyOctets[offset + lengthInOctets] = '\0';
+
+        self->keys[i]               = self->keyOctets + offset;
+        self->keyLengthsInOctets[i] = lengthInOctets;
+
+        offset += lengthInOctets + 1;
+    }
+
+    if (!values)
+    {
+        return true;
+    }
+
+    size_t const valueSizeInOctets = self->tables.valueSizeInOctets;
+
+    self->values = octaspire_allocator_malloc(
+        self->allocator,
+        numElements * valueSizeInOctets);
+
+    if (!self->values)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        memcpy(
+            self->values + i * valueSizeInOctets,
+            octaspire_vector_get_raw_data_for_element_at_const(
+                values,
+                (ptrdiff_t)indices[i]),
+            valueSizeInOctets);
+    }
+
+    return true;
+}
+
+octaspire_static_map_t *octaspire_static_map_new(
+    octaspire_vector_t const * const keys,
+    octaspire_vector_t const * const values,
+    octaspire_allocator_t *allocator)
+{
+    size_t const numElements = octaspire_vector_get_length(keys);
+
+    if (values && octaspire_vector_get_length(values) != numElements)
+    {
+        return 0;
+    }
+
+    octaspire_static_map_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_static_map_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->allocator          = allocator;
+    self->pilots             = 0;
+    self->keys               = 0;
+    self->keyLengthsInOctets = 0;
+    self->keyOctets          = 0;
+    self->values             = 0;
+
+    memset(self->seed, 0, sizeof(self->seed));
+
+    self->tables.numElements = numElements;
+
+    self->tables.numBuckets = numElements ?
+        ((numElements + OCTASPIRE_STATIC_MAP_PRIVATE_KEYS_PER_BUCKET - 1) /
+            OCTASPIRE_STATIC_MAP_PRIVATE_KEYS_PER_BUCKET) :
+        1;
+
+    self->tables.valueSizeInOctets =
+        values ? octaspire_vector_get_element_size_in_octets(values) : 0;
+
+    self->pilots = octaspire_allocator_malloc(
+        self->allocator,
+        self->tables.numBuckets * sizeof(uint32_t));
+
+    if (!self->pilots)
+    {
+        octaspire_static_map_release(self);
+        self = 0;
+        return 0;
+    }
+
+    if (numElements)
+    {
+        self->keys = octaspire_allocator_malloc(
+            self->allocator,
+            numElements * sizeof(char*));
+
+        self->keyLengthsInOctets = octaspire_allocator_malloc(
+            self->allocator,
+            numElements * sizeof(size_t));
+
+        uint64_t * const hashes = octaspire_allocator_malloc(
+            self->allocator,
+            numElements * sizeof(uint64_t));
+
+        size_t * const indices = octaspire_allocator_malloc(
+            self->allocator,
+            numElements * sizeof(size_t));
+
+        octaspire_static_map_private_status_t status =
+            OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_ALLOCATION_FAILURE;
+
+        if (self->keys && self->keyLengthsInOctets && hashes && indices)
+        {
+            status = OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_TRY_NEXT_SEED;
+        }
+
+        // Seeds are tried in a fixed order to keep builds deterministic
+        for (size_t attempt = 0;
+             attempt < OCTASPIRE_STATIC_MAP_PRIVATE_MAX_NUM_ATTEMPTS &&
+             status == OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_TRY_NEXT_SEED;
+             ++attempt)
+        {
+            memset(self->seed, 0, sizeof(self->seed));
+            self->seed[0] = (uint8_t)attempt;
+
+            for (size_t i = 0; i < numElements; ++i)
+            {
+                hashes[i] = octaspire_static_map_private_get_hash(
+                    octaspire_vector_get_element_at_const(keys, (ptrdiff_t)i),
+                    self->seed);
+            }
+
+            memset(self->pilots, 0, self->tables.numBuckets * sizeof(uint32_t));
+
+            status =
+                octaspire_static_map_private_find_pilots(self, keys, hashes, indices);
+        }
+
+        bool const isCopied =
+            status == OCTASPIRE_STATIC_MAP_PRIVATE_STATUS_OK &&
+            octaspire_static_map_private_copy_elements(self, keys, values, indices);
+
+        octaspire_allocator_free(self->allocator, indices);
+        octaspire_allocator_free(self->allocator, hashes);
+
+        if (!isCopied)
+        {
+            octaspire_static_map_release(self);
+            self = 0;
+            return 0;
+        }
+    }
+
+    self->tables.seed               = self->seed;
+    self->tables.pilots             = self->pilots;
+    self->tables.keys               = (char const * const *)self->keys;
+    self->tables.keyLengthsInOctets = self->keyLengthsInOctets;
+    self->tables.values             = self->values;
+
+    return self;
+}
+
+void octaspire_static_map_release(octaspire_static_map_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    octaspire_allocator_free(self->allocator, self->values);
+    self->values = 0;
+
+    octaspire_allocator_free(self->allocator, self->keyOctets);
+    self->keyOctets = 0;
+
+    octaspire_allocator_free(self->allocator, self->keyLengthsInOctets);
+    self->keyLengthsInOctets = 0;
+
+    octaspire_allocator_free(self->allocator, self->keys);
+    self->keys = 0;
+
+    octaspire_allocator_free(self->allocator, self->pilots);
+    self->pilots = 0;
+
+    octaspire_allocator_free(self->allocator, self);
+}
+
+ptrdiff_t octaspire_static_map_tables_get_index(
+    octaspire_static_map_tables_t const * const self,
+    void const * const key,
+    size_t const keyLengthInOctets)
+{
+    assert(self);
+
+    if (!self->numElements)
+    {
+        return -1;
+    }
+
+    uint64_t const hash =
+        octaspire_helpers_calculate_siphash13(key, keyLengthInOctets, self->seed);
+
+    size_t const index = octaspire_static_map_private_get_position(
+        hash,
+        self->pilots[octaspire_static_map_private_get_bucket(hash, self->numBuckets)],
+        self->numElements);
+
+    if (self->keyLengthsInOctets[index] != keyLengthInOctets ||
+        (keyLengthInOctets && memcmp(self->keys[index], key, keyLengthInOctets) != 0))
+    {
+        return -1;
+    }
+
+    return (ptrdiff_t)index;
+}
+
+void const *octaspire_static_map_tables_get_value_const(
+    octaspire_static_map_tables_t const * const self,
+    void const * const key,
+    size_t const keyLengthInOctets)
+{
+    ptrdiff_t const index =
+        octaspire_static_map_tables_get_index(self, key, keyLengthInOctets);
+
+    if (index < 0 || !self->values)
+    {
+        return 0;
+    }
+
+    return self->values + (size_t)index * self->valueSizeInOctets;
+}
+
+size_t octaspire_static_map_get_number_of_elements(
+    octaspire_static_map_t const * const self)
+{
+    return self->tables.numElements;
+}
+
+octaspire_static_map_tables_t const *octaspire_static_map_get_tables(
+    octaspire_static_map_t const * const self)
+{
+    return &(self->tables);
+}
+
+ptrdiff_t octaspire_static_map_get_index(
+    octaspire_static_map_t const * const self,
+    octaspire_string_t const * const key)
+{
+    return octaspire_static_map_tables_get_index(
+        &(self->tables),
+        octaspire_string_get_c_string(key),
+        octaspire_string_get_length_in_octets(key));
+}
+
+void const *octaspire_static_map_get_value_const(
+    octaspire_static_map_t const * const self,
+    octaspire_string_t const * const key)
+{
+    return octaspire_static_map_tables_get_value_const(
+        &(self->tables),
+        octaspire_string_get_c_string(key),
+        octaspire_string_get_length_in_octets(key));
+}
+
+// Appends 'count' numbers, 'NUMBERS_PER_LINE' to a line, as the body
+// of an array initializer.
+static bool octaspire_static_map_private_append_numbers(
+    octaspire_string_t * const output,
+    size_t const count,
+    unsigned long (*getNumber)(void const * const context, size_t const index),
+    void const * const context)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        bool const isFirstOnLine =
+            (i % OCTASPIRE_STATIC_MAP_PRIVATE_NUMBERS_PER_LINE) == 0;
+
+        bool const isLastOnLine =
+            (i + 1) == count ||
+            ((i + 1) % OCTASPIRE_STATIC_MAP_PRIVATE_NUMBERS_PER_LINE) == 0;
+
+        if (!octaspire_string_concatenate_format(
+                output,
+                "%s%lu%s",
+                isFirstOnLine ? "    " : " ",
+                getNumber(context, i),
+                isLastOnLine ? ",\n" : ","))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static unsigned long octaspire_static_map_private_get_seed_octet(
+    void const * const context,
+    size_t const index)
+{
+    return ((octaspire_static_map_tables_t const *)context)->seed[index];
+}
+
+static unsigned long octaspire_static_map_private_get_pilot(
+    void const * const context,
+    size_t const index)
+{
+    return ((octaspire_static_map_tables_t const *)context)->pilots[index];
+}
+
+static unsigned long octaspire_static_map_private_get_key_length(
+    void const * const context,
+    size_t const index)
+{
+    return (unsigned long)
+        ((octaspire_static_map_tables_t const *)context)->keyLengthsInOctets[index];
+}
+
+static unsigned long octaspire_static_map_private_get_value_octet(
+    void const * const context,
+    size_t const index)
+{
+    return ((octaspire_static_map_tables_t const *)context)->values[index];
+}
+
+// Appends the key as a string literal. Octal escapes are used for
+// everything but letters, digits and spaces, because they cannot run
+// into the following characters.
+static bool octaspire_static_map_private_append_key(
+    octaspire_string_t * const output,
+    char const * const key,
+    size_t const lengthInOctets)
+{
+    char chunk[4 * 32 + 1];
+
+    if (!octaspire_string_concatenate_c_string(output, "    \""))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < lengthInOctets;)
+    {
+        size_t chunkLength = 0;
+
+        for (size_t j = 0;
+             j < OCTASPIRE_STATIC_MAP_PRIVATE_OCTETS_PER_CHUNK && i < lengthInOctets;
+             ++j, ++i)
+        {
+            unsigned char const c = (unsigned char)key[i];
+
+            if ((c >= 'a' && c <= 'z') ||
+                (c >= 'A' && c <= 'Z') ||
+                (c >= '0' && c <= '9') ||
+                c == ' ' || c == '_' || c == '-' || c == '.')
+            {
+                chunk[chunkLength++] = (char)c;
+            }
+            else
+            {
+                chunkLength += (size_t)sprintf(chunk + chunkLength, "\\%03o", c);
+            }
+        }
+
+        chunk[chunkLength] = '\0';
+
+        if (!octaspire_string_concatenate_c_string(output, chunk))
+        {
+            return false;
+        }
+    }
+
+    return octaspire_string_concatenate_c_string(output, "\",\n");
+}
+
+octaspire_string_t *octaspire_static_map_to_c_source(
+    octaspire_static_map_t const * const self,
+    char const * const name,
+    octaspire_allocator_t *allocator)
+{
+    octaspire_static_map_tables_t const * const tables = &(self->tables);
+
+    octaspire_string_t *output = octaspire_string_new_format(
+        allocator,
+        "// Generated by octaspire_static_map_to_c_source\n"
+        "static uint8_t const %s_seed[%zu] =\n{\n",
+        name,
+        sizeof(self->seed));
+
+    bool isOk = output &&
+        octaspire_static_map_private_append_numbers(
+            output,
+            sizeof(self->seed),
+            octaspire_static_map_private_get_seed_octet,
+            tables) &&
+        octaspire_string_concatenate_format(
+            output,
+            "};\n\nstatic uint32_t const %s_pilots[%zu] =\n{\n",
+            name,
+            tables->numBuckets) &&
+        octaspire_static_map_private_append_numbers(
+            output,
+            tables->numBuckets,
+            octaspire_static_map_private_get_pilot,
+            tables) &&
+        octaspire_string_concatenate_c_string(output, "};\n\n");
+
+    // Arrays cannot be empty, so an empty map has only the seed and pilots
+    if (isOk && tables->numElements)
+    {
+        isOk = octaspire_string_concatenate_format(
+            output,
+            "static char const * const %s_keys[%zu] =\n{\n",
+            name,
+            tables->numElements);
+
+        for (size_t i = 0; isOk && i < tables->numElements; ++i)
+        {
+            isOk = octaspire_static_map_private_append_key(
+                output,
+                tables->keys[i],
+                tables->keyLengthsInOctets[i]);
+        }
+
+        isOk = isOk &&
+            octaspire_string_concatenate_format(
+                output,
+                "};\n\nstatic size_t const %s_key_lengths[%zu] =\n{\n",
+                name,
+                tables->numElements) &&
+            octaspire_static_map_private_append_numbers(
+                output,
+                tables->numElements,
+                octaspire_static_map_private_get_key_length,
+                tables) &&
+            octaspire_string_concatenate_c_string(output, "};\n\n");
+
+        if (isOk && tables->values)
+        {
+            size_t const numValueOctets =
+                tables->numElements * tables->valueSizeInOctets;
+
+            isOk =
+                octaspire_string_concatenate_format(
+                    output,
+                    "static uint8_t const %s_values[%zu] =\n{\n",
+                    name,
+                    numValueOctets) &&
+                octaspire_static_map_private_append_numbers(
+                    output,
+                    numValueOctets,
+                    octaspire_static_map_private_get_value_octet,
+                    tables) &&
+                octaspire_string_concatenate_c_string(output, "};\n\n");
+        }
+    }
+
+    char const * const arrayPrefix = tables->numElements ? name : "";
+
+    isOk = isOk &&
+        octaspire_string_concatenate_format(
+            output,
+            "static octaspire_static_map_tables_t const %s =\n{\n"
+            "    %zu,\n"
+            "    %zu,\n"
+            "    %zu,\n"
+            "    %s_seed,\n"
+            "    %s_pilots,\n"
+            "    %s%s,\n"
+            "    %s%s,\n"
+            "    %s%s\n"
+            "};\n",
+            name,
+            tables->numElements,
+            tables->numBuckets,
+            tables->valueSizeInOctets,
+            name,
+            name,
+            arrayPrefix,
+            tables->numElements ? "_keys" : "0",
+            arrayPrefix,
+            tables->numElements ? "_key_lengths" : "0",
+            (tables->numElements && tables->values) ? name : "",
+            (tables->numElements && tables->values) ? "_values" : "0");
+
+    if (!isOk)
+    {
+        octaspire_string_release(output);
+        output = 0;
+        return 0;
+    }
+
+    return output;
+}
+
@@ -23,6 +23,7 @@ limitations under the License.
 #include <string.h>
 #include "external/jenkins_one_at_a_time.h"
 #include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string_view.h"
 #include "octaspire/core/octaspire_utf8.h"
 #include "octaspire/core/octaspire_helpers.h"
 
@@ -37,6 +38,13 @@ struct octaspire_string_t
 
 static char const octaspire_string_private_null_octet = '\0';
 
+enum
+{
+    OCTASPIRE_STRING_PRIVATE_DECODE_BLOCK_LENGTH = 256,
+    OCTASPIRE_STRING_PRIVATE_ENCODE_BLOCK_LENGTH = 1024,
+    OCTASPIRE_STRING_PRIVATE_FORMAT_BUFFER_LENGTH = 256
+};
+
 
 // Prototypes for private functions /////////////////////////////////////////
 static bool octaspire_string_private_check_substring_match_at(
@@ -44,16 +52,27 @@ static bool octaspire_string_private_check_substring_match_at(
     size_t const startFromIndex,
     octaspire_string_t const * const substring);
 
-static bool octaspire_string_private_is_string_at_index(
+static size_t octaspire_string_private_get_octet_index_of_ucs_index(
     octaspire_string_t const * const self,
-    size_t const selfIndex,
-    octaspire_string_t const * const str,
-    size_t const strFirstIndex,
-    size_t const strLastIndex);
+    size_t const ucsIndex);
 
 static bool octaspire_string_private_ensure_octets_are_up_to_date(
     octaspire_string_t const * const self);
 
+static bool octaspire_string_private_append_buffer(
+    octaspire_string_t * const self,
+    char const * const buffer,
+    size_t const lengthInOctets);
+
+static char *octaspire_string_private_vformat(
+    octaspire_allocator_t * const allocator,
+    char * const stackBuffer,
+    size_t const stackBufferLength,
+    size_t * const lengthInOctets,
+    bool * const isEncodingError,
+    char const * const fmt,
+    va_list arguments);
+
 //////////////////////////////////////////////////////////////////////////////
 
 
@@ -82,13 +101,15 @@ octaspire_string_t *octaspire_string_new_from_buffer(
 
     self->allocator        = allocator;
 
-    // We cannot know how many actual UCS characters there are in buffer, because
-    // characters can be encoded between one and four octets. To speed up allocation,
-    // without allocating too much space, we preallocate lengthInOctets / 4 characters.
+    // Every octet that is not a continuation octet starts a character, so
+    // counting them gives the number of characters in valid UTF-8, and the
+    // vector needs not to grow while decoding.
     self->ucsCharacters    = octaspire_vector_new_with_preallocated_elements(
         sizeof(uint32_t),
         false,
-        lengthInOctets / 4,
+        buffer ? octaspire_utf8_count_ucs_characters(
+            buffer,
+            lengthInOctets) : 0,
         0,
         self->allocator);
 
@@ -109,150 +130,106 @@ octaspire_string_t *octaspire_string_new_from_buffer(
 
     self->errorAtOctet = 0;
 
-    if (buffer && lengthInOctets)
+    if (buffer && !octaspire_string_private_append_buffer(self, buffer, lengthInOctets))
     {
-        size_t index = 0;
-        uint32_t ucsChar = 0;
-        int numOctets = 0;
-        while (index < lengthInOctets)
-        {
-            // TODO XXX is (lengthInOctets - index) correct?
-            octaspire_utf8_decode_status_t const status = octaspire_utf8_decode_character(
-                buffer + index,
-                (lengthInOctets - index),
-                &ucsChar,
-                &numOctets);
-
-            if (status != OCTASPIRE_UTF8_DECODE_STATUS_OK)
-            {
-                self->errorStatus  = OCTASPIRE_STRING_ERROR_STATUS_DECODING_ERROR;
-                self->errorAtOctet = index;
-                break;
-            }
-
-            if (numOctets > 0)
-            {
-                if (!octaspire_vector_push_back_element(self->ucsCharacters, &ucsChar))
-                {
-                    octaspire_string_release(self);
-                    self = 0;
-                    return 0;
-                }
-
-                index += (size_t)numOctets;
-            }
-        }
+        octaspire_string_release(self);
+        self = 0;
+        return 0;
     }
 
     return self;
 }
 
-octaspire_string_t *octaspire_string_new_format(
-    octaspire_allocator_t *allocator,
-    char const * const fmt,
-    ...)
-{
-    va_list arguments;
-    va_start(arguments, fmt);
-
-    octaspire_string_t *result =
-        octaspire_string_new_vformat(allocator, fmt, arguments);
-
-    va_end(arguments);
-
-    return result;
-}
-
-octaspire_string_t *octaspire_string_new_vformat(
-    octaspire_allocator_t *allocator,
-    char const * const fmt,
-    va_list arguments)
+bool octaspire_string_private_append_buffer(
+    octaspire_string_t * const self,
+    char const * const buffer,
+    size_t const lengthInOctets)
 {
-    va_list copyOfVarArgs;
-    va_copy(copyOfVarArgs, arguments);
-
-    octaspire_string_error_status_t errorStatus =
-        OCTASPIRE_STRING_ERROR_STATUS_OK;
+    // Decoded in blocks, so that a block of characters at a time is
+    // appended to the vector.
+    uint32_t decoded[OCTASPIRE_STRING_PRIVATE_DECODE_BLOCK_LENGTH];
 
-    size_t                                         errorAtOctet = 0;
-
-    octaspire_string_t *self =
-        octaspire_allocator_malloc(allocator, sizeof(octaspire_string_t));
+    size_t index = 0;
 
-    if (!self)
+    while (index < lengthInOctets)
     {
-        va_end(copyOfVarArgs);
-        return self;
-    }
+        size_t blockLength = octaspire_helpers_min_size_t(
+            lengthInOctets - index,
+            OCTASPIRE_STRING_PRIVATE_DECODE_BLOCK_LENGTH);
 
-    self->allocator        = allocator;
+        // Do not split a character between two blocks
+        for (size_t i = 0;
+             i < 3 &&
+             index + blockLength < lengthInOctets &&
+             ((uint8_t)buffer[index + blockLength] & 0xC0) == 0x80;
+             ++i)
+        {
+            --blockLength;
+        }
 
-    assert(self->allocator);
+        size_t numOctets = 0;
+        size_t numUcsCharacters = 0;
 
-    self->octets = octaspire_vector_new(
-        sizeof(char),
-        false,
-        0,
-        self->allocator);
+        octaspire_utf8_decode_status_t const status = octaspire_utf8_decode_buffer(
+            buffer + index,
+            blockLength,
+            decoded,
+            &numOctets,
+            &numUcsCharacters);
 
-    self->ucsCharacters     = octaspire_vector_new(sizeof(uint32_t), false, 0, self->allocator);
+        if (numUcsCharacters &&
+            !octaspire_vector_push_back_elements(
+                self->ucsCharacters,
+                decoded,
+                numUcsCharacters))
+        {
+            return false;
+        }
 
-    octaspire_string_reset_error_status(self);
+        index += numOctets;
 
-    size_t buflen = 8;
-    char *buffer = octaspire_allocator_malloc(allocator, buflen);
-    assert(buffer);
+        if (status != OCTASPIRE_UTF8_DECODE_STATUS_OK)
+        {
+            self->errorStatus  = OCTASPIRE_STRING_ERROR_STATUS_DECODING_ERROR;
+            self->errorAtOctet = index;
+            break;
+        }
+    }
 
-    octaspire_vector_t *vec2 = octaspire_vector_new(
-        sizeof(char),
-        false,
-        0,
-        allocator);
+    return true;
+}
 
-    assert(vec2);
+// Formats into 'stackBuffer' when the result fits there, and otherwise
+// into a buffer of the size that the first vsnprintf reported. The
+// returned buffer must be freed by the caller if it is not 'stackBuffer'.
+// Returns 0 on allocation failure, or when vsnprintf fails, in which case
+// 'isEncodingError' is set.
+char *octaspire_string_private_vformat(
+    octaspire_allocator_t * const allocator,
+    char * const stackBuffer,
+    size_t const stackBufferLength,
+    size_t * const lengthInOctets,
+    bool * const isEncodingError,
+    char const * const fmt,
+    va_list arguments)
+{
+    char *buffer = stackBuffer;
+    size_t buflen = stackBufferLength;
 
-    int negativeResultCounter = -1;
+    *lengthInOctets  = 0;
+    *isEncodingError = false;
 
-    bool firstRound = true;
     while (true)
     {
-        if (negativeResultCounter > 1000)
-        {
-            errorStatus = OCTASPIRE_STRING_ERROR_STATUS_ENCODING_ERROR;
-            // TODO XXX what octet index to put here? Negative index, or just unused on this error type?
-            errorAtOctet = 0;
-            break;
-        }
-
-        int n = 0;
-
-        if (firstRound)
-        {
-            firstRound = false;
-        }
-        else
-        {
-            va_copy(copyOfVarArgs, arguments);
-        }
+        va_list copyOfVarArgs;
+        va_copy(copyOfVarArgs, arguments);
 
 #ifdef OCTASPIRE_CLANG_PRAGMAS_ENABLED
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wformat-nonliteral"
 #endif
 
-    #ifdef OCTASPIRE_PLAN9_IMPLEMENTATION
-        n = vsnprintf(
-            buffer,
-            buflen - 1,
-            fmt,
-            copyOfVarArgs);
-    #else
-        n = vsnprintf(
-            buffer,
-            buflen,
-            fmt,
-            copyOfVarArgs);
-    #endif
+        int const n = vsnprintf(buffer, buflen, fmt, copyOfVarArgs);
 
 #ifdef OCTASPIRE_CLANG_PRAGMAS_ENABLED
 #pragma clang diagnostic pop
@@ -262,107 +239,76 @@ octaspire_string_t *octaspire_string_new_vformat(
 
         if (n < 0)
         {
-            // Encoding error in C99 or, on older glibc, the output was truncated.
-            // Try again with more space. Because we don't know how much
-            // space is required, lets double it (and make sure that the length is not zero).
-            // Because we don't know is the reason for failure an encoding error or missing space,
-            // we will start counting to prevent looping forever.
-            ++negativeResultCounter;
-
-            buflen *= 2;
-            char *tmpPtr = octaspire_allocator_realloc(allocator, buffer, buflen);
-            //char *tmpPtr = realloc(buffer, buflen);
-
-            if (tmpPtr)
-            {
-                buffer = tmpPtr;
-                memset(buffer, 0, buflen);
-            }
-            else
-            {
-                octaspire_allocator_free(allocator, buffer);
-                buffer = 0;
-                return 0;
-            }
+            *isEncodingError = true;
+            break;
         }
-        else if ((size_t)n >= buflen)
-        {
-            // TODO calculate exact size
-
-            buflen *= 2;
-            char *tmpPtr = octaspire_allocator_realloc(allocator, buffer, buflen);
-            //char *tmpPtr = realloc(buffer, buflen);
 
-            if (tmpPtr)
-            {
-                buffer = tmpPtr;
-                memset(buffer, 0, buflen);
-            }
-            else
-            {
-                octaspire_allocator_free(allocator, buffer);
-                buffer = 0;
-                return 0;
-            }
-        }
-        else if (n > 0)
+        // Leaving one octet unused tells a complete result apart from a
+        // truncated one also with vsnprintf that returns the number of
+        // octets written (like on Plan 9) instead of the number needed.
+        if ((size_t)n + 1 < buflen)
         {
-            assert((size_t)n < buflen);
-            // Success
-            for (size_t i = 0; i < (size_t)n; ++i)
-            {
-                char const c = buffer[i];
+            *lengthInOctets = (size_t)n;
+            return buffer;
+        }
 
-                octaspire_vector_push_back_element(vec2, &c);
-            }
+        if (buffer != stackBuffer)
+        {
+            octaspire_allocator_free(allocator, buffer);
+        }
 
-            if (!octaspire_vector_push_back_char(
-                    vec2,
-                    octaspire_string_private_null_octet))
-            {
-                abort();
-            }
+        buflen = octaspire_helpers_max_size_t(buflen * 2, (size_t)n + 2);
+        buffer = octaspire_allocator_malloc(allocator, buflen);
 
-            break;
-        }
-        else
+        if (!buffer)
         {
-            // Empty string
-            break;
-            //assert(false);
+            return 0;
         }
     }
 
-    //assert(!octaspire_vector_is_empty(vec2));
-
-    if (!octaspire_vector_push_back_char(vec2, octaspire_string_private_null_octet))
+    if (buffer != stackBuffer)
     {
-        abort();
+        octaspire_allocator_free(allocator, buffer);
     }
 
-    octaspire_string_t *tmpStr = octaspire_string_new(
-        octaspire_vector_get_element_at(vec2, 0),
-        allocator);
+    return 0;
+}
+
+octaspire_string_t *octaspire_string_new_format(
+    octaspire_allocator_t *allocator,
+    char const * const fmt,
+    ...)
+{
+    va_list arguments;
+    va_start(arguments, fmt);
+
+    octaspire_string_t *result =
+        octaspire_string_new_vformat(allocator, fmt, arguments);
 
-    octaspire_string_release(self);
-    self = tmpStr;
+    va_end(arguments);
 
-    assert(self);
+    return result;
+}
+
+octaspire_string_t *octaspire_string_new_vformat(
+    octaspire_allocator_t *allocator,
+    char const * const fmt,
+    va_list arguments)
+{
+    octaspire_string_t *self = octaspire_string_new_from_buffer(0, 0, allocator);
 
-    if (!octaspire_string_is_error(self))
+    if (!self)
     {
-        if (errorStatus != OCTASPIRE_STRING_ERROR_STATUS_OK)
-        {
-            self->errorStatus  = errorStatus;
-            self->errorAtOctet = errorAtOctet;
-        }
+        return 0;
     }
 
-    octaspire_allocator_free(allocator, buffer);
-    buffer = 0;
-
-    octaspire_vector_release(vec2);
-    vec2 = 0;
+    if (!octaspire_string_concatenate_vformat(self, fmt, arguments) &&
+        self->errorStatus != OCTASPIRE_STRING_ERROR_STATUS_ENCODING_ERROR)
+    {
+        octaspire_string_release(self);
+        self = 0;
+        return 0;
+    }
 
     return self;
 }
@@ -651,36 +597,7 @@ bool octaspire_string_concatenate_c_string(
         return false;
     }
 
-    size_t const strLen = strlen(str);
-
-    bool result = true;
-
-    size_t index = 0;
-    uint32_t ucsChar = 0;
-    int numOctets = 0;
-    while (str[index] != '\0')
-    {
-        octaspire_utf8_decode_status_t status =
-            octaspire_utf8_decode_character(str + index, (strLen - index), &ucsChar, &numOctets);
-
-        assert(numOctets >= 0);
-
-        if (status != OCTASPIRE_UTF8_DECODE_STATUS_OK)
-        {
-            self->errorStatus  = OCTASPIRE_STRING_ERROR_STATUS_DECODING_ERROR;
-            self->errorAtOctet = index;
-            break;
-        }
-
-        if (!octaspire_vector_push_back_element(self->ucsCharacters, &ucsChar))
-        {
-            result = false;
-        }
-
-        index += (size_t)numOctets;
-    }
-
-    return result;
+    return octaspire_string_private_append_buffer(self, str, strlen(str));
 }
 
 bool octaspire_string_concatenate_format(
@@ -691,27 +608,59 @@ bool octaspire_string_concatenate_format(
     va_list arguments;
     va_start(arguments, fmt);
 
-    octaspire_string_t *str =
-        octaspire_string_new_vformat(self->allocator, fmt, arguments);
+    bool const result =
+        octaspire_string_concatenate_vformat(self, fmt, arguments);
 
     va_end(arguments);
 
-    if (!str)
+    return result;
+}
+
+bool octaspire_string_concatenate_vformat(
+    octaspire_string_t * const self,
+    char const * const fmt,
+    va_list arguments)
+{
+    octaspire_string_reset_error_status(self);
+
+    char stackBuffer[OCTASPIRE_STRING_PRIVATE_FORMAT_BUFFER_LENGTH];
+    size_t lengthInOctets = 0;
+    bool isEncodingError = false;
+
+    char * const buffer = octaspire_string_private_vformat(
+        self->allocator,
+        stackBuffer,
+        sizeof(stackBuffer),
+        &lengthInOctets,
+        &isEncodingError,
+        fmt,
+        arguments);
+
+    if (!buffer)
     {
+        if (isEncodingError)
+        {
+            self->errorStatus  = OCTASPIRE_STRING_ERROR_STATUS_ENCODING_ERROR;
+            self->errorAtOctet = 0;
+        }
+
         return false;
     }
 
-    if (!octaspire_vector_clear(self->octets))
+    bool result = octaspire_vector_clear(self->octets);
+
+    if (result)
     {
-        return false;
+        result = octaspire_string_private_append_buffer(
+            self,
+            buffer,
+            lengthInOctets);
     }
 
-    bool result = octaspire_string_concatenate_c_string(
-        self,
-        octaspire_string_get_c_string(str));
-
-    octaspire_string_release(str);
-    str = 0;
+    if (buffer != stackBuffer)
+    {
+        octaspire_allocator_free(self->allocator, buffer);
+    }
 
     return result;
 }
@@ -726,25 +675,22 @@ bool octaspire_string_private_check_substring_match_at(
     size_t const substringLength =
         octaspire_string_get_length_in_ucs_characters(substring);
 
-    for (size_t i = 0; i < substringLength; ++i)
+    if (startFromIndex > selfLength || substringLength > selfLength - startFromIndex)
     {
-        if ((startFromIndex + i) >= selfLength)
-        {
-            return false;
-        }
+        return false;
+    }
 
-        if (octaspire_string_get_ucs_character_at_index(
-                self,
-                (ptrdiff_t)(startFromIndex + i)) !=
-            octaspire_string_get_ucs_character_at_index(
-                substring,
-                (ptrdiff_t)i))
-        {
-            return false;
-        }
+    if (!substringLength)
+    {
+        return true;
     }
 
-    return true;
+    return memcmp(
+        octaspire_vector_get_element_at_const(
+            self->ucsCharacters,
+            (ptrdiff_t)startFromIndex),
+        octaspire_vector_get_element_at_const(substring->ucsCharacters, 0),
+        substringLength * sizeof(uint32_t)) == 0;
 }
 
 ptrdiff_t octaspire_string_find_first_substring(
@@ -760,20 +706,33 @@ ptrdiff_t octaspire_string_find_first_substring(
         return -1;
     }
 
-    size_t const selfLength = octaspire_string_get_length_in_ucs_characters(self);
+    if (octaspire_string_is_empty(substring))
+    {
+        return (ptrdiff_t)realIndex.index;
+    }
+
+    // Search the UTF-8 octets and count the characters before the match
+    octaspire_string_view_t selfView;
+    octaspire_string_view_init_from_string(&selfView, self);
 
-    for (size_t i = realIndex.index; i < (realIndex.index + selfLength); ++i)
+    octaspire_string_view_t substringView;
+    octaspire_string_view_init_from_string(&substringView, substring);
+
+    size_t const startOctetIndex =
+        octaspire_string_private_get_octet_index_of_ucs_index(self, realIndex.index);
+
+    ptrdiff_t const octetIndex =
+        octaspire_string_view_find(&selfView, &substringView, startOctetIndex);
+
+    if (octetIndex < 0)
     {
-        if (octaspire_string_private_check_substring_match_at(
-                self,
-                i,
-                substring))
-        {
-            return (ptrdiff_t)i;
-        }
+        return -1;
     }
 
-    return -1;
+    return (ptrdiff_t)(realIndex.index +
+        octaspire_utf8_count_ucs_characters(
+            octaspire_string_view_get_octets(&selfView) + startOctetIndex,
+            (size_t)octetIndex - startOctetIndex));
 }
 
 bool octaspire_string_remove_character_at(
@@ -848,48 +807,120 @@ size_t octaspire_string_remove_all_substrings(
     octaspire_string_t * const self,
     octaspire_string_t const * const substring)
 {
-    if (!octaspire_vector_clear(self->octets))
+    size_t const selfLength = octaspire_string_get_length_in_ucs_characters(self);
+
+    size_t const substringLength =
+        octaspire_string_get_length_in_ucs_characters(substring);
+
+    if (!substringLength || substringLength > selfLength)
     {
-        abort();
+        return 0;
     }
 
-    size_t result = 0;
+    if (self == substring)
+    {
+        octaspire_helpers_verify_true(octaspire_string_clear(self));
+        return 1;
+    }
 
-    size_t const substringLength =
-        octaspire_string_get_length_in_ucs_characters(substring);
+    // Removing the first occurrence again and again, until there are none
+    // left, gives the same result as this single pass. The characters are
+    // moved down in place, and a Knuth-Morris-Pratt matcher tracks how much
+    // of the substring the kept characters end with. When they end with the
+    // whole substring, it is dropped and the matcher continues from the
+    // state it had before the dropped characters. 'failure' holds the KMP
+    // failure function and 'states' the matcher state after each kept
+    // character.
+    size_t * const failure = octaspire_allocator_malloc(
+        self->allocator,
+        (substringLength + selfLength + 1) * sizeof(size_t));
 
-    while (true)
+    if (!failure)
     {
-        if (octaspire_string_is_empty(self))
-        {
-            return result;
-        }
+        return 0;
+    }
+
+    size_t * const states = failure + substringLength;
+
+    uint32_t const * const pattern =
+        octaspire_vector_get_element_at_const(substring->ucsCharacters, 0);
 
-        ptrdiff_t const substringIndex =
-            octaspire_string_find_first_substring(self, 0, substring);
+    failure[0] = 0;
 
-        if (substringIndex < 0)
+    for (size_t i = 1, k = 0; i < substringLength; ++i)
+    {
+        while (k > 0 && pattern[i] != pattern[k])
         {
-            return result;
+            k = failure[k - 1];
         }
 
-        if (octaspire_string_remove_characters_at(
-            self,
-            substringIndex,
-            substringLength))
+        if (pattern[i] == pattern[k])
         {
-            ++result;
+            ++k;
         }
+
+        failure[i] = k;
     }
-}
 
-bool octaspire_string_clear(
-    octaspire_string_t * const self)
-{
-    self->errorStatus       = OCTASPIRE_STRING_ERROR_STATUS_OK;
-    self->errorAtOctet      = 0;
+    uint32_t * const characters =
+        octaspire_vector_get_element_at(self->ucsCharacters, 0);
 
-    if (!octaspire_vector_clear(self->octets))
+    size_t result    = 0;
+    size_t numKept   = 0;
+
+    states[0] = 0;
+
+    for (size_t i = 0; i < selfLength; ++i)
+    {
+        uint32_t const c = characters[i];
+        size_t k = states[numKept];
+
+        while (k > 0 && c != pattern[k])
+        {
+            k = failure[k - 1];
+        }
+
+        if (c == pattern[k])
+        {
+            ++k;
+        }
+
+        characters[numKept] = c;
+        ++numKept;
+        states[numKept] = k;
+
+        if (k == substringLength)
+        {
+            numKept -= substringLength;
+            ++result;
+        }
+    }
+
+    octaspire_allocator_free(self->allocator, failure);
+
+    if (!result)
+    {
+        return 0;
+    }
+
+    for (size_t i = numKept; i < selfLength; ++i)
+    {
+        octaspire_helpers_verify_true(
+            octaspire_vector_remove_element_at(self->ucsCharacters, -1));
+    }
+
+    octaspire_helpers_verify_true(octaspire_vector_clear(self->octets));
+
+    return result;
+}
+
+bool octaspire_string_clear(
+    octaspire_string_t * const self)
+{
+    self->errorStatus       = OCTASPIRE_STRING_ERROR_STATUS_OK;
+    self->errorAtOctet      = 0;
+
+    if (!octaspire_vector_clear(self->octets))
     {
         return false;
     }
@@ -911,26 +942,25 @@ bool octaspire_string_is_equal(
         return false;
     }
 
-    for (size_t i = 0; i < myLen; ++i)
+    if (myLen == 0 || self == other)
     {
-        uint32_t ucsChar1 =
-            *(uint32_t const * const)octaspire_vector_get_element_at(
-                self->ucsCharacters,
-                (ptrdiff_t)i);
-
-        uint32_t ucsChar2 =
-            *(uint32_t const * const)octaspire_vector_get_element_at(
-                other->ucsCharacters,
-                (ptrdiff_t)i);
-
-        if (ucsChar1 != ucsChar2)
-        {
-            return false;
-        }
+        return true;
+    }
 
+    // When both have their UTF-8 encoding at hand, strings with the same
+    // number of characters but of different size differ already there.
+    if (!octaspire_vector_is_empty(self->octets) &&
+        !octaspire_vector_is_empty(other->octets) &&
+        octaspire_vector_get_length(self->octets) !=
+            octaspire_vector_get_length(other->octets))
+    {
+        return false;
     }
 
-    return true;
+    return memcmp(
+        octaspire_vector_get_element_at_const(self->ucsCharacters, 0),
+        octaspire_vector_get_element_at_const(other->ucsCharacters, 0),
+        myLen * sizeof(uint32_t)) == 0;
 }
 
 bool octaspire_string_is_equal_to_c_string(
@@ -959,132 +989,243 @@ bool octaspire_string_is_equal_to_c_string(
     return memcmp(octaspire_vector_get_element_at(self->octets,  0), str, len) == 0;
 }
 
-static int octaspire_string_levenshtein_distance_helper_get_slot(
-    octaspire_vector_t const * const vectors,
-    size_t                     const i,
-    size_t                     const j)
+static size_t const OCTASPIRE_STRING_PRIVATE_LEVENSHTEIN_BIT_PARALLEL_MAX_LENGTH = 64;
+
+static size_t octaspire_string_private_levenshtein_distance_bit_parallel(
+    uint32_t const * const pattern,
+    size_t const patternLength,
+    uint32_t const * const text,
+    size_t const textLength,
+    size_t const maxDistance)
 {
-    octaspire_vector_t const * const row = octaspire_vector_get_element_at_const(
-        vectors,
-        i);
+    // Myers' bit-parallel algorithm in the formulation of Hyyro. Bit i of
+    // the vectors tells whether the difference between rows i and i+1 of
+    // the current column of the dynamic programming matrix is +1 (Pv) or
+    // -1 (Mv). The pattern has at most 64 characters, so a column fits in
+    // one word. Peq, the bit mask of the positions of every pattern
+    // character, is kept in a small open addressing table.
+    uint32_t keys[128];
+    uint64_t masks[128];
+    bool     isUsed[128];
 
-    int const * const result =
-        octaspire_vector_get_element_at_const(row, j);
+    memset(isUsed, 0, sizeof(isUsed));
 
-    octaspire_helpers_verify_not_null(result);
-    return *result;
-}
+    for (size_t i = 0; i < patternLength; ++i)
+    {
+        size_t slot = (size_t)((pattern[i] * 2654435761u) >> 25);
 
-static bool octaspire_string_levenshtein_distance_helper_set_slot(
-    octaspire_vector_t * const vectors,
-    size_t               const i,
-    size_t               const j,
-    int                  const slot)
-{
-    octaspire_vector_t * const row = octaspire_vector_get_element_at(
-        vectors,
-        i);
+        while (isUsed[slot] && keys[slot] != pattern[i])
+        {
+            slot = (slot + 1) & 127;
+        }
+
+        if (!isUsed[slot])
+        {
+            isUsed[slot] = true;
+            keys[slot]   = pattern[i];
+            masks[slot]  = 0;
+        }
 
-    return octaspire_vector_replace_element_at(row, j, &slot);
+        masks[slot] |= ((uint64_t)1 << i);
+    }
+
+    uint64_t const lastBit = (uint64_t)1 << (patternLength - 1);
+
+    uint64_t pv = ~(uint64_t)0;
+    uint64_t mv = 0;
+    size_t score = patternLength;
+
+    for (size_t j = 0; j < textLength; ++j)
+    {
+        size_t slot = (size_t)((text[j] * 2654435761u) >> 25);
+
+        while (isUsed[slot] && keys[slot] != text[j])
+        {
+            slot = (slot + 1) & 127;
+        }
+
+        uint64_t const eq = isUsed[slot] ? masks[slot] : 0;
+
+        uint64_t const xv = eq | mv;
+        uint64_t const xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if (ph & lastBit)
+        {
+            ++score;
+        }
+        else if (mh & lastBit)
+        {
+            --score;
+        }
+
+        ph = (ph << 1) | 1;
+        mh = mh << 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // Every remaining text character can lower the score by one at most
+        size_t const remaining = textLength - j - 1;
+
+        if (score > remaining && score - remaining > maxDistance)
+        {
+            return maxDistance + 1;
+        }
+    }
+
+    return score;
 }
 
-size_t octaspire_string_levenshtein_distance(
-    octaspire_string_t const * const self,
-    octaspire_string_t const * const other)
+static size_t octaspire_string_private_levenshtein_distance_two_rows(
+    uint32_t const * const shorter,
+    size_t const shorterLength,
+    uint32_t const * const longer,
+    size_t const longerLength,
+    size_t const maxDistance,
+    octaspire_allocator_t * const allocator)
 {
-    size_t const selfLen = octaspire_string_get_length_in_ucs_characters(self);
+    // Only the cells at most 'maxDistance' away from the diagonal can
+    // have a value of at most 'maxDistance', so only they are computed.
+    // Values above 'maxDistance' are kept as 'tooFar'.
+    size_t const tooFar = maxDistance + 1;
 
-    size_t const otherLen =
-        octaspire_string_get_length_in_ucs_characters(other);
+    size_t * const rows = octaspire_allocator_malloc(
+        allocator,
+        2 * (shorterLength + 1) * sizeof(size_t));
 
-    octaspire_vector_t * vectors = octaspire_vector_new(
-        sizeof(octaspire_vector_t *),
-        true,
-        (octaspire_vector_element_callback_t)octaspire_vector_release,
-        self->allocator);
+    octaspire_helpers_verify_not_null(rows);
 
-    // Create vector of vectors
+    size_t *previous = rows;
+    size_t *current  = rows + shorterLength + 1;
 
-    for (size_t i = 0; i < selfLen+1; ++i)
+    for (size_t j = 0; j <= shorterLength; ++j)
     {
-        octaspire_vector_t * row = octaspire_vector_new(
-            sizeof(int),
-            false,
-            0,
-            self->allocator);
+        previous[j] = octaspire_helpers_min_size_t(j, tooFar);
+    }
 
-        octaspire_vector_push_back_element(vectors, &row);
+    for (size_t i = 1; i <= longerLength; ++i)
+    {
+        size_t const first = (i > maxDistance) ? (i - maxDistance) : 1;
+
+        size_t const last = (maxDistance >= shorterLength - 1 ||
+                             i >= shorterLength - maxDistance)
+            ? shorterLength
+            : (i + maxDistance);
+
+        current[0] = octaspire_helpers_min_size_t(i, tooFar);
+        current[first - 1] = (first > 1) ? tooFar : current[0];
+
+        size_t rowMinimum = current[first - 1];
 
-        if (i == 0)
+        for (size_t j = first; j <= last; ++j)
         {
-            octaspire_vector_push_back_int(row, i);
+            size_t const cost = (shorter[j - 1] == longer[i - 1]) ? 0 : 1;
 
-            for (size_t j = 1; j < otherLen+1; ++j)
-            {
-                octaspire_vector_push_back_int(row, j);
-            }
+            size_t value = previous[j - 1] + cost;
+            value = octaspire_helpers_min_size_t(value, previous[j] + 1);
+            value = octaspire_helpers_min_size_t(value, current[j - 1] + 1);
+            value = octaspire_helpers_min_size_t(value, tooFar);
+
+            current[j] = value;
+            rowMinimum = octaspire_helpers_min_size_t(rowMinimum, value);
         }
-        else
+
+        if (last < shorterLength)
         {
-            octaspire_vector_push_back_int(row, i);
+            current[last + 1] = tooFar;
+        }
 
-            for (size_t j = 1; j < otherLen+1; ++j)
-            {
-                octaspire_vector_push_back_int(row, 0);
-            }
+        if (rowMinimum > maxDistance)
+        {
+            octaspire_allocator_free(allocator, rows);
+            return tooFar;
         }
+
+        size_t * const tmp = previous;
+        previous = current;
+        current  = tmp;
+    }
+
+    size_t const result = previous[shorterLength];
+
+    octaspire_allocator_free(allocator, rows);
+
+    return result;
+}
+
+size_t octaspire_string_levenshtein_distance(
+    octaspire_string_t const * const self,
+    octaspire_string_t const * const other)
+{
+    return octaspire_string_levenshtein_distance_bounded(
+        self,
+        other,
+        octaspire_helpers_max_size_t(
+            octaspire_string_get_length_in_ucs_characters(self),
+            octaspire_string_get_length_in_ucs_characters(other)));
+}
+
+size_t octaspire_string_levenshtein_distance_bounded(
+    octaspire_string_t const * const self,
+    octaspire_string_t const * const other,
+    size_t const maxDistance)
+{
+    octaspire_string_t const * shorter = self;
+    octaspire_string_t const * longer  = other;
+
+    if (octaspire_string_get_length_in_ucs_characters(shorter) >
+        octaspire_string_get_length_in_ucs_characters(longer))
+    {
+        shorter = other;
+        longer  = self;
     }
 
-    // Main loop.
+    size_t const shorterLength = octaspire_string_get_length_in_ucs_characters(shorter);
+    size_t const longerLength  = octaspire_string_get_length_in_ucs_characters(longer);
+
+    // The distance is never larger than the length of the longer string
+    size_t const bound = octaspire_helpers_min_size_t(maxDistance, longerLength);
 
-    for (size_t j = 1; j < otherLen+1; ++j)
+    if (longerLength - shorterLength > bound)
     {
-        for (size_t i = 1; i < selfLen+1; ++i)
-        {
-            if (octaspire_string_get_ucs_character_at_index(self, i-1) ==
-                octaspire_string_get_ucs_character_at_index(other, j-1))
-            {
-                octaspire_string_levenshtein_distance_helper_set_slot(
-                    vectors,
-                    i,
-                    j,
-                    octaspire_string_levenshtein_distance_helper_get_slot(
-                        vectors,
-                        i - 1,
-                        j - 1));
-            }
-            else
-            {
-                octaspire_string_levenshtein_distance_helper_set_slot(
-                    vectors,
-                    i,
-                    j,
-                    octaspire_helpers_min3_int(
-                        octaspire_string_levenshtein_distance_helper_get_slot(
-                            vectors,
-                            i - 1,
-                            j) + 1,      // deletion
-                        octaspire_string_levenshtein_distance_helper_get_slot(
-                            vectors,
-                            i,
-                            j - 1) + 1,  // insertion
-                        octaspire_string_levenshtein_distance_helper_get_slot(
-                            vectors,
-                            i - 1,
-                            j - 1) + 1)); // substitution
-            }
-        }
+        return bound + 1;
     }
 
-    int result = octaspire_string_levenshtein_distance_helper_get_slot(
-        vectors,
-        selfLen,
-        otherLen);
+    if (!shorterLength)
+    {
+        return longerLength;
+    }
 
-    octaspire_vector_release(vectors);
-    vectors = 0;
+    uint32_t const * const shorterCharacters =
+        octaspire_vector_get_element_at_const(shorter->ucsCharacters, 0);
 
-    return result;
+    uint32_t const * const longerCharacters =
+        octaspire_vector_get_element_at_const(longer->ucsCharacters, 0);
+
+    size_t result = 0;
+
+    if (shorterLength <= OCTASPIRE_STRING_PRIVATE_LEVENSHTEIN_BIT_PARALLEL_MAX_LENGTH)
+    {
+        result = octaspire_string_private_levenshtein_distance_bit_parallel(
+            shorterCharacters,
+            shorterLength,
+            longerCharacters,
+            longerLength,
+            bound);
+    }
+    else
+    {
+        result = octaspire_string_private_levenshtein_distance_two_rows(
+            shorterCharacters,
+            shorterLength,
+            longerCharacters,
+            longerLength,
+            bound,
+            self->allocator);
+    }
+
+    return octaspire_helpers_min_size_t(result, bound + 1);
 }
 
 int octaspire_string_compare(
@@ -1094,9 +1235,55 @@ int octaspire_string_compare(
     assert(self);
     assert(other);
 
-    return octaspire_string_compare_to_c_string(
-        self,
-        octaspire_string_get_c_string(other));
+    size_t const myLen = octaspire_string_get_length_in_ucs_characters(self);
+    size_t const otherLen = octaspire_string_get_length_in_ucs_characters(other);
+    size_t const minLen = octaspire_helpers_min_size_t(myLen, otherLen);
+
+    if (minLen > 0 && self != other)
+    {
+        // UTF-8 sorts like the UCS characters it encodes, so when both
+        // encodings are at hand one memcmp is enough. The terminating
+        // null octets are left out; they are not part of the strings.
+        if (!octaspire_vector_is_empty(self->octets) &&
+            !octaspire_vector_is_empty(other->octets))
+        {
+            size_t const myOctets = octaspire_vector_get_length(self->octets) - 1;
+            size_t const otherOctets = octaspire_vector_get_length(other->octets) - 1;
+
+            int const result = memcmp(
+                octaspire_vector_get_element_at_const(self->octets, 0),
+                octaspire_vector_get_element_at_const(other->octets, 0),
+                octaspire_helpers_min_size_t(myOctets, otherOctets));
+
+            if (result != 0)
+            {
+                return result;
+            }
+        }
+        else
+        {
+            uint32_t const * const myChars =
+                octaspire_vector_get_element_at_const(self->ucsCharacters, 0);
+
+            uint32_t const * const otherChars =
+                octaspire_vector_get_element_at_const(other->ucsCharacters, 0);
+
+            for (size_t i = 0; i < minLen; ++i)
+            {
+                if (myChars[i] != otherChars[i])
+                {
+                    return (myChars[i] < otherChars[i]) ? -1 : 1;
+                }
+            }
+        }
+    }
+
+    if (myLen == otherLen)
+    {
+        return 0;
+    }
+
+    return (myLen < otherLen) ? -1 : 1;
 }
 
 int octaspire_string_compare_to_c_string(
@@ -1132,20 +1319,7 @@ bool octaspire_string_starts_with(
         return false;
     }
 
-    for (size_t i = 0; i < otherLen; ++i)
-    {
-        if (octaspire_string_get_ucs_character_at_index(
-                self,
-                (ptrdiff_t)i) !=
-            octaspire_string_get_ucs_character_at_index(
-                other,
-                (ptrdiff_t)i))
-        {
-            return false;
-        }
-    }
-
-    return true;
+    return octaspire_string_private_check_substring_match_at(self, 0, other);
 }
 
 bool octaspire_string_starts_with_c_string(
@@ -1179,22 +1353,7 @@ bool octaspire_string_ends_with(
         return false;
     }
 
-    size_t const myStartIndex = myLen - otherLen;
-
-    for (size_t i = 0; i < otherLen; ++i)
-    {
-        if (octaspire_string_get_ucs_character_at_index(
-                self,
-                (ptrdiff_t)(myStartIndex + i)) !=
-            octaspire_string_get_ucs_character_at_index(
-                other,
-                (ptrdiff_t)i))
-        {
-            return false;
-        }
-    }
-
-    return true;
+    return octaspire_string_private_check_substring_match_at(self, myLen - otherLen, other);
 }
 
 bool octaspire_string_ends_with_c_string(
@@ -1239,6 +1398,16 @@ uint32_t octaspire_string_get_hash(
     return hash;
 }
 
+uint32_t octaspire_string_get_keyed_hash(
+    octaspire_string_t const * const self,
+    uint8_t const * const seed)
+{
+    return octaspire_helpers_calculate_keyed_hash_for_memory_buffer_argument(
+        octaspire_string_get_c_string(self),
+        octaspire_string_get_length_in_octets(self),
+        seed);
+}
+
 bool octaspire_string_push_back_ucs_character(
     octaspire_string_t *self,
     uint32_t const character)
@@ -1381,15 +1550,6 @@ octaspire_vector_t *octaspire_string_split(
     octaspire_string_t *self,
     char const * const delimiter)
 {
-    octaspire_string_t *delimString = octaspire_string_new(
-        delimiter,
-        self->allocator);
-
-    if (!delimString)
-    {
-        return 0;
-    }
-
     octaspire_vector_t *result = octaspire_vector_new(
         sizeof(octaspire_string_t*),
         true,
@@ -1398,108 +1558,42 @@ octaspire_vector_t *octaspire_string_split(
 
     if (!result)
     {
-        octaspire_string_release(delimString);
-        delimString = 0;
         return 0;
     }
 
-    octaspire_string_t *collectorString = octaspire_string_new(
-        "",
-        self->allocator);
+    octaspire_string_view_split_iterator_t iterator;
 
-    if (!collectorString)
-    {
-        octaspire_string_release(delimString);
-        delimString = 0;
+    octaspire_string_view_split_iterator_init_from_string(
+        &iterator,
+        self,
+        delimiter);
 
-        octaspire_vector_release(result);
-        result = 0;
-        return 0;
-    }
+    octaspire_string_view_t part;
 
-    for (size_t i = 0;
-         i < octaspire_string_get_length_in_ucs_characters(self);
-         ++i)
+    while (octaspire_string_view_split_iterator_next(&iterator, &part))
     {
-        octaspire_string_push_back_ucs_character(
-            collectorString,
-            octaspire_string_get_ucs_character_at_index(
-                self,
-                (ptrdiff_t)i));
-
-        if (octaspire_string_is_equal(collectorString, delimString))
-        {
-            octaspire_string_clear(collectorString);
-        }
-        else if (octaspire_string_ends_with(collectorString, delimString))
-        {
-            size_t const numUcsCharsToGet =
-                octaspire_string_get_length_in_ucs_characters(collectorString) -
-                octaspire_string_get_length_in_ucs_characters(delimString);
-
-            octaspire_string_t *token =
-                octaspire_string_new_substring_from_given_index_and_length(
-                    collectorString,
-                    collectorString->allocator,
-                    0,
-                    numUcsCharsToGet);
-
-            assert(token);
-
-            octaspire_vector_push_back_element(result, &token);
-
-            octaspire_string_clear(collectorString);
-        }
-    }
+        octaspire_string_t *token = octaspire_string_view_to_string(
+            &part,
+            self->allocator);
 
-    if (!octaspire_string_is_empty(collectorString))
-    {
-        if (octaspire_string_is_equal(collectorString, delimString))
+        if (!token)
         {
-            octaspire_string_clear(collectorString);
+            octaspire_vector_release(result);
+            result = 0;
+            return 0;
         }
-        else if (octaspire_string_ends_with(collectorString, delimString))
-        {
-            size_t const numUcsCharsToGet =
-                octaspire_string_get_length_in_ucs_characters(collectorString) -
-                octaspire_string_get_length_in_ucs_characters(delimString);
 
-            octaspire_string_t *token =
-                octaspire_string_new_substring_from_given_index_and_length(
-                    collectorString,
-                    collectorString->allocator,
-                    0,
-                    numUcsCharsToGet);
-
-            assert(token);
-
-            octaspire_vector_push_back_element(result, &token);
-
-            octaspire_string_clear(collectorString);
-        }
-        else
+        if (!octaspire_vector_push_back_element(result, &token))
         {
-            octaspire_string_t *token =
-                octaspire_string_new_copy(
-                    collectorString,
-                    collectorString->allocator);
-
-            assert(token);
-
-            octaspire_vector_push_back_element(result, &token);
+            octaspire_string_release(token);
+            token = 0;
 
-            octaspire_string_clear(collectorString);
+            octaspire_vector_release(result);
+            result = 0;
+            return 0;
         }
-
-        octaspire_string_clear(collectorString);
     }
 
-    octaspire_string_release(collectorString);
-    collectorString = 0;
-
-    octaspire_string_release(delimString);
-    delimString = 0;
-
     return result;
 }
 
@@ -1624,76 +1718,100 @@ static bool octaspire_string_private_ensure_octets_are_up_to_date(
         return true;
     }
 
-    for (size_t i = 0; i < octaspire_vector_get_length(self->ucsCharacters); ++i)
-    {
-        octaspire_utf8_character_t encoded;
+    size_t const numUcsCharacters = octaspire_vector_get_length(self->ucsCharacters);
 
-        uint32_t const ucsChar = *(uint32_t const * const)
-            octaspire_vector_get_element_at_const(
-                self->ucsCharacters,
-                (ptrdiff_t)i);
+    uint32_t const * const ucsCharacters = numUcsCharacters
+        ? octaspire_vector_get_element_at_const(self->ucsCharacters, 0)
+        : 0;
 
-        octaspire_utf8_encode_status_t const status = octaspire_utf8_encode_character(
-            ucsChar,
-            &encoded);
+    size_t lengthInOctets = 0;
 
-        if (status != OCTASPIRE_UTF8_ENCODE_STATUS_OK)
-        {
-            return false;
-        }
-
-        for (size_t j = 0; j < encoded.numoctets; ++j)
-        {
-            // Ugly; force into non-const.
-            if (!octaspire_vector_push_back_element(
-                    (octaspire_vector_t * const)self->octets,
-                    encoded.octets + 4 - encoded.numoctets + j))
-            {
-                return false;
-            }
-        }
+    if (octaspire_utf8_get_encoded_length(
+            ucsCharacters,
+            numUcsCharacters,
+            &lengthInOctets) != OCTASPIRE_UTF8_ENCODE_STATUS_OK)
+    {
+        return false;
     }
 
-    // Append null byte to allow use with libc
     // Ugly; force into non-const.
-    if (!octaspire_vector_push_back_element(
-        (octaspire_vector_t * const)self->octets,
-        &octaspire_string_private_null_octet))
+    octaspire_vector_t * const octets = (octaspire_vector_t * const)self->octets;
+
+    // Room for the null byte too, so that the vector is allocated once
+    if (!octaspire_vector_reserve(octets, lengthInOctets + 1))
     {
         return false;
     }
 
-    return true;
+    char encoded[OCTASPIRE_STRING_PRIVATE_ENCODE_BLOCK_LENGTH];
+    size_t index = 0;
+
+    while (index < numUcsCharacters)
+    {
+        size_t numOctetsEncoded = 0;
+        size_t numUcsCharactersEncoded = 0;
+
+        octaspire_helpers_verify_true(octaspire_utf8_encode_buffer(
+            ucsCharacters + index,
+            numUcsCharacters - index,
+            encoded,
+            sizeof(encoded),
+            &numOctetsEncoded,
+            &numUcsCharactersEncoded) == OCTASPIRE_UTF8_ENCODE_STATUS_OK);
+
+        // Cannot fail, there is room already
+        octaspire_helpers_verify_true(
+            octaspire_vector_push_back_elements(octets, encoded, numOctetsEncoded));
+
+        index += numUcsCharactersEncoded;
+    }
+
+    // Append null byte to allow use with libc
+    return octaspire_vector_push_back_element(
+        octets,
+        &octaspire_string_private_null_octet);
 }
 
-bool octaspire_string_private_is_string_at_index(
+bool octaspire_string_encode_to_buffer(
     octaspire_string_t const * const self,
-    size_t const selfIndex,
-    octaspire_string_t const * const str,
-    size_t const strFirstIndex,
-    size_t const strLastIndex)
+    char * const buffer,
+    size_t const bufferLengthInOctets,
+    size_t * const lengthInOctets)
 {
-    size_t selfIndex2 = selfIndex;
-    for (size_t i = strFirstIndex; i <= strLastIndex; ++i)
-    {
-        if (selfIndex2 >= octaspire_string_get_length_in_ucs_characters(self))
-        {
-            return false;
-        }
+    assert(self);
 
-        if (octaspire_string_get_ucs_character_at_index(
-                self,
-                (ptrdiff_t)selfIndex2) !=
-            octaspire_string_get_ucs_character_at_index(
-                str,
-                (ptrdiff_t)i))
-        {
-            return false;
-        }
+    size_t const numUcsCharacters = octaspire_vector_get_length(self->ucsCharacters);
+
+    uint32_t const * const ucsCharacters = numUcsCharacters
+        ? octaspire_vector_get_element_at_const(self->ucsCharacters, 0)
+        : 0;
 
-        ++selfIndex2;
+    if (octaspire_utf8_get_encoded_length(
+            ucsCharacters,
+            numUcsCharacters,
+            lengthInOctets) != OCTASPIRE_UTF8_ENCODE_STATUS_OK)
+    {
+        return false;
     }
 
+    if (bufferLengthInOctets == 0)
+    {
+        return true;
+    }
+
+    size_t numOctetsEncoded = 0;
+    size_t numUcsCharactersEncoded = 0;
+
+    octaspire_helpers_verify_true(octaspire_utf8_encode_buffer(
+        ucsCharacters,
+        numUcsCharacters,
+        buffer,
+        bufferLengthInOctets - 1,
+        &numOctetsEncoded,
+        &numUcsCharactersEncoded) == OCTASPIRE_UTF8_ENCODE_STATUS_OK);
+
+    buffer[numOctetsEncoded] = '\0';
+
     return true;
 }
 
@@ -1729,19 +1847,331 @@ octaspire_vector_t *octaspire_string_find_string(
         0,
         self->allocator);
 
-    for (size_t i = 0; i < octaspire_string_get_length_in_ucs_characters(self); ++i)
+    if (!result)
     {
-        if (octaspire_string_private_is_string_at_index(
-            self,
-            i,
-            str,
-            realIndex.index,
-            strEndIndex))
+        return 0;
+    }
+
+    octaspire_string_view_t strView;
+    octaspire_string_view_init_from_string(&strView, str);
+
+    size_t const needleStartOctetIndex =
+        octaspire_string_private_get_octet_index_of_ucs_index(str, realIndex.index);
+
+    size_t const needleEndOctetIndex =
+        octaspire_string_private_get_octet_index_of_ucs_index(str, strEndIndex + 1);
+
+    octaspire_string_view_t needle;
+
+    octaspire_helpers_verify_true(octaspire_string_view_get_subview(
+        &strView,
+        needleStartOctetIndex,
+        needleEndOctetIndex - needleStartOctetIndex,
+        &needle));
+
+    octaspire_string_view_searcher_t searcher;
+    octaspire_string_view_searcher_init(&searcher, &needle);
+
+    octaspire_string_view_t selfView;
+    octaspire_string_view_init_from_string(&selfView, self);
+
+    char const * const octets = octaspire_string_view_get_octets(&selfView);
+
+    // Matches can overlap, so the search continues from the octet after
+    // the start of the previous match.
+    size_t ucsIndex   = 0;
+    size_t octetIndex = 0;
+
+    ptrdiff_t found = octaspire_string_view_searcher_find(&searcher, &selfView, 0);
+
+    while (found >= 0)
+    {
+        ucsIndex += octaspire_utf8_count_ucs_characters(
+            octets + octetIndex,
+            (size_t)found - octetIndex);
+
+        octetIndex = (size_t)found;
+
+        if (!octaspire_vector_push_back_element(result, &ucsIndex))
         {
-            octaspire_vector_push_back_element(result, &i);
+            octaspire_vector_release(result);
+            result = 0;
+            return 0;
         }
+
+        found = octaspire_string_view_searcher_find(&searcher, &selfView, octetIndex + 1);
+    }
+
+    return result;
+}
+
+static size_t octaspire_string_private_get_octet_index_of_ucs_index(
+    octaspire_string_t const * const self,
+    size_t const ucsIndex)
+{
+    if (!ucsIndex)
+    {
+        return 0;
+    }
+
+    uint32_t const * const characters =
+        octaspire_vector_get_element_at_const(self->ucsCharacters, 0);
+
+    size_t result = 0;
+
+    for (size_t i = 0; i < ucsIndex; ++i)
+    {
+        uint32_t const ucsChar = characters[i];
+
+        if (ucsChar < 0x80)
+        {
+            result += 1;
+        }
+        else if (ucsChar < 0x800)
+        {
+            result += 2;
+        }
+        else if (ucsChar < 0x10000)
+        {
+            result += 3;
+        }
+        else
+        {
+            result += 4;
+        }
+    }
+
+    return result;
+}
+
+// String builder ////////////////////////////////////////////////////////////
+
+struct octaspire_string_builder_t
+{
+    octaspire_vector_t    *octets;
+    octaspire_allocator_t *allocator;
+};
+
+octaspire_string_builder_t *octaspire_string_builder_new(
+    octaspire_allocator_t *allocator)
+{
+    octaspire_string_builder_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_string_builder_t));
+
+    if (!self)
+    {
+        return 0;
+    }
+
+    self->allocator = allocator;
+    self->octets    = octaspire_vector_new(sizeof(char), false, 0, allocator);
+
+    if (!self->octets)
+    {
+        octaspire_string_builder_release(self);
+        self = 0;
+        return 0;
+    }
+
+    return self;
+}
+
+void octaspire_string_builder_release(octaspire_string_builder_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    octaspire_vector_release(self->octets);
+    octaspire_allocator_free(self->allocator, self);
+}
+
+bool octaspire_string_builder_append_buffer(
+    octaspire_string_builder_t * const self,
+    char const * const buffer,
+    size_t const lengthInOctets)
+{
+    return octaspire_vector_push_back_elements(self->octets, buffer, lengthInOctets);
+}
+
+bool octaspire_string_builder_append_c_string(
+    octaspire_string_builder_t * const self,
+    char const * const str)
+{
+    octaspire_helpers_verify_not_null(str);
+    return octaspire_string_builder_append_buffer(self, str, strlen(str));
+}
+
+bool octaspire_string_builder_append_string(
+    octaspire_string_builder_t * const self,
+    octaspire_string_t const * const str)
+{
+    return octaspire_string_builder_append_buffer(
+        self,
+        octaspire_string_get_c_string(str),
+        octaspire_string_get_length_in_octets(str));
+}
+
+bool octaspire_string_builder_append_format(
+    octaspire_string_builder_t * const self,
+    char const * const fmt,
+    ...)
+{
+    va_list arguments;
+    va_start(arguments, fmt);
+
+    bool const result =
+        octaspire_string_builder_append_vformat(self, fmt, arguments);
+
+    va_end(arguments);
+
+    return result;
+}
+
+bool octaspire_string_builder_append_vformat(
+    octaspire_string_builder_t * const self,
+    char const * const fmt,
+    va_list arguments)
+{
+    char stackBuffer[OCTASPIRE_STRING_PRIVATE_FORMAT_BUFFER_LENGTH];
+    size_t lengthInOctets = 0;
+    bool isEncodingError = false;
+
+    char * const buffer = octaspire_string_private_vformat(
+        self->allocator,
+        stackBuffer,
+        sizeof(stackBuffer),
+        &lengthInOctets,
+        &isEncodingError,
+        fmt,
+        arguments);
+
+    if (!buffer)
+    {
+        return false;
+    }
+
+    bool const result =
+        octaspire_vector_push_back_elements(self->octets, buffer, lengthInOctets);
+
+    if (buffer != stackBuffer)
+    {
+        octaspire_allocator_free(self->allocator, buffer);
     }
 
     return result;
 }
 
+bool octaspire_string_builder_append_int64(
+    octaspire_string_builder_t * const self,
+    int64_t const value)
+{
+    return octaspire_string_builder_append_format(self, "%" PRId64, value);
+}
+
+bool octaspire_string_builder_append_uint64(
+    octaspire_string_builder_t * const self,
+    uint64_t const value)
+{
+    return octaspire_string_builder_append_format(self, "%" PRIu64, value);
+}
+
+bool octaspire_string_builder_append_ucs_character(
+    octaspire_string_builder_t * const self,
+    uint32_t const character)
+{
+    octaspire_utf8_character_t encoded;
+
+    if (octaspire_utf8_encode_character(character, &encoded) !=
+        OCTASPIRE_UTF8_ENCODE_STATUS_OK)
+    {
+        return false;
+    }
+
+    return octaspire_vector_push_back_elements(
+        self->octets,
+        encoded.octets + 4 - encoded.numoctets,
+        encoded.numoctets);
+}
+
+size_t octaspire_string_builder_get_length_in_octets(
+    octaspire_string_builder_t const * const self)
+{
+    return octaspire_vector_get_length(self->octets);
+}
+
+bool octaspire_string_builder_clear(octaspire_string_builder_t * const self)
+{
+    return octaspire_vector_clear(self->octets);
+}
+
+octaspire_string_t *octaspire_string_builder_finish(
+    octaspire_string_builder_t * const self)
+{
+    size_t const lengthInOctets = octaspire_vector_get_length(self->octets);
+
+    octaspire_vector_t * const replacement =
+        octaspire_vector_new(sizeof(char), false, 0, self->allocator);
+
+    if (!replacement)
+    {
+        return 0;
+    }
+
+    octaspire_string_t *result =
+        octaspire_allocator_malloc(self->allocator, sizeof(octaspire_string_t));
+
+    if (!result)
+    {
+        octaspire_vector_release(replacement);
+        return 0;
+    }
+
+    result->allocator     = self->allocator;
+    result->errorStatus   = OCTASPIRE_STRING_ERROR_STATUS_OK;
+    result->errorAtOctet  = 0;
+    result->octets        = 0;
+
+    if (!octaspire_vector_push_back_element(
+            self->octets,
+            &octaspire_string_private_null_octet))
+    {
+        octaspire_string_release(result);
+        octaspire_vector_release(replacement);
+        return 0;
+    }
+
+    char const * const buffer = octaspire_vector_get_element_at_const(self->octets, 0);
+
+    // Sized and decoded like in octaspire_string_new_from_buffer
+    result->ucsCharacters = octaspire_vector_new_with_preallocated_elements(
+        sizeof(uint32_t),
+        false,
+        octaspire_utf8_count_ucs_characters(buffer, lengthInOctets),
+        0,
+        self->allocator);
+
+    if (!result->ucsCharacters ||
+        !octaspire_string_private_append_buffer(result, buffer, lengthInOctets))
+    {
+        octaspire_helpers_verify_true(
+            octaspire_vector_pop_back_element(self->octets));
+
+        octaspire_string_release(result);
+        octaspire_vector_release(replacement);
+        return 0;
+    }
+
+    // The octets are handed over as they are; they are the cached UTF-8
+    // form of the string unless decoding stopped early.
+    result->octets = self->octets;
+    self->octets   = replacement;
+
+    if (result->errorStatus != OCTASPIRE_STRING_ERROR_STATUS_OK)
+    {
+        octaspire_vector_clear(result->octets);
+    }
+
+    return result;
+}
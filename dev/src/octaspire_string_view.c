@@ -0,0 +1,858 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_string_view.h"
+#include <assert.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include "octaspire/core/octaspire_helpers.h"
+
+static size_t const OCTASPIRE_STRING_VIEW_PRIVATE_MAX_DOUBLE_LENGTH_IN_OCTETS   = 63;
+static size_t const OCTASPIRE_STRING_VIEW_PRIVATE_MAX_SHORT_NEEDLE_LENGTH      = 8;
+static size_t const OCTASPIRE_STRING_VIEW_PRIVATE_MAX_HORSPOOL_NEEDLE_LENGTH   = 256;
+
+void octaspire_string_view_init(
+    octaspire_string_view_t * const self,
+    char const * const octets,
+    size_t const lengthInOctets)
+{
+    assert(self);
+    assert(octets || !lengthInOctets);
+
+    memset(self, 0, sizeof(octaspire_string_view_t));
+
+    self->octets         = octets ? octets : "";
+    self->lengthInOctets = lengthInOctets;
+}
+
+void octaspire_string_view_init_from_c_string(
+    octaspire_string_view_t * const self,
+    char const * const str)
+{
+    octaspire_helpers_verify_not_null(str);
+    octaspire_string_view_init(self, str, strlen(str));
+}
+
+void octaspire_string_view_init_from_string(
+    octaspire_string_view_t * const self,
+    octaspire_string_t const * const str)
+{
+    octaspire_string_view_init(
+        self,
+        octaspire_string_get_c_string(str),
+        octaspire_string_get_length_in_octets(str));
+
+    self->lengthInUcsCharacters        = octaspire_string_get_length_in_ucs_characters(str);
+    self->isLengthInUcsCharactersKnown = true;
+}
+
+char const *octaspire_string_view_get_octets(
+    octaspire_string_view_t const * const self)
+{
+    return self->octets;
+}
+
+size_t octaspire_string_view_get_length_in_octets(
+    octaspire_string_view_t const * const self)
+{
+    return self->lengthInOctets;
+}
+
+size_t octaspire_string_view_get_length_in_ucs_characters(
+    octaspire_string_view_t * const self)
+{
+    if (!self->isLengthInUcsCharactersKnown)
+    {
+        size_t result = 0;
+
+        for (size_t i = 0; i < self->lengthInOctets; ++i)
+        {
+            // Count every octet that is not a continuation octet
+            if (((uint8_t)self->octets[i] & 0xC0) != 0x80)
+            {
+                ++result;
+            }
+        }
+
+        self->lengthInUcsCharacters        = result;
+        self->isLengthInUcsCharactersKnown = true;
+    }
+
+    return self->lengthInUcsCharacters;
+}
+
+bool octaspire_string_view_is_empty(
+    octaspire_string_view_t const * const self)
+{
+    return self->lengthInOctets == 0;
+}
+
+bool octaspire_string_view_get_subview(
+    octaspire_string_view_t const * const self,
+    size_t const octetIndex,
+    size_t const lengthInOctets,
+    octaspire_string_view_t * const result)
+{
+    if (octetIndex > self->lengthInOctets ||
+        lengthInOctets > self->lengthInOctets - octetIndex)
+    {
+        return false;
+    }
+
+    octaspire_string_view_init(result, self->octets + octetIndex, lengthInOctets);
+    return true;
+}
+
+int octaspire_string_view_compare(
+    octaspire_string_view_t const * const self,
+    octaspire_string_view_t const * const other)
+{
+    size_t const minLength =
+        octaspire_helpers_min_size_t(self->lengthInOctets, other->lengthInOctets);
+
+    int const result = minLength ? memcmp(self->octets, other->octets, minLength) : 0;
+
+    if (result != 0)
+    {
+        return result;
+    }
+
+    if (self->lengthInOctets == other->lengthInOctets)
+    {
+        return 0;
+    }
+
+    return (self->lengthInOctets < other->lengthInOctets) ? -1 : 1;
+}
+
+bool octaspire_string_view_is_equal(
+    octaspire_string_view_t const * const self,
+    octaspire_string_view_t const * const other)
+{
+    return self->lengthInOctets == other->lengthInOctets &&
+        (!self->lengthInOctets ||
+         memcmp(self->octets, other->octets, self->lengthInOctets) == 0);
+}
+
+bool octaspire_string_view_is_equal_to_c_string(
+    octaspire_string_view_t const * const self,
+    char const * const str)
+{
+    octaspire_string_view_t other;
+    octaspire_string_view_init_from_c_string(&other, str);
+    return octaspire_string_view_is_equal(self, &other);
+}
+
+bool octaspire_string_view_is_equal_to_string(
+    octaspire_string_view_t const * const self,
+    octaspire_string_t const * const str)
+{
+    octaspire_string_view_t other;
+
+    octaspire_string_view_init(
+        &other,
+        octaspire_string_get_c_string(str),
+        octaspire_string_get_length_in_octets(str));
+
+    return octaspire_string_view_is_equal(self, &other);
+}
+
+uint32_t octaspire_string_view_get_hash(
+    octaspire_string_view_t const * const self)
+{
+    // Jenkins one-at-a-time hash of the octets and of the '\0' that
+    // octaspire_string_get_hash includes. Adding the '\0' octet only
+    // mixes the hash.
+    uint32_t hash = 0;
+
+    for (size_t i = 0; i <= self->lengthInOctets; ++i)
+    {
+        hash += (i < self->lengthInOctets) ? (uint8_t)self->octets[i] : 0;
+        hash += (hash << 10);
+        hash ^= (hash >>  6);
+    }
+
+    hash += (hash <<  3);
+    hash ^= (hash >> 11);
+    hash += (hash << 15);
+
+    return hash;
+}
+
+uint32_t octaspire_string_view_get_keyed_hash(
+    octaspire_string_view_t const * const self,
+    uint8_t const * const seed)
+{
+    return octaspire_helpers_calculate_keyed_hash_for_memory_buffer_argument(
+        self->octets,
+        self->lengthInOctets,
+        seed);
+}
+
+ptrdiff_t octaspire_string_view_find(
+    octaspire_string_view_t const * const self,
+    octaspire_string_view_t const * const needle,
+    size_t const startOctetIndex)
+{
+    octaspire_string_view_searcher_t searcher;
+    octaspire_string_view_searcher_init(&searcher, needle);
+    return octaspire_string_view_searcher_find(&searcher, self, startOctetIndex);
+}
+
+static void octaspire_string_view_searcher_private_maximal_suffix(
+    uint8_t const * const needle,
+    size_t const needleLength,
+    bool const useReversedOrder,
+    ptrdiff_t * const maximalSuffix,
+    size_t * const period)
+{
+    // Crochemore-Perrin computation of the maximal suffix of the needle
+    // and of its period, for one of the two orderings of the alphabet.
+    ptrdiff_t ms = -1;
+    size_t    j  = 0;
+    size_t    k  = 1;
+    size_t    p  = 1;
+
+    while (j + k < needleLength)
+    {
+        uint8_t const a = needle[j + k];
+        uint8_t const b = needle[(size_t)(ms + (ptrdiff_t)k)];
+
+        if (useReversedOrder ? (a > b) : (a < b))
+        {
+            j += k;
+            k  = 1;
+            p  = (size_t)((ptrdiff_t)j - ms);
+        }
+        else if (a == b)
+        {
+            if (k != p)
+            {
+                ++k;
+            }
+            else
+            {
+                j += p;
+                k  = 1;
+            }
+        }
+        else
+        {
+            ms = (ptrdiff_t)j;
+            j  = (size_t)ms + 1;
+            k  = 1;
+            p  = 1;
+        }
+    }
+
+    *maximalSuffix = ms;
+    *period        = p;
+}
+
+void octaspire_string_view_searcher_init(
+    octaspire_string_view_searcher_t * const self,
+    octaspire_string_view_t const * const needle)
+{
+    assert(self);
+
+    memset(self, 0, sizeof(octaspire_string_view_searcher_t));
+
+    self->needle               = needle->octets;
+    self->needleLengthInOctets = needle->lengthInOctets;
+
+    size_t const m = needle->lengthInOctets;
+
+    if (m == 0)
+    {
+        self->algorithm = OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_EMPTY;
+    }
+    else if (m == 1)
+    {
+        self->algorithm = OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_OCTET;
+    }
+    else if (m <= OCTASPIRE_STRING_VIEW_PRIVATE_MAX_SHORT_NEEDLE_LENGTH)
+    {
+        self->algorithm = OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_SHORT;
+    }
+    else if (m <= OCTASPIRE_STRING_VIEW_PRIVATE_MAX_HORSPOOL_NEEDLE_LENGTH)
+    {
+        self->algorithm = OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_HORSPOOL;
+
+        for (size_t c = 0; c < 256; ++c)
+        {
+            self->shifts[c] = (uint16_t)m;
+        }
+
+        for (size_t i = 0; i + 1 < m; ++i)
+        {
+            self->shifts[(uint8_t)self->needle[i]] = (uint16_t)(m - 1 - i);
+        }
+    }
+    else
+    {
+        self->algorithm = OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_TWO_WAY;
+
+        uint8_t const * const x = (uint8_t const *)self->needle;
+
+        ptrdiff_t suffix         = 0;
+        ptrdiff_t reversedSuffix = 0;
+        size_t    period         = 0;
+        size_t    reversedPeriod = 0;
+
+        octaspire_string_view_searcher_private_maximal_suffix(
+            x, m, false, &suffix, &period);
+
+        octaspire_string_view_searcher_private_maximal_suffix(
+            x, m, true, &reversedSuffix, &reversedPeriod);
+
+        if (suffix > reversedSuffix)
+        {
+            self->criticalPosition = suffix;
+            self->period           = period;
+        }
+        else
+        {
+            self->criticalPosition = reversedSuffix;
+            self->period           = reversedPeriod;
+        }
+
+        self->isPeriodic = memcmp(
+            x,
+            x + self->period,
+            (size_t)(self->criticalPosition + 1)) == 0;
+
+        if (!self->isPeriodic)
+        {
+            self->period = octaspire_helpers_max_size_t(
+                (size_t)(self->criticalPosition + 1),
+                m - (size_t)(self->criticalPosition + 1)) + 1;
+        }
+    }
+}
+
+static ptrdiff_t octaspire_string_view_searcher_private_find_short(
+    octaspire_string_view_searcher_t const * const self,
+    char const * const haystack,
+    size_t const start,
+    size_t const last)
+{
+    size_t const m = self->needleLengthInOctets;
+    char const first      = self->needle[0];
+    char const lastOctet  = self->needle[m - 1];
+
+    char const * candidate = haystack + start;
+    char const * const end = haystack + last;
+
+    while (candidate <= end)
+    {
+        candidate = memchr(candidate, first, (size_t)(end - candidate) + 1);
+
+        if (!candidate)
+        {
+            return -1;
+        }
+
+        if (candidate[m - 1] == lastOctet &&
+            memcmp(candidate + 1, self->needle + 1, m - 2) == 0)
+        {
+            return candidate - haystack;
+        }
+
+        ++candidate;
+    }
+
+    return -1;
+}
+
+static ptrdiff_t octaspire_string_view_searcher_private_find_horspool(
+    octaspire_string_view_searcher_t const * const self,
+    char const * const haystack,
+    size_t const start,
+    size_t const last)
+{
+    size_t const m = self->needleLengthInOctets;
+    char const lastOctet = self->needle[m - 1];
+
+    size_t j = start;
+
+    while (j <= last)
+    {
+        char const c = haystack[j + m - 1];
+
+        if (c == lastOctet && memcmp(haystack + j, self->needle, m - 1) == 0)
+        {
+            return (ptrdiff_t)j;
+        }
+
+        j += self->shifts[(uint8_t)c];
+    }
+
+    return -1;
+}
+
+static ptrdiff_t octaspire_string_view_searcher_private_find_two_way(
+    octaspire_string_view_searcher_t const * const self,
+    char const * const haystack,
+    size_t const start,
+    size_t const last)
+{
+    uint8_t const * const x = (uint8_t const *)self->needle;
+    uint8_t const * const y = (uint8_t const *)haystack;
+
+    ptrdiff_t const m    = (ptrdiff_t)self->needleLengthInOctets;
+    ptrdiff_t const ell  = self->criticalPosition;
+    size_t const    per  = self->period;
+
+    size_t j = start;
+
+    if (self->isPeriodic)
+    {
+        // Length of the prefix of the needle that is known to match after
+        // a shift by the period, or -1.
+        ptrdiff_t memory = -1;
+
+        while (j <= last)
+        {
+            ptrdiff_t i = ((ell > memory) ? ell : memory) + 1;
+
+            while (i < m && x[i] == y[(size_t)i + j])
+            {
+                ++i;
+            }
+
+            if (i >= m)
+            {
+                i = ell;
+
+                while (i > memory && x[i] == y[(size_t)i + j])
+                {
+                    --i;
+                }
+
+                if (i <= memory)
+                {
+                    return (ptrdiff_t)j;
+                }
+
+                j += per;
+                memory = m - (ptrdiff_t)per - 1;
+            }
+            else
+            {
+                j += (size_t)(i - ell);
+                memory = -1;
+            }
+        }
+    }
+    else
+    {
+        while (j <= last)
+        {
+            ptrdiff_t i = ell + 1;
+
+            while (i < m && x[i] == y[(size_t)i + j])
+            {
+                ++i;
+            }
+
+            if (i >= m)
+            {
+                i = ell;
+
+                while (i >= 0 && x[i] == y[(size_t)i + j])
+                {
+                    --i;
+                }
+
+                if (i < 0)
+                {
+                    return (ptrdiff_t)j;
+                }
+
+                j += per;
+            }
+            else
+            {
+                j += (size_t)(i - ell);
+            }
+        }
+    }
+
+    return -1;
+}
+
+ptrdiff_t octaspire_string_view_searcher_find(
+    octaspire_string_view_searcher_t const * const self,
+    octaspire_string_view_t const * const haystack,
+    size_t const startOctetIndex)
+{
+    size_t const m = self->needleLengthInOctets;
+
+    if (startOctetIndex > haystack->lengthInOctets ||
+        m > haystack->lengthInOctets - startOctetIndex)
+    {
+        return -1;
+    }
+
+    // Last octet index where the needle can start
+    size_t const last = haystack->lengthInOctets - m;
+
+    switch (self->algorithm)
+    {
+        case OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_EMPTY:
+        {
+            return (ptrdiff_t)startOctetIndex;
+        }
+
+        case OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_OCTET:
+        {
+            return octaspire_string_view_find_octet(
+                haystack,
+                self->needle[0],
+                startOctetIndex);
+        }
+
+        case OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_SHORT:
+        {
+            return octaspire_string_view_searcher_private_find_short(
+                self,
+                haystack->octets,
+                startOctetIndex,
+                last);
+        }
+
+        case OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_HORSPOOL:
+        {
+            return octaspire_string_view_searcher_private_find_horspool(
+                self,
+                haystack->octets,
+                startOctetIndex,
+                last);
+        }
+
+        default:
+        {
+            assert(self->algorithm == OCTASPIRE_STRING_VIEW_SEARCH_ALGORITHM_TWO_WAY);
+
+            return octaspire_string_view_searcher_private_find_two_way(
+                self,
+                haystack->octets,
+                startOctetIndex,
+                last);
+        }
+    }
+}
+
+ptrdiff_t octaspire_string_view_find_octet(
+    octaspire_string_view_t const * const self,
+    char const octet,
+    size_t const startOctetIndex)
+{
+    if (startOctetIndex >= self->lengthInOctets)
+    {
+        return -1;
+    }
+
+    char const * const found = memchr(
+        self->octets + startOctetIndex,
+        octet,
+        self->lengthInOctets - startOctetIndex);
+
+    return found ? (found - self->octets) : -1;
+}
+
+bool octaspire_string_view_starts_with(
+    octaspire_string_view_t const * const self,
+    octaspire_string_view_t const * const prefix)
+{
+    return prefix->lengthInOctets <= self->lengthInOctets &&
+        (!prefix->lengthInOctets ||
+         memcmp(self->octets, prefix->octets, prefix->lengthInOctets) == 0);
+}
+
+bool octaspire_string_view_ends_with(
+    octaspire_string_view_t const * const self,
+    octaspire_string_view_t const * const suffix)
+{
+    return suffix->lengthInOctets <= self->lengthInOctets &&
+        (!suffix->lengthInOctets ||
+         memcmp(
+             self->octets + self->lengthInOctets - suffix->lengthInOctets,
+             suffix->octets,
+             suffix->lengthInOctets) == 0);
+}
+
+static bool octaspire_string_view_private_to_magnitude(
+    octaspire_string_view_t const * const self,
+    bool * const isNegative,
+    uint64_t const limitForPositive,
+    uint64_t const limitForNegative,
+    uint64_t * const result)
+{
+    size_t index = 0;
+
+    *isNegative = false;
+
+    if (self->lengthInOctets &&
+        (self->octets[0] == '-' || self->octets[0] == '+'))
+    {
+        *isNegative = (self->octets[0] == '-');
+        ++index;
+    }
+
+    if (index == self->lengthInOctets)
+    {
+        return false;
+    }
+
+    uint64_t const limit = *isNegative ? limitForNegative : limitForPositive;
+    uint64_t magnitude = 0;
+
+    for (; index < self->lengthInOctets; ++index)
+    {
+        char const c = self->octets[index];
+
+        if (c < '0' || c > '9')
+        {
+            return false;
+        }
+
+        uint64_t const digit = (uint64_t)(c - '0');
+
+        if (magnitude > limit / 10 ||
+            (magnitude == limit / 10 && digit > limit % 10))
+        {
+            return false;
+        }
+
+        magnitude = magnitude * 10 + digit;
+    }
+
+    *result = magnitude;
+    return true;
+}
+
+bool octaspire_string_view_to_int64(
+    octaspire_string_view_t const * const self,
+    int64_t * const result)
+{
+    bool isNegative = false;
+    uint64_t magnitude = 0;
+
+    if (!octaspire_string_view_private_to_magnitude(
+            self,
+            &isNegative,
+            (uint64_t)INT64_MAX,
+            (uint64_t)INT64_MAX + 1,
+            &magnitude))
+    {
+        return false;
+    }
+
+    if (isNegative)
+    {
+        // Negate in unsigned arithmetic, so that INT64_MIN does not overflow
+        *result = (magnitude == (uint64_t)INT64_MAX + 1)
+            ? INT64_MIN
+            : -(int64_t)magnitude;
+    }
+    else
+    {
+        *result = (int64_t)magnitude;
+    }
+
+    return true;
+}
+
+bool octaspire_string_view_to_uint64(
+    octaspire_string_view_t const * const self,
+    uint64_t * const result)
+{
+    bool isNegative = false;
+    uint64_t magnitude = 0;
+
+    if (!octaspire_string_view_private_to_magnitude(
+            self,
+            &isNegative,
+            UINT64_MAX,
+            0,
+            &magnitude) ||
+        isNegative)
+    {
+        return false;
+    }
+
+    *result = magnitude;
+    return true;
+}
+
+bool octaspire_string_view_to_double(
+    octaspire_string_view_t const * const self,
+    double * const result)
+{
+    // strtod needs a '\0' at the end, so numbers are copied to the stack
+    char buffer[OCTASPIRE_STRING_VIEW_PRIVATE_MAX_DOUBLE_LENGTH_IN_OCTETS + 1];
+
+    if (!self->lengthInOctets ||
+        self->lengthInOctets > OCTASPIRE_STRING_VIEW_PRIVATE_MAX_DOUBLE_LENGTH_IN_OCTETS ||
+        isspace((unsigned char)self->octets[0]) ||
+        memchr(self->octets, '\0', self->lengthInOctets))
+    {
+        return false;
+    }
+
+    memcpy(buffer, self->octets, self->lengthInOctets);
+    buffer[self->lengthInOctets] = '\0';
+
+    char *end = 0;
+    double const value = strtod(buffer, &end);
+
+    if (end != buffer + self->lengthInOctets)
+    {
+        return false;
+    }
+
+    *result = value;
+    return true;
+}
+
+octaspire_string_t *octaspire_string_view_to_string(
+    octaspire_string_view_t const * const self,
+    octaspire_allocator_t *allocator)
+{
+    return octaspire_string_new_from_buffer(
+        self->octets,
+        self->lengthInOctets,
+        allocator);
+}
+
+void octaspire_string_view_split_iterator_init(
+    octaspire_string_view_split_iterator_t * const self,
+    octaspire_string_view_t const * const view,
+    octaspire_string_view_t const * const delimiter,
+    bool const skipEmptyParts)
+{
+    assert(self);
+
+    memset(self, 0, sizeof(octaspire_string_view_split_iterator_t));
+
+    self->next                    = view->octets;
+    self->end                     = view->octets + view->lengthInOctets;
+    self->delimiterLengthInOctets = delimiter->lengthInOctets;
+    self->skipEmptyParts          = skipEmptyParts;
+    self->isFinished              = false;
+
+    octaspire_string_view_searcher_init(&self->searcher, delimiter);
+}
+
+void octaspire_string_view_split_iterator_init_from_string(
+    octaspire_string_view_split_iterator_t * const self,
+    octaspire_string_t const * const str,
+    char const * const delimiter)
+{
+    octaspire_string_view_t view;
+    octaspire_string_view_init_from_string(&view, str);
+
+    octaspire_string_view_t delimiterView;
+    octaspire_string_view_init_from_c_string(&delimiterView, delimiter);
+
+    octaspire_string_view_split_iterator_init(self, &view, &delimiterView, true);
+}
+
+static size_t octaspire_string_view_split_iterator_private_get_character_length(
+    octaspire_string_view_split_iterator_t const * const self)
+{
+    uint8_t const first = (uint8_t)self->next[0];
+
+    size_t length = 1;
+
+    if ((first & 0xE0) == 0xC0)
+    {
+        length = 2;
+    }
+    else if ((first & 0xF0) == 0xE0)
+    {
+        length = 3;
+    }
+    else if ((first & 0xF8) == 0xF0)
+    {
+        length = 4;
+    }
+
+    return octaspire_helpers_min_size_t(length, (size_t)(self->end - self->next));
+}
+
+static char const *octaspire_string_view_split_iterator_private_find_delimiter(
+    octaspire_string_view_split_iterator_t const * const self)
+{
+    octaspire_string_view_t haystack;
+    octaspire_string_view_init(&haystack, self->next, (size_t)(self->end - self->next));
+
+    ptrdiff_t const index =
+        octaspire_string_view_searcher_find(&self->searcher, &haystack, 0);
+
+    return (index < 0) ? 0 : (self->next + index);
+}
+
+bool octaspire_string_view_split_iterator_next(
+    octaspire_string_view_split_iterator_t * const self,
+    octaspire_string_view_t * const part)
+{
+    if (!self->delimiterLengthInOctets)
+    {
+        if (self->next == self->end)
+        {
+            self->isFinished = true;
+            return false;
+        }
+
+        size_t const length =
+            octaspire_string_view_split_iterator_private_get_character_length(self);
+
+        octaspire_string_view_init(part, self->next, length);
+        self->next += length;
+        return true;
+    }
+
+    while (!self->isFinished)
+    {
+        char const * const found =
+            octaspire_string_view_split_iterator_private_find_delimiter(self);
+
+        char const * const partEnd = found ? found : self->end;
+
+        octaspire_string_view_init(part, self->next, (size_t)(partEnd - self->next));
+
+        if (found)
+        {
+            self->next = found + self->delimiterLengthInOctets;
+        }
+        else
+        {
+            self->next       = self->end;
+            self->isFinished = true;
+        }
+
+        if (!self->skipEmptyParts || !octaspire_string_view_is_empty(part))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
@@ -0,0 +1,447 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_utf16.h"
+#include <assert.h>
+#include <string.h>
+#include "octaspire/core/octaspire_utf8.h"
+#include "octaspire/core/octaspire_helpers.h"
+
+// UTF-8 and UTF-16 are converted through UTF-32 in blocks of this many
+// characters, that stay in the cache between the two steps.
+enum
+{
+    OCTASPIRE_UTF16_PRIVATE_BLOCK_LENGTH = 256
+};
+
+static bool octaspire_utf16_private_is_high_surrogate(uint32_t const unit)
+{
+    return unit >= 0xD800 && unit <= 0xDBFF;
+}
+
+static bool octaspire_utf16_private_is_low_surrogate(uint32_t const unit)
+{
+    return unit >= 0xDC00 && unit <= 0xDFFF;
+}
+
+// Returns zero for characters that UTF-16 cannot encode
+static size_t octaspire_utf16_private_get_encoded_length_of_character(uint32_t const character)
+{
+    if (character < 0xD800 || (character > 0xDFFF && character <= 0xFFFF))
+    {
+        return 1;
+    }
+
+    return (character >= 0x10000 && character <= 0x10FFFF) ? 2 : 0;
+}
+
+octaspire_utf16_status_t octaspire_utf16_decode_buffer(
+    uint16_t const * const units,
+    size_t const numUnits,
+    uint32_t * const result,
+    size_t * const numUnitsDecoded,
+    size_t * const numUcsCharactersDecoded)
+{
+    size_t index = 0;
+    size_t numDecoded = 0;
+    octaspire_utf16_status_t status = OCTASPIRE_UTF16_STATUS_OK;
+
+    while (index < numUnits)
+    {
+        // Four characters outside the surrogate range at a time
+        while (numUnits - index >= 4 &&
+               (units[index]     < 0xD800 || units[index]     > 0xDFFF) &&
+               (units[index + 1] < 0xD800 || units[index + 1] > 0xDFFF) &&
+               (units[index + 2] < 0xD800 || units[index + 2] > 0xDFFF) &&
+               (units[index + 3] < 0xD800 || units[index + 3] > 0xDFFF))
+        {
+            result[numDecoded]     = units[index];
+            result[numDecoded + 1] = units[index + 1];
+            result[numDecoded + 2] = units[index + 2];
+            result[numDecoded + 3] = units[index + 3];
+
+            index      += 4;
+            numDecoded += 4;
+        }
+
+        if (index >= numUnits)
+        {
+            break;
+        }
+
+        uint32_t const unit = units[index];
+
+        if (!octaspire_utf16_private_is_high_surrogate(unit) &&
+            !octaspire_utf16_private_is_low_surrogate(unit))
+        {
+            result[numDecoded] = unit;
+            ++index;
+        }
+        else if (octaspire_utf16_private_is_high_surrogate(unit) &&
+                 index + 1 < numUnits &&
+                 octaspire_utf16_private_is_low_surrogate(units[index + 1]))
+        {
+            result[numDecoded] =
+                0x10000 + (((unit - 0xD800) << 10) | ((uint32_t)units[index + 1] - 0xDC00));
+
+            index += 2;
+        }
+        else
+        {
+            status = OCTASPIRE_UTF16_STATUS_UNPAIRED_SURROGATE;
+            break;
+        }
+
+        ++numDecoded;
+    }
+
+    *numUnitsDecoded         = index;
+    *numUcsCharactersDecoded = numDecoded;
+
+    return status;
+}
+
+octaspire_utf16_status_t octaspire_utf16_get_encoded_length(
+    uint32_t const * const characters,
+    size_t const numCharacters,
+    size_t * const numUnits)
+{
+    size_t result = 0;
+
+    for (size_t i = 0; i < numCharacters; ++i)
+    {
+        size_t const length =
+            octaspire_utf16_private_get_encoded_length_of_character(characters[i]);
+
+        if (length == 0)
+        {
+            *numUnits = result;
+            return OCTASPIRE_UTF16_STATUS_ILLEGAL_CHARACTER_NUMBER;
+        }
+
+        result += length;
+    }
+
+    *numUnits = result;
+    return OCTASPIRE_UTF16_STATUS_OK;
+}
+
+octaspire_utf16_status_t octaspire_utf16_encode_buffer(
+    uint32_t const * const characters,
+    size_t const numCharacters,
+    uint16_t * const result,
+    size_t const resultLengthInUnits,
+    size_t * const numUnitsEncoded,
+    size_t * const numUcsCharactersEncoded)
+{
+    size_t index = 0;
+    size_t numEncoded = 0;
+    octaspire_utf16_status_t status = OCTASPIRE_UTF16_STATUS_OK;
+
+    while (numEncoded < numCharacters)
+    {
+        uint32_t const character = characters[numEncoded];
+
+        size_t const length =
+            octaspire_utf16_private_get_encoded_length_of_character(character);
+
+        if (length == 0)
+        {
+            status = OCTASPIRE_UTF16_STATUS_ILLEGAL_CHARACTER_NUMBER;
+            break;
+        }
+
+        if (resultLengthInUnits - index < length)
+        {
+            break;
+        }
+
+        if (length == 1)
+        {
+            result[index] = (uint16_t)character;
+        }
+        else
+        {
+            uint32_t const offset = character - 0x10000;
+
+            result[index]     = (uint16_t)(0xD800 + (offset >> 10));
+            result[index + 1] = (uint16_t)(0xDC00 + (offset & 0x3FF));
+        }
+
+        index += length;
+        ++numEncoded;
+    }
+
+    *numUnitsEncoded         = index;
+    *numUcsCharactersEncoded = numEncoded;
+
+    return status;
+}
+
+// Length of the next block of UTF-16, so that a surrogate pair is not
+// split between two blocks.
+static size_t octaspire_utf16_private_get_utf16_block_length(
+    uint16_t const * const units,
+    size_t const numUnits)
+{
+    size_t length = octaspire_helpers_min_size_t(
+        numUnits,
+        OCTASPIRE_UTF16_PRIVATE_BLOCK_LENGTH);
+
+    if (length < numUnits && octaspire_utf16_private_is_high_surrogate(units[length - 1]))
+    {
+        --length;
+    }
+
+    return length;
+}
+
+// Length of the next block of UTF-8, so that a character is not split
+// between two blocks.
+static size_t octaspire_utf16_private_get_utf8_block_length(
+    char const * const buffer,
+    size_t const lengthInOctets)
+{
+    size_t length = octaspire_helpers_min_size_t(
+        lengthInOctets,
+        OCTASPIRE_UTF16_PRIVATE_BLOCK_LENGTH);
+
+    for (size_t i = 0;
+         i < 3 && length < lengthInOctets && ((uint8_t)buffer[length] & 0xC0) == 0x80;
+         ++i)
+    {
+        --length;
+    }
+
+    return length;
+}
+
+octaspire_utf16_status_t octaspire_utf16_get_length_in_utf8(
+    uint16_t const * const units,
+    size_t const numUnits,
+    size_t * const lengthInOctets)
+{
+    uint32_t characters[OCTASPIRE_UTF16_PRIVATE_BLOCK_LENGTH];
+    size_t index = 0;
+
+    *lengthInOctets = 0;
+
+    while (index < numUnits)
+    {
+        size_t numUnitsDecoded = 0;
+        size_t numCharacters = 0;
+
+        octaspire_utf16_status_t const status = octaspire_utf16_decode_buffer(
+            units + index,
+            octaspire_utf16_private_get_utf16_block_length(units + index, numUnits - index),
+            characters,
+            &numUnitsDecoded,
+            &numCharacters);
+
+        size_t length = 0;
+
+        // Everything UTF-16 can encode, UTF-8 can too
+        octaspire_helpers_verify_true(
+            octaspire_utf8_get_encoded_length(characters, numCharacters, &length) ==
+                OCTASPIRE_UTF8_ENCODE_STATUS_OK);
+
+        *lengthInOctets += length;
+        index += numUnitsDecoded;
+
+        if (status != OCTASPIRE_UTF16_STATUS_OK)
+        {
+            return status;
+        }
+    }
+
+    return OCTASPIRE_UTF16_STATUS_OK;
+}
+
+octaspire_utf16_status_t octaspire_utf16_to_utf8(
+    uint16_t const * const units,
+    size_t const numUnits,
+    char * const result,
+    size_t const resultLengthInOctets,
+    size_t * const numUnitsConverted,
+    size_t * const numOctetsWritten)
+{
+    uint32_t characters[OCTASPIRE_UTF16_PRIVATE_BLOCK_LENGTH];
+    size_t index = 0;
+    size_t numWritten = 0;
+    octaspire_utf16_status_t status = OCTASPIRE_UTF16_STATUS_OK;
+
+    while (index < numUnits)
+    {
+        size_t numUnitsDecoded = 0;
+        size_t numCharacters = 0;
+
+        status = octaspire_utf16_decode_buffer(
+            units + index,
+            octaspire_utf16_private_get_utf16_block_length(units + index, numUnits - index),
+            characters,
+            &numUnitsDecoded,
+            &numCharacters);
+
+        size_t numOctetsEncoded = 0;
+        size_t numCharactersEncoded = 0;
+
+        octaspire_helpers_verify_true(octaspire_utf8_encode_buffer(
+            characters,
+            numCharacters,
+            result + numWritten,
+            resultLengthInOctets - numWritten,
+            &numOctetsEncoded,
+            &numCharactersEncoded) == OCTASPIRE_UTF8_ENCODE_STATUS_OK);
+
+        numWritten += numOctetsEncoded;
+
+        if (numCharactersEncoded < numCharacters)
+        {
+            // The result is full; count the units of what fit
+            for (size_t i = 0; i < numCharactersEncoded; ++i)
+            {
+                index += (characters[i] >= 0x10000) ? 2 : 1;
+            }
+
+            status = OCTASPIRE_UTF16_STATUS_OK;
+            break;
+        }
+
+        index += numUnitsDecoded;
+
+        if (status != OCTASPIRE_UTF16_STATUS_OK)
+        {
+            break;
+        }
+    }
+
+    *numUnitsConverted = index;
+    *numOctetsWritten  = numWritten;
+
+    return status;
+}
+
+octaspire_utf16_status_t octaspire_utf16_get_length_of_utf8(
+    char const * const buffer,
+    size_t const lengthInOctets,
+    size_t * const numUnits)
+{
+    uint32_t characters[OCTASPIRE_UTF16_PRIVATE_BLOCK_LENGTH];
+    size_t index = 0;
+
+    *numUnits = 0;
+
+    while (index < lengthInOctets)
+    {
+        size_t numOctetsDecoded = 0;
+        size_t numCharacters = 0;
+
+        octaspire_utf8_decode_status_t const decodeStatus = octaspire_utf8_decode_buffer(
+            buffer + index,
+            octaspire_utf16_private_get_utf8_block_length(buffer + index, lengthInOctets - index),
+            characters,
+            &numOctetsDecoded,
+            &numCharacters);
+
+        size_t length = 0;
+
+        octaspire_utf16_status_t const status =
+            octaspire_utf16_get_encoded_length(characters, numCharacters, &length);
+
+        *numUnits += length;
+
+        if (status != OCTASPIRE_UTF16_STATUS_OK)
+        {
+            return status;
+        }
+
+        if (decodeStatus != OCTASPIRE_UTF8_DECODE_STATUS_OK)
+        {
+            return OCTASPIRE_UTF16_STATUS_ILLEGAL_UTF8;
+        }
+
+        index += numOctetsDecoded;
+    }
+
+    return OCTASPIRE_UTF16_STATUS_OK;
+}
+
+octaspire_utf16_status_t octaspire_utf16_from_utf8(
+    char const * const buffer,
+    size_t const lengthInOctets,
+    uint16_t * const result,
+    size_t const resultLengthInUnits,
+    size_t * const numOctetsConverted,
+    size_t * const numUnitsWritten)
+{
+    uint32_t characters[OCTASPIRE_UTF16_PRIVATE_BLOCK_LENGTH];
+    size_t index = 0;
+    size_t numWritten = 0;
+    octaspire_utf16_status_t status = OCTASPIRE_UTF16_STATUS_OK;
+
+    while (index < lengthInOctets)
+    {
+        size_t numOctetsDecoded = 0;
+        size_t numCharacters = 0;
+
+        octaspire_utf8_decode_status_t const decodeStatus = octaspire_utf8_decode_buffer(
+            buffer + index,
+            octaspire_utf16_private_get_utf8_block_length(buffer + index, lengthInOctets - index),
+            characters,
+            &numOctetsDecoded,
+            &numCharacters);
+
+        size_t numUnitsEncoded = 0;
+        size_t numCharactersEncoded = 0;
+
+        status = octaspire_utf16_encode_buffer(
+            characters,
+            numCharacters,
+            result + numWritten,
+            resultLengthInUnits - numWritten,
+            &numUnitsEncoded,
+            &numCharactersEncoded);
+
+        numWritten += numUnitsEncoded;
+
+        if (numCharactersEncoded < numCharacters)
+        {
+            // The result is full, or a character cannot be encoded;
+            // count the octets of what was written
+            size_t length = 0;
+
+            octaspire_helpers_verify_true(
+                octaspire_utf8_get_encoded_length(characters, numCharactersEncoded, &length) ==
+                    OCTASPIRE_UTF8_ENCODE_STATUS_OK);
+
+            index += length;
+            break;
+        }
+
+        index += numOctetsDecoded;
+
+        if (decodeStatus != OCTASPIRE_UTF8_DECODE_STATUS_OK)
+        {
+            status = OCTASPIRE_UTF16_STATUS_ILLEGAL_UTF8;
+            break;
+        }
+    }
+
+    *numOctetsConverted = index;
+    *numUnitsWritten    = numWritten;
+
+    return status;
+}
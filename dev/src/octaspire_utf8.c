@@ -459,3 +459,462 @@ octaspire_utf8_decode_status_t octaspire_utf8_decode_character_from_buffer(
     return octaspire_utf8_private_decode_helper(buffer, (size_t)*numoctets, numOctetsAvailable, result);
 }
 
+
+static uint64_t const OCTASPIRE_UTF8_PRIVATE_LOW_BITS_OF_OCTETS  = UINT64_C(0x0101010101010101);
+static uint64_t const OCTASPIRE_UTF8_PRIVATE_HIGH_BITS_OF_OCTETS = UINT64_C(0x8080808080808080);
+
+static bool octaspire_utf8_private_is_continuation_octet(uint8_t const octet)
+{
+    return (octet & 0xC0) == 0x80;
+}
+
+octaspire_utf8_decode_status_t octaspire_utf8_decode_buffer(
+    char const * const buffer,
+    size_t const lengthInOctets,
+    uint32_t * const result,
+    size_t * const numOctetsDecoded,
+    size_t * const numUcsCharactersDecoded)
+{
+    uint8_t const * const octets = (uint8_t const *)buffer;
+    size_t index = 0;
+    size_t numDecoded = 0;
+    octaspire_utf8_decode_status_t status = OCTASPIRE_UTF8_DECODE_STATUS_OK;
+
+    while (index < lengthInOctets)
+    {
+        // Eight ASCII octets, none of them null, at a time
+        while (lengthInOctets - index >= sizeof(uint64_t))
+        {
+            uint64_t word = 0;
+            memcpy(&word, octets + index, sizeof(uint64_t));
+
+            uint64_t const hasHighBit  = word & OCTASPIRE_UTF8_PRIVATE_HIGH_BITS_OF_OCTETS;
+            uint64_t const hasZeroByte =
+                (word - OCTASPIRE_UTF8_PRIVATE_LOW_BITS_OF_OCTETS) &
+                ~word &
+                OCTASPIRE_UTF8_PRIVATE_HIGH_BITS_OF_OCTETS;
+
+            if (hasHighBit || hasZeroByte)
+            {
+                break;
+            }
+
+            for (size_t i = 0; i < sizeof(uint64_t); ++i)
+            {
+                result[numDecoded + i] = octets[index + i];
+            }
+
+            index      += sizeof(uint64_t);
+            numDecoded += sizeof(uint64_t);
+        }
+
+        if (index >= lengthInOctets)
+        {
+            break;
+        }
+
+        uint8_t const octet0 = octets[index];
+        size_t const available = lengthInOctets - index;
+        uint32_t character = 0;
+        size_t numOctets = 0;
+
+        if (octet0 != 0 && octet0 < 0x80)
+        {
+            character = octet0;
+            numOctets = 1;
+        }
+        else if (octet0 >= 0xC2 && octet0 <= 0xDF)
+        {
+            if (available >= 2 &&
+                octaspire_utf8_private_is_continuation_octet(octets[index + 1]))
+            {
+                character = ((uint32_t)(octet0 & 0x1F) << 6) |
+                    (uint32_t)(octets[index + 1] & 0x3F);
+
+                numOctets = 2;
+            }
+        }
+        else if (octet0 >= 0xE0 && octet0 <= 0xEF)
+        {
+            if (available >= 3 &&
+                octaspire_utf8_private_is_continuation_octet(octets[index + 1]) &&
+                octaspire_utf8_private_is_continuation_octet(octets[index + 2]))
+            {
+                character = ((uint32_t)(octet0 & 0x0F) << 12) |
+                    ((uint32_t)(octets[index + 1] & 0x3F) << 6) |
+                    (uint32_t)(octets[index + 2] & 0x3F);
+
+                numOctets = (character > octaspire_utf8_private_range2_end) ? 3 : 0;
+            }
+        }
+        else if (octet0 >= 0xF0 && octet0 <= 0xF7)
+        {
+            if (available >= 4 &&
+                octaspire_utf8_private_is_continuation_octet(octets[index + 1]) &&
+                octaspire_utf8_private_is_continuation_octet(octets[index + 2]) &&
+                octaspire_utf8_private_is_continuation_octet(octets[index + 3]))
+            {
+                character = ((uint32_t)(octet0 & 0x07) << 18) |
+                    ((uint32_t)(octets[index + 1] & 0x3F) << 12) |
+                    ((uint32_t)(octets[index + 2] & 0x3F) << 6) |
+                    (uint32_t)(octets[index + 3] & 0x3F);
+
+                numOctets = (character > octaspire_utf8_private_range3_end) ? 4 : 0;
+            }
+        }
+
+        if (numOctets == 0)
+        {
+            // Not valid; let the single character decoder tell why
+            int ignored = 0;
+
+            status = octaspire_utf8_decode_character(
+                buffer + index,
+                available,
+                &character,
+                &ignored);
+
+            assert(status != OCTASPIRE_UTF8_DECODE_STATUS_OK);
+            break;
+        }
+
+        result[numDecoded] = character;
+        index += numOctets;
+        ++numDecoded;
+    }
+
+    *numOctetsDecoded        = index;
+    *numUcsCharactersDecoded = numDecoded;
+
+    return status;
+}
+
+size_t octaspire_utf8_count_ucs_characters(
+    char const * const buffer,
+    size_t const lengthInOctets)
+{
+    uint8_t const * const octets = (uint8_t const *)buffer;
+    size_t result = 0;
+    size_t index = 0;
+
+    // A continuation octet has its highest bit on and the next one off
+    while (lengthInOctets - index >= sizeof(uint64_t))
+    {
+        uint64_t word = 0;
+        memcpy(&word, octets + index, sizeof(uint64_t));
+
+        uint64_t const continuations =
+            word & ~(word << 1) & OCTASPIRE_UTF8_PRIVATE_HIGH_BITS_OF_OCTETS;
+
+        size_t numContinuations = 0;
+
+        for (uint64_t bits = continuations; bits; bits &= bits - 1)
+        {
+            ++numContinuations;
+        }
+
+        result += sizeof(uint64_t) - numContinuations;
+        index  += sizeof(uint64_t);
+    }
+
+    for (; index < lengthInOctets; ++index)
+    {
+        if (!octaspire_utf8_private_is_continuation_octet(octets[index]))
+        {
+            ++result;
+        }
+    }
+
+    return result;
+}
+
+static size_t octaspire_utf8_private_get_encoded_length_of_character(uint32_t const character)
+{
+    if (character <= octaspire_utf8_private_range1_end)
+    {
+        return 1;
+    }
+
+    if (character <= octaspire_utf8_private_range2_end)
+    {
+        return 2;
+    }
+
+    if (character <= octaspire_utf8_private_range3_end)
+    {
+        return (character >= 0xD800 && character <= 0xDFFF) ? 0 : 3;
+    }
+
+    return (character <= octaspire_utf8_private_range4_end) ? 4 : 0;
+}
+
+octaspire_utf8_encode_status_t octaspire_utf8_get_encoded_length(
+    uint32_t const * const characters,
+    size_t const numCharacters,
+    size_t * const lengthInOctets)
+{
+    size_t result = 0;
+
+    for (size_t i = 0; i < numCharacters; ++i)
+    {
+        size_t const length =
+            octaspire_utf8_private_get_encoded_length_of_character(characters[i]);
+
+        if (length == 0)
+        {
+            *lengthInOctets = result;
+            return OCTASPIRE_UTF8_ENCODE_STATUS_ILLEGAL_CHARACTER_NUMBER;
+        }
+
+        result += length;
+    }
+
+    *lengthInOctets = result;
+    return OCTASPIRE_UTF8_ENCODE_STATUS_OK;
+}
+
+octaspire_utf8_encode_status_t octaspire_utf8_encode_buffer(
+    uint32_t const * const characters,
+    size_t const numCharacters,
+    char * const result,
+    size_t const resultLengthInOctets,
+    size_t * const numOctetsEncoded,
+    size_t * const numUcsCharactersEncoded)
+{
+    uint8_t * const octets = (uint8_t*)result;
+    size_t index = 0;
+    size_t numEncoded = 0;
+    octaspire_utf8_encode_status_t status = OCTASPIRE_UTF8_ENCODE_STATUS_OK;
+
+    while (numEncoded < numCharacters)
+    {
+        // Four ASCII characters at a time
+        while (numCharacters - numEncoded >= 4 &&
+               resultLengthInOctets - index >= 4 &&
+               (characters[numEncoded]     |
+                characters[numEncoded + 1] |
+                characters[numEncoded + 2] |
+                characters[numEncoded + 3]) <= octaspire_utf8_private_range1_end)
+        {
+            octets[index]     = (uint8_t)characters[numEncoded];
+            octets[index + 1] = (uint8_t)characters[numEncoded + 1];
+            octets[index + 2] = (uint8_t)characters[numEncoded + 2];
+            octets[index + 3] = (uint8_t)characters[numEncoded + 3];
+
+            index      += 4;
+            numEncoded += 4;
+        }
+
+        if (numEncoded >= numCharacters)
+        {
+            break;
+        }
+
+        uint32_t const character = characters[numEncoded];
+
+        size_t const length =
+            octaspire_utf8_private_get_encoded_length_of_character(character);
+
+        if (length == 0)
+        {
+            status = OCTASPIRE_UTF8_ENCODE_STATUS_ILLEGAL_CHARACTER_NUMBER;
+            break;
+        }
+
+        if (resultLengthInOctets - index < length)
+        {
+            break;
+        }
+
+        switch (length)
+        {
+            case 1:
+            {
+                octets[index] = (uint8_t)character;
+            }
+            break;
+
+            case 2:
+            {
+                octets[index]     = (uint8_t)(0xC0 | (character >> 6));
+                octets[index + 1] = (uint8_t)(0x80 | (character & 0x3F));
+            }
+            break;
+
+            case 3:
+            {
+                octets[index]     = (uint8_t)(0xE0 | (character >> 12));
+                octets[index + 1] = (uint8_t)(0x80 | ((character >> 6) & 0x3F));
+                octets[index + 2] = (uint8_t)(0x80 | (character & 0x3F));
+            }
+            break;
+
+            default:
+            {
+                octets[index]     = (uint8_t)(0xF0 | (character >> 18));
+                octets[index + 1] = (uint8_t)(0x80 | ((character >> 12) & 0x3F));
+                octets[index + 2] = (uint8_t)(0x80 | ((character >> 6) & 0x3F));
+                octets[index + 3] = (uint8_t)(0x80 | (character & 0x3F));
+            }
+            break;
+        }
+
+        index += length;
+        ++numEncoded;
+    }
+
+    *numOctetsEncoded        = index;
+    *numUcsCharactersEncoded = numEncoded;
+
+    return status;
+}
+
+// Number of octets in a character that starts with 'octet', or zero if
+// it cannot start a character that is longer than one octet.
+static size_t octaspire_utf8_private_get_length_of_multioctet_character(uint8_t const octet)
+{
+    if (octet >= 0xC0 && octet <= 0xDF)
+    {
+        return 2;
+    }
+
+    if (octet >= 0xE0 && octet <= 0xEF)
+    {
+        return 3;
+    }
+
+    if (octet >= 0xF0 && octet <= 0xF7)
+    {
+        return 4;
+    }
+
+    return 0;
+}
+
+void octaspire_utf8_decoder_init(
+    octaspire_utf8_decoder_t * const self)
+{
+    self->numOctetsDecoded = 0;
+    self->numPendingOctets = 0;
+    self->status           = OCTASPIRE_UTF8_DECODE_STATUS_OK;
+    memset(self->pendingOctets, 0, sizeof(self->pendingOctets));
+}
+
+octaspire_utf8_decode_status_t octaspire_utf8_decoder_decode(
+    octaspire_utf8_decoder_t * const self,
+    char const * const chunk,
+    size_t const lengthInOctets,
+    uint32_t * const result,
+    size_t * const numUcsCharactersDecoded)
+{
+    *numUcsCharactersDecoded = 0;
+
+    if (self->status != OCTASPIRE_UTF8_DECODE_STATUS_OK)
+    {
+        return self->status;
+    }
+
+    uint8_t const * const octets = (uint8_t const *)chunk;
+    size_t index = 0;
+
+    // Complete the character left over from the previous chunk
+    if (self->numPendingOctets > 0)
+    {
+        size_t const length =
+            octaspire_utf8_private_get_length_of_multioctet_character(self->pendingOctets[0]);
+
+        while (self->numPendingOctets < length &&
+               index < lengthInOctets &&
+               octaspire_utf8_private_is_continuation_octet(octets[index]))
+        {
+            self->pendingOctets[self->numPendingOctets] = octets[index];
+            ++(self->numPendingOctets);
+            ++index;
+        }
+
+        if (self->numPendingOctets < length && index == lengthInOctets)
+        {
+            return OCTASPIRE_UTF8_DECODE_STATUS_OK;
+        }
+
+        size_t numOctets = 0;
+        size_t numDecoded = 0;
+
+        self->status = octaspire_utf8_decode_buffer(
+            (char const *)self->pendingOctets,
+            self->numPendingOctets,
+            result,
+            &numOctets,
+            &numDecoded);
+
+        if (self->status != OCTASPIRE_UTF8_DECODE_STATUS_OK)
+        {
+            return self->status;
+        }
+
+        self->numOctetsDecoded += numOctets;
+        self->numPendingOctets  = 0;
+        *numUcsCharactersDecoded = numDecoded;
+    }
+
+    size_t numOctets = 0;
+    size_t numDecoded = 0;
+
+    self->status = octaspire_utf8_decode_buffer(
+        chunk + index,
+        lengthInOctets - index,
+        result + *numUcsCharactersDecoded,
+        &numOctets,
+        &numDecoded);
+
+    self->numOctetsDecoded   += numOctets;
+    *numUcsCharactersDecoded += numDecoded;
+    index                    += numOctets;
+
+    if (self->status == OCTASPIRE_UTF8_DECODE_STATUS_OK)
+    {
+        return self->status;
+    }
+
+    // A character cut by the end of the chunk is kept for the next one
+    size_t const length =
+        octaspire_utf8_private_get_length_of_multioctet_character(octets[index]);
+
+    size_t const numAvailable = lengthInOctets - index;
+
+    if (numAvailable >= length)
+    {
+        return self->status;
+    }
+
+    for (size_t i = 1; i < numAvailable; ++i)
+    {
+        if (!octaspire_utf8_private_is_continuation_octet(octets[index + i]))
+        {
+            return self->status;
+        }
+    }
+
+    memcpy(self->pendingOctets, octets + index, numAvailable);
+    self->numPendingOctets = numAvailable;
+    self->status           = OCTASPIRE_UTF8_DECODE_STATUS_OK;
+
+    return self->status;
+}
+
+octaspire_utf8_decode_status_t octaspire_utf8_decoder_finish(
+    octaspire_utf8_decoder_t * const self)
+{
+    if (self->status == OCTASPIRE_UTF8_DECODE_STATUS_OK && self->numPendingOctets > 0)
+    {
+        self->status = OCTASPIRE_UTF8_DECODE_STATUS_INPUT_NOT_ENOUGH_OCTETS_AVAILABLE;
+    }
+
+    return self->status;
+}
+
+size_t octaspire_utf8_decoder_get_number_of_octets_decoded(
+    octaspire_utf8_decoder_t const * const self)
+{
+    return self->numOctetsDecoded;
+}
@@ -75,14 +75,11 @@ static bool octaspire_vector_private_grow(
     self->numAllocated = newNumAllocated;
 
     // Initialize new elements to zero.
-    for (size_t i = self->numElements; i < self->numAllocated; ++i)
-    {
-        void *s = ((char*)self->elements) + (i * self->elementSize);
+    void *s = ((char*)self->elements) + (self->numElements * self->elementSize);
 
-        if (s != memset(s, 0, self->elementSize))
-        {
-            abort();
-        }
+    if (s != memset(s, 0, (self->numAllocated - self->numElements) * self->elementSize))
+    {
+        abort();
     }
 
     return true;
@@ -271,6 +268,23 @@ void octaspire_vector_set_compacting_limit_for_preallocated_elements(
     self->compactingLimitForAllocated = numPreAllocatedElementsAtLeastPresentAtAnyMoment;
 }
 
+bool octaspire_vector_reserve(
+    octaspire_vector_t * const self,
+    size_t const numElements)
+{
+    while (numElements > self->numAllocated)
+    {
+        if (!octaspire_vector_private_grow(
+                self,
+                octaspire_helpers_ceilf((float)numElements / (float)self->numAllocated)))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 size_t octaspire_vector_get_length(
     octaspire_vector_t const * const self)
 {
@@ -628,6 +642,38 @@ bool octaspire_vector_push_back_element(
         octaspire_vector_get_length(self));
 }
 
+bool octaspire_vector_push_back_elements(
+    octaspire_vector_t * const self,
+    void const * const elements,
+    size_t const numElements)
+{
+    if (!numElements)
+    {
+        return true;
+    }
+
+    size_t const numNeeded = self->numElements + numElements;
+
+    while (numNeeded > self->numAllocated)
+    {
+        if (!octaspire_vector_private_grow(
+                self,
+                octaspire_helpers_ceilf((float)numNeeded / (float)self->numAllocated)))
+        {
+            return false;
+        }
+    }
+
+    memcpy(
+        octaspire_vector_private_index_to_pointer(self, self->numElements),
+        elements,
+        numElements * self->elementSize);
+
+    self->numElements = numNeeded;
+
+    return true;
+}
+
 bool octaspire_vector_push_back_char(
     octaspire_vector_t *self,
     char const element)
@@ -0,0 +1,518 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "octaspire/core/octaspire_xor_filter.h"
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include "octaspire/core/octaspire_helpers.h"
+
+// The fingerprint array is split into three blocks of equal length. Every
+// hash has one slot in each block, and the xor of its three slots equals
+// its fingerprint.
+struct octaspire_xor_filter_t
+{
+    octaspire_allocator_t *allocator;
+    uint8_t               *fingerprints;
+    size_t                 blockLength;
+    uint32_t               seed;
+    char                   padding[4];
+};
+
+typedef struct octaspire_xor_filter_private_slot_t
+{
+    uint32_t hashes;
+    uint32_t count;
+}
+octaspire_xor_filter_private_slot_t;
+
+typedef struct octaspire_xor_filter_private_peeled_t
+{
+    size_t   index;
+    uint32_t hash;
+    char     padding[4];
+}
+octaspire_xor_filter_private_peeled_t;
+
+static char const   OCTASPIRE_XOR_FILTER_PRIVATE_MAGIC[4] = {'O', 'X', 'F', '2'};
+static size_t const OCTASPIRE_XOR_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS = 12;
+static size_t const OCTASPIRE_XOR_FILTER_PRIVATE_MAX_NUM_ATTEMPTS        = 64;
+
+// Finalizer of MurmurHash3; a bijection, so distinct hashes stay distinct.
+static uint32_t octaspire_xor_filter_private_mix(uint32_t hash)
+{
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// 64 bit finalizer of MurmurHash3
+static uint64_t octaspire_xor_filter_private_mix64(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static uint64_t octaspire_xor_filter_private_rotate_left64(
+    uint64_t const value,
+    unsigned int const count)
+{
+    return (value << count) | (value >> (64 - count));
+}
+
+// Maps 'value' to [0, length) with a multiply and a shift instead of a
+// division; 'length' fits in 32 bits, as the serialized format requires.
+static size_t octaspire_xor_filter_private_reduce(
+    uint32_t const value,
+    size_t const length)
+{
+    return (size_t)(((uint64_t)value * (uint64_t)length) >> 32);
+}
+
+// The three slots come from different 32 bit windows of one 64 bit mix of
+// the seed and the hash, so that they are independent of each other. With
+// a single 32 bit mix the slots are correlated, and peeling fails for
+// every seed on some sets.
+static void octaspire_xor_filter_private_get_indices(
+    size_t const blockLength,
+    uint32_t const seed,
+    uint32_t const hash,
+    size_t indices[3])
+{
+    uint64_t const mixed =
+        octaspire_xor_filter_private_mix64(((uint64_t)seed << 32) | hash);
+
+    indices[0] = octaspire_xor_filter_private_reduce(
+        (uint32_t)mixed,
+        blockLength);
+
+    indices[1] = blockLength + octaspire_xor_filter_private_reduce(
+        (uint32_t)octaspire_xor_filter_private_rotate_left64(mixed, 21),
+        blockLength);
+
+    indices[2] = 2 * blockLength + octaspire_xor_filter_private_reduce(
+        (uint32_t)octaspire_xor_filter_private_rotate_left64(mixed, 42),
+        blockLength);
+}
+
+static uint8_t octaspire_xor_filter_private_get_fingerprint(
+    uint32_t const seed,
+    uint32_t const hash)
+{
+    return (uint8_t)(octaspire_xor_filter_private_mix(hash ^ ~seed) >> 24);
+}
+
+static void octaspire_xor_filter_private_write_uint32(
+    uint8_t * const octets,
+    uint32_t const value)
+{
+    octets[0] = (uint8_t)(value);
+    octets[1] = (uint8_t)(value >> 8);
+    octets[2] = (uint8_t)(value >> 16);
+    octets[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t octaspire_xor_filter_private_read_uint32(
+    uint8_t const * const octets)
+{
+    return (uint32_t)octets[0] |
+        ((uint32_t)octets[1] << 8) |
+        ((uint32_t)octets[2] << 16) |
+        ((uint32_t)octets[3] << 24);
+}
+
+static int octaspire_xor_filter_private_compare_hashes(
+    void const * const first,
+    void const * const second)
+{
+    uint32_t const a = *(uint32_t const *)first;
+    uint32_t const b = *(uint32_t const *)second;
+    return (a > b) - (a < b);
+}
+
+static octaspire_xor_filter_t *octaspire_xor_filter_private_new_with_block_length(
+    size_t const blockLength,
+    octaspire_allocator_t *allocator)
+{
+    octaspire_xor_filter_t *self =
+        octaspire_allocator_malloc(allocator, sizeof(octaspire_xor_filter_t));
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->allocator   = allocator;
+    self->blockLength = blockLength;
+    self->seed        = 0;
+
+    self->fingerprints =
+        octaspire_allocator_malloc(self->allocator, 3 * blockLength);
+
+    if (!self->fingerprints)
+    {
+        octaspire_xor_filter_release(self);
+        self = 0;
+        return 0;
+    }
+
+    return self;
+}
+
+// Tries to peel every hash with the current seed, recording the order in
+// 'peeled'. Returns false if the hypergraph has a cycle.
+static bool octaspire_xor_filter_private_peel(
+    octaspire_xor_filter_t const * const self,
+    uint32_t const * const hashes,
+    size_t const numHashes,
+    octaspire_xor_filter_private_slot_t * const slots,
+    size_t * const queue,
+    octaspire_xor_filter_private_peeled_t * const peeled)
+{
+    size_t const numSlots = 3 * self->blockLength;
+    size_t indices[3];
+
+    memset(slots, 0, numSlots * sizeof(octaspire_xor_filter_private_slot_t));
+
+    for (size_t i = 0; i < numHashes; ++i)
+    {
+        octaspire_xor_filter_private_get_indices(
+            self->blockLength, self->seed, hashes[i], indices);
+
+        for (size_t j = 0; j < 3; ++j)
+        {
+            slots[indices[j]].hashes ^= hashes[i];
+            ++(slots[indices[j]].count);
+        }
+    }
+
+    size_t queueLength = 0;
+
+    for (size_t i = 0; i < numSlots; ++i)
+    {
+        if (slots[i].count == 1)
+        {
+            queue[queueLength++] = i;
+        }
+    }
+
+    size_t numPeeled = 0;
+
+    while (queueLength)
+    {
+        size_t const index = queue[--queueLength];
+
+        // Slots can be queued more than once; the first visit empties it.
+        if (slots[index].count != 1)
+        {
+            continue;
+        }
+
+        uint32_t const hash = slots[index].hashes;
+
+        peeled[numPeeled].index = index;
+        peeled[numPeeled].hash  = hash;
+        ++numPeeled;
+
+        octaspire_xor_filter_private_get_indices(
+            self->blockLength, self->seed, hash, indices);
+
+        for (size_t j = 0; j < 3; ++j)
+        {
+            slots[indices[j]].hashes ^= hash;
+            --(slots[indices[j]].count);
+
+            if (slots[indices[j]].count == 1)
+            {
+                queue[queueLength++] = indices[j];
+            }
+        }
+    }
+
+    return numPeeled == numHashes;
+}
+
+octaspire_xor_filter_t *octaspire_xor_filter_new_from_hashes(
+    uint32_t const * const hashes,
+    size_t const numHashes,
+    octaspire_allocator_t *allocator)
+{
+    // Sorted copy without duplicates
+    uint32_t *uniqueHashes = octaspire_allocator_malloc(
+        allocator,
+        (numHashes ? numHashes : 1) * sizeof(uint32_t));
+
+    if (!uniqueHashes)
+    {
+        return 0;
+    }
+
+    size_t numUniqueHashes = 0;
+
+    if (numHashes)
+    {
+        memcpy(uniqueHashes, hashes, numHashes * sizeof(uint32_t));
+
+        qsort(
+            uniqueHashes,
+            numHashes,
+            sizeof(uint32_t),
+            octaspire_xor_filter_private_compare_hashes);
+
+        numUniqueHashes = 1;
+
+        for (size_t i = 1; i < numHashes; ++i)
+        {
+            if (uniqueHashes[i] != uniqueHashes[numUniqueHashes - 1])
+            {
+                uniqueHashes[numUniqueHashes++] = uniqueHashes[i];
+            }
+        }
+    }
+
+    size_t const numSlots    = 32 + (123 * numUniqueHashes + 99) / 100;
+    size_t const blockLength = (numSlots + 2) / 3;
+
+    octaspire_xor_filter_t *self =
+        octaspire_xor_filter_private_new_with_block_length(blockLength, allocator);
+
+    octaspire_xor_filter_private_slot_t *slots = octaspire_allocator_malloc(
+        allocator,
+        3 * blockLength * sizeof(octaspire_xor_filter_private_slot_t));
+
+    // A slot is queued at most twice: initially and when its count drops
+    // to one.
+    size_t *queue = octaspire_allocator_malloc(
+        allocator,
+        6 * blockLength * sizeof(size_t));
+
+    octaspire_xor_filter_private_peeled_t *peeled = octaspire_allocator_malloc(
+        allocator,
+        (numUniqueHashes ? numUniqueHashes : 1) *
+            sizeof(octaspire_xor_filter_private_peeled_t));
+
+    bool isBuilt = false;
+
+    if (self && slots && queue && peeled)
+    {
+        for (size_t attempt = 0;
+             attempt < OCTASPIRE_XOR_FILTER_PRIVATE_MAX_NUM_ATTEMPTS;
+             ++attempt)
+        {
+            self->seed = octaspire_xor_filter_private_mix((uint32_t)attempt + 0x9e3779b9U);
+
+            if (octaspire_xor_filter_private_peel(
+                    self, uniqueHashes, numUniqueHashes, slots, queue, peeled))
+            {
+                isBuilt = true;
+                break;
+            }
+        }
+    }
+
+    if (isBuilt)
+    {
+        // Assign in reverse peeling order, so that the slot of every hash
+        // is still free when it is reached.
+        for (size_t i = numUniqueHashes; i > 0; --i)
+        {
+            octaspire_xor_filter_private_peeled_t const * const entry = &peeled[i - 1];
+
+            size_t indices[3];
+
+            octaspire_xor_filter_private_get_indices(
+                blockLength, self->seed, entry->hash, indices);
+
+            self->fingerprints[entry->index] = 0;
+
+            self->fingerprints[entry->index] = (uint8_t)(
+                octaspire_xor_filter_private_get_fingerprint(self->seed, entry->hash) ^
+                self->fingerprints[indices[0]] ^
+                self->fingerprints[indices[1]] ^
+                self->fingerprints[indices[2]]);
+        }
+    }
+
+    octaspire_allocator_free(allocator, peeled);
+    octaspire_allocator_free(allocator, queue);
+    octaspire_allocator_free(allocator, slots);
+    octaspire_allocator_free(allocator, uniqueHashes);
+
+    if (!isBuilt)
+    {
+        octaspire_xor_filter_release(self);
+        self = 0;
+    }
+
+    return self;
+}
+
+octaspire_xor_filter_t *octaspire_xor_filter_new_from_vector(
+    octaspire_vector_t const * const keys,
+    octaspire_map_key_hash_function_t hashFunction,
+    octaspire_allocator_t *allocator)
+{
+    size_t const numKeys = octaspire_vector_get_length(keys);
+
+    uint32_t *hashes = octaspire_allocator_malloc(
+        allocator,
+        (numKeys ? numKeys : 1) * sizeof(uint32_t));
+
+    if (!hashes)
+    {
+        return 0;
+    }
+
+    for (size_t i = 0; i < numKeys; ++i)
+    {
+        hashes[i] = hashFunction(octaspire_vector_get_element_at_const(keys, (ptrdiff_t)i));
+    }
+
+    octaspire_xor_filter_t * const self =
+        octaspire_xor_filter_new_from_hashes(hashes, numKeys, allocator);
+
+    octaspire_allocator_free(allocator, hashes);
+
+    return self;
+}
+
+octaspire_xor_filter_t *octaspire_xor_filter_new_from_buffer(
+    void const * const buffer,
+    size_t const lengthInOctets,
+    octaspire_allocator_t *allocator)
+{
+    uint8_t const * const octets = buffer;
+
+    if (lengthInOctets < OCTASPIRE_XOR_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS ||
+        memcmp(octets, OCTASPIRE_XOR_FILTER_PRIVATE_MAGIC, 4) != 0)
+    {
+        return 0;
+    }
+
+    uint32_t const seed        = octaspire_xor_filter_private_read_uint32(octets + 4);
+    size_t const   blockLength = octaspire_xor_filter_private_read_uint32(octets + 8);
+
+    if (!blockLength ||
+        (lengthInOctets - OCTASPIRE_XOR_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS) / 3 !=
+            blockLength ||
+        (lengthInOctets - OCTASPIRE_XOR_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS) % 3 != 0)
+    {
+        return 0;
+    }
+
+    octaspire_xor_filter_t * const self =
+        octaspire_xor_filter_private_new_with_block_length(blockLength, allocator);
+
+    if (!self)
+    {
+        return self;
+    }
+
+    self->seed = seed;
+
+    memcpy(
+        self->fingerprints,
+        octets + OCTASPIRE_XOR_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS,
+        3 * blockLength);
+
+    return self;
+}
+
+void octaspire_xor_filter_release(octaspire_xor_filter_t *self)
+{
+    if (!self)
+    {
+        return;
+    }
+
+    octaspire_allocator_free(self->allocator, self->fingerprints);
+    self->fingerprints = 0;
+
+    octaspire_allocator_free(self->allocator, self);
+}
+
+bool octaspire_xor_filter_may_contain(
+    octaspire_xor_filter_t const * const self,
+    uint32_t const hash)
+{
+    size_t indices[3];
+
+    octaspire_xor_filter_private_get_indices(self->blockLength, self->seed, hash, indices);
+
+    return octaspire_xor_filter_private_get_fingerprint(self->seed, hash) ==
+        (uint8_t)(self->fingerprints[indices[0]] ^
+                  self->fingerprints[indices[1]] ^
+                  self->fingerprints[indices[2]]);
+}
+
+size_t octaspire_xor_filter_get_length_in_octets(
+    octaspire_xor_filter_t const * const self)
+{
+    return 3 * self->blockLength;
+}
+
+octaspire_vector_t *octaspire_xor_filter_serialize(
+    octaspire_xor_filter_t const * const self,
+    octaspire_allocator_t *allocator)
+{
+    if (self->blockLength > 0xFFFFFFFFU)
+    {
+        return 0;
+    }
+
+    size_t const numOctets =
+        OCTASPIRE_XOR_FILTER_PRIVATE_HEADER_LENGTH_IN_OCTETS +
+        octaspire_xor_filter_get_length_in_octets(self);
+
+    octaspire_vector_t * const result = octaspire_vector_new_with_preallocated_elements(
+        sizeof(uint8_t),
+        false,
+        numOctets,
+        0,
+        allocator);
+
+    if (!result)
+    {
+        return result;
+    }
+
+    uint8_t header[12];
+    memcpy(header, OCTASPIRE_XOR_FILTER_PRIVATE_MAGIC, 4);
+    octaspire_xor_filter_private_write_uint32(header + 4, self->seed);
+    octaspire_xor_filter_private_write_uint32(header + 8, (uint32_t)self->blockLength);
+
+    for (size_t i = 0; i < sizeof(header); ++i)
+    {
+        octaspire_helpers_verify_true(
+            octaspire_vector_push_back_element(result, &header[i]));
+    }
+
+    for (size_t i = 0; i < octaspire_xor_filter_get_length_in_octets(self); ++i)
+    {
+        octaspire_helpers_verify_true(
+            octaspire_vector_push_back_element(result, &self->fingerprints[i]));
+    }
+
+    return result;
+}
+
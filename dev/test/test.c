@@ -29,6 +29,20 @@ extern SUITE(octaspire_string_suite);
 extern SUITE(octaspire_pair_suite);
 extern SUITE(octaspire_map_suite);
 extern SUITE(octaspire_semver_suite);
+extern SUITE(octaspire_hamt_suite);
+extern SUITE(octaspire_btree_suite);
+extern SUITE(octaspire_radix_tree_suite);
+extern SUITE(octaspire_atom_table_suite);
+extern SUITE(octaspire_lru_cache_suite);
+extern SUITE(octaspire_bloom_filter_suite);
+extern SUITE(octaspire_xor_filter_suite);
+extern SUITE(octaspire_flat_map_suite);
+extern SUITE(octaspire_static_map_suite);
+extern SUITE(octaspire_rope_suite);
+extern SUITE(octaspire_string_view_suite);
+extern SUITE(octaspire_aho_corasick_suite);
+extern SUITE(octaspire_bk_tree_suite);
+extern SUITE(octaspire_utf16_suite);
 
 void octaspire_core_amalgamated_write_test_file(
     char const * const name,
@@ -233,5 +247,19 @@ int main(int argc, char **argv)
     RUN_SUITE(octaspire_pair_suite);
     RUN_SUITE(octaspire_map_suite);
     RUN_SUITE(octaspire_semver_suite);
+    RUN_SUITE(octaspire_hamt_suite);
+    RUN_SUITE(octaspire_btree_suite);
+    RUN_SUITE(octaspire_radix_tree_suite);
+    RUN_SUITE(octaspire_atom_table_suite);
+    RUN_SUITE(octaspire_lru_cache_suite);
+    RUN_SUITE(octaspire_bloom_filter_suite);
+    RUN_SUITE(octaspire_xor_filter_suite);
+    RUN_SUITE(octaspire_flat_map_suite);
+    RUN_SUITE(octaspire_static_map_suite);
+    RUN_SUITE(octaspire_rope_suite);
+    RUN_SUITE(octaspire_string_view_suite);
+    RUN_SUITE(octaspire_aho_corasick_suite);
+    RUN_SUITE(octaspire_bk_tree_suite);
+    RUN_SUITE(octaspire_utf16_suite);
     GREATEST_MAIN_END();
 }
@@ -0,0 +1,343 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_aho_corasick.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_aho_corasick.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_vector.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireAhoCorasickTestAllocator = 0;
+
+TEST octaspire_aho_corasick_new_test(void)
+{
+    char const * const words[] = { "he", "she", "his", "hers" };
+    size_t const numWords = sizeof(words) / sizeof(words[0]);
+
+    octaspire_vector_t *patterns = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireAhoCorasickTestAllocator);
+
+    ASSERT(patterns);
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        octaspire_string_t *pattern =
+            octaspire_string_new(words[i], octaspireAhoCorasickTestAllocator);
+
+        ASSERT(pattern);
+        ASSERT(octaspire_vector_push_back_element(patterns, &pattern));
+    }
+
+    octaspire_aho_corasick_t *automaton =
+        octaspire_aho_corasick_new(patterns, octaspireAhoCorasickTestAllocator);
+
+    ASSERT(automaton);
+    ASSERT_EQ(4, octaspire_aho_corasick_get_number_of_patterns(automaton));
+
+    // Root, h, he, her, hers, hi, his, s, sh, she
+    ASSERT_EQ(10, octaspire_aho_corasick_get_number_of_states(automaton));
+
+    octaspire_vector_t *matches =
+        octaspire_aho_corasick_find_all_in_buffer(automaton, "ushers his", 10);
+
+    ASSERT(matches);
+    ASSERT_EQ(4, octaspire_vector_get_length(matches));
+
+    size_t const expected[][2] =
+    {
+        { 1, 1 },
+        { 0, 2 },
+        { 3, 2 },
+        { 2, 7 }
+    };
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        octaspire_aho_corasick_match_t const * const match =
+            octaspire_vector_get_element_at_const(matches, (ptrdiff_t)i);
+
+        ASSERT_EQ(expected[i][0], match->patternIndex);
+        ASSERT_EQ(expected[i][1], match->octetIndex);
+        ASSERT_EQ(expected[i][1], match->ucsIndex);
+    }
+
+    octaspire_vector_release(matches);
+    matches = 0;
+
+    octaspire_aho_corasick_release(automaton);
+    automaton = 0;
+
+    octaspire_vector_release(patterns);
+    patterns = 0;
+
+    PASS();
+}
+
+TEST octaspire_aho_corasick_new_fails_on_empty_pattern_test(void)
+{
+    char const * const words[] = { "a", "" };
+    size_t const numWords = sizeof(words) / sizeof(words[0]);
+
+    octaspire_vector_t *patterns = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireAhoCorasickTestAllocator);
+
+    ASSERT(patterns);
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        octaspire_string_t *pattern =
+            octaspire_string_new(words[i], octaspireAhoCorasickTestAllocator);
+
+        ASSERT(pattern);
+        ASSERT(octaspire_vector_push_back_element(patterns, &pattern));
+    }
+
+    ASSERT_FALSE(octaspire_aho_corasick_new(patterns, octaspireAhoCorasickTestAllocator));
+
+    octaspire_vector_release(patterns);
+    patterns = 0;
+
+    // Without patterns there are no matches
+    patterns = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireAhoCorasickTestAllocator);
+
+    ASSERT(patterns);
+
+    octaspire_aho_corasick_t *automaton =
+        octaspire_aho_corasick_new(patterns, octaspireAhoCorasickTestAllocator);
+
+    ASSERT(automaton);
+    ASSERT_EQ(1, octaspire_aho_corasick_get_number_of_states(automaton));
+
+    octaspire_aho_corasick_iterator_t iterator;
+    octaspire_aho_corasick_iterator_init(&iterator, automaton, "abc", 3);
+
+    octaspire_aho_corasick_match_t match;
+    ASSERT_FALSE(octaspire_aho_corasick_iterator_next(&iterator, &match));
+
+    octaspire_aho_corasick_release(automaton);
+    automaton = 0;
+
+    octaspire_vector_release(patterns);
+    patterns = 0;
+
+    PASS();
+}
+
+TEST octaspire_aho_corasick_find_all_in_string_test(void)
+{
+    char const * const words[] = { "\xC3\xA4\xC3\xA4", "x\xE2\x82\xAC", "\xC3\xA4", "x\xE2\x82\xAC" };
+    size_t const numWords = sizeof(words) / sizeof(words[0]);
+
+    octaspire_vector_t *patterns = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireAhoCorasickTestAllocator);
+
+    ASSERT(patterns);
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        octaspire_string_t *pattern =
+            octaspire_string_new(words[i], octaspireAhoCorasickTestAllocator);
+
+        ASSERT(pattern);
+        ASSERT(octaspire_vector_push_back_element(patterns, &pattern));
+    }
+
+    octaspire_aho_corasick_t *automaton =
+        octaspire_aho_corasick_new(patterns, octaspireAhoCorasickTestAllocator);
+
+    ASSERT(automaton);
+
+    octaspire_string_t *str = octaspire_string_new(
+        "ax\xE2\x82\xAC\xC3\xA4\xC3\xA4",
+        octaspireAhoCorasickTestAllocator);
+
+    ASSERT(str);
+
+    octaspire_vector_t *matches = octaspire_aho_corasick_find_all_in_string(automaton, str);
+
+    ASSERT(matches);
+
+    // Pattern index, octet index and UCS index of every match
+    size_t const expected[][3] =
+    {
+        { 1, 1, 1 },
+        { 3, 1, 1 },
+        { 2, 5, 3 },
+        { 0, 5, 3 },
+        { 2, 7, 4 }
+    };
+
+    ASSERT_EQ(5, octaspire_vector_get_length(matches));
+
+    for (size_t i = 0; i < 5; ++i)
+    {
+        octaspire_aho_corasick_match_t const * const match =
+            octaspire_vector_get_element_at_const(matches, (ptrdiff_t)i);
+
+        ASSERT_EQ(expected[i][0], match->patternIndex);
+        ASSERT_EQ(expected[i][1], match->octetIndex);
+        ASSERT_EQ(expected[i][2], match->ucsIndex);
+    }
+
+    octaspire_vector_release(matches);
+    matches = 0;
+
+    octaspire_string_release(str);
+    str = 0;
+
+    octaspire_aho_corasick_release(automaton);
+    automaton = 0;
+
+    octaspire_vector_release(patterns);
+    patterns = 0;
+
+    PASS();
+}
+
+TEST octaspire_aho_corasick_random_test(void)
+{
+    // Compare against checking every pattern at every end position.
+    // Matches that end at the same octet come longest first, and equal
+    // patterns in the order of their indices.
+    size_t const numPatterns = 300;
+    size_t const textLength  = 3000;
+
+    octaspire_vector_t *patterns = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireAhoCorasickTestAllocator);
+
+    ASSERT(patterns);
+
+    char *text = octaspire_allocator_malloc(octaspireAhoCorasickTestAllocator, textLength);
+
+    ASSERT(text);
+
+    uint32_t seed = 99;
+
+    for (size_t i = 0; i < numPatterns; ++i)
+    {
+        char buffer[8];
+
+        seed = seed * 1103515245u + 12345u;
+        size_t const length = 1 + (seed >> 16) % 7;
+
+        for (size_t j = 0; j < length; ++j)
+        {
+            seed = seed * 1103515245u + 12345u;
+            buffer[j] = (char)('a' + (seed >> 16) % 4);
+        }
+
+        octaspire_string_t *pattern = octaspire_string_new_from_buffer(
+            buffer,
+            length,
+            octaspireAhoCorasickTestAllocator);
+
+        ASSERT(pattern);
+        ASSERT(octaspire_vector_push_back_element(patterns, &pattern));
+    }
+
+    for (size_t i = 0; i < textLength; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        text[i] = (char)('a' + (seed >> 16) % 5);
+    }
+
+    octaspire_aho_corasick_t *automaton =
+        octaspire_aho_corasick_new(patterns, octaspireAhoCorasickTestAllocator);
+
+    ASSERT(automaton);
+
+    octaspire_aho_corasick_iterator_t iterator;
+    octaspire_aho_corasick_iterator_init(&iterator, automaton, text, textLength);
+
+    octaspire_aho_corasick_match_t match;
+    size_t numMatches = 0;
+
+    for (size_t end = 1; end <= textLength; ++end)
+    {
+        for (size_t length = 7; length > 0; --length)
+        {
+            for (size_t i = 0; i < numPatterns; ++i)
+            {
+                octaspire_string_t const * const pattern =
+                    octaspire_vector_get_element_at_const(patterns, (ptrdiff_t)i);
+
+                if (octaspire_string_get_length_in_octets(pattern) != length ||
+                    length > end ||
+                    memcmp(
+                        text + end - length,
+                        octaspire_string_get_c_string(pattern),
+                        length) != 0)
+                {
+                    continue;
+                }
+
+                ASSERT(octaspire_aho_corasick_iterator_next(&iterator, &match));
+                ASSERT_EQ(i, match.patternIndex);
+                ASSERT_EQ(end - length, match.octetIndex);
+                ++numMatches;
+            }
+        }
+    }
+
+    ASSERT_FALSE(octaspire_aho_corasick_iterator_next(&iterator, &match));
+    ASSERT(numMatches > textLength);
+
+    octaspire_aho_corasick_release(automaton);
+    automaton = 0;
+
+    octaspire_allocator_free(octaspireAhoCorasickTestAllocator, text);
+    text = 0;
+
+    octaspire_vector_release(patterns);
+    patterns = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_aho_corasick_suite)
+{
+    octaspireAhoCorasickTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireAhoCorasickTestAllocator);
+
+    RUN_TEST(octaspire_aho_corasick_new_test);
+    RUN_TEST(octaspire_aho_corasick_new_fails_on_empty_pattern_test);
+    RUN_TEST(octaspire_aho_corasick_find_all_in_string_test);
+    RUN_TEST(octaspire_aho_corasick_random_test);
+
+    octaspire_allocator_release(octaspireAhoCorasickTestAllocator);
+    octaspireAhoCorasickTestAllocator = 0;
+}
+
@@ -0,0 +1,348 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_atom_table.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_atom_table.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireAtomTableTestAllocator = 0;
+
+TEST octaspire_atom_table_new_test(void)
+{
+    octaspire_atom_table_t *table =
+        octaspire_atom_table_new(octaspireAtomTableTestAllocator);
+
+    ASSERT(table);
+    ASSERT_EQ(octaspireAtomTableTestAllocator, table->allocator);
+    ASSERT_EQ(0, octaspire_atom_table_get_number_of_atoms(table));
+    ASSERT_EQ(OCTASPIRE_ATOM_TABLE_PRIVATE_SMALLEST_NUM_SLOTS, table->numSlots);
+
+    ASSERT_EQ(
+        OCTASPIRE_ATOM_TABLE_INVALID_ATOM,
+        octaspire_atom_table_find(table, "a", 1));
+
+    octaspire_atom_table_release(table);
+    table = 0;
+
+    PASS();
+}
+
+TEST octaspire_atom_table_new_allocation_failure_on_first_allocation_test(void)
+{
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireAtomTableTestAllocator,
+        1,
+        0);
+
+    octaspire_atom_table_t *table =
+        octaspire_atom_table_new(octaspireAtomTableTestAllocator);
+
+    ASSERT_FALSE(table);
+
+    ASSERT_EQ(
+        0,
+        octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+            octaspireAtomTableTestAllocator));
+
+    PASS();
+}
+
+TEST octaspire_atom_table_new_allocation_failure_on_later_allocations_test(void)
+{
+    for (size_t i = 1; i < 6; ++i)
+    {
+        octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+            octaspireAtomTableTestAllocator,
+            i + 1,
+            ~((uint32_t)1 << i));
+
+        octaspire_atom_table_t *table =
+            octaspire_atom_table_new(octaspireAtomTableTestAllocator);
+
+        octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+            octaspireAtomTableTestAllocator,
+            0,
+            0);
+
+        if (table)
+        {
+            ASSERT_EQ(0, octaspire_atom_table_intern_c_string(table, "abc"));
+            octaspire_atom_table_release(table);
+            table = 0;
+        }
+    }
+
+    PASS();
+}
+
+TEST octaspire_atom_table_intern_test(void)
+{
+    octaspire_atom_table_t *table =
+        octaspire_atom_table_new(octaspireAtomTableTestAllocator);
+
+    ASSERT(table);
+
+    octaspire_atom_t const a = octaspire_atom_table_intern_c_string(table, "alpha");
+    octaspire_atom_t const b = octaspire_atom_table_intern_c_string(table, "beta");
+    octaspire_atom_t const c = octaspire_atom_table_intern(table, "alphabet", 5);
+
+    ASSERT_EQ(0, a);
+    ASSERT_EQ(1, b);
+    ASSERT_EQ(a, c);
+    ASSERT_EQ(2, octaspire_atom_table_get_number_of_atoms(table));
+
+    char const * const alpha = octaspire_atom_table_get_c_string(table, a);
+    ASSERT_STR_EQ("alpha", alpha);
+    ASSERT_EQ(5, octaspire_atom_table_get_length_in_octets(table, a));
+    ASSERT_STR_EQ("beta", octaspire_atom_table_get_c_string(table, b));
+    ASSERT_EQ(4, octaspire_atom_table_get_length_in_octets(table, b));
+
+    ASSERT_EQ(
+        octaspire_helpers_calculate_hash_for_memory_buffer_argument("beta", 4),
+        octaspire_atom_table_get_hash(table, b));
+
+    // The canonical copy is shared by all interned equal strings.
+    char buffer[] = "alpha";
+    ASSERT_EQ(a, octaspire_atom_table_intern_c_string(table, buffer));
+    ASSERT_EQ(alpha, octaspire_atom_table_get_c_string(table, a));
+    ASSERT(buffer != alpha);
+
+    ASSERT_EQ(a, octaspire_atom_table_find(table, "alpha", 5));
+    ASSERT_EQ(b, octaspire_atom_table_find(table, "beta", 4));
+    ASSERT_EQ(OCTASPIRE_ATOM_TABLE_INVALID_ATOM, octaspire_atom_table_find(table, "bet", 3));
+    ASSERT_EQ(OCTASPIRE_ATOM_TABLE_INVALID_ATOM, octaspire_atom_table_find(table, "gamma", 5));
+    ASSERT_EQ(2, octaspire_atom_table_get_number_of_atoms(table));
+
+    octaspire_atom_table_release(table);
+    table = 0;
+
+    PASS();
+}
+
+TEST octaspire_atom_table_intern_empty_and_embedded_nul_test(void)
+{
+    octaspire_atom_table_t *table =
+        octaspire_atom_table_new(octaspireAtomTableTestAllocator);
+
+    ASSERT(table);
+
+    octaspire_atom_t const empty = octaspire_atom_table_intern(table, "", 0);
+    octaspire_atom_t const a     = octaspire_atom_table_intern(table, "a\0b", 3);
+    octaspire_atom_t const b     = octaspire_atom_table_intern(table, "a\0c", 3);
+    octaspire_atom_t const c     = octaspire_atom_table_intern(table, "a", 1);
+
+    ASSERT_EQ(0, empty);
+    ASSERT_EQ(1, a);
+    ASSERT_EQ(2, b);
+    ASSERT_EQ(3, c);
+
+    ASSERT_EQ(empty, octaspire_atom_table_intern_c_string(table, ""));
+    ASSERT_EQ(a, octaspire_atom_table_find(table, "a\0b", 3));
+    ASSERT_STR_EQ("", octaspire_atom_table_get_c_string(table, empty));
+    ASSERT_EQ(0, octaspire_atom_table_get_length_in_octets(table, empty));
+    ASSERT_EQ(3, octaspire_atom_table_get_length_in_octets(table, a));
+    ASSERT_MEM_EQ("a\0b", octaspire_atom_table_get_c_string(table, a), 4);
+
+    octaspire_atom_table_release(table);
+    table = 0;
+
+    PASS();
+}
+
+TEST octaspire_atom_table_intern_string_test(void)
+{
+    octaspire_atom_table_t *table =
+        octaspire_atom_table_new(octaspireAtomTableTestAllocator);
+
+    ASSERT(table);
+
+    octaspire_string_t *str =
+        octaspire_string_new("Hello, World!", octaspireAtomTableTestAllocator);
+
+    ASSERT(str);
+
+    octaspire_atom_t const atom = octaspire_atom_table_intern_string(table, str);
+
+    ASSERT_EQ(0, atom);
+    ASSERT_EQ(atom, octaspire_atom_table_intern_c_string(table, "Hello, World!"));
+    ASSERT_STR_EQ(
+        octaspire_string_get_c_string(str),
+        octaspire_atom_table_get_c_string(table, atom));
+
+    octaspire_string_release(str);
+    str = 0;
+
+    octaspire_atom_table_release(table);
+    table = 0;
+
+    PASS();
+}
+
+TEST octaspire_atom_table_intern_many_test(void)
+{
+    octaspire_atom_table_t *table =
+        octaspire_atom_table_new(octaspireAtomTableTestAllocator);
+
+    ASSERT(table);
+
+    size_t const numAtoms = 5000;
+    char const *canonical[5000];
+    char buffer[32];
+
+    for (size_t i = 0; i < numAtoms; ++i)
+    {
+        int const length = snprintf(buffer, sizeof(buffer), "atom-%zu", i);
+        ASSERT(length > 0);
+
+        ASSERT_EQ(i, octaspire_atom_table_intern(table, buffer, (size_t)length));
+        canonical[i] = octaspire_atom_table_get_c_string(table, i);
+    }
+
+    // Longer than a block
+    char longOctets[6000];
+    memset(longOctets, 'x', sizeof(longOctets));
+
+    ASSERT_EQ(
+        numAtoms,
+        octaspire_atom_table_intern(table, longOctets, sizeof(longOctets)));
+
+    ASSERT_EQ(numAtoms + 1, octaspire_atom_table_get_number_of_atoms(table));
+    ASSERT(table->numSlots >= 2 * (numAtoms + 1));
+
+    for (size_t i = 0; i < numAtoms; ++i)
+    {
+        int const length = snprintf(buffer, sizeof(buffer), "atom-%zu", i);
+
+        ASSERT_EQ(i, octaspire_atom_table_find(table, buffer, (size_t)length));
+        ASSERT_EQ(i, octaspire_atom_table_intern(table, buffer, (size_t)length));
+
+        // Canonical copies never move.
+        ASSERT_EQ(canonical[i], octaspire_atom_table_get_c_string(table, i));
+        ASSERT_STR_EQ(buffer, canonical[i]);
+    }
+
+    ASSERT_EQ(numAtoms + 1, octaspire_atom_table_get_number_of_atoms(table));
+
+    ASSERT_MEM_EQ(
+        longOctets,
+        octaspire_atom_table_get_c_string(table, numAtoms),
+        sizeof(longOctets));
+
+    octaspire_atom_table_release(table);
+    table = 0;
+
+    PASS();
+}
+
+TEST octaspire_atom_table_intern_allocation_failure_test(void)
+{
+    octaspire_atom_table_t *table =
+        octaspire_atom_table_new(octaspireAtomTableTestAllocator);
+
+    ASSERT(table);
+
+    char buffer[32];
+
+    // 32 atoms fill the first index to its load limit; the next one grows
+    // it. Fail each of the first few allocations of interning in turn.
+    for (size_t i = 0; i < 32; ++i)
+    {
+        int const length = snprintf(buffer, sizeof(buffer), "%zu", i);
+
+        for (size_t j = 0; j < 3; ++j)
+        {
+            octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+                octaspireAtomTableTestAllocator,
+                j + 1,
+                ~((uint32_t)1 << j));
+
+            octaspire_atom_t const atom =
+                octaspire_atom_table_intern(table, buffer, (size_t)length);
+
+            octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+                octaspireAtomTableTestAllocator,
+                0,
+                0);
+
+            if (atom == OCTASPIRE_ATOM_TABLE_INVALID_ATOM)
+            {
+                ASSERT_EQ(i, octaspire_atom_table_get_number_of_atoms(table));
+
+                ASSERT_EQ(
+                    OCTASPIRE_ATOM_TABLE_INVALID_ATOM,
+                    octaspire_atom_table_find(table, buffer, (size_t)length));
+            }
+            else
+            {
+                ASSERT_EQ(i, atom);
+                ASSERT_EQ(i + 1, octaspire_atom_table_get_number_of_atoms(table));
+            }
+        }
+
+        ASSERT_EQ(i, octaspire_atom_table_intern(table, buffer, (size_t)length));
+    }
+
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireAtomTableTestAllocator,
+        1,
+        0);
+
+    ASSERT_EQ(
+        OCTASPIRE_ATOM_TABLE_INVALID_ATOM,
+        octaspire_atom_table_intern_c_string(table, "grow"));
+
+    ASSERT_EQ(OCTASPIRE_ATOM_TABLE_PRIVATE_SMALLEST_NUM_SLOTS, table->numSlots);
+    ASSERT_EQ(32, octaspire_atom_table_get_number_of_atoms(table));
+
+    for (size_t i = 0; i < 32; ++i)
+    {
+        int const length = snprintf(buffer, sizeof(buffer), "%zu", i);
+        ASSERT_EQ(i, octaspire_atom_table_find(table, buffer, (size_t)length));
+        ASSERT_STR_EQ(buffer, octaspire_atom_table_get_c_string(table, i));
+    }
+
+    ASSERT_EQ(32, octaspire_atom_table_intern_c_string(table, "grow"));
+    ASSERT(table->numSlots > OCTASPIRE_ATOM_TABLE_PRIVATE_SMALLEST_NUM_SLOTS);
+
+    octaspire_atom_table_release(table);
+    table = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_atom_table_suite)
+{
+    octaspireAtomTableTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireAtomTableTestAllocator);
+
+    RUN_TEST(octaspire_atom_table_new_test);
+    RUN_TEST(octaspire_atom_table_new_allocation_failure_on_first_allocation_test);
+    RUN_TEST(octaspire_atom_table_new_allocation_failure_on_later_allocations_test);
+    RUN_TEST(octaspire_atom_table_intern_test);
+    RUN_TEST(octaspire_atom_table_intern_empty_and_embedded_nul_test);
+    RUN_TEST(octaspire_atom_table_intern_string_test);
+    RUN_TEST(octaspire_atom_table_intern_many_test);
+    RUN_TEST(octaspire_atom_table_intern_allocation_failure_test);
+
+    octaspire_allocator_release(octaspireAtomTableTestAllocator);
+    octaspireAtomTableTestAllocator = 0;
+}
+
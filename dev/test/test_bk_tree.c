@@ -0,0 +1,412 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_bk_tree.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_bk_tree.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_vector.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireBkTreeTestAllocator = 0;
+
+static octaspire_bk_tree_match_t const *octaspire_bk_tree_test_get_match(
+    octaspire_vector_t const * const matches,
+    size_t const index)
+{
+    return octaspire_vector_get_element_at_const(matches, (ptrdiff_t)index);
+}
+
+TEST octaspire_bk_tree_find_within_distance_test(void)
+{
+    char const * const words[] =
+    {
+        "length", "lenght", "height", "width", "depth", "len", "strlen", "l\xC3\xA4ngd"
+    };
+
+    size_t const numWords = sizeof(words) / sizeof(words[0]);
+
+    octaspire_vector_t *strings = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireBkTreeTestAllocator);
+
+    ASSERT(strings);
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        octaspire_string_t *str =
+            octaspire_string_new(words[i], octaspireBkTreeTestAllocator);
+
+        ASSERT(str);
+        ASSERT(octaspire_vector_push_back_element(strings, &str));
+    }
+
+    octaspire_bk_tree_t *tree =
+        octaspire_bk_tree_new(strings, octaspireBkTreeTestAllocator);
+
+    ASSERT(tree);
+    ASSERT_EQ(numWords, octaspire_bk_tree_get_number_of_strings(tree));
+    ASSERT_STR_EQ("depth", octaspire_string_get_c_string(
+        octaspire_bk_tree_get_string_at_index(tree, 4)));
+    ASSERT_FALSE(octaspire_bk_tree_get_string_at_index(tree, numWords));
+
+    octaspire_string_t *query =
+        octaspire_string_new("lenth", octaspireBkTreeTestAllocator);
+
+    ASSERT(query);
+
+    octaspire_vector_t *matches =
+        octaspire_bk_tree_find_within_distance(tree, query, 2);
+
+    ASSERT(matches);
+    ASSERT_EQ(4, octaspire_vector_get_length(matches));
+
+    ASSERT_EQ(0, octaspire_bk_tree_test_get_match(matches, 0)->stringIndex);
+    ASSERT_EQ(1, octaspire_bk_tree_test_get_match(matches, 0)->distance);
+    ASSERT_EQ(1, octaspire_bk_tree_test_get_match(matches, 1)->stringIndex);
+    ASSERT_EQ(2, octaspire_bk_tree_test_get_match(matches, 1)->distance);
+    ASSERT_EQ(4, octaspire_bk_tree_test_get_match(matches, 2)->stringIndex);
+    ASSERT_EQ(2, octaspire_bk_tree_test_get_match(matches, 2)->distance);
+    ASSERT_EQ(5, octaspire_bk_tree_test_get_match(matches, 3)->stringIndex);
+    ASSERT_EQ(2, octaspire_bk_tree_test_get_match(matches, 3)->distance);
+
+    octaspire_vector_release(matches);
+    matches = 0;
+
+    matches = octaspire_bk_tree_find_within_distance(tree, query, 0);
+    ASSERT(matches);
+    ASSERT(octaspire_vector_is_empty(matches));
+
+    octaspire_vector_release(matches);
+    matches = 0;
+
+    octaspire_string_release(query);
+    query = octaspire_string_new("l\xC3\xA4nge", octaspireBkTreeTestAllocator);
+    ASSERT(query);
+
+    matches = octaspire_bk_tree_find_within_distance(tree, query, 1);
+    ASSERT(matches);
+    ASSERT_EQ(1, octaspire_vector_get_length(matches));
+    ASSERT_EQ(7, octaspire_bk_tree_test_get_match(matches, 0)->stringIndex);
+    ASSERT_EQ(1, octaspire_bk_tree_test_get_match(matches, 0)->distance);
+
+    octaspire_vector_release(matches);
+    matches = 0;
+
+    octaspire_string_release(query);
+    query = 0;
+
+    octaspire_bk_tree_release(tree);
+    tree = 0;
+
+    octaspire_vector_release(strings);
+    strings = 0;
+
+    PASS();
+}
+
+TEST octaspire_bk_tree_find_nearest_test(void)
+{
+    char const * const words[] = { "abc", "abd", "abc", "xyz", "ab", "abcd" };
+    size_t const numWords = sizeof(words) / sizeof(words[0]);
+
+    octaspire_vector_t *strings = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireBkTreeTestAllocator);
+
+    ASSERT(strings);
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        octaspire_string_t *str =
+            octaspire_string_new(words[i], octaspireBkTreeTestAllocator);
+
+        ASSERT(str);
+        ASSERT(octaspire_vector_push_back_element(strings, &str));
+    }
+
+    octaspire_bk_tree_t *tree =
+        octaspire_bk_tree_new(strings, octaspireBkTreeTestAllocator);
+
+    ASSERT(tree);
+
+    octaspire_string_t *query =
+        octaspire_string_new("abc", octaspireBkTreeTestAllocator);
+
+    ASSERT(query);
+
+    // Duplicates are all found, and ties go to the smaller index
+    octaspire_vector_t *matches = octaspire_bk_tree_find_nearest(tree, query, 3);
+
+    ASSERT(matches);
+    ASSERT_EQ(3, octaspire_vector_get_length(matches));
+    ASSERT_EQ(0, octaspire_bk_tree_test_get_match(matches, 0)->stringIndex);
+    ASSERT_EQ(0, octaspire_bk_tree_test_get_match(matches, 0)->distance);
+    ASSERT_EQ(2, octaspire_bk_tree_test_get_match(matches, 1)->stringIndex);
+    ASSERT_EQ(0, octaspire_bk_tree_test_get_match(matches, 1)->distance);
+    ASSERT_EQ(1, octaspire_bk_tree_test_get_match(matches, 2)->stringIndex);
+    ASSERT_EQ(1, octaspire_bk_tree_test_get_match(matches, 2)->distance);
+
+    octaspire_vector_release(matches);
+    matches = 0;
+
+    matches = octaspire_bk_tree_find_nearest(tree, query, 0);
+    ASSERT(matches);
+    ASSERT(octaspire_vector_is_empty(matches));
+
+    octaspire_vector_release(matches);
+    matches = 0;
+
+    matches = octaspire_bk_tree_find_nearest(tree, query, 100);
+    ASSERT(matches);
+    ASSERT_EQ(numWords, octaspire_vector_get_length(matches));
+    ASSERT_EQ(3, octaspire_bk_tree_test_get_match(matches, numWords - 1)->stringIndex);
+    ASSERT_EQ(3, octaspire_bk_tree_test_get_match(matches, numWords - 1)->distance);
+
+    octaspire_vector_release(matches);
+    matches = 0;
+
+    octaspire_string_release(query);
+    query = 0;
+
+    octaspire_bk_tree_release(tree);
+    tree = 0;
+
+    octaspire_vector_release(strings);
+    strings = 0;
+
+    PASS();
+}
+
+TEST octaspire_bk_tree_new_empty_test(void)
+{
+    octaspire_vector_t *strings = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireBkTreeTestAllocator);
+
+    ASSERT(strings);
+
+    octaspire_bk_tree_t *tree =
+        octaspire_bk_tree_new(strings, octaspireBkTreeTestAllocator);
+
+    ASSERT(tree);
+    ASSERT_EQ(0, octaspire_bk_tree_get_number_of_strings(tree));
+
+    octaspire_string_t *query =
+        octaspire_string_new("", octaspireBkTreeTestAllocator);
+
+    ASSERT(query);
+
+    octaspire_vector_t *matches =
+        octaspire_bk_tree_find_within_distance(tree, query, 10);
+
+    ASSERT(matches);
+    ASSERT(octaspire_vector_is_empty(matches));
+
+    octaspire_vector_release(matches);
+    matches = octaspire_bk_tree_find_nearest(tree, query, 10);
+
+    ASSERT(matches);
+    ASSERT(octaspire_vector_is_empty(matches));
+
+    octaspire_vector_release(matches);
+    matches = 0;
+
+    octaspire_string_release(query);
+    query = 0;
+
+    octaspire_bk_tree_release(tree);
+    tree = 0;
+
+    octaspire_vector_release(strings);
+    strings = 0;
+
+    PASS();
+}
+
+TEST octaspire_bk_tree_random_test(void)
+{
+    // Results must be the same as when comparing against every string
+    size_t const numStrings = 2000;
+    uint32_t seed = 11;
+
+    octaspire_vector_t *strings = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireBkTreeTestAllocator);
+
+    ASSERT(strings);
+
+    for (size_t i = 0; i < numStrings + 50; ++i)
+    {
+        octaspire_string_t *str =
+            octaspire_string_new("", octaspireBkTreeTestAllocator);
+
+        ASSERT(str);
+
+        seed = seed * 1103515245u + 12345u;
+        size_t const length = 3 + (seed >> 16) % 8;
+
+        for (size_t j = 0; j < length; ++j)
+        {
+            seed = seed * 1103515245u + 12345u;
+            ASSERT(octaspire_string_push_back_ucs_character(str, 'a' + (seed >> 16) % 4));
+        }
+
+        ASSERT(octaspire_vector_push_back_element(strings, &str));
+    }
+
+    // The last 50 strings are only used as queries
+    octaspire_vector_t *queries = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireBkTreeTestAllocator);
+
+    ASSERT(queries);
+
+    while (octaspire_vector_get_length(strings) > numStrings)
+    {
+        octaspire_string_t *query = octaspire_string_new_copy(
+            octaspire_vector_peek_back_element_const(strings),
+            octaspireBkTreeTestAllocator);
+
+        ASSERT(query);
+        ASSERT(octaspire_vector_push_back_element(queries, &query));
+        ASSERT(octaspire_vector_pop_back_element(strings));
+    }
+
+    octaspire_bk_tree_t *tree =
+        octaspire_bk_tree_new(strings, octaspireBkTreeTestAllocator);
+
+    ASSERT(tree);
+
+    size_t * const distances = octaspire_allocator_malloc(
+        octaspireBkTreeTestAllocator,
+        numStrings * sizeof(size_t));
+
+    ASSERT(distances);
+
+    for (size_t q = 0; q < octaspire_vector_get_length(queries); ++q)
+    {
+        octaspire_string_t const * const query =
+            octaspire_vector_get_element_at_const(queries, (ptrdiff_t)q);
+
+        for (size_t i = 0; i < numStrings; ++i)
+        {
+            distances[i] = octaspire_string_levenshtein_distance(
+                query,
+                octaspire_vector_get_element_at_const(strings, (ptrdiff_t)i));
+        }
+
+        size_t const maxDistance = q % 4;
+
+        octaspire_vector_t *matches =
+            octaspire_bk_tree_find_within_distance(tree, query, maxDistance);
+
+        ASSERT(matches);
+
+        size_t numExpected = 0;
+
+        for (size_t i = 0; i < numStrings; ++i)
+        {
+            if (distances[i] <= maxDistance)
+            {
+                ++numExpected;
+            }
+        }
+
+        ASSERT_EQ(numExpected, octaspire_vector_get_length(matches));
+
+        for (size_t i = 0; i < octaspire_vector_get_length(matches); ++i)
+        {
+            octaspire_bk_tree_match_t const * const match =
+                octaspire_bk_tree_test_get_match(matches, i);
+
+            ASSERT_EQ(distances[match->stringIndex], match->distance);
+
+            if (i > 0)
+            {
+                ASSERT(octaspire_bk_tree_private_compare_matches(
+                    octaspire_bk_tree_test_get_match(matches, i - 1),
+                    match) < 0);
+            }
+        }
+
+        octaspire_vector_release(matches);
+
+        // The nearest ones are the first of all matches in the same order
+        size_t const maxNumMatches = 1 + q % 10;
+
+        octaspire_vector_t *allMatches =
+            octaspire_bk_tree_find_within_distance(tree, query, SIZE_MAX);
+
+        matches = octaspire_bk_tree_find_nearest(tree, query, maxNumMatches);
+
+        ASSERT(allMatches && matches);
+        ASSERT_EQ(numStrings, octaspire_vector_get_length(allMatches));
+        ASSERT_EQ(maxNumMatches, octaspire_vector_get_length(matches));
+
+        ASSERT_MEM_EQ(
+            octaspire_vector_get_element_at_const(allMatches, 0),
+            octaspire_vector_get_element_at_const(matches, 0),
+            maxNumMatches * sizeof(octaspire_bk_tree_match_t));
+
+        octaspire_vector_release(matches);
+        matches = 0;
+
+        octaspire_vector_release(allMatches);
+        allMatches = 0;
+    }
+
+    octaspire_allocator_free(octaspireBkTreeTestAllocator, distances);
+
+    octaspire_bk_tree_release(tree);
+    tree = 0;
+
+    octaspire_vector_release(queries);
+    queries = 0;
+
+    octaspire_vector_release(strings);
+    strings = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_bk_tree_suite)
+{
+    octaspireBkTreeTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireBkTreeTestAllocator);
+
+    RUN_TEST(octaspire_bk_tree_find_within_distance_test);
+    RUN_TEST(octaspire_bk_tree_find_nearest_test);
+    RUN_TEST(octaspire_bk_tree_new_empty_test);
+    RUN_TEST(octaspire_bk_tree_random_test);
+
+    octaspire_allocator_release(octaspireBkTreeTestAllocator);
+    octaspireBkTreeTestAllocator = 0;
+}
+
@@ -0,0 +1,282 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_bloom_filter.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_bloom_filter.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_helpers.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireBloomFilterTestAllocator = 0;
+
+static uint32_t octaspire_bloom_filter_test_hash(size_t const value)
+{
+    return octaspire_helpers_calculate_hash_for_size_t_argument(value);
+}
+
+static uint32_t octaspire_bloom_filter_test_size_t_hash_function(void const * const key)
+{
+    return octaspire_bloom_filter_test_hash(*(size_t const *)key);
+}
+
+TEST octaspire_bloom_filter_new_test(void)
+{
+    octaspire_bloom_filter_t *filter =
+        octaspire_bloom_filter_new(1000, 10, octaspireBloomFilterTestAllocator);
+
+    ASSERT(filter);
+    ASSERT_EQ(octaspireBloomFilterTestAllocator, filter->allocator);
+
+    // 10000 bits rounded up to 256 bit blocks
+    ASSERT_EQ(40, filter->numBlocks);
+    ASSERT_EQ(40 * 32, octaspire_bloom_filter_get_length_in_octets(filter));
+    ASSERT_EQ(0, (size_t)filter->words % 32);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_FALSE(octaspire_bloom_filter_may_contain(
+            filter,
+            octaspire_bloom_filter_test_hash(i)));
+    }
+
+    octaspire_bloom_filter_release(filter);
+    filter = 0;
+
+    // Even an empty filter has one block.
+    filter = octaspire_bloom_filter_new(0, 10, octaspireBloomFilterTestAllocator);
+    ASSERT(filter);
+    ASSERT_EQ(1, filter->numBlocks);
+
+    octaspire_bloom_filter_release(filter);
+    filter = 0;
+
+    PASS();
+}
+
+TEST octaspire_bloom_filter_new_allocation_failure_test(void)
+{
+    for (size_t i = 0; i < 2; ++i)
+    {
+        octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+            octaspireBloomFilterTestAllocator,
+            i + 1,
+            ~((uint32_t)1 << i));
+
+        octaspire_bloom_filter_t *filter =
+            octaspire_bloom_filter_new(100, 10, octaspireBloomFilterTestAllocator);
+
+        ASSERT_FALSE(filter);
+
+        ASSERT_EQ(
+            0,
+            octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+                octaspireBloomFilterTestAllocator));
+    }
+
+    PASS();
+}
+
+TEST octaspire_bloom_filter_add_and_may_contain_test(void)
+{
+    size_t const numElements = 10000;
+
+    octaspire_bloom_filter_t *filter =
+        octaspire_bloom_filter_new(numElements, 10, octaspireBloomFilterTestAllocator);
+
+    ASSERT(filter);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        octaspire_bloom_filter_add(filter, octaspire_bloom_filter_test_hash(i));
+    }
+
+    // No false negatives
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        ASSERT(octaspire_bloom_filter_may_contain(
+            filter,
+            octaspire_bloom_filter_test_hash(i)));
+    }
+
+    // About one percent of false positives among 10 * numElements misses
+    size_t numFalsePositives = 0;
+
+    for (size_t i = numElements; i < 11 * numElements; ++i)
+    {
+        if (octaspire_bloom_filter_may_contain(filter, octaspire_bloom_filter_test_hash(i)))
+        {
+            ++numFalsePositives;
+        }
+    }
+
+    ASSERT(numFalsePositives < 2 * 10 * numElements / 100);
+
+    octaspire_bloom_filter_clear(filter);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        ASSERT_FALSE(octaspire_bloom_filter_may_contain(
+            filter,
+            octaspire_bloom_filter_test_hash(i)));
+    }
+
+    octaspire_bloom_filter_release(filter);
+    filter = 0;
+
+    PASS();
+}
+
+TEST octaspire_bloom_filter_new_from_vector_test(void)
+{
+    octaspire_vector_t *keys = octaspire_vector_new(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBloomFilterTestAllocator);
+
+    ASSERT(keys);
+
+    for (size_t i = 0; i < 500; ++i)
+    {
+        size_t const key = i * 3;
+        ASSERT(octaspire_vector_push_back_element(keys, &key));
+    }
+
+    octaspire_bloom_filter_t *filter = octaspire_bloom_filter_new_from_vector(
+        keys,
+        octaspire_bloom_filter_test_size_t_hash_function,
+        10,
+        octaspireBloomFilterTestAllocator);
+
+    ASSERT(filter);
+    ASSERT_EQ(20, filter->numBlocks);
+
+    for (size_t i = 0; i < 500; ++i)
+    {
+        ASSERT(octaspire_bloom_filter_may_contain(
+            filter,
+            octaspire_bloom_filter_test_hash(i * 3)));
+    }
+
+    octaspire_bloom_filter_release(filter);
+    filter = 0;
+
+    octaspire_vector_release(keys);
+    keys = 0;
+
+    PASS();
+}
+
+TEST octaspire_bloom_filter_serialize_test(void)
+{
+    octaspire_bloom_filter_t *filter =
+        octaspire_bloom_filter_new(100, 10, octaspireBloomFilterTestAllocator);
+
+    ASSERT(filter);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        octaspire_bloom_filter_add(filter, octaspire_bloom_filter_test_hash(i));
+    }
+
+    octaspire_vector_t *buffer =
+        octaspire_bloom_filter_serialize(filter, octaspireBloomFilterTestAllocator);
+
+    ASSERT(buffer);
+    ASSERT_EQ(8 + 4 * 32, octaspire_vector_get_length(buffer));
+
+    uint8_t const * const octets = octaspire_vector_get_element_at_const(buffer, 0);
+    ASSERT_MEM_EQ("OBF1", octets, 4);
+    ASSERT_EQ(4, octets[4]);
+    ASSERT_EQ(0, octets[5]);
+
+    // Words are stored in little endian order.
+    ASSERT_EQ(filter->words[0] & 0xFF, octets[8]);
+    ASSERT_EQ(filter->words[0] >> 24,  octets[11]);
+
+    octaspire_bloom_filter_t *copy = octaspire_bloom_filter_new_from_buffer(
+        octets,
+        octaspire_vector_get_length(buffer),
+        octaspireBloomFilterTestAllocator);
+
+    ASSERT(copy);
+    ASSERT_EQ(filter->numBlocks, copy->numBlocks);
+    ASSERT_MEM_EQ(
+        filter->words,
+        copy->words,
+        octaspire_bloom_filter_get_length_in_octets(filter));
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        uint32_t const hash = octaspire_bloom_filter_test_hash(i);
+
+        ASSERT_EQ(
+            octaspire_bloom_filter_may_contain(filter, hash),
+            octaspire_bloom_filter_may_contain(copy, hash));
+    }
+
+    // Truncated, wrong magic and wrong number of blocks
+    ASSERT_FALSE(octaspire_bloom_filter_new_from_buffer(
+        octets,
+        octaspire_vector_get_length(buffer) - 1,
+        octaspireBloomFilterTestAllocator));
+
+    ASSERT_FALSE(octaspire_bloom_filter_new_from_buffer(
+        octets + 1,
+        octaspire_vector_get_length(buffer) - 1,
+        octaspireBloomFilterTestAllocator));
+
+    ASSERT_FALSE(octaspire_bloom_filter_new_from_buffer(
+        octets,
+        octaspire_vector_get_length(buffer) - 32,
+        octaspireBloomFilterTestAllocator));
+
+    ASSERT_FALSE(octaspire_bloom_filter_new_from_buffer(
+        octets,
+        4,
+        octaspireBloomFilterTestAllocator));
+
+    octaspire_bloom_filter_release(copy);
+    copy = 0;
+
+    octaspire_vector_release(buffer);
+    buffer = 0;
+
+    octaspire_bloom_filter_release(filter);
+    filter = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_bloom_filter_suite)
+{
+    octaspireBloomFilterTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireBloomFilterTestAllocator);
+
+    RUN_TEST(octaspire_bloom_filter_new_test);
+    RUN_TEST(octaspire_bloom_filter_new_allocation_failure_test);
+    RUN_TEST(octaspire_bloom_filter_add_and_may_contain_test);
+    RUN_TEST(octaspire_bloom_filter_new_from_vector_test);
+    RUN_TEST(octaspire_bloom_filter_serialize_test);
+
+    octaspire_allocator_release(octaspireBloomFilterTestAllocator);
+    octaspireBloomFilterTestAllocator = 0;
+}
+
@@ -0,0 +1,670 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_btree.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_btree.h"
+#include "octaspire/core/octaspire_vector.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_helpers.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireBtreeTestAllocator = 0;
+
+static size_t octaspireBtreeTestNumValuesReleased = 0;
+
+static void octaspire_btree_test_value_release_callback(void *value)
+{
+    OCTASPIRE_HELPERS_UNUSED_PARAMETER(value);
+    ++octaspireBtreeTestNumValuesReleased;
+}
+
+// Checks node sizes, key order and that all leaves are at the same
+// depth. Returns the number of elements in the subtree, or SIZE_MAX if
+// the subtree is not valid.
+static size_t octaspire_btree_test_validate_node(
+    octaspire_btree_t const * const btree,
+    octaspire_btree_node_t const * const node,
+    size_t const depth,
+    size_t * const leafDepth,
+    bool const isRoot)
+{
+    if (!isRoot && node->numKeys < OCTASPIRE_BTREE_PRIVATE_MIN_DEGREE - 1)
+    {
+        return SIZE_MAX;
+    }
+
+    if (node->numKeys > OCTASPIRE_BTREE_PRIVATE_MAX_KEYS || node->numKeys == 0)
+    {
+        return SIZE_MAX;
+    }
+
+    for (size_t i = 1; i < node->numKeys; ++i)
+    {
+        if (*(size_t const *)octaspire_btree_private_key_at(btree, node, i - 1) >=
+            *(size_t const *)octaspire_btree_private_key_at(btree, node, i))
+        {
+            return SIZE_MAX;
+        }
+    }
+
+    if (node->isLeaf)
+    {
+        if (*leafDepth == SIZE_MAX)
+        {
+            *leafDepth = depth;
+        }
+
+        return (*leafDepth == depth) ? node->numKeys : SIZE_MAX;
+    }
+
+    octaspire_btree_node_t * const * const children =
+        octaspire_btree_private_get_children(btree, node);
+
+    size_t result = node->numKeys;
+
+    for (size_t i = 0; i <= node->numKeys; ++i)
+    {
+        size_t const numChildElements = octaspire_btree_test_validate_node(
+            btree,
+            children[i],
+            depth + 1,
+            leafDepth,
+            false);
+
+        if (numChildElements == SIZE_MAX)
+        {
+            return SIZE_MAX;
+        }
+
+        result += numChildElements;
+    }
+
+    return result;
+}
+
+static bool octaspire_btree_test_is_valid(octaspire_btree_t const * const btree)
+{
+    if (!btree->root)
+    {
+        return btree->numElements == 0;
+    }
+
+    size_t leafDepth = SIZE_MAX;
+
+    return octaspire_btree_test_validate_node(
+        btree,
+        btree->root,
+        0,
+        &leafDepth,
+        true) == btree->numElements;
+}
+
+// Deterministic permutation of 0 .. numElements - 1
+static size_t octaspire_btree_test_permute(size_t const i, size_t const numElements)
+{
+    return (i * 7919) % numElements;
+}
+
+TEST octaspire_btree_new_test(void)
+{
+    octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBtreeTestAllocator);
+
+    ASSERT(btree);
+    ASSERT(octaspire_btree_is_empty(btree));
+    ASSERT_EQ(0, octaspire_btree_get_number_of_elements(btree));
+
+    size_t const key = 0;
+    ASSERT_FALSE(octaspire_btree_get_const(btree, &key));
+    ASSERT_FALSE(octaspire_btree_remove(btree, &key));
+
+    octaspire_btree_element_const_iterator_t iter =
+        octaspire_btree_element_const_iterator_init(btree);
+
+    ASSERT_FALSE(iter.key);
+    ASSERT_FALSE(octaspire_btree_element_const_iterator_next(&iter));
+
+    octaspire_btree_release(btree);
+    btree = 0;
+
+    PASS();
+}
+
+TEST octaspire_btree_new_allocation_failure_on_first_allocation_test(void)
+{
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireBtreeTestAllocator,
+        1,
+        0);
+
+    octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBtreeTestAllocator);
+
+    ASSERT_FALSE(btree);
+
+    ASSERT_EQ(
+        0,
+        octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+            octaspireBtreeTestAllocator));
+
+    PASS();
+}
+
+TEST octaspire_btree_new_allocation_failure_on_second_allocation_test(void)
+{
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireBtreeTestAllocator,
+        2,
+        0x01);
+
+    octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBtreeTestAllocator);
+
+    ASSERT_FALSE(btree);
+
+    ASSERT_EQ(
+        0,
+        octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+            octaspireBtreeTestAllocator));
+
+    PASS();
+}
+
+TEST octaspire_btree_put_and_get_test(void)
+{
+    octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBtreeTestAllocator);
+
+    ASSERT(btree);
+
+    size_t const numElements = 10007;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        size_t const key   = octaspire_btree_test_permute(i, numElements);
+        size_t const value = key * 2;
+        ASSERT(octaspire_btree_put(btree, &key, &value));
+        ASSERT_EQ(i + 1, octaspire_btree_get_number_of_elements(btree));
+    }
+
+    ASSERT(octaspire_btree_test_is_valid(btree));
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        size_t const * const value = octaspire_btree_get_const(btree, &i);
+        ASSERT(value);
+        ASSERT_EQ(i * 2, *value);
+    }
+
+    ASSERT_FALSE(octaspire_btree_get_const(btree, &numElements));
+
+    // Put with existing key replaces the value
+    size_t const key   = 100;
+    size_t const value = 1;
+    ASSERT(octaspire_btree_put(btree, &key, &value));
+    ASSERT_EQ(numElements, octaspire_btree_get_number_of_elements(btree));
+    ASSERT_EQ(1, *(size_t*)octaspire_btree_get(btree, &key));
+
+    octaspire_btree_release(btree);
+    btree = 0;
+
+    PASS();
+}
+
+TEST octaspire_btree_remove_test(void)
+{
+    octaspireBtreeTestNumValuesReleased = 0;
+
+    octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        octaspire_btree_test_value_release_callback,
+        octaspireBtreeTestAllocator);
+
+    ASSERT(btree);
+
+    size_t const numElements = 5003;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        ASSERT(octaspire_btree_put(btree, &i, &i));
+    }
+
+    ASSERT(octaspire_btree_test_is_valid(btree));
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        size_t const key = octaspire_btree_test_permute(i, numElements);
+
+        if (key % 3 == 0)
+        {
+            continue;
+        }
+
+        ASSERT(octaspire_btree_remove(btree, &key));
+        ASSERT_FALSE(octaspire_btree_remove(btree, &key));
+        ASSERT_FALSE(octaspire_btree_get_const(btree, &key));
+    }
+
+    ASSERT(octaspire_btree_test_is_valid(btree));
+    ASSERT_EQ((numElements + 2) / 3, octaspire_btree_get_number_of_elements(btree));
+    ASSERT_EQ(numElements - ((numElements + 2) / 3), octaspireBtreeTestNumValuesReleased);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        size_t const * const value = octaspire_btree_get_const(btree, &i);
+
+        if (i % 3 == 0)
+        {
+            ASSERT(value);
+            ASSERT_EQ(i, *value);
+        }
+        else
+        {
+            ASSERT_FALSE(value);
+        }
+    }
+
+    for (size_t i = 0; i < numElements; i += 3)
+    {
+        ASSERT(octaspire_btree_remove(btree, &i));
+    }
+
+    ASSERT(octaspire_btree_is_empty(btree));
+    ASSERT(octaspire_btree_test_is_valid(btree));
+    ASSERT_EQ(numElements, octaspireBtreeTestNumValuesReleased);
+
+    octaspire_btree_release(btree);
+    btree = 0;
+
+    PASS();
+}
+
+TEST octaspire_btree_iteration_is_in_key_order_test(void)
+{
+    octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBtreeTestAllocator);
+
+    ASSERT(btree);
+
+    size_t const numElements = 3001;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        size_t const key = octaspire_btree_test_permute(i, numElements);
+        ASSERT(octaspire_btree_put(btree, &key, &i));
+    }
+
+    size_t expected = 0;
+
+    for (octaspire_btree_element_const_iterator_t iter =
+            octaspire_btree_element_const_iterator_init(btree);
+         iter.key;
+         octaspire_btree_element_const_iterator_next(&iter))
+    {
+        ASSERT_EQ(expected, *(size_t const *)iter.key);
+        ++expected;
+    }
+
+    ASSERT_EQ(numElements, expected);
+
+    octaspire_btree_release(btree);
+    btree = 0;
+
+    PASS();
+}
+
+TEST octaspire_btree_element_const_iterator_init_lower_bound_test(void)
+{
+    octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBtreeTestAllocator);
+
+    ASSERT(btree);
+
+    // Only even keys
+    for (size_t i = 0; i < 2000; i += 2)
+    {
+        ASSERT(octaspire_btree_put(btree, &i, &i));
+    }
+
+    for (size_t i = 0; i < 2000; ++i)
+    {
+        octaspire_btree_element_const_iterator_t iter =
+            octaspire_btree_element_const_iterator_init_lower_bound(btree, &i);
+
+        size_t const expected = (i % 2) ? (i + 1) : i;
+
+        if (expected >= 2000)
+        {
+            ASSERT_FALSE(iter.key);
+        }
+        else
+        {
+            ASSERT(iter.key);
+            ASSERT_EQ(expected, *(size_t const *)iter.key);
+            ASSERT_EQ(expected, *(size_t const *)iter.value);
+        }
+    }
+
+    octaspire_btree_release(btree);
+    btree = 0;
+
+    PASS();
+}
+
+TEST octaspire_btree_element_const_iterator_init_range_test(void)
+{
+    octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBtreeTestAllocator);
+
+    ASSERT(btree);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        size_t const key = octaspire_btree_test_permute(i, 1000) * 10;
+        ASSERT(octaspire_btree_put(btree, &key, &i));
+    }
+
+    size_t const lowerKey = 1234;
+    size_t const upperKey = 5670;
+
+    size_t counter  = 0;
+    size_t expected = 1240;
+
+    octaspire_btree_element_const_iterator_t iter =
+        octaspire_btree_element_const_iterator_init_range(btree, &lowerKey, &upperKey);
+
+    while (iter.key)
+    {
+        ASSERT_EQ(expected, *(size_t const *)iter.key);
+        expected += 10;
+        ++counter;
+        octaspire_btree_element_const_iterator_next(&iter);
+    }
+
+    ASSERT_EQ(5660, expected - 10);
+    ASSERT_EQ(443, counter);
+
+    // Empty range
+    iter = octaspire_btree_element_const_iterator_init_range(btree, &upperKey, &lowerKey);
+    ASSERT_FALSE(iter.key);
+
+    octaspire_btree_release(btree);
+    btree = 0;
+
+    PASS();
+}
+
+TEST octaspire_btree_load_sorted_test(void)
+{
+    size_t const sizes[] = {1, 2, 30, 31, 32, 33, 500, 1023, 1024, 1025, 40000};
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+    {
+        size_t const numElements = sizes[s];
+
+        octaspire_vector_t *keys = octaspire_vector_new(
+            sizeof(size_t),
+            false,
+            0,
+            octaspireBtreeTestAllocator);
+
+        ASSERT(keys);
+
+        for (size_t i = 0; i < numElements; ++i)
+        {
+            size_t const key = i * 3;
+            ASSERT(octaspire_vector_push_back_element(keys, &key));
+        }
+
+        octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+            sizeof(size_t),
+            false,
+            0,
+            octaspireBtreeTestAllocator);
+
+        ASSERT(btree);
+
+        ASSERT(octaspire_btree_load_sorted(
+            btree,
+            octaspire_vector_get_element_at_const(keys, 0),
+            octaspire_vector_get_element_at_const(keys, 0),
+            numElements));
+
+        ASSERT_EQ(numElements, octaspire_btree_get_number_of_elements(btree));
+        ASSERT(octaspire_btree_test_is_valid(btree));
+
+        size_t expected = 0;
+
+        octaspire_btree_element_const_iterator_t iter =
+            octaspire_btree_element_const_iterator_init(btree);
+
+        while (iter.key)
+        {
+            ASSERT_EQ(expected, *(size_t const *)iter.key);
+            ASSERT_EQ(expected, *(size_t const *)iter.value);
+            expected += 3;
+            octaspire_btree_element_const_iterator_next(&iter);
+        }
+
+        ASSERT_EQ(numElements * 3, expected);
+
+        // Loaded tree works with later updates
+        for (size_t i = 0; i < numElements; ++i)
+        {
+            size_t const key = (i * 3) + 1;
+            ASSERT(octaspire_btree_put(btree, &key, &key));
+        }
+
+        for (size_t i = 0; i < numElements; i += 2)
+        {
+            size_t const key = i * 3;
+            ASSERT(octaspire_btree_remove(btree, &key));
+        }
+
+        ASSERT(octaspire_btree_test_is_valid(btree));
+
+        // Tree must be empty
+        ASSERT_FALSE(octaspire_btree_load_sorted(
+            btree,
+            octaspire_vector_get_element_at_const(keys, 0),
+            octaspire_vector_get_element_at_const(keys, 0),
+            numElements));
+
+        octaspire_btree_release(btree);
+        btree = 0;
+
+        octaspire_vector_release(keys);
+        keys = 0;
+    }
+
+    PASS();
+}
+
+TEST octaspire_btree_load_sorted_with_unsorted_input_test(void)
+{
+    size_t const keys[] = {1, 2, 3, 3, 4};
+
+    octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBtreeTestAllocator);
+
+    ASSERT(btree);
+
+    ASSERT_FALSE(octaspire_btree_load_sorted(btree, keys, keys, 5));
+    ASSERT(octaspire_btree_is_empty(btree));
+
+    ASSERT(octaspire_btree_load_sorted(btree, keys, keys, 3));
+    ASSERT_EQ(3, octaspire_btree_get_number_of_elements(btree));
+
+    octaspire_btree_release(btree);
+    btree = 0;
+
+    PASS();
+}
+
+TEST octaspire_btree_new_with_octaspire_string_keys_test(void)
+{
+    octaspire_btree_t *btree = octaspire_btree_new_with_octaspire_string_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBtreeTestAllocator);
+
+    ASSERT(btree);
+
+    char const * const words[] = {"pear", "apple", "orange", "banana", "cherry"};
+    char const * const sorted[] = {"apple", "banana", "cherry", "orange", "pear"};
+
+    for (size_t i = 0; i < 5; ++i)
+    {
+        octaspire_string_t *key =
+            octaspire_string_new(words[i], octaspireBtreeTestAllocator);
+
+        ASSERT(octaspire_btree_put(btree, &key, &i));
+    }
+
+    // Stored key is kept and the new equal key is released.
+    octaspire_string_t *key =
+        octaspire_string_new("apple", octaspireBtreeTestAllocator);
+
+    size_t const value = 100;
+    ASSERT(octaspire_btree_put(btree, &key, &value));
+    ASSERT_EQ(5, octaspire_btree_get_number_of_elements(btree));
+
+    key = octaspire_string_new("apple", octaspireBtreeTestAllocator);
+    ASSERT_EQ(100, *(size_t const *)octaspire_btree_get_const(btree, &key));
+    ASSERT(octaspire_btree_remove(btree, &key));
+    ASSERT_FALSE(octaspire_btree_get_const(btree, &key));
+    octaspire_string_release(key);
+    key = 0;
+
+    size_t index = 1;
+
+    for (octaspire_btree_element_const_iterator_t iter =
+            octaspire_btree_element_const_iterator_init(btree);
+         iter.key;
+         octaspire_btree_element_const_iterator_next(&iter))
+    {
+        ASSERT_STR_EQ(sorted[index], octaspire_string_get_c_string(iter.key));
+        ++index;
+    }
+
+    ASSERT_EQ(5, index);
+
+    octaspire_btree_release(btree);
+    btree = 0;
+
+    PASS();
+}
+
+TEST octaspire_btree_put_allocation_failure_test(void)
+{
+    octaspire_btree_t *btree = octaspire_btree_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireBtreeTestAllocator);
+
+    ASSERT(btree);
+
+    // Fill the root leaf, so that the next put must split it.
+    for (size_t i = 0; i < OCTASPIRE_BTREE_PRIVATE_MAX_KEYS; ++i)
+    {
+        ASSERT(octaspire_btree_put(btree, &i, &i));
+    }
+
+    for (size_t i = 0; i < 2; ++i)
+    {
+        octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+            octaspireBtreeTestAllocator,
+            i + 1,
+            ~((uint32_t)1 << i));
+
+        size_t const key = 1000;
+        ASSERT_FALSE(octaspire_btree_put(btree, &key, &key));
+
+        ASSERT_EQ(
+            0,
+            octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+                octaspireBtreeTestAllocator));
+
+        ASSERT_EQ(
+            OCTASPIRE_BTREE_PRIVATE_MAX_KEYS,
+            octaspire_btree_get_number_of_elements(btree));
+
+        ASSERT(octaspire_btree_test_is_valid(btree));
+    }
+
+    size_t const key = 1000;
+    ASSERT(octaspire_btree_put(btree, &key, &key));
+    ASSERT(octaspire_btree_test_is_valid(btree));
+
+    octaspire_btree_release(btree);
+    btree = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_btree_suite)
+{
+    octaspireBtreeTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireBtreeTestAllocator);
+
+    RUN_TEST(octaspire_btree_new_test);
+    RUN_TEST(octaspire_btree_new_allocation_failure_on_first_allocation_test);
+    RUN_TEST(octaspire_btree_new_allocation_failure_on_second_allocation_test);
+    RUN_TEST(octaspire_btree_put_and_get_test);
+    RUN_TEST(octaspire_btree_remove_test);
+    RUN_TEST(octaspire_btree_iteration_is_in_key_order_test);
+    RUN_TEST(octaspire_btree_element_const_iterator_init_lower_bound_test);
+    RUN_TEST(octaspire_btree_element_const_iterator_init_range_test);
+    RUN_TEST(octaspire_btree_load_sorted_test);
+    RUN_TEST(octaspire_btree_load_sorted_with_unsorted_input_test);
+    RUN_TEST(octaspire_btree_new_with_octaspire_string_keys_test);
+    RUN_TEST(octaspire_btree_put_allocation_failure_test);
+
+    octaspire_allocator_release(octaspireBtreeTestAllocator);
+    octaspireBtreeTestAllocator = 0;
+}
+
@@ -0,0 +1,331 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_flat_map.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_flat_map.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireFlatMapTestAllocator = 0;
+
+TEST octaspire_flat_map_build_with_string_keys_test(void)
+{
+    octaspire_flat_map_builder_t *builder =
+        octaspire_flat_map_builder_new(octaspireFlatMapTestAllocator);
+
+    ASSERT(builder);
+
+    size_t const numElements = 1000;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        octaspire_string_t *key = octaspire_string_new_format(
+            octaspireFlatMapTestAllocator,
+            "key%zu",
+            i);
+
+        ASSERT(key);
+
+        uint64_t const value = i * 3;
+
+        ASSERT(octaspire_flat_map_builder_add_with_string_key(
+            builder,
+            key,
+            &value,
+            sizeof(value)));
+
+        octaspire_string_release(key);
+        key = 0;
+    }
+
+    ASSERT_EQ(numElements, octaspire_flat_map_builder_get_number_of_elements(builder));
+
+    size_t lengthInOctets = 0;
+
+    char *image = octaspire_flat_map_builder_build(
+        builder,
+        &lengthInOctets,
+        octaspireFlatMapTestAllocator);
+
+    ASSERT(image);
+    ASSERT(lengthInOctets > numElements * 8);
+
+    octaspire_flat_map_builder_release(builder);
+    builder = 0;
+
+    octaspire_flat_map_t flatMap;
+    ASSERT(octaspire_flat_map_init(&flatMap, image, lengthInOctets));
+    ASSERT_EQ(numElements, octaspire_flat_map_get_number_of_elements(&flatMap));
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        octaspire_string_t *key = octaspire_string_new_format(
+            octaspireFlatMapTestAllocator,
+            "key%zu",
+            i);
+
+        ASSERT(key);
+
+        void const *value = 0;
+        size_t valueLengthInOctets = 0;
+
+        ASSERT(octaspire_flat_map_get_with_string_key(
+            &flatMap,
+            key,
+            &value,
+            &valueLengthInOctets));
+
+        ASSERT_EQ(sizeof(uint64_t), valueLengthInOctets);
+        ASSERT_EQ(0, ((uint8_t const *)value - (uint8_t const *)image) % 8);
+        ASSERT_EQ(i * 3, *(uint64_t const *)value);
+
+        octaspire_string_release(key);
+        key = 0;
+    }
+
+    void const *value = 0;
+    size_t valueLengthInOctets = 0;
+
+    ASSERT_FALSE(octaspire_flat_map_get(&flatMap, "key1000", 7, &value, &valueLengthInOctets));
+    ASSERT_FALSE(octaspire_flat_map_get(&flatMap, "key", 3, &value, &valueLengthInOctets));
+    ASSERT_FALSE(octaspire_flat_map_get(&flatMap, "", 0, &value, &valueLengthInOctets));
+
+    octaspire_allocator_free(octaspireFlatMapTestAllocator, image);
+    image = 0;
+
+    PASS();
+}
+
+TEST octaspire_flat_map_build_with_integer_keys_test(void)
+{
+    octaspire_flat_map_builder_t *builder =
+        octaspire_flat_map_builder_new(octaspireFlatMapTestAllocator);
+
+    ASSERT(builder);
+
+    for (uint64_t i = 0; i < 100; ++i)
+    {
+        char value[16];
+        int const length = sprintf(value, "v%" PRIu64, i);
+
+        ASSERT(octaspire_flat_map_builder_add_with_integer_key(
+            builder,
+            i * 0x100000001u,
+            value,
+            (size_t)length));
+    }
+
+    // Keys and values can also be empty
+    ASSERT(octaspire_flat_map_builder_add(builder, "", 0, "", 0));
+
+    size_t lengthInOctets = 0;
+
+    char *image = octaspire_flat_map_builder_build(
+        builder,
+        &lengthInOctets,
+        octaspireFlatMapTestAllocator);
+
+    ASSERT(image);
+
+    octaspire_flat_map_builder_release(builder);
+    builder = 0;
+
+    // The image does not depend on its address
+    char *copy = octaspire_allocator_malloc(octaspireFlatMapTestAllocator, lengthInOctets);
+    ASSERT(copy);
+    memcpy(copy, image, lengthInOctets);
+    octaspire_allocator_free(octaspireFlatMapTestAllocator, image);
+    image = 0;
+
+    octaspire_flat_map_t flatMap;
+    ASSERT(octaspire_flat_map_init(&flatMap, copy, lengthInOctets));
+    ASSERT_EQ(101, octaspire_flat_map_get_number_of_elements(&flatMap));
+
+    void const *value = 0;
+    size_t valueLengthInOctets = 0;
+
+    ASSERT(octaspire_flat_map_get_with_integer_key(
+        &flatMap,
+        42 * 0x100000001u,
+        &value,
+        &valueLengthInOctets));
+
+    ASSERT_EQ(3, valueLengthInOctets);
+    ASSERT_MEM_EQ("v42", value, 3);
+
+    ASSERT_FALSE(octaspire_flat_map_get_with_integer_key(
+        &flatMap,
+        42,
+        &value,
+        &valueLengthInOctets));
+
+    ASSERT(octaspire_flat_map_get(&flatMap, "", 0, &value, &valueLengthInOctets));
+    ASSERT_EQ(0, valueLengthInOctets);
+
+    octaspire_allocator_free(octaspireFlatMapTestAllocator, copy);
+    copy = 0;
+
+    PASS();
+}
+
+TEST octaspire_flat_map_build_fails_on_duplicate_keys_test(void)
+{
+    octaspire_flat_map_builder_t *builder =
+        octaspire_flat_map_builder_new(octaspireFlatMapTestAllocator);
+
+    ASSERT(builder);
+
+    ASSERT(octaspire_flat_map_builder_add(builder, "abc", 3, "1", 1));
+    ASSERT(octaspire_flat_map_builder_add(builder, "abd", 3, "2", 1));
+    ASSERT(octaspire_flat_map_builder_add(builder, "abc", 3, "3", 1));
+
+    size_t lengthInOctets = 0;
+
+    ASSERT_FALSE(octaspire_flat_map_builder_build(
+        builder,
+        &lengthInOctets,
+        octaspireFlatMapTestAllocator));
+
+    octaspire_flat_map_builder_release(builder);
+    builder = 0;
+
+    PASS();
+}
+
+TEST octaspire_flat_map_empty_test(void)
+{
+    octaspire_flat_map_builder_t *builder =
+        octaspire_flat_map_builder_new(octaspireFlatMapTestAllocator);
+
+    ASSERT(builder);
+
+    size_t lengthInOctets = 0;
+
+    char *image = octaspire_flat_map_builder_build(
+        builder,
+        &lengthInOctets,
+        octaspireFlatMapTestAllocator);
+
+    ASSERT(image);
+
+    octaspire_flat_map_builder_release(builder);
+    builder = 0;
+
+    octaspire_flat_map_t flatMap;
+    ASSERT(octaspire_flat_map_init(&flatMap, image, lengthInOctets));
+    ASSERT_EQ(0, octaspire_flat_map_get_number_of_elements(&flatMap));
+
+    void const *value = 0;
+    size_t valueLengthInOctets = 0;
+
+    ASSERT_FALSE(octaspire_flat_map_get(&flatMap, "a", 1, &value, &valueLengthInOctets));
+
+    octaspire_allocator_free(octaspireFlatMapTestAllocator, image);
+    image = 0;
+
+    PASS();
+}
+
+TEST octaspire_flat_map_init_rejects_malformed_images_test(void)
+{
+    octaspire_flat_map_builder_t *builder =
+        octaspire_flat_map_builder_new(octaspireFlatMapTestAllocator);
+
+    ASSERT(builder);
+
+    for (uint64_t i = 0; i < 10; ++i)
+    {
+        ASSERT(octaspire_flat_map_builder_add_with_integer_key(builder, i, &i, sizeof(i)));
+    }
+
+    size_t lengthInOctets = 0;
+
+    uint8_t *image = (uint8_t*)octaspire_flat_map_builder_build(
+        builder,
+        &lengthInOctets,
+        octaspireFlatMapTestAllocator);
+
+    ASSERT(image);
+
+    octaspire_flat_map_builder_release(builder);
+    builder = 0;
+
+    octaspire_flat_map_t flatMap;
+
+    // Truncated
+    ASSERT_FALSE(octaspire_flat_map_init(&flatMap, image, lengthInOctets - 1));
+    ASSERT_FALSE(octaspire_flat_map_init(&flatMap, image, 8));
+
+    // Wrong magic
+    image[0] = 'X';
+    ASSERT_FALSE(octaspire_flat_map_init(&flatMap, image, lengthInOctets));
+    image[0] = 'O';
+
+    // Number of slots that is not a power of two
+    ++image[16];
+    ASSERT_FALSE(octaspire_flat_map_init(&flatMap, image, lengthInOctets));
+    --image[16];
+
+    ASSERT(octaspire_flat_map_init(&flatMap, image, lengthInOctets));
+
+    // An entry offset pointing outside of the image is not followed
+    void const *value = 0;
+    size_t valueLengthInOctets = 0;
+
+    for (size_t i = 0; i < flatMap.numSlots; ++i)
+    {
+        uint8_t * const slot = image + flatMap.slotsOffset + i * 16;
+
+        if (octaspire_flat_map_private_read_uint64(slot + 8))
+        {
+            octaspire_flat_map_private_write_uint64(slot + 8, UINT64_MAX);
+        }
+    }
+
+    for (uint64_t i = 0; i < 10; ++i)
+    {
+        ASSERT_FALSE(octaspire_flat_map_get_with_integer_key(
+            &flatMap,
+            i,
+            &value,
+            &valueLengthInOctets));
+    }
+
+    octaspire_allocator_free(octaspireFlatMapTestAllocator, image);
+    image = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_flat_map_suite)
+{
+    octaspireFlatMapTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireFlatMapTestAllocator);
+
+    RUN_TEST(octaspire_flat_map_build_with_string_keys_test);
+    RUN_TEST(octaspire_flat_map_build_with_integer_keys_test);
+    RUN_TEST(octaspire_flat_map_build_fails_on_duplicate_keys_test);
+    RUN_TEST(octaspire_flat_map_empty_test);
+    RUN_TEST(octaspire_flat_map_init_rejects_malformed_images_test);
+
+    octaspire_allocator_release(octaspireFlatMapTestAllocator);
+    octaspireFlatMapTestAllocator = 0;
+}
+
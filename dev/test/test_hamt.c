@@ -0,0 +1,673 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_hamt.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_hamt.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_helpers.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireHamtTestAllocator = 0;
+
+static size_t octaspireHamtTestNumValuesReleased = 0;
+
+static void octaspire_hamt_test_value_release_callback(void *value)
+{
+    OCTASPIRE_HELPERS_UNUSED_PARAMETER(value);
+    ++octaspireHamtTestNumValuesReleased;
+}
+
+// Replaces 'hamt' with a new version that has 'key' mapped to 'value'.
+static bool octaspire_hamt_test_put_size_t(
+    octaspire_hamt_t ** const hamt,
+    size_t const key,
+    size_t const value)
+{
+    octaspire_hamt_t * const next = octaspire_hamt_put(
+        *hamt,
+        octaspire_map_helper_size_t_get_hash(key),
+        &key,
+        &value);
+
+    if (!next)
+    {
+        return false;
+    }
+
+    octaspire_hamt_release(*hamt);
+    *hamt = next;
+    return true;
+}
+
+static size_t const *octaspire_hamt_test_get_size_t(
+    octaspire_hamt_t const * const hamt,
+    size_t const key)
+{
+    octaspire_hamt_node_t const * const node = octaspire_hamt_get_const(
+        hamt,
+        octaspire_map_helper_size_t_get_hash(key),
+        &key);
+
+    if (!node)
+    {
+        return 0;
+    }
+
+    return (size_t const *)octaspire_hamt_node_get_value_const(node);
+}
+
+TEST octaspire_hamt_new_test(void)
+{
+    octaspire_hamt_t *hamt = octaspire_hamt_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireHamtTestAllocator);
+
+    ASSERT(hamt);
+    ASSERT(octaspire_hamt_is_empty(hamt));
+    ASSERT_EQ(0, octaspire_hamt_get_number_of_elements(hamt));
+    ASSERT_FALSE(octaspire_hamt_test_get_size_t(hamt, 0));
+
+    // The key hash function hashes the value of the key, not its address
+    size_t const key = 1234;
+
+    ASSERT_EQ(
+        octaspire_map_helper_size_t_get_hash(key),
+        hamt->config->keyHashFunction(&key));
+
+    octaspire_hamt_release(hamt);
+    hamt = 0;
+
+    PASS();
+}
+
+TEST octaspire_hamt_new_allocation_failure_on_first_allocation_test(void)
+{
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireHamtTestAllocator,
+        1,
+        0);
+
+    octaspire_hamt_t *hamt = octaspire_hamt_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireHamtTestAllocator);
+
+    ASSERT_FALSE(hamt);
+
+    ASSERT_EQ(
+        0,
+        octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+            octaspireHamtTestAllocator));
+
+    PASS();
+}
+
+TEST octaspire_hamt_put_and_get_with_size_t_keys_test(void)
+{
+    octaspire_hamt_t *hamt = octaspire_hamt_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireHamtTestAllocator);
+
+    ASSERT(hamt);
+
+    size_t const numElements = 5000;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        ASSERT(octaspire_hamt_test_put_size_t(&hamt, i, i * 3));
+        ASSERT_EQ(i + 1, octaspire_hamt_get_number_of_elements(hamt));
+    }
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        size_t const * const value = octaspire_hamt_test_get_size_t(hamt, i);
+        ASSERT(value);
+        ASSERT_EQ(i * 3, *value);
+    }
+
+    ASSERT_FALSE(octaspire_hamt_test_get_size_t(hamt, numElements));
+
+    octaspire_hamt_release(hamt);
+    hamt = 0;
+
+    PASS();
+}
+
+TEST octaspire_hamt_old_versions_are_not_changed_test(void)
+{
+    octaspire_hamt_t *v1 = octaspire_hamt_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireHamtTestAllocator);
+
+    ASSERT(v1);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        ASSERT(octaspire_hamt_test_put_size_t(&v1, i, i));
+    }
+
+    size_t const key   = 100;
+    size_t const value = 200;
+
+    octaspire_hamt_t *v2 = octaspire_hamt_put(
+        v1,
+        octaspire_map_helper_size_t_get_hash(key),
+        &key,
+        &value);
+
+    ASSERT(v2);
+
+    size_t const removedKey = 50;
+
+    octaspire_hamt_t *v3 = octaspire_hamt_remove(
+        v2,
+        octaspire_map_helper_size_t_get_hash(removedKey),
+        &removedKey);
+
+    ASSERT(v3);
+
+    size_t const replacedValue = 999;
+
+    octaspire_hamt_t *v4 = octaspire_hamt_put(
+        v3,
+        octaspire_map_helper_size_t_get_hash(key),
+        &key,
+        &replacedValue);
+
+    ASSERT(v4);
+
+    ASSERT_EQ(100, octaspire_hamt_get_number_of_elements(v1));
+    ASSERT_EQ(101, octaspire_hamt_get_number_of_elements(v2));
+    ASSERT_EQ(100, octaspire_hamt_get_number_of_elements(v3));
+    ASSERT_EQ(100, octaspire_hamt_get_number_of_elements(v4));
+
+    ASSERT_FALSE(octaspire_hamt_test_get_size_t(v1, key));
+    ASSERT_EQ(value,         *octaspire_hamt_test_get_size_t(v2, key));
+    ASSERT_EQ(value,         *octaspire_hamt_test_get_size_t(v3, key));
+    ASSERT_EQ(replacedValue, *octaspire_hamt_test_get_size_t(v4, key));
+
+    ASSERT_EQ(removedKey, *octaspire_hamt_test_get_size_t(v1, removedKey));
+    ASSERT_EQ(removedKey, *octaspire_hamt_test_get_size_t(v2, removedKey));
+    ASSERT_FALSE(octaspire_hamt_test_get_size_t(v3, removedKey));
+    ASSERT_FALSE(octaspire_hamt_test_get_size_t(v4, removedKey));
+
+    octaspire_hamt_release(v2);
+    v2 = 0;
+
+    octaspire_hamt_release(v4);
+    v4 = 0;
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(i, *octaspire_hamt_test_get_size_t(v1, i));
+    }
+
+    octaspire_hamt_release(v1);
+    v1 = 0;
+
+    ASSERT_FALSE(octaspire_hamt_test_get_size_t(v3, removedKey));
+    ASSERT_EQ(value, *octaspire_hamt_test_get_size_t(v3, key));
+
+    octaspire_hamt_release(v3);
+    v3 = 0;
+
+    PASS();
+}
+
+TEST octaspire_hamt_new_snapshot_test(void)
+{
+    octaspire_hamt_t *hamt = octaspire_hamt_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireHamtTestAllocator);
+
+    ASSERT(hamt);
+
+    for (size_t i = 0; i < 64; ++i)
+    {
+        ASSERT(octaspire_hamt_test_put_size_t(&hamt, i, i + 1));
+    }
+
+    octaspire_hamt_t *snapshot = octaspire_hamt_new_snapshot(hamt);
+
+    ASSERT(snapshot);
+
+    for (size_t i = 0; i < 64; ++i)
+    {
+        ASSERT(octaspire_hamt_test_put_size_t(&hamt, i, 0));
+    }
+
+    ASSERT_EQ(64, octaspire_hamt_get_number_of_elements(snapshot));
+
+    for (size_t i = 0; i < 64; ++i)
+    {
+        ASSERT_EQ(i + 1, *octaspire_hamt_test_get_size_t(snapshot, i));
+        ASSERT_EQ(0,     *octaspire_hamt_test_get_size_t(hamt, i));
+    }
+
+    octaspire_hamt_release(hamt);
+    hamt = 0;
+
+    octaspire_hamt_release(snapshot);
+    snapshot = 0;
+
+    PASS();
+}
+
+TEST octaspire_hamt_remove_test(void)
+{
+    octaspire_hamt_t *hamt = octaspire_hamt_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireHamtTestAllocator);
+
+    ASSERT(hamt);
+
+    size_t const numElements = 2000;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        ASSERT(octaspire_hamt_test_put_size_t(&hamt, i, i));
+    }
+
+    size_t const missingKey = numElements + 1;
+
+    octaspire_hamt_t *same = octaspire_hamt_remove(
+        hamt,
+        octaspire_map_helper_size_t_get_hash(missingKey),
+        &missingKey);
+
+    ASSERT(same);
+    ASSERT_EQ(numElements, octaspire_hamt_get_number_of_elements(same));
+
+    octaspire_hamt_release(same);
+    same = 0;
+
+    for (size_t i = 0; i < numElements; i += 2)
+    {
+        octaspire_hamt_t * const next = octaspire_hamt_remove(
+            hamt,
+            octaspire_map_helper_size_t_get_hash(i),
+            &i);
+
+        ASSERT(next);
+        octaspire_hamt_release(hamt);
+        hamt = next;
+    }
+
+    ASSERT_EQ(numElements / 2, octaspire_hamt_get_number_of_elements(hamt));
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        if (i % 2 == 0)
+        {
+            ASSERT_FALSE(octaspire_hamt_test_get_size_t(hamt, i));
+        }
+        else
+        {
+            ASSERT_EQ(i, *octaspire_hamt_test_get_size_t(hamt, i));
+        }
+    }
+
+    for (size_t i = 1; i < numElements; i += 2)
+    {
+        octaspire_hamt_t * const next = octaspire_hamt_remove(
+            hamt,
+            octaspire_map_helper_size_t_get_hash(i),
+            &i);
+
+        ASSERT(next);
+        octaspire_hamt_release(hamt);
+        hamt = next;
+    }
+
+    ASSERT(octaspire_hamt_is_empty(hamt));
+
+    octaspire_hamt_element_const_iterator_t iter =
+        octaspire_hamt_element_const_iterator_init(hamt);
+
+    ASSERT_FALSE(iter.element);
+
+    octaspire_hamt_release(hamt);
+    hamt = 0;
+
+    PASS();
+}
+
+TEST octaspire_hamt_colliding_hashes_test(void)
+{
+    octaspire_hamt_t *hamt = octaspire_hamt_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireHamtTestAllocator);
+
+    ASSERT(hamt);
+
+    uint32_t const hash = 12345;
+
+    for (size_t i = 0; i < 50; ++i)
+    {
+        octaspire_hamt_t * const next = octaspire_hamt_put(hamt, hash, &i, &i);
+        ASSERT(next);
+        octaspire_hamt_release(hamt);
+        hamt = next;
+    }
+
+    // Key with a different hash sharing the first levels
+    size_t const otherKey = 1000;
+
+    octaspire_hamt_t *other = octaspire_hamt_put(
+        hamt,
+        hash | 0x80000000,
+        &otherKey,
+        &otherKey);
+
+    ASSERT(other);
+    ASSERT_EQ(51, octaspire_hamt_get_number_of_elements(other));
+
+    for (size_t i = 0; i < 50; ++i)
+    {
+        octaspire_hamt_node_t const * const node =
+            octaspire_hamt_get_const(other, hash, &i);
+
+        ASSERT(node);
+        ASSERT_EQ(hash, octaspire_hamt_node_get_hash(node));
+        ASSERT_EQ(i, *(size_t const *)octaspire_hamt_node_get_key_const(node));
+        ASSERT_EQ(i, *(size_t const *)octaspire_hamt_node_get_value_const(node));
+    }
+
+    ASSERT(octaspire_hamt_get_const(other, hash | 0x80000000, &otherKey));
+    ASSERT_FALSE(octaspire_hamt_get_const(other, hash, &otherKey));
+
+    for (size_t i = 0; i < 50; ++i)
+    {
+        octaspire_hamt_t * const next = octaspire_hamt_remove(other, hash, &i);
+        ASSERT(next);
+        octaspire_hamt_release(other);
+        other = next;
+        ASSERT_FALSE(octaspire_hamt_get_const(other, hash, &i));
+    }
+
+    ASSERT_EQ(1, octaspire_hamt_get_number_of_elements(other));
+    ASSERT(octaspire_hamt_get_const(other, hash | 0x80000000, &otherKey));
+
+    octaspire_hamt_release(other);
+    other = 0;
+
+    ASSERT_EQ(50, octaspire_hamt_get_number_of_elements(hamt));
+
+    octaspire_hamt_release(hamt);
+    hamt = 0;
+
+    PASS();
+}
+
+TEST octaspire_hamt_values_are_released_with_last_version_test(void)
+{
+    octaspireHamtTestNumValuesReleased = 0;
+
+    octaspire_hamt_t *v1 = octaspire_hamt_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        octaspire_hamt_test_value_release_callback,
+        octaspireHamtTestAllocator);
+
+    ASSERT(v1);
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        ASSERT(octaspire_hamt_test_put_size_t(&v1, i, i));
+    }
+
+    // Replacing values of the newest version releases nothing, because the
+    // old values are still in the older version.
+    octaspire_hamt_t *v2 = octaspire_hamt_new_snapshot(v1);
+    ASSERT(v2);
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        ASSERT(octaspire_hamt_test_put_size_t(&v2, i, i + 1));
+    }
+
+    ASSERT_EQ(0, octaspireHamtTestNumValuesReleased);
+
+    octaspire_hamt_release(v1);
+    v1 = 0;
+
+    ASSERT_EQ(10, octaspireHamtTestNumValuesReleased);
+
+    octaspire_hamt_release(v2);
+    v2 = 0;
+
+    ASSERT_EQ(20, octaspireHamtTestNumValuesReleased);
+
+    PASS();
+}
+
+TEST octaspire_hamt_new_with_octaspire_string_keys_test(void)
+{
+    octaspire_hamt_t *hamt = octaspire_hamt_new_with_octaspire_string_keys(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_map_element_callback_t)octaspire_string_release,
+        octaspireHamtTestAllocator);
+
+    ASSERT(hamt);
+
+    for (size_t i = 0; i < 200; ++i)
+    {
+        octaspire_string_t *key = octaspire_string_new_format(
+            octaspireHamtTestAllocator,
+            "key-%zu",
+            i);
+
+        octaspire_string_t *value = octaspire_string_new_format(
+            octaspireHamtTestAllocator,
+            "value-%zu",
+            i);
+
+        octaspire_hamt_t * const next = octaspire_hamt_put(
+            hamt,
+            octaspire_string_get_hash(key),
+            &key,
+            &value);
+
+        ASSERT(next);
+        octaspire_hamt_release(hamt);
+        hamt = next;
+    }
+
+    ASSERT_EQ(200, octaspire_hamt_get_number_of_elements(hamt));
+
+    octaspire_string_t *key =
+        octaspire_string_new("key-123", octaspireHamtTestAllocator);
+
+    octaspire_hamt_node_t const * const node = octaspire_hamt_get_const(
+        hamt,
+        octaspire_string_get_hash(key),
+        &key);
+
+    ASSERT(node);
+
+    ASSERT_STR_EQ(
+        "key-123",
+        octaspire_string_get_c_string(octaspire_hamt_node_get_key_const(node)));
+
+    ASSERT_STR_EQ(
+        "value-123",
+        octaspire_string_get_c_string(octaspire_hamt_node_get_value_const(node)));
+
+    octaspire_hamt_t * const removed = octaspire_hamt_remove(
+        hamt,
+        octaspire_string_get_hash(key),
+        &key);
+
+    ASSERT(removed);
+    ASSERT_EQ(199, octaspire_hamt_get_number_of_elements(removed));
+    ASSERT_FALSE(octaspire_hamt_get_const(
+        removed,
+        octaspire_string_get_hash(key),
+        &key));
+
+    octaspire_string_release(key);
+    key = 0;
+
+    octaspire_hamt_release(removed);
+    octaspire_hamt_release(hamt);
+    hamt = 0;
+
+    PASS();
+}
+
+TEST octaspire_hamt_element_const_iterator_test(void)
+{
+    octaspire_hamt_t *hamt = octaspire_hamt_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireHamtTestAllocator);
+
+    ASSERT(hamt);
+
+    size_t const numElements = 1024;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        ASSERT(octaspire_hamt_test_put_size_t(&hamt, i, i));
+    }
+
+    bool seen[1024] = {false};
+    size_t counter = 0;
+
+    octaspire_hamt_element_const_iterator_t iter =
+        octaspire_hamt_element_const_iterator_init(hamt);
+
+    while (iter.element)
+    {
+        size_t const key =
+            *(size_t const *)octaspire_hamt_node_get_key_const(iter.element);
+
+        ASSERT(key < numElements);
+        ASSERT_FALSE(seen[key]);
+        seen[key] = true;
+        ++counter;
+
+        octaspire_hamt_element_const_iterator_next(&iter);
+    }
+
+    ASSERT_EQ(numElements, counter);
+
+    octaspire_hamt_release(hamt);
+    hamt = 0;
+
+    PASS();
+}
+
+TEST octaspire_hamt_put_allocation_failure_test(void)
+{
+    octaspireHamtTestNumValuesReleased = 0;
+
+    octaspire_hamt_t *hamt = octaspire_hamt_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        octaspire_hamt_test_value_release_callback,
+        octaspireHamtTestAllocator);
+
+    ASSERT(hamt);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        ASSERT(octaspire_hamt_test_put_size_t(&hamt, i, i));
+    }
+
+    // Fail each allocation made by put in turn.
+    for (size_t i = 0; i < 4; ++i)
+    {
+        octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+            octaspireHamtTestAllocator,
+            i + 1,
+            ~((uint32_t)1 << i));
+
+        size_t const key = 1000 + i;
+        octaspire_hamt_t * const next = octaspire_hamt_put(
+            hamt,
+            octaspire_map_helper_size_t_get_hash(key),
+            &key,
+            &key);
+
+        octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+            octaspireHamtTestAllocator,
+            0,
+            0);
+
+        if (next)
+        {
+            octaspire_hamt_release(next);
+        }
+
+        ASSERT_EQ(100, octaspire_hamt_get_number_of_elements(hamt));
+    }
+
+    ASSERT_EQ(0, octaspireHamtTestNumValuesReleased);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(i, *octaspire_hamt_test_get_size_t(hamt, i));
+    }
+
+    octaspire_hamt_release(hamt);
+    hamt = 0;
+
+    ASSERT_EQ(100, octaspireHamtTestNumValuesReleased);
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_hamt_suite)
+{
+    octaspireHamtTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireHamtTestAllocator);
+
+    RUN_TEST(octaspire_hamt_new_test);
+    RUN_TEST(octaspire_hamt_new_allocation_failure_on_first_allocation_test);
+    RUN_TEST(octaspire_hamt_put_and_get_with_size_t_keys_test);
+    RUN_TEST(octaspire_hamt_old_versions_are_not_changed_test);
+    RUN_TEST(octaspire_hamt_new_snapshot_test);
+    RUN_TEST(octaspire_hamt_remove_test);
+    RUN_TEST(octaspire_hamt_colliding_hashes_test);
+    RUN_TEST(octaspire_hamt_values_are_released_with_last_version_test);
+    RUN_TEST(octaspire_hamt_new_with_octaspire_string_keys_test);
+    RUN_TEST(octaspire_hamt_element_const_iterator_test);
+    RUN_TEST(octaspire_hamt_put_allocation_failure_test);
+
+    octaspire_allocator_release(octaspireHamtTestAllocator);
+    octaspireHamtTestAllocator = 0;
+}
+
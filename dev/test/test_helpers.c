@@ -285,6 +285,61 @@ TEST octaspire_helpers_calculate_hash_for_memory_buffer_argument_test(void)
     PASS();
 }
 
+TEST octaspire_helpers_private_siphash24_reference_vectors_test(void)
+{
+    // Vectors of the SipHash-2-4 reference implementation: key is 00..0f
+    // and the message 00, 01, ... of the given length.
+    uint8_t key[16];
+    uint8_t message[15];
+
+    for (size_t i = 0; i < sizeof(key); ++i)
+    {
+        key[i] = (uint8_t)i;
+    }
+
+    for (size_t i = 0; i < sizeof(message); ++i)
+    {
+        message[i] = (uint8_t)i;
+    }
+
+    ASSERT(0x726fdb47dd0e0e31ULL ==
+        octaspire_helpers_private_siphash(message, 0, key, 2, 4));
+
+    ASSERT(0x93f5f5799a932462ULL ==
+        octaspire_helpers_private_siphash(message, 8, key, 2, 4));
+
+    ASSERT(0xa129ca6149be45e5ULL ==
+        octaspire_helpers_private_siphash(message, 15, key, 2, 4));
+
+    PASS();
+}
+
+TEST octaspire_helpers_calculate_keyed_hash_for_memory_buffer_argument_test(void)
+{
+    uint8_t key1[16] = {0};
+    uint8_t key2[16] = {0};
+    key2[15] = 1;
+
+    char const * const buffer = "123456789=?qwertyuiop#_.:,!++?";
+
+    uint64_t const hash =
+        octaspire_helpers_calculate_siphash13(buffer, strlen(buffer), key1);
+
+    ASSERT(hash == octaspire_helpers_calculate_siphash13(buffer, strlen(buffer), key1));
+    ASSERT(hash != octaspire_helpers_calculate_siphash13(buffer, strlen(buffer), key2));
+    ASSERT(hash != octaspire_helpers_calculate_siphash13(buffer, strlen(buffer) - 1, key1));
+    ASSERT(hash != octaspire_helpers_private_siphash(buffer, strlen(buffer), key1, 2, 4));
+
+    ASSERT_EQ(
+        (uint32_t)(hash ^ (hash >> 32)),
+        octaspire_helpers_calculate_keyed_hash_for_memory_buffer_argument(
+            buffer,
+            strlen(buffer),
+            key1));
+
+    PASS();
+}
+
 TEST octaspire_helpers_base64_encode_qwerty1_line_len_0_test(void)
 {
     char const * const input = "qwerty1";
@@ -983,6 +1038,8 @@ GREATEST_SUITE(octaspire_helpers_suite)
     RUN_TEST(octaspire_helpers_is_odd_size_t_test);
 
     RUN_TEST(octaspire_helpers_calculate_hash_for_memory_buffer_argument_test);
+    RUN_TEST(octaspire_helpers_private_siphash24_reference_vectors_test);
+    RUN_TEST(octaspire_helpers_calculate_keyed_hash_for_memory_buffer_argument_test);
 
     RUN_TEST(octaspire_helpers_base64_encode_qwerty1_line_len_0_test);
     RUN_TEST(octaspire_helpers_base64_encode_qwerty1_line_len_10_test);
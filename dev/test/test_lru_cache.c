@@ -0,0 +1,621 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_lru_cache.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_lru_cache.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_helpers.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireLruCacheTestAllocator = 0;
+
+static size_t octaspireLruCacheTestNumValuesReleased = 0;
+static size_t octaspireLruCacheTestLastValueReleased = 0;
+
+static void octaspire_lru_cache_test_value_release_callback(void *value)
+{
+    ++octaspireLruCacheTestNumValuesReleased;
+    octaspireLruCacheTestLastValueReleased = *(size_t const *)value;
+}
+
+static bool octaspire_lru_cache_test_put(
+    octaspire_lru_cache_t * const cache,
+    size_t const key,
+    size_t const value)
+{
+    return octaspire_lru_cache_put(
+        cache,
+        octaspire_map_helper_size_t_get_hash(key),
+        &key,
+        &value);
+}
+
+static size_t const *octaspire_lru_cache_test_get(
+    octaspire_lru_cache_t * const cache,
+    size_t const key)
+{
+    return octaspire_lru_cache_get(
+        cache,
+        octaspire_map_helper_size_t_get_hash(key),
+        &key);
+}
+
+static bool octaspire_lru_cache_test_contains(
+    octaspire_lru_cache_t const * const cache,
+    size_t const key)
+{
+    return octaspire_lru_cache_peek_const(
+        cache,
+        octaspire_map_helper_size_t_get_hash(key),
+        &key) != 0;
+}
+
+// Checks that the list and the map agree.
+static bool octaspire_lru_cache_test_is_valid(
+    octaspire_lru_cache_t const * const cache)
+{
+    size_t numEntries  = 0;
+    size_t totalCharge = 0;
+
+    octaspire_lru_cache_private_entry_t const *previous = 0;
+
+    for (octaspire_lru_cache_private_entry_t const *entry = cache->front;
+         entry;
+         entry = entry->next)
+    {
+        if (entry->previous != previous)
+        {
+            return false;
+        }
+
+        if (octaspire_map_element_get_value_const(entry->element) != entry)
+        {
+            return false;
+        }
+
+        previous = entry;
+        ++numEntries;
+        totalCharge += entry->charge;
+    }
+
+    return previous == cache->back &&
+        numEntries == octaspire_lru_cache_get_number_of_elements(cache) &&
+        totalCharge == cache->totalCharge &&
+        totalCharge <= cache->capacity;
+}
+
+TEST octaspire_lru_cache_new_test(void)
+{
+    octaspire_lru_cache_t *cache = octaspire_lru_cache_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        10,
+        OCTASPIRE_LRU_CACHE_POLICY_LRU,
+        octaspireLruCacheTestAllocator);
+
+    ASSERT(cache);
+    ASSERT_EQ(octaspireLruCacheTestAllocator, cache->allocator);
+    ASSERT(octaspire_lru_cache_is_empty(cache));
+    ASSERT_EQ(0,  octaspire_lru_cache_get_number_of_elements(cache));
+    ASSERT_EQ(10, octaspire_lru_cache_get_capacity(cache));
+    ASSERT_EQ(0,  octaspire_lru_cache_get_total_charge(cache));
+    ASSERT_FALSE(octaspire_lru_cache_evict(cache));
+    ASSERT_FALSE(octaspire_lru_cache_test_get(cache, 1));
+    ASSERT(octaspire_lru_cache_get_hit_ratio(cache) == 0);
+
+    octaspire_lru_cache_release(cache);
+    cache = 0;
+
+    PASS();
+}
+
+TEST octaspire_lru_cache_new_allocation_failure_on_first_allocation_test(void)
+{
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireLruCacheTestAllocator,
+        1,
+        0);
+
+    octaspire_lru_cache_t *cache = octaspire_lru_cache_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        10,
+        OCTASPIRE_LRU_CACHE_POLICY_LRU,
+        octaspireLruCacheTestAllocator);
+
+    ASSERT_FALSE(cache);
+
+    ASSERT_EQ(
+        0,
+        octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+            octaspireLruCacheTestAllocator));
+
+    PASS();
+}
+
+TEST octaspire_lru_cache_put_and_get_evicts_least_recently_used_test(void)
+{
+    octaspireLruCacheTestNumValuesReleased = 0;
+
+    octaspire_lru_cache_t *cache = octaspire_lru_cache_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        octaspire_lru_cache_test_value_release_callback,
+        3,
+        OCTASPIRE_LRU_CACHE_POLICY_LRU,
+        octaspireLruCacheTestAllocator);
+
+    ASSERT(cache);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ASSERT(octaspire_lru_cache_test_put(cache, i, 100 + i));
+    }
+
+    ASSERT_EQ(3, octaspire_lru_cache_get_number_of_elements(cache));
+    ASSERT_EQ(100, *octaspire_lru_cache_test_get(cache, 0));
+
+    // 1 is now the least recently used.
+    ASSERT(octaspire_lru_cache_test_put(cache, 3, 103));
+    ASSERT_EQ(1,   octaspireLruCacheTestNumValuesReleased);
+    ASSERT_EQ(101, octaspireLruCacheTestLastValueReleased);
+    ASSERT_FALSE(octaspire_lru_cache_test_get(cache, 1));
+
+    ASSERT_EQ(102, *octaspire_lru_cache_test_get(cache, 2));
+    ASSERT_EQ(100, *octaspire_lru_cache_test_get(cache, 0));
+
+    ASSERT(octaspire_lru_cache_test_put(cache, 4, 104));
+    ASSERT_EQ(2,   octaspireLruCacheTestNumValuesReleased);
+    ASSERT_EQ(103, octaspireLruCacheTestLastValueReleased);
+
+    ASSERT_EQ(3, octaspire_lru_cache_get_number_of_elements(cache));
+    ASSERT(octaspire_lru_cache_test_contains(cache, 0));
+    ASSERT(octaspire_lru_cache_test_contains(cache, 2));
+    ASSERT(octaspire_lru_cache_test_contains(cache, 4));
+    ASSERT(octaspire_lru_cache_test_is_valid(cache));
+
+    octaspire_lru_cache_statistics_t const statistics =
+        octaspire_lru_cache_get_statistics(cache);
+
+    ASSERT_EQ(3, statistics.numHits);
+    ASSERT_EQ(1, statistics.numMisses);
+    ASSERT_EQ(5, statistics.numInsertions);
+    ASSERT_EQ(2, statistics.numEvictions);
+    ASSERT(octaspire_lru_cache_get_hit_ratio(cache) == 0.75);
+
+    octaspire_lru_cache_reset_statistics(cache);
+    ASSERT_EQ(0, octaspire_lru_cache_get_statistics(cache).numHits);
+    ASSERT(octaspire_lru_cache_get_hit_ratio(cache) == 0);
+
+    octaspire_lru_cache_release(cache);
+    cache = 0;
+
+    ASSERT_EQ(5, octaspireLruCacheTestNumValuesReleased);
+
+    PASS();
+}
+
+TEST octaspire_lru_cache_put_replaces_value_test(void)
+{
+    octaspireLruCacheTestNumValuesReleased = 0;
+
+    octaspire_lru_cache_t *cache = octaspire_lru_cache_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        octaspire_lru_cache_test_value_release_callback,
+        2,
+        OCTASPIRE_LRU_CACHE_POLICY_LRU,
+        octaspireLruCacheTestAllocator);
+
+    ASSERT(cache);
+
+    ASSERT(octaspire_lru_cache_test_put(cache, 1, 10));
+    ASSERT(octaspire_lru_cache_test_put(cache, 2, 20));
+
+    // Replacing makes 1 the most recently used element.
+    ASSERT(octaspire_lru_cache_test_put(cache, 1, 11));
+    ASSERT_EQ(1,  octaspireLruCacheTestNumValuesReleased);
+    ASSERT_EQ(10, octaspireLruCacheTestLastValueReleased);
+    ASSERT_EQ(2,  octaspire_lru_cache_get_number_of_elements(cache));
+    ASSERT_EQ(2,  octaspire_lru_cache_get_statistics(cache).numInsertions);
+
+    ASSERT(octaspire_lru_cache_test_put(cache, 3, 30));
+    ASSERT_EQ(20, octaspireLruCacheTestLastValueReleased);
+    ASSERT_EQ(11, *octaspire_lru_cache_test_get(cache, 1));
+    ASSERT_EQ(30, *octaspire_lru_cache_test_get(cache, 3));
+    ASSERT(octaspire_lru_cache_test_is_valid(cache));
+
+    octaspire_lru_cache_release(cache);
+    cache = 0;
+
+    PASS();
+}
+
+TEST octaspire_lru_cache_put_with_charge_test(void)
+{
+    octaspireLruCacheTestNumValuesReleased = 0;
+
+    octaspire_lru_cache_t *cache = octaspire_lru_cache_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        octaspire_lru_cache_test_value_release_callback,
+        100,
+        OCTASPIRE_LRU_CACHE_POLICY_LRU,
+        octaspireLruCacheTestAllocator);
+
+    ASSERT(cache);
+
+    size_t key   = 1;
+    size_t value = 10;
+
+    ASSERT(octaspire_lru_cache_put_with_charge(
+        cache, octaspire_map_helper_size_t_get_hash(key), &key, &value, 40));
+
+    key = 2; value = 20;
+    ASSERT(octaspire_lru_cache_put_with_charge(
+        cache, octaspire_map_helper_size_t_get_hash(key), &key, &value, 40));
+
+    ASSERT_EQ(80, octaspire_lru_cache_get_total_charge(cache));
+
+    key = 3; value = 30;
+    ASSERT(octaspire_lru_cache_put_with_charge(
+        cache, octaspire_map_helper_size_t_get_hash(key), &key, &value, 30));
+
+    ASSERT_EQ(1,  octaspireLruCacheTestNumValuesReleased);
+    ASSERT_EQ(10, octaspireLruCacheTestLastValueReleased);
+    ASSERT_EQ(70, octaspire_lru_cache_get_total_charge(cache));
+
+    // Too large to ever fit
+    key = 4; value = 40;
+    ASSERT_FALSE(octaspire_lru_cache_put_with_charge(
+        cache, octaspire_map_helper_size_t_get_hash(key), &key, &value, 101));
+
+    ASSERT_EQ(2, octaspire_lru_cache_get_number_of_elements(cache));
+
+    // Growing the charge of 3 evicts 2 but never 3 itself.
+    key = 3; value = 31;
+    ASSERT(octaspire_lru_cache_put_with_charge(
+        cache, octaspire_map_helper_size_t_get_hash(key), &key, &value, 100));
+
+    ASSERT_EQ(1,   octaspire_lru_cache_get_number_of_elements(cache));
+    ASSERT_EQ(100, octaspire_lru_cache_get_total_charge(cache));
+    ASSERT_EQ(31,  *octaspire_lru_cache_test_get(cache, 3));
+    ASSERT(octaspire_lru_cache_test_is_valid(cache));
+
+    octaspire_lru_cache_set_capacity(cache, 50);
+    ASSERT(octaspire_lru_cache_is_empty(cache));
+    ASSERT_EQ(0,  octaspire_lru_cache_get_total_charge(cache));
+    ASSERT_EQ(50, octaspire_lru_cache_get_capacity(cache));
+    ASSERT_EQ(4,  octaspireLruCacheTestNumValuesReleased);
+
+    octaspire_lru_cache_release(cache);
+    cache = 0;
+
+    PASS();
+}
+
+TEST octaspire_lru_cache_clock_policy_test(void)
+{
+    octaspireLruCacheTestNumValuesReleased = 0;
+
+    octaspire_lru_cache_t *cache = octaspire_lru_cache_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        octaspire_lru_cache_test_value_release_callback,
+        3,
+        OCTASPIRE_LRU_CACHE_POLICY_CLOCK,
+        octaspireLruCacheTestAllocator);
+
+    ASSERT(cache);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ASSERT(octaspire_lru_cache_test_put(cache, i, 100 + i));
+    }
+
+    // A hit only marks the element; the order stays the same.
+    octaspire_lru_cache_private_entry_t const * const back = cache->back;
+    ASSERT_EQ(100, *octaspire_lru_cache_test_get(cache, 0));
+    ASSERT_EQ(back, cache->back);
+    ASSERT(back->isReferenced);
+
+    // 0 gets a second chance, so 1 is evicted.
+    ASSERT(octaspire_lru_cache_test_put(cache, 3, 103));
+    ASSERT_EQ(101, octaspireLruCacheTestLastValueReleased);
+    ASSERT_FALSE(back->isReferenced);
+
+    ASSERT(octaspire_lru_cache_test_put(cache, 4, 104));
+    ASSERT_EQ(102, octaspireLruCacheTestLastValueReleased);
+
+    ASSERT(octaspire_lru_cache_test_put(cache, 5, 105));
+    ASSERT_EQ(100, octaspireLruCacheTestLastValueReleased);
+
+    ASSERT(octaspire_lru_cache_test_contains(cache, 3));
+    ASSERT(octaspire_lru_cache_test_contains(cache, 4));
+    ASSERT(octaspire_lru_cache_test_contains(cache, 5));
+    ASSERT(octaspire_lru_cache_test_is_valid(cache));
+
+    // Every element referenced: eviction falls back to FIFO order.
+    for (size_t i = 3; i < 6; ++i)
+    {
+        ASSERT(octaspire_lru_cache_test_get(cache, i));
+    }
+
+    ASSERT(octaspire_lru_cache_evict(cache));
+    ASSERT_EQ(103, octaspireLruCacheTestLastValueReleased);
+    ASSERT_EQ(4, octaspire_lru_cache_get_statistics(cache).numEvictions);
+    ASSERT(octaspire_lru_cache_test_is_valid(cache));
+
+    octaspire_lru_cache_release(cache);
+    cache = 0;
+
+    PASS();
+}
+
+TEST octaspire_lru_cache_remove_and_clear_test(void)
+{
+    octaspireLruCacheTestNumValuesReleased = 0;
+
+    octaspire_lru_cache_t *cache = octaspire_lru_cache_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        octaspire_lru_cache_test_value_release_callback,
+        1000,
+        OCTASPIRE_LRU_CACHE_POLICY_LRU,
+        octaspireLruCacheTestAllocator);
+
+    ASSERT(cache);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT(octaspire_lru_cache_test_put(cache, i, i));
+    }
+
+    for (size_t i = 0; i < 1000; i += 2)
+    {
+        size_t const key = i;
+
+        ASSERT(octaspire_lru_cache_remove(
+            cache, octaspire_map_helper_size_t_get_hash(key), &key));
+
+        ASSERT_FALSE(octaspire_lru_cache_remove(
+            cache, octaspire_map_helper_size_t_get_hash(key), &key));
+    }
+
+    ASSERT_EQ(500, octaspireLruCacheTestNumValuesReleased);
+    ASSERT_EQ(500, octaspire_lru_cache_get_number_of_elements(cache));
+    ASSERT_EQ(0,   octaspire_lru_cache_get_statistics(cache).numEvictions);
+    ASSERT(octaspire_lru_cache_test_is_valid(cache));
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(i % 2 == 1, octaspire_lru_cache_test_contains(cache, i));
+    }
+
+    octaspire_lru_cache_clear(cache);
+
+    ASSERT(octaspire_lru_cache_is_empty(cache));
+    ASSERT_EQ(1000, octaspireLruCacheTestNumValuesReleased);
+    ASSERT_EQ(0,    octaspire_lru_cache_get_total_charge(cache));
+    ASSERT(octaspire_lru_cache_test_is_valid(cache));
+
+    ASSERT(octaspire_lru_cache_test_put(cache, 7, 7));
+    ASSERT_EQ(7, *octaspire_lru_cache_test_get(cache, 7));
+
+    octaspire_lru_cache_release(cache);
+    cache = 0;
+
+    PASS();
+}
+
+TEST octaspire_lru_cache_with_octaspire_string_keys_test(void)
+{
+    octaspire_lru_cache_t *cache = octaspire_lru_cache_new_with_octaspire_string_keys(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_map_element_callback_t)octaspire_string_release,
+        2,
+        OCTASPIRE_LRU_CACHE_POLICY_LRU,
+        octaspireLruCacheTestAllocator);
+
+    ASSERT(cache);
+
+    char const * const names[] = {"one", "two", "three", "one"};
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        octaspire_string_t *key =
+            octaspire_string_new(names[i], octaspireLruCacheTestAllocator);
+
+        octaspire_string_t *value =
+            octaspire_string_new_format(octaspireLruCacheTestAllocator, "%zu", i);
+
+        ASSERT(octaspire_lru_cache_put(
+            cache, octaspire_string_get_hash(key), &key, &value));
+    }
+
+    ASSERT_EQ(2, octaspire_lru_cache_get_number_of_elements(cache));
+
+    octaspire_string_t *key =
+        octaspire_string_new("one", octaspireLruCacheTestAllocator);
+
+    octaspire_string_t const * const value =
+        octaspire_lru_cache_get(cache, octaspire_string_get_hash(key), &key);
+
+    ASSERT(value);
+    ASSERT_STR_EQ("3", octaspire_string_get_c_string(value));
+
+    octaspire_string_release(key);
+    key = octaspire_string_new("two", octaspireLruCacheTestAllocator);
+    ASSERT_FALSE(octaspire_lru_cache_get(cache, octaspire_string_get_hash(key), &key));
+    octaspire_string_release(key);
+    key = 0;
+
+    ASSERT(octaspire_lru_cache_test_is_valid(cache));
+
+    octaspire_lru_cache_release(cache);
+    cache = 0;
+
+    PASS();
+}
+
+TEST octaspire_lru_cache_put_allocation_failure_test(void)
+{
+    octaspire_lru_cache_t *cache = octaspire_lru_cache_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        2,
+        OCTASPIRE_LRU_CACHE_POLICY_LRU,
+        octaspireLruCacheTestAllocator);
+
+    ASSERT(cache);
+
+    ASSERT(octaspire_lru_cache_test_put(cache, 1, 10));
+    ASSERT(octaspire_lru_cache_test_put(cache, 2, 20));
+
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireLruCacheTestAllocator,
+        1,
+        0);
+
+    ASSERT_FALSE(octaspire_lru_cache_test_put(cache, 3, 30));
+
+    ASSERT_EQ(
+        0,
+        octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+            octaspireLruCacheTestAllocator));
+
+    // Nothing was evicted.
+    ASSERT_EQ(2, octaspire_lru_cache_get_number_of_elements(cache));
+    ASSERT_EQ(10, *octaspire_lru_cache_test_get(cache, 1));
+    ASSERT_EQ(20, *octaspire_lru_cache_test_get(cache, 2));
+    ASSERT_FALSE(octaspire_lru_cache_test_get(cache, 3));
+    ASSERT(octaspire_lru_cache_test_is_valid(cache));
+
+    octaspire_lru_cache_release(cache);
+    cache = 0;
+
+    PASS();
+}
+
+TEST octaspire_lru_cache_random_operations_test(void)
+{
+    // Reference model: keys in order of recency, most recent first.
+    size_t const capacity = 16;
+    size_t model[16];
+    size_t modelLength = 0;
+
+    octaspire_lru_cache_t *cache = octaspire_lru_cache_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        capacity,
+        OCTASPIRE_LRU_CACHE_POLICY_LRU,
+        octaspireLruCacheTestAllocator);
+
+    ASSERT(cache);
+
+    uint32_t state = 12345;
+
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        size_t const key       = (state >> 16) % 40;
+        bool   const isPut     = ((state >> 8) & 1) != 0;
+
+        size_t index = 0;
+
+        while (index < modelLength && model[index] != key)
+        {
+            ++index;
+        }
+
+        bool const isInModel = index < modelLength;
+
+        if (isPut)
+        {
+            ASSERT(octaspire_lru_cache_test_put(cache, key, key * 2));
+        }
+        else
+        {
+            size_t const * const value = octaspire_lru_cache_test_get(cache, key);
+            ASSERT_EQ(isInModel, value != 0);
+
+            if (value)
+            {
+                ASSERT_EQ(key * 2, *value);
+            }
+            else
+            {
+                continue;
+            }
+        }
+
+        if (!isInModel)
+        {
+            index = (modelLength < capacity) ? modelLength++ : (capacity - 1);
+        }
+
+        memmove(model + 1, model, index * sizeof(size_t));
+        model[0] = key;
+    }
+
+    ASSERT_EQ(modelLength, octaspire_lru_cache_get_number_of_elements(cache));
+    ASSERT(octaspire_lru_cache_test_is_valid(cache));
+
+    size_t i = 0;
+
+    for (octaspire_lru_cache_private_entry_t const *entry = cache->front;
+         entry;
+         entry = entry->next)
+    {
+        ASSERT_EQ(model[i], *(size_t const *)octaspire_map_element_get_key_const(entry->element));
+        ++i;
+    }
+
+    octaspire_lru_cache_release(cache);
+    cache = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_lru_cache_suite)
+{
+    octaspireLruCacheTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireLruCacheTestAllocator);
+
+    RUN_TEST(octaspire_lru_cache_new_test);
+    RUN_TEST(octaspire_lru_cache_new_allocation_failure_on_first_allocation_test);
+    RUN_TEST(octaspire_lru_cache_put_and_get_evicts_least_recently_used_test);
+    RUN_TEST(octaspire_lru_cache_put_replaces_value_test);
+    RUN_TEST(octaspire_lru_cache_put_with_charge_test);
+    RUN_TEST(octaspire_lru_cache_clock_policy_test);
+    RUN_TEST(octaspire_lru_cache_remove_and_clear_test);
+    RUN_TEST(octaspire_lru_cache_with_octaspire_string_keys_test);
+    RUN_TEST(octaspire_lru_cache_put_allocation_failure_test);
+    RUN_TEST(octaspire_lru_cache_random_operations_test);
+
+    octaspire_allocator_release(octaspireLruCacheTestAllocator);
+    octaspireLruCacheTestAllocator = 0;
+}
+
@@ -728,6 +728,550 @@ TEST octaspire_map_is_empty_test(void)
     PASS();
 }
 
+TEST octaspire_map_clear_keeps_buckets_test(void)
+{
+    octaspire_map_t *hashMap = octaspire_map_new_with_octaspire_string_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(hashMap);
+
+    for (size_t round = 0; round < 3; ++round)
+    {
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            octaspire_string_t *key = octaspire_string_new_format(
+                octaspireContainerHashMapTestAllocator,
+                "key%zu",
+                i);
+
+            ASSERT(key);
+            ASSERT(octaspire_map_put(
+                hashMap,
+                octaspire_string_get_hash(key),
+                &key,
+                &i));
+        }
+
+        ASSERT_EQ(1000, octaspire_map_get_number_of_elements(hashMap));
+
+        size_t const numBuckets = octaspire_vector_get_length(hashMap->buckets);
+        ASSERT(numBuckets > OCTASPIRE_MAP_SMALLEST_SIZE);
+
+        // Clearing must not allocate
+        octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+            octaspireContainerHashMapTestAllocator,
+            1,
+            0x00);
+
+        ASSERT(octaspire_map_clear(hashMap));
+
+        ASSERT_EQ(
+            1,
+            octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+                octaspireContainerHashMapTestAllocator));
+
+        octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+            octaspireContainerHashMapTestAllocator,
+            0,
+            0x00);
+
+        ASSERT(octaspire_map_is_empty(hashMap));
+        ASSERT_EQ(0, hashMap->numBucketsInUse);
+        ASSERT_EQ(numBuckets, octaspire_vector_get_length(hashMap->buckets));
+
+        for (size_t i = 0; i < numBuckets; ++i)
+        {
+            ASSERT(octaspire_vector_is_empty(
+                octaspire_vector_get_element_at(hashMap->buckets, (ptrdiff_t)i)));
+        }
+    }
+
+    // Clearing an empty map is also fine
+    ASSERT(octaspire_map_clear(hashMap));
+    ASSERT(octaspire_map_is_empty(hashMap));
+
+    octaspire_map_release(hashMap);
+    hashMap = 0;
+
+    PASS();
+}
+
+TEST octaspire_map_clear_with_shrink_test(void)
+{
+    octaspire_map_t *hashMap = octaspire_map_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(hashMap);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT(octaspire_map_put(hashMap, (uint32_t)i, &i, &i));
+    }
+
+    ASSERT(octaspire_vector_get_length(hashMap->buckets) > OCTASPIRE_MAP_SMALLEST_SIZE);
+
+    // Failing to allocate the smaller buckets still leaves the map cleared
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireContainerHashMapTestAllocator,
+        1,
+        0x00);
+
+    ASSERT_FALSE(octaspire_map_clear_with_shrink(hashMap, true));
+    ASSERT(octaspire_map_is_empty(hashMap));
+
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireContainerHashMapTestAllocator,
+        0,
+        0x00);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT(octaspire_map_put(hashMap, (uint32_t)i, &i, &i));
+    }
+
+    ASSERT(octaspire_map_clear_with_shrink(hashMap, true));
+    ASSERT(octaspire_map_is_empty(hashMap));
+    ASSERT_EQ(0, hashMap->numBucketsInUse);
+
+    ASSERT_EQ(
+        OCTASPIRE_MAP_SMALLEST_SIZE,
+        octaspire_vector_get_length(hashMap->buckets));
+
+    size_t const key = 7;
+    ASSERT(octaspire_map_put(hashMap, (uint32_t)key, &key, &key));
+    ASSERT(octaspire_map_get(hashMap, (uint32_t)key, &key));
+
+    octaspire_map_release(hashMap);
+    hashMap = 0;
+
+    PASS();
+}
+
+TEST octaspire_map_new_from_arrays_test(void)
+{
+    size_t const numElements = 10000;
+
+    size_t   *keys   = octaspire_allocator_malloc(
+        octaspireContainerHashMapTestAllocator, numElements * sizeof(size_t));
+
+    size_t   *values = octaspire_allocator_malloc(
+        octaspireContainerHashMapTestAllocator, numElements * sizeof(size_t));
+
+    uint32_t *hashes = octaspire_allocator_malloc(
+        octaspireContainerHashMapTestAllocator, numElements * sizeof(uint32_t));
+
+    ASSERT(keys && values && hashes);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        keys[i]   = numElements - i;
+        values[i] = i;
+        hashes[i] = octaspire_map_helper_size_t_get_hash(keys[i]);
+    }
+
+    octaspire_map_t *hashMap = octaspire_map_new_from_arrays(
+        keys,
+        values,
+        hashes,
+        numElements,
+        sizeof(size_t),
+        false,
+        sizeof(size_t),
+        false,
+        octaspire_map_new_test_key_compare_function_for_size_t_keys,
+        octaspire_map_new_test_key_hash_function_for_size_t_keys,
+        0,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(hashMap);
+    ASSERT_EQ(numElements, octaspire_map_get_number_of_elements(hashMap));
+
+    // Sized once: 10000 elements fit under the load factor with 16384
+    // buckets.
+    ASSERT_EQ(16384, octaspire_vector_get_length(hashMap->buckets));
+    ASSERT(octaspire_map_private_get_load_factor(hashMap) < OCTASPIRE_MAP_MAX_LOAD_FACTOR);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        octaspire_map_element_t const * const element =
+            octaspire_map_get_const(hashMap, hashes[i], &keys[i]);
+
+        ASSERT(element);
+        ASSERT_EQ(hashes[i], octaspire_map_element_get_hash(element));
+        ASSERT_EQ(values[i], *(size_t const *)octaspire_map_element_get_value_const(element));
+    }
+
+    // The map works normally afterwards.
+    size_t const key   = 0;
+    size_t const value = 123;
+    ASSERT(octaspire_map_put(hashMap, octaspire_map_helper_size_t_get_hash(key), &key, &value));
+    ASSERT(octaspire_map_remove(hashMap, hashes[0], &keys[0]));
+    ASSERT_EQ(numElements, octaspire_map_get_number_of_elements(hashMap));
+
+    octaspire_map_release(hashMap);
+    hashMap = 0;
+
+    // Hashes calculated with the hash function
+    hashMap = octaspire_map_new_from_arrays(
+        keys,
+        values,
+        0,
+        numElements,
+        sizeof(size_t),
+        false,
+        sizeof(size_t),
+        false,
+        octaspire_map_new_test_key_compare_function_for_size_t_keys,
+        octaspire_map_new_test_key_hash_function_for_size_t_keys,
+        0,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(hashMap);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        octaspire_map_element_t const * const element =
+            octaspire_map_get_const(hashMap, (uint32_t)keys[i], &keys[i]);
+
+        ASSERT(element);
+        ASSERT_EQ(values[i], *(size_t const *)octaspire_map_element_get_value_const(element));
+    }
+
+    octaspire_map_release(hashMap);
+    hashMap = 0;
+
+    // Duplicate keys are rejected.
+    keys[numElements - 1] = keys[0];
+    hashes[numElements - 1] = hashes[0];
+
+    ASSERT_FALSE(octaspire_map_new_from_arrays(
+        keys,
+        values,
+        hashes,
+        numElements,
+        sizeof(size_t),
+        false,
+        sizeof(size_t),
+        false,
+        octaspire_map_new_test_key_compare_function_for_size_t_keys,
+        octaspire_map_new_test_key_hash_function_for_size_t_keys,
+        0,
+        0,
+        octaspireContainerHashMapTestAllocator));
+
+    // So is a failing allocation.
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireContainerHashMapTestAllocator,
+        1,
+        0);
+
+    ASSERT_FALSE(octaspire_map_new_from_arrays(
+        keys,
+        values,
+        hashes,
+        10,
+        sizeof(size_t),
+        false,
+        sizeof(size_t),
+        false,
+        octaspire_map_new_test_key_compare_function_for_size_t_keys,
+        octaspire_map_new_test_key_hash_function_for_size_t_keys,
+        0,
+        0,
+        octaspireContainerHashMapTestAllocator));
+
+    ASSERT_EQ(
+        0,
+        octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+            octaspireContainerHashMapTestAllocator));
+
+    // Empty
+    hashMap = octaspire_map_new_from_arrays(
+        0,
+        0,
+        0,
+        0,
+        sizeof(size_t),
+        false,
+        sizeof(size_t),
+        false,
+        octaspire_map_new_test_key_compare_function_for_size_t_keys,
+        octaspire_map_new_test_key_hash_function_for_size_t_keys,
+        0,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(hashMap);
+    ASSERT(octaspire_map_is_empty(hashMap));
+    ASSERT_EQ(OCTASPIRE_MAP_SMALLEST_SIZE, octaspire_vector_get_length(hashMap->buckets));
+
+    octaspire_map_release(hashMap);
+    hashMap = 0;
+
+    octaspire_allocator_free(octaspireContainerHashMapTestAllocator, hashes);
+    octaspire_allocator_free(octaspireContainerHashMapTestAllocator, values);
+    octaspire_allocator_free(octaspireContainerHashMapTestAllocator, keys);
+
+    PASS();
+}
+
+TEST octaspire_map_new_from_arrays_with_octaspire_string_keys_test(void)
+{
+    octaspire_string_t *keys[3];
+    octaspire_string_t *values[3];
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        keys[i] = octaspire_string_new_format(
+            octaspireContainerHashMapTestAllocator, "key%zu", i);
+
+        values[i] = octaspire_string_new_format(
+            octaspireContainerHashMapTestAllocator, "value%zu", i);
+
+        ASSERT(keys[i] && values[i]);
+    }
+
+    octaspire_map_t *hashMap = octaspire_map_new_from_arrays(
+        keys,
+        values,
+        0,
+        3,
+        sizeof(octaspire_string_t*),
+        true,
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_map_key_compare_function_t)octaspire_string_is_equal,
+        (octaspire_map_key_hash_function_t)octaspire_string_get_hash,
+        (octaspire_map_element_callback_t)octaspire_string_release,
+        (octaspire_map_element_callback_t)octaspire_string_release,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(hashMap);
+
+    octaspire_string_t *key =
+        octaspire_string_new("key1", octaspireContainerHashMapTestAllocator);
+
+    octaspire_map_element_t const * const element =
+        octaspire_map_get_const(hashMap, octaspire_string_get_hash(key), &key);
+
+    ASSERT(element);
+    ASSERT_STR_EQ(
+        "value1",
+        octaspire_string_get_c_string(octaspire_map_element_get_value_const(element)));
+
+    octaspire_string_release(key);
+    key = 0;
+
+    // Releases the keys and values.
+    octaspire_map_release(hashMap);
+    hashMap = 0;
+
+    PASS();
+}
+
+static size_t octaspire_map_test_get_longest_bucket_length(
+    octaspire_map_t const * const hashMap)
+{
+    size_t result = 0;
+
+    for (size_t i = 0; i < octaspire_vector_get_length(hashMap->buckets); ++i)
+    {
+        octaspire_vector_t const * const bucket =
+            octaspire_vector_get_element_at_const(hashMap->buckets, (ptrdiff_t)i);
+
+        result = octaspire_helpers_max_size_t(result, octaspire_vector_get_length(bucket));
+    }
+
+    return result;
+}
+
+TEST octaspire_map_new_with_untrusted_size_t_keys_test(void)
+{
+    octaspire_map_t *hashMap = octaspire_map_new_with_untrusted_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(hashMap);
+    ASSERT(octaspire_map_is_for_untrusted_keys(hashMap));
+
+    octaspire_map_t *trustedHashMap = octaspire_map_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(trustedHashMap);
+    ASSERT_FALSE(octaspire_map_is_for_untrusted_keys(trustedHashMap));
+
+    // Simulate keys chosen to collide: every caller given hash is the same.
+    size_t const numElements = 1000;
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        size_t const value = i * 2;
+        ASSERT(octaspire_map_put(hashMap,        0, &i, &value));
+        ASSERT(octaspire_map_put(trustedHashMap, 0, &i, &value));
+    }
+
+    ASSERT_EQ(numElements, octaspire_map_get_number_of_elements(hashMap));
+    ASSERT_EQ(numElements, octaspire_map_test_get_longest_bucket_length(trustedHashMap));
+    ASSERT(octaspire_map_test_get_longest_bucket_length(hashMap) < 16);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        // The hash argument does not matter.
+        octaspire_map_element_t const * const element =
+            octaspire_map_get_const(hashMap, (uint32_t)i, &i);
+
+        ASSERT(element);
+        ASSERT_EQ(i,     *(size_t const *)octaspire_map_element_get_key_const(element));
+        ASSERT_EQ(i * 2, *(size_t const *)octaspire_map_element_get_value_const(element));
+
+        ASSERT_EQ(
+            octaspire_map_helper_size_t_get_keyed_hash(&i, hashMap->seed),
+            octaspire_map_element_get_hash(element));
+    }
+
+    for (size_t i = 0; i < numElements; i += 2)
+    {
+        ASSERT(octaspire_map_remove(hashMap, 12345, &i));
+    }
+
+    ASSERT_EQ(numElements / 2, octaspire_map_get_number_of_elements(hashMap));
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        ASSERT_EQ(i % 2 == 1, octaspire_map_get(hashMap, 0, &i) != 0);
+    }
+
+    octaspire_map_release(trustedHashMap);
+    trustedHashMap = 0;
+
+    octaspire_map_release(hashMap);
+    hashMap = 0;
+
+    PASS();
+}
+
+TEST octaspire_map_new_with_untrusted_octaspire_string_keys_test(void)
+{
+    octaspire_map_t *hashMap = octaspire_map_new_with_untrusted_octaspire_string_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(hashMap);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        octaspire_string_t *key = octaspire_string_new_format(
+            octaspireContainerHashMapTestAllocator,
+            "key%zu",
+            i);
+
+        ASSERT(key);
+        ASSERT(octaspire_map_put(hashMap, 0, &key, &i));
+    }
+
+    octaspire_string_t *key =
+        octaspire_string_new("key42", octaspireContainerHashMapTestAllocator);
+
+    octaspire_map_element_t const * const element =
+        octaspire_map_get_const(hashMap, 0, &key);
+
+    ASSERT(element);
+    ASSERT_EQ(42, *(size_t const *)octaspire_map_element_get_value_const(element));
+
+    ASSERT_EQ(
+        octaspire_string_get_keyed_hash(key, hashMap->seed),
+        octaspire_map_element_get_hash(element));
+
+    ASSERT(octaspire_map_remove(hashMap, 0, &key));
+    ASSERT_FALSE(octaspire_map_get_const(hashMap, 0, &key));
+    ASSERT_EQ(99, octaspire_map_get_number_of_elements(hashMap));
+
+    octaspire_string_release(key);
+    key = 0;
+
+    octaspire_map_release(hashMap);
+    hashMap = 0;
+
+    PASS();
+}
+
+TEST octaspire_map_set_seed_test(void)
+{
+    octaspire_map_t *first = octaspire_map_new_with_untrusted_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    octaspire_map_t *second = octaspire_map_new_with_untrusted_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(first && second);
+
+    // Every map gets its own seed.
+    ASSERT(memcmp(first->seed, second->seed, OCTASPIRE_MAP_SEED_LENGTH_IN_OCTETS) != 0);
+
+    uint8_t seed[OCTASPIRE_MAP_SEED_LENGTH_IN_OCTETS];
+
+    for (size_t i = 0; i < sizeof(seed); ++i)
+    {
+        seed[i] = (uint8_t)(i * 7);
+    }
+
+    ASSERT(octaspire_map_set_seed(first,  seed));
+    ASSERT(octaspire_map_set_seed(second, seed));
+    ASSERT_MEM_EQ(seed, first->seed, sizeof(seed));
+
+    size_t const key = 5;
+    ASSERT(octaspire_map_put(first,  0, &key, &key));
+    ASSERT(octaspire_map_put(second, 0, &key, &key));
+
+    ASSERT_EQ(
+        octaspire_map_element_get_hash(octaspire_map_get(first,  0, &key)),
+        octaspire_map_element_get_hash(octaspire_map_get(second, 0, &key)));
+
+    // Not allowed once the map has elements, or for trusted maps.
+    ASSERT_FALSE(octaspire_map_set_seed(first, seed));
+
+    octaspire_map_t *trusted = octaspire_map_new_with_size_t_keys(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireContainerHashMapTestAllocator);
+
+    ASSERT(trusted);
+    ASSERT_FALSE(octaspire_map_set_seed(trusted, seed));
+
+    octaspire_map_release(trusted);
+    trusted = 0;
+
+    octaspire_map_release(second);
+    second = 0;
+
+    octaspire_map_release(first);
+    first = 0;
+
+    PASS();
+}
+
 GREATEST_SUITE(octaspire_map_suite)
 {
     octaspireContainerHashMapTestAllocator = octaspire_allocator_new(0);
@@ -750,6 +1294,13 @@ GREATEST_SUITE(octaspire_map_suite)
 
     RUN_TEST(octaspire_map_get_at_index_test);
     RUN_TEST(octaspire_map_is_empty_test);
+    RUN_TEST(octaspire_map_new_with_untrusted_size_t_keys_test);
+    RUN_TEST(octaspire_map_new_with_untrusted_octaspire_string_keys_test);
+    RUN_TEST(octaspire_map_set_seed_test);
+    RUN_TEST(octaspire_map_clear_keeps_buckets_test);
+    RUN_TEST(octaspire_map_clear_with_shrink_test);
+    RUN_TEST(octaspire_map_new_from_arrays_test);
+    RUN_TEST(octaspire_map_new_from_arrays_with_octaspire_string_keys_test);
 
     octaspire_allocator_release(octaspireContainerHashMapTestAllocator);
     octaspireContainerHashMapTestAllocator = 0;
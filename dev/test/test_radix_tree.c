@@ -0,0 +1,708 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_radix_tree.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_radix_tree.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_helpers.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireRadixTreeTestAllocator = 0;
+
+static size_t octaspireRadixTreeTestNumValuesReleased = 0;
+
+static void octaspire_radix_tree_test_value_release_callback(void *value)
+{
+    OCTASPIRE_HELPERS_UNUSED_PARAMETER(value);
+    ++octaspireRadixTreeTestNumValuesReleased;
+}
+
+static bool octaspire_radix_tree_test_put(
+    octaspire_radix_tree_t * const radixTree,
+    char const * const key,
+    size_t const value)
+{
+    octaspire_string_t * const str =
+        octaspire_string_new(key, octaspireRadixTreeTestAllocator);
+
+    bool const result = octaspire_radix_tree_put(radixTree, str, &value);
+    octaspire_string_release(str);
+    return result;
+}
+
+static bool octaspire_radix_tree_test_remove(
+    octaspire_radix_tree_t * const radixTree,
+    char const * const key)
+{
+    octaspire_string_t * const str =
+        octaspire_string_new(key, octaspireRadixTreeTestAllocator);
+
+    bool const result = octaspire_radix_tree_remove(radixTree, str);
+    octaspire_string_release(str);
+    return result;
+}
+
+static size_t const *octaspire_radix_tree_test_get(
+    octaspire_radix_tree_t const * const radixTree,
+    char const * const key)
+{
+    octaspire_string_t * const str =
+        octaspire_string_new(key, octaspireRadixTreeTestAllocator);
+
+    octaspire_radix_tree_node_t const * const node =
+        octaspire_radix_tree_get_const(radixTree, str);
+
+    octaspire_string_release(str);
+
+    return node ? octaspire_radix_tree_node_get_value_const(node) : 0;
+}
+
+static char const *octaspire_radix_tree_test_get_longest_prefix(
+    octaspire_radix_tree_t const * const radixTree,
+    char const * const key)
+{
+    octaspire_string_t * const str =
+        octaspire_string_new(key, octaspireRadixTreeTestAllocator);
+
+    octaspire_radix_tree_node_t const * const node =
+        octaspire_radix_tree_get_longest_prefix_const(radixTree, str);
+
+    octaspire_string_release(str);
+
+    return node ? octaspire_radix_tree_node_get_key_const(node) : 0;
+}
+
+// Checks that inner nodes are compact and in the right size class, and
+// that leaves are reachable with their own keys. Returns the number of
+// elements in the subtree, or SIZE_MAX if the subtree is not valid.
+static size_t octaspire_radix_tree_test_validate_node(
+    octaspire_radix_tree_node_t const * const node,
+    char * const path,
+    size_t const depth)
+{
+    if (node->kind == OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF)
+    {
+        return (node->numOctets >= depth && memcmp(node->octets, path, depth) == 0) ?
+            1 : SIZE_MAX;
+    }
+
+    if (node->numChildren + (node->leaf ? 1 : 0) < 2)
+    {
+        return SIZE_MAX;
+    }
+
+    if (node->kind != OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4 &&
+        node->numChildren <= 3)
+    {
+        return SIZE_MAX;
+    }
+
+    if (node->numOctets)
+    {
+        memcpy(path + depth, node->octets, node->numOctets);
+    }
+
+    size_t const childDepth = depth + node->numOctets;
+    size_t       result     = 0;
+
+    if (node->leaf)
+    {
+        if (node->leaf->numOctets != childDepth ||
+            memcmp(node->leaf->octets, path, childDepth) != 0)
+        {
+            return SIZE_MAX;
+        }
+
+        ++result;
+    }
+
+    uint8_t octet = 0;
+    size_t  next  = 0;
+    size_t  numChildren = 0;
+
+    octaspire_radix_tree_node_t const *child = 0;
+
+    while ((child = octaspire_radix_tree_private_find_child_from(node, next, &octet)))
+    {
+        path[childDepth] = (char)octet;
+
+        size_t const numChildElements =
+            octaspire_radix_tree_test_validate_node(child, path, childDepth + 1);
+
+        if (numChildElements == SIZE_MAX)
+        {
+            return SIZE_MAX;
+        }
+
+        result += numChildElements;
+        next = (size_t)octet + 1;
+        ++numChildren;
+    }
+
+    return (numChildren == node->numChildren) ? result : SIZE_MAX;
+}
+
+static bool octaspire_radix_tree_test_is_valid(
+    octaspire_radix_tree_t const * const radixTree)
+{
+    if (!radixTree->root)
+    {
+        return radixTree->numElements == 0;
+    }
+
+    char path[256];
+
+    return octaspire_radix_tree_test_validate_node(radixTree->root, path, 0) ==
+        radixTree->numElements;
+}
+
+TEST octaspire_radix_tree_new_test(void)
+{
+    octaspire_radix_tree_t *radixTree = octaspire_radix_tree_new(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireRadixTreeTestAllocator);
+
+    ASSERT(radixTree);
+    ASSERT(octaspire_radix_tree_is_empty(radixTree));
+    ASSERT_EQ(0, octaspire_radix_tree_get_number_of_elements(radixTree));
+    ASSERT_FALSE(octaspire_radix_tree_test_get(radixTree, "a"));
+    ASSERT_FALSE(octaspire_radix_tree_test_get_longest_prefix(radixTree, "a"));
+    ASSERT_FALSE(octaspire_radix_tree_test_remove(radixTree, "a"));
+
+    octaspire_radix_tree_element_const_iterator_t iter =
+        octaspire_radix_tree_element_const_iterator_init(radixTree);
+
+    ASSERT_FALSE(iter.element);
+
+    octaspire_radix_tree_release(radixTree);
+    radixTree = 0;
+
+    PASS();
+}
+
+TEST octaspire_radix_tree_new_allocation_failure_on_first_allocation_test(void)
+{
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireRadixTreeTestAllocator,
+        1,
+        0);
+
+    octaspire_radix_tree_t *radixTree = octaspire_radix_tree_new(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireRadixTreeTestAllocator);
+
+    ASSERT_FALSE(radixTree);
+
+    ASSERT_EQ(
+        0,
+        octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+            octaspireRadixTreeTestAllocator));
+
+    PASS();
+}
+
+TEST octaspire_radix_tree_put_and_get_test(void)
+{
+    octaspire_radix_tree_t *radixTree = octaspire_radix_tree_new(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireRadixTreeTestAllocator);
+
+    ASSERT(radixTree);
+
+    char const * const keys[] =
+    {
+        "romane", "romanus", "romulus", "rubens", "ruber", "rubicon",
+        "rubicundus", "rom", "r", "", "rubicundusx", "ab", "a"
+    };
+
+    size_t const numKeys = sizeof(keys) / sizeof(keys[0]);
+
+    for (size_t i = 0; i < numKeys; ++i)
+    {
+        ASSERT(octaspire_radix_tree_test_put(radixTree, keys[i], i));
+        ASSERT_EQ(i + 1, octaspire_radix_tree_get_number_of_elements(radixTree));
+        ASSERT(octaspire_radix_tree_test_is_valid(radixTree));
+    }
+
+    for (size_t i = 0; i < numKeys; ++i)
+    {
+        size_t const * const value = octaspire_radix_tree_test_get(radixTree, keys[i]);
+        ASSERT(value);
+        ASSERT_EQ(i, *value);
+    }
+
+    ASSERT_FALSE(octaspire_radix_tree_test_get(radixTree, "ro"));
+    ASSERT_FALSE(octaspire_radix_tree_test_get(radixTree, "roman"));
+    ASSERT_FALSE(octaspire_radix_tree_test_get(radixTree, "romanes"));
+    ASSERT_FALSE(octaspire_radix_tree_test_get(radixTree, "b"));
+
+    // Replacing value
+    ASSERT(octaspire_radix_tree_test_put(radixTree, "rom", 100));
+    ASSERT_EQ(numKeys, octaspire_radix_tree_get_number_of_elements(radixTree));
+    ASSERT_EQ(100, *octaspire_radix_tree_test_get(radixTree, "rom"));
+
+    octaspire_radix_tree_release(radixTree);
+    radixTree = 0;
+
+    PASS();
+}
+
+TEST octaspire_radix_tree_node_kinds_grow_and_shrink_test(void)
+{
+    octaspire_radix_tree_t *radixTree = octaspire_radix_tree_new(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireRadixTreeTestAllocator);
+
+    ASSERT(radixTree);
+
+    char key[] = {'k', 'x', '\0'};
+
+    // Keys stay in the ASCII range to be valid UTF-8
+    for (size_t i = 1; i < 128; ++i)
+    {
+        key[1] = (char)i;
+        ASSERT(octaspire_radix_tree_test_put(radixTree, key, i));
+        ASSERT(octaspire_radix_tree_test_is_valid(radixTree));
+
+        if (i == 1)
+        {
+            ASSERT_EQ(OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF, radixTree->root->kind);
+        }
+        else if (i <= 4)
+        {
+            ASSERT_EQ(OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_4, radixTree->root->kind);
+        }
+        else if (i <= 16)
+        {
+            ASSERT_EQ(OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_16, radixTree->root->kind);
+        }
+        else if (i <= 48)
+        {
+            ASSERT_EQ(OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_48, radixTree->root->kind);
+        }
+        else
+        {
+            ASSERT_EQ(OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_256, radixTree->root->kind);
+        }
+    }
+
+    for (size_t i = 1; i < 128; ++i)
+    {
+        key[1] = (char)i;
+        ASSERT_EQ(i, *octaspire_radix_tree_test_get(radixTree, key));
+    }
+
+    for (size_t i = 127; i > 1; --i)
+    {
+        key[1] = (char)i;
+        ASSERT(octaspire_radix_tree_test_remove(radixTree, key));
+        ASSERT_FALSE(octaspire_radix_tree_test_get(radixTree, key));
+        ASSERT(octaspire_radix_tree_test_is_valid(radixTree));
+    }
+
+    // Last remaining leaf replaces its parent
+    ASSERT_EQ(OCTASPIRE_RADIX_TREE_PRIVATE_NODE_KIND_LEAF, radixTree->root->kind);
+
+    key[1] = 1;
+    ASSERT(octaspire_radix_tree_test_remove(radixTree, key));
+    ASSERT(octaspire_radix_tree_is_empty(radixTree));
+    ASSERT_FALSE(radixTree->root);
+
+    octaspire_radix_tree_release(radixTree);
+    radixTree = 0;
+
+    PASS();
+}
+
+TEST octaspire_radix_tree_remove_test(void)
+{
+    octaspireRadixTreeTestNumValuesReleased = 0;
+
+    octaspire_radix_tree_t *radixTree = octaspire_radix_tree_new(
+        sizeof(size_t),
+        false,
+        octaspire_radix_tree_test_value_release_callback,
+        octaspireRadixTreeTestAllocator);
+
+    ASSERT(radixTree);
+
+    char const * const keys[] =
+    {
+        "", "a", "ab", "abc", "abcd", "abd", "b", "ba", "bab", "babe"
+    };
+
+    size_t const numKeys = sizeof(keys) / sizeof(keys[0]);
+
+    for (size_t i = 0; i < numKeys; ++i)
+    {
+        ASSERT(octaspire_radix_tree_test_put(radixTree, keys[i], i));
+    }
+
+    ASSERT_FALSE(octaspire_radix_tree_test_remove(radixTree, "abce"));
+    ASSERT_FALSE(octaspire_radix_tree_test_remove(radixTree, "bb"));
+    ASSERT_FALSE(octaspire_radix_tree_test_remove(radixTree, "ba "));
+    ASSERT_EQ(0, octaspireRadixTreeTestNumValuesReleased);
+
+    for (size_t i = 0; i < numKeys; ++i)
+    {
+        size_t const index = (i * 7) % numKeys;
+
+        ASSERT(octaspire_radix_tree_test_remove(radixTree, keys[index]));
+        ASSERT_FALSE(octaspire_radix_tree_test_remove(radixTree, keys[index]));
+        ASSERT_FALSE(octaspire_radix_tree_test_get(radixTree, keys[index]));
+        ASSERT(octaspire_radix_tree_test_is_valid(radixTree));
+        ASSERT_EQ(i + 1, octaspireRadixTreeTestNumValuesReleased);
+
+        for (size_t j = i + 1; j < numKeys; ++j)
+        {
+            size_t const other = (j * 7) % numKeys;
+            ASSERT_EQ(other, *octaspire_radix_tree_test_get(radixTree, keys[other]));
+        }
+    }
+
+    ASSERT(octaspire_radix_tree_is_empty(radixTree));
+
+    octaspire_radix_tree_release(radixTree);
+    radixTree = 0;
+
+    PASS();
+}
+
+TEST octaspire_radix_tree_get_longest_prefix_const_test(void)
+{
+    octaspire_radix_tree_t *radixTree = octaspire_radix_tree_new(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireRadixTreeTestAllocator);
+
+    ASSERT(radixTree);
+
+    ASSERT(octaspire_radix_tree_test_put(radixTree, "core", 0));
+    ASSERT(octaspire_radix_tree_test_put(radixTree, "core.string", 1));
+    ASSERT(octaspire_radix_tree_test_put(radixTree, "core.string.view", 2));
+    ASSERT(octaspire_radix_tree_test_put(radixTree, "core.map", 3));
+
+    ASSERT_STR_EQ(
+        "core.string",
+        octaspire_radix_tree_test_get_longest_prefix(radixTree, "core.string.builder"));
+
+    ASSERT_STR_EQ(
+        "core.string.view",
+        octaspire_radix_tree_test_get_longest_prefix(radixTree, "core.string.view"));
+
+    ASSERT_STR_EQ(
+        "core",
+        octaspire_radix_tree_test_get_longest_prefix(radixTree, "core.vector"));
+
+    ASSERT_STR_EQ(
+        "core.map",
+        octaspire_radix_tree_test_get_longest_prefix(radixTree, "core.mapping"));
+
+    ASSERT_FALSE(octaspire_radix_tree_test_get_longest_prefix(radixTree, "cor"));
+    ASSERT_FALSE(octaspire_radix_tree_test_get_longest_prefix(radixTree, "lisp"));
+
+    ASSERT(octaspire_radix_tree_test_put(radixTree, "", 4));
+
+    ASSERT_STR_EQ("", octaspire_radix_tree_test_get_longest_prefix(radixTree, "lisp"));
+
+    octaspire_radix_tree_release(radixTree);
+    radixTree = 0;
+
+    PASS();
+}
+
+TEST octaspire_radix_tree_element_const_iterator_with_prefix_test(void)
+{
+    octaspire_radix_tree_t *radixTree = octaspire_radix_tree_new(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireRadixTreeTestAllocator);
+
+    ASSERT(radixTree);
+
+    char const * const keys[] =
+    {
+        "octaspire_string_new", "octaspire_string_release", "octaspire_map_new",
+        "octaspire_map_put", "octaspire_string_new_format", "octaspire_string",
+        "octaspire_vector_new", "octopus", "äiti", "äidinkieli", "öljy"
+    };
+
+    for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); ++i)
+    {
+        ASSERT(octaspire_radix_tree_test_put(radixTree, keys[i], i));
+    }
+
+    char const * const expected[] =
+    {
+        "octaspire_string", "octaspire_string_new", "octaspire_string_new_format",
+        "octaspire_string_release"
+    };
+
+    octaspire_string_t *prefix =
+        octaspire_string_new("octaspire_string", octaspireRadixTreeTestAllocator);
+
+    size_t index = 0;
+
+    for (octaspire_radix_tree_element_const_iterator_t iter =
+            octaspire_radix_tree_element_const_iterator_init_with_prefix(radixTree, prefix);
+         iter.element;
+         octaspire_radix_tree_element_const_iterator_next(&iter))
+    {
+        ASSERT(index < 4);
+
+        ASSERT_STR_EQ(
+            expected[index],
+            octaspire_radix_tree_node_get_key_const(iter.element));
+
+        ++index;
+    }
+
+    ASSERT_EQ(4, index);
+
+    octaspire_string_release(prefix);
+    prefix = octaspire_string_new("ä", octaspireRadixTreeTestAllocator);
+
+    octaspire_radix_tree_element_const_iterator_t iter =
+        octaspire_radix_tree_element_const_iterator_init_with_prefix(radixTree, prefix);
+
+    ASSERT_STR_EQ("äidinkieli", octaspire_radix_tree_node_get_key_const(iter.element));
+    ASSERT(octaspire_radix_tree_element_const_iterator_next(&iter));
+    ASSERT_STR_EQ("äiti", octaspire_radix_tree_node_get_key_const(iter.element));
+    ASSERT_FALSE(octaspire_radix_tree_element_const_iterator_next(&iter));
+    ASSERT_FALSE(iter.element);
+
+    octaspire_string_release(prefix);
+    prefix = octaspire_string_new("octaspire_z", octaspireRadixTreeTestAllocator);
+
+    iter = octaspire_radix_tree_element_const_iterator_init_with_prefix(radixTree, prefix);
+    ASSERT_FALSE(iter.element);
+
+    octaspire_string_release(prefix);
+    prefix = 0;
+
+    octaspire_radix_tree_release(radixTree);
+    radixTree = 0;
+
+    PASS();
+}
+
+// All strings of length 0 to 5 over "abc", in lexicographic order
+static size_t octaspire_radix_tree_test_generate_keys(
+    char keys[][6],
+    size_t numKeys,
+    char * const current,
+    size_t const length)
+{
+    current[length] = '\0';
+    memcpy(keys[numKeys], current, 6);
+    ++numKeys;
+
+    if (length == 5)
+    {
+        return numKeys;
+    }
+
+    for (char c = 'a'; c <= 'c'; ++c)
+    {
+        current[length] = c;
+        numKeys = octaspire_radix_tree_test_generate_keys(keys, numKeys, current, length + 1);
+    }
+
+    return numKeys;
+}
+
+TEST octaspire_radix_tree_random_operations_test(void)
+{
+    static char keys[364][6];
+    bool isPresent[364] = {false};
+    char current[6];
+
+    size_t const numKeys = octaspire_radix_tree_test_generate_keys(keys, 0, current, 0);
+    ASSERT_EQ(364, numKeys);
+
+    octaspire_radix_tree_t *radixTree = octaspire_radix_tree_new(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireRadixTreeTestAllocator);
+
+    ASSERT(radixTree);
+
+    uint32_t random = 12345;
+    size_t numPresent = 0;
+
+    for (size_t round = 0; round < 4000; ++round)
+    {
+        random = (random * 1103515245) + 12345;
+        size_t const index = (random >> 8) % numKeys;
+
+        // Mostly insert during the first half, mostly remove after it
+        bool const insert = ((random >> 4) % 4) < ((round < 2000) ? 3u : 1u);
+
+        if (insert)
+        {
+            ASSERT(octaspire_radix_tree_test_put(radixTree, keys[index], index));
+            numPresent += isPresent[index] ? 0 : 1;
+            isPresent[index] = true;
+        }
+        else
+        {
+            ASSERT_EQ(
+                isPresent[index],
+                octaspire_radix_tree_test_remove(radixTree, keys[index]));
+
+            numPresent -= isPresent[index] ? 1 : 0;
+            isPresent[index] = false;
+        }
+
+        ASSERT_EQ(numPresent, octaspire_radix_tree_get_number_of_elements(radixTree));
+
+        if (round % 100 == 0)
+        {
+            ASSERT(octaspire_radix_tree_test_is_valid(radixTree));
+
+            size_t expected = 0;
+
+            for (octaspire_radix_tree_element_const_iterator_t iter =
+                    octaspire_radix_tree_element_const_iterator_init(radixTree);
+                 iter.element;
+                 octaspire_radix_tree_element_const_iterator_next(&iter))
+            {
+                while (!isPresent[expected])
+                {
+                    ++expected;
+                }
+
+                ASSERT_STR_EQ(
+                    keys[expected],
+                    octaspire_radix_tree_node_get_key_const(iter.element));
+
+                ASSERT_EQ(
+                    expected,
+                    *(size_t const *)octaspire_radix_tree_node_get_value_const(iter.element));
+
+                ++expected;
+            }
+
+            while (expected < numKeys)
+            {
+                ASSERT_FALSE(isPresent[expected]);
+                ++expected;
+            }
+        }
+    }
+
+    octaspire_radix_tree_release(radixTree);
+    radixTree = 0;
+
+    PASS();
+}
+
+TEST octaspire_radix_tree_put_allocation_failure_test(void)
+{
+    octaspire_radix_tree_t *radixTree = octaspire_radix_tree_new(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireRadixTreeTestAllocator);
+
+    ASSERT(radixTree);
+
+    ASSERT(octaspire_radix_tree_test_put(radixTree, "abcdef", 0));
+    ASSERT(octaspire_radix_tree_test_put(radixTree, "abcxyz", 1));
+
+    octaspire_string_t *keys[] =
+    {
+        octaspire_string_new("abcdeg", octaspireRadixTreeTestAllocator),
+        octaspire_string_new("abq",    octaspireRadixTreeTestAllocator),
+        octaspire_string_new("abc",    octaspireRadixTreeTestAllocator),
+        octaspire_string_new("abcz",   octaspireRadixTreeTestAllocator)
+    };
+
+    for (size_t k = 0; k < 4; ++k)
+    {
+        ASSERT(octaspire_string_get_c_string(keys[k]));
+
+        // Fail each of the (at most three) allocations of put in turn.
+        for (size_t i = 0; i < 3; ++i)
+        {
+            octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+                octaspireRadixTreeTestAllocator,
+                i + 1,
+                ~((uint32_t)1 << i));
+
+            size_t const value = 100;
+            bool const result = octaspire_radix_tree_put(radixTree, keys[k], &value);
+
+            octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+                octaspireRadixTreeTestAllocator,
+                0,
+                0);
+
+            if (result)
+            {
+                ASSERT(octaspire_radix_tree_remove(radixTree, keys[k]));
+            }
+
+            ASSERT_EQ(2, octaspire_radix_tree_get_number_of_elements(radixTree));
+            ASSERT(octaspire_radix_tree_test_is_valid(radixTree));
+            ASSERT_EQ(0, *octaspire_radix_tree_test_get(radixTree, "abcdef"));
+            ASSERT_EQ(1, *octaspire_radix_tree_test_get(radixTree, "abcxyz"));
+        }
+
+        octaspire_string_release(keys[k]);
+        keys[k] = 0;
+    }
+
+    octaspire_radix_tree_release(radixTree);
+    radixTree = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_radix_tree_suite)
+{
+    octaspireRadixTreeTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireRadixTreeTestAllocator);
+
+    RUN_TEST(octaspire_radix_tree_new_test);
+    RUN_TEST(octaspire_radix_tree_new_allocation_failure_on_first_allocation_test);
+    RUN_TEST(octaspire_radix_tree_put_and_get_test);
+    RUN_TEST(octaspire_radix_tree_node_kinds_grow_and_shrink_test);
+    RUN_TEST(octaspire_radix_tree_remove_test);
+    RUN_TEST(octaspire_radix_tree_get_longest_prefix_const_test);
+    RUN_TEST(octaspire_radix_tree_element_const_iterator_with_prefix_test);
+    RUN_TEST(octaspire_radix_tree_random_operations_test);
+    RUN_TEST(octaspire_radix_tree_put_allocation_failure_test);
+
+    octaspire_allocator_release(octaspireRadixTreeTestAllocator);
+    octaspireRadixTreeTestAllocator = 0;
+}
+
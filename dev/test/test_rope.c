@@ -0,0 +1,316 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_rope.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_rope.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireRopeTestAllocator = 0;
+
+TEST octaspire_rope_new_test(void)
+{
+    octaspire_rope_t *rope = octaspire_rope_new(octaspireRopeTestAllocator);
+
+    ASSERT(rope);
+    ASSERT(octaspire_rope_is_empty(rope));
+    ASSERT_EQ(0, octaspire_rope_get_length_in_ucs_characters(rope));
+    ASSERT_EQ(0, octaspire_rope_get_length_in_octets(rope));
+    ASSERT_EQ(1, octaspire_rope_get_number_of_lines(rope));
+    ASSERT_EQ(0, octaspire_rope_get_ucs_index_of_line(rope, 0));
+    ASSERT_EQ(0, octaspire_rope_get_line_of_ucs_index(rope, 0));
+
+    octaspire_string_t *str = octaspire_rope_to_string(rope, octaspireRopeTestAllocator);
+    ASSERT(str);
+    ASSERT_STR_EQ("", octaspire_string_get_c_string(str));
+
+    octaspire_string_release(str);
+    str = 0;
+
+    octaspire_rope_release(rope);
+    rope = 0;
+
+    PASS();
+}
+
+TEST octaspire_rope_insert_and_remove_test(void)
+{
+    octaspire_rope_t *rope = octaspire_rope_new(octaspireRopeTestAllocator);
+    ASSERT(rope);
+
+    ASSERT(octaspire_rope_insert_c_string_at(rope, 0, "Hello world"));
+    ASSERT(octaspire_rope_insert_c_string_at(rope, 5, ", \xC3\xA4\xE2\x82\xAC"));
+    ASSERT(octaspire_rope_insert_c_string_at(rope, 15, "!"));
+
+    ASSERT_EQ(16, octaspire_rope_get_length_in_ucs_characters(rope));
+    ASSERT_EQ(0xE4,   octaspire_rope_get_ucs_character_at_index(rope, 7));
+    ASSERT_EQ(0x20AC, octaspire_rope_get_ucs_character_at_index(rope, 8));
+    ASSERT_EQ('w',    octaspire_rope_get_ucs_character_at_index(rope, 10));
+
+    ASSERT(octaspire_rope_remove_ucs_characters_at(rope, 5, 4));
+
+    octaspire_string_t *str = octaspire_rope_to_string(rope, octaspireRopeTestAllocator);
+    ASSERT(str);
+    ASSERT_STR_EQ("Hello world!", octaspire_string_get_c_string(str));
+
+    octaspire_string_release(str);
+    str = 0;
+
+    // Invalid indices and invalid UTF-8 leave the rope unchanged
+    ASSERT_FALSE(octaspire_rope_insert_c_string_at(rope, 13, "x"));
+    ASSERT_FALSE(octaspire_rope_insert_c_string_at(rope, 0, "\xC3"));
+    ASSERT_FALSE(octaspire_rope_remove_ucs_characters_at(rope, 10, 3));
+    ASSERT_EQ(12, octaspire_rope_get_length_in_ucs_characters(rope));
+
+    ASSERT(octaspire_rope_remove_ucs_characters_at(rope, 0, 12));
+    ASSERT(octaspire_rope_is_empty(rope));
+
+    octaspire_rope_release(rope);
+    rope = 0;
+
+    PASS();
+}
+
+TEST octaspire_rope_lines_test(void)
+{
+    octaspire_rope_t *rope = octaspire_rope_new(octaspireRopeTestAllocator);
+    ASSERT(rope);
+
+    ASSERT(octaspire_rope_insert_c_string_at(rope, 0, "first\n\xC3\xA4\n\nlast"));
+
+    ASSERT_EQ(4, octaspire_rope_get_number_of_lines(rope));
+    ASSERT_EQ(0,  octaspire_rope_get_ucs_index_of_line(rope, 0));
+    ASSERT_EQ(6,  octaspire_rope_get_ucs_index_of_line(rope, 1));
+    ASSERT_EQ(8,  octaspire_rope_get_ucs_index_of_line(rope, 2));
+    ASSERT_EQ(9,  octaspire_rope_get_ucs_index_of_line(rope, 3));
+
+    ASSERT_EQ(0, octaspire_rope_get_line_of_ucs_index(rope, 0));
+    ASSERT_EQ(0, octaspire_rope_get_line_of_ucs_index(rope, 5));
+    ASSERT_EQ(1, octaspire_rope_get_line_of_ucs_index(rope, 6));
+    ASSERT_EQ(1, octaspire_rope_get_line_of_ucs_index(rope, 7));
+    ASSERT_EQ(2, octaspire_rope_get_line_of_ucs_index(rope, 8));
+    ASSERT_EQ(3, octaspire_rope_get_line_of_ucs_index(rope, 13));
+
+    octaspire_rope_release(rope);
+    rope = 0;
+
+    PASS();
+}
+
+TEST octaspire_rope_new_from_large_string_test(void)
+{
+    octaspire_string_t *str = octaspire_string_new("", octaspireRopeTestAllocator);
+    ASSERT(str);
+
+    size_t const numLines = 2000;
+
+    for (size_t i = 0; i < numLines; ++i)
+    {
+        ASSERT(octaspire_string_concatenate_format(str, "line %zu \xE2\x82\xAC\n", i));
+    }
+
+    octaspire_rope_t *rope = octaspire_rope_new_from_string(str, octaspireRopeTestAllocator);
+    ASSERT(rope);
+
+    ASSERT_EQ(
+        octaspire_string_get_length_in_ucs_characters(str),
+        octaspire_rope_get_length_in_ucs_characters(rope));
+
+    ASSERT_EQ(
+        octaspire_string_get_length_in_octets(str),
+        octaspire_rope_get_length_in_octets(rope));
+
+    ASSERT_EQ(numLines + 1, octaspire_rope_get_number_of_lines(rope));
+
+    size_t const line = 1234;
+    size_t const index = octaspire_rope_get_ucs_index_of_line(rope, line);
+
+    ASSERT_EQ('l',  octaspire_rope_get_ucs_character_at_index(rope, index));
+    ASSERT_EQ('\n', octaspire_rope_get_ucs_character_at_index(rope, index - 1));
+    ASSERT_EQ('4',  octaspire_rope_get_ucs_character_at_index(rope, index + 8));
+    ASSERT_EQ(line, octaspire_rope_get_line_of_ucs_index(rope, index));
+
+    octaspire_string_t *copy = octaspire_rope_to_string(rope, octaspireRopeTestAllocator);
+    ASSERT(copy);
+    ASSERT(octaspire_string_is_equal(str, copy));
+
+    octaspire_string_release(copy);
+    copy = 0;
+
+    octaspire_rope_release(rope);
+    rope = 0;
+
+    octaspire_string_release(str);
+    str = 0;
+
+    PASS();
+}
+
+TEST octaspire_rope_random_edits_test(void)
+{
+    // Pieces of text and their UCS characters
+    char const * const pieces[] = { "a", "bc\n", "\xC3\xA4", "\xE2\x82\xAC\xE2\x82\xAC\n", "" };
+    uint32_t const piecesAsUcs[][3] = { { 'a' }, { 'b', 'c', '\n' }, { 0xE4 }, { 0x20AC, 0x20AC, '\n' }, { 0 } };
+    size_t const pieceLengths[] = { 1, 3, 1, 3, 0 };
+
+    size_t const maxLength = 20000;
+
+    uint32_t *expected = octaspire_allocator_malloc(
+        octaspireRopeTestAllocator,
+        maxLength * sizeof(uint32_t));
+
+    ASSERT(expected);
+
+    octaspire_rope_t *rope = octaspire_rope_new(octaspireRopeTestAllocator);
+    ASSERT(rope);
+
+    size_t length = 0;
+    uint32_t random = 12345;
+
+    for (size_t round = 0; round < 20000; ++round)
+    {
+        random = random * 1103515245u + 12345u;
+
+        size_t const piece = (random >> 8) % 5;
+        size_t const index = length ? (random >> 12) % (length + 1) : 0;
+
+        if (length + 3 <= maxLength && (random >> 4) % 3)
+        {
+            ASSERT(octaspire_rope_insert_c_string_at(rope, index, pieces[piece]));
+
+            memmove(
+                expected + index + pieceLengths[piece],
+                expected + index,
+                (length - index) * sizeof(uint32_t));
+
+            memcpy(expected + index, piecesAsUcs[piece], pieceLengths[piece] * sizeof(uint32_t));
+            length += pieceLengths[piece];
+        }
+        else
+        {
+            // Sometimes remove long ranges that span many chunks
+            size_t numToRemove = (random >> 20) % ((round % 500) ? 4 : 700);
+
+            if (numToRemove > length - index)
+            {
+                numToRemove = length - index;
+            }
+
+            ASSERT(octaspire_rope_remove_ucs_characters_at(rope, index, numToRemove));
+
+            memmove(
+                expected + index,
+                expected + index + numToRemove,
+                (length - index - numToRemove) * sizeof(uint32_t));
+
+            length -= numToRemove;
+        }
+
+        ASSERT_EQ(length, octaspire_rope_get_length_in_ucs_characters(rope));
+    }
+
+    size_t numNewlines = 0;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        ASSERT_EQ(expected[i], octaspire_rope_get_ucs_character_at_index(rope, i));
+
+        if (expected[i] == '\n')
+        {
+            ++numNewlines;
+            ASSERT_EQ(i + 1, octaspire_rope_get_ucs_index_of_line(rope, numNewlines));
+        }
+
+        ASSERT_EQ(numNewlines, octaspire_rope_get_line_of_ucs_index(rope, i + 1));
+    }
+
+    ASSERT_EQ(numNewlines + 1, octaspire_rope_get_number_of_lines(rope));
+
+    octaspire_string_t *str = octaspire_rope_to_string(rope, octaspireRopeTestAllocator);
+    ASSERT(str);
+    ASSERT_EQ(length, octaspire_string_get_length_in_ucs_characters(str));
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        ASSERT_EQ(expected[i], octaspire_string_get_ucs_character_at_index(str, (ptrdiff_t)i));
+    }
+
+    octaspire_string_release(str);
+    str = 0;
+
+    octaspire_rope_release(rope);
+    rope = 0;
+
+    octaspire_allocator_free(octaspireRopeTestAllocator, expected);
+    expected = 0;
+
+    PASS();
+}
+
+TEST octaspire_rope_allocation_failure_test(void)
+{
+    octaspire_rope_t *rope = octaspire_rope_new(octaspireRopeTestAllocator);
+    ASSERT(rope);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        ASSERT(octaspire_rope_insert_c_string_at(rope, 0, "0123456789"));
+    }
+
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireRopeTestAllocator,
+        1,
+        0x00);
+
+    // Removing a range that spans chunks needs to split a chunk
+    ASSERT_FALSE(octaspire_rope_remove_ucs_characters_at(rope, 5, 600));
+    ASSERT_EQ(1000, octaspire_rope_get_length_in_ucs_characters(rope));
+
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireRopeTestAllocator,
+        0,
+        0x00);
+
+    ASSERT(octaspire_rope_remove_ucs_characters_at(rope, 5, 600));
+    ASSERT_EQ(400, octaspire_rope_get_length_in_ucs_characters(rope));
+    ASSERT_EQ('5', octaspire_rope_get_ucs_character_at_index(rope, 5));
+
+    octaspire_rope_release(rope);
+    rope = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_rope_suite)
+{
+    octaspireRopeTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireRopeTestAllocator);
+
+    RUN_TEST(octaspire_rope_new_test);
+    RUN_TEST(octaspire_rope_insert_and_remove_test);
+    RUN_TEST(octaspire_rope_lines_test);
+    RUN_TEST(octaspire_rope_new_from_large_string_test);
+    RUN_TEST(octaspire_rope_random_edits_test);
+    RUN_TEST(octaspire_rope_allocation_failure_test);
+
+    octaspire_allocator_release(octaspireRopeTestAllocator);
+    octaspireRopeTestAllocator = 0;
+}
+
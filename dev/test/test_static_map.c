@@ -0,0 +1,393 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_static_map.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_static_map.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_vector.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireStaticMapTestAllocator = 0;
+
+TEST octaspire_static_map_new_test(void)
+{
+    size_t const numElements = 5000;
+
+    octaspire_vector_t *keys = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireStaticMapTestAllocator);
+
+    octaspire_vector_t *values = octaspire_vector_new(
+        sizeof(size_t),
+        false,
+        0,
+        octaspireStaticMapTestAllocator);
+
+    ASSERT(keys && values);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        octaspire_string_t *key = octaspire_string_new_format(
+            octaspireStaticMapTestAllocator,
+            "key%zu",
+            i);
+
+        ASSERT(key);
+        ASSERT(octaspire_vector_push_back_element(keys, &key));
+
+        size_t const value = i * 7;
+        ASSERT(octaspire_vector_push_back_element(values, &value));
+    }
+
+    octaspire_static_map_t *staticMap =
+        octaspire_static_map_new(keys, values, octaspireStaticMapTestAllocator);
+
+    ASSERT(staticMap);
+    ASSERT_EQ(numElements, octaspire_static_map_get_number_of_elements(staticMap));
+
+    // Every key has its own index and there are no empty slots
+    bool *isUsed = octaspire_allocator_malloc(
+        octaspireStaticMapTestAllocator,
+        numElements * sizeof(bool));
+
+    ASSERT(isUsed);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        octaspire_string_t const * const key =
+            octaspire_vector_get_element_at_const(keys, (ptrdiff_t)i);
+
+        ptrdiff_t const index = octaspire_static_map_get_index(staticMap, key);
+
+        ASSERT(index >= 0 && (size_t)index < numElements);
+        ASSERT_FALSE(isUsed[index]);
+        isUsed[index] = true;
+
+        size_t const * const value =
+            octaspire_static_map_get_value_const(staticMap, key);
+
+        ASSERT(value);
+        ASSERT_EQ(i * 7, *value);
+    }
+
+    octaspire_allocator_free(octaspireStaticMapTestAllocator, isUsed);
+    isUsed = 0;
+
+    octaspire_string_t *missing =
+        octaspire_string_new("key5000", octaspireStaticMapTestAllocator);
+
+    ASSERT(missing);
+    ASSERT_EQ(-1, octaspire_static_map_get_index(staticMap, missing));
+    ASSERT_FALSE(octaspire_static_map_get_value_const(staticMap, missing));
+
+    octaspire_string_release(missing);
+    missing = 0;
+
+    octaspire_static_map_release(staticMap);
+    staticMap = 0;
+
+    octaspire_vector_release(values);
+    values = 0;
+
+    octaspire_vector_release(keys);
+    keys = 0;
+
+    PASS();
+}
+
+TEST octaspire_static_map_new_without_values_test(void)
+{
+    char const * const words[] = { "if", "else", "while", "for", "", "return" };
+    size_t const numWords = sizeof(words) / sizeof(words[0]);
+
+    octaspire_vector_t *keys = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireStaticMapTestAllocator);
+
+    ASSERT(keys);
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        octaspire_string_t *key =
+            octaspire_string_new(words[i], octaspireStaticMapTestAllocator);
+
+        ASSERT(key);
+        ASSERT(octaspire_vector_push_back_element(keys, &key));
+    }
+
+    octaspire_static_map_t *staticMap =
+        octaspire_static_map_new(keys, 0, octaspireStaticMapTestAllocator);
+
+    ASSERT(staticMap);
+
+    octaspire_static_map_tables_t const * const tables =
+        octaspire_static_map_get_tables(staticMap);
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        ptrdiff_t const index =
+            octaspire_static_map_tables_get_index(tables, words[i], strlen(words[i]));
+
+        ASSERT(index >= 0);
+        ASSERT_STR_EQ(words[i], tables->keys[index]);
+        ASSERT_FALSE(octaspire_static_map_tables_get_value_const(
+            tables,
+            words[i],
+            strlen(words[i])));
+    }
+
+    ASSERT_EQ(-1, octaspire_static_map_tables_get_index(tables, "els", 3));
+    ASSERT_EQ(-1, octaspire_static_map_tables_get_index(tables, "else\0", 5));
+
+    octaspire_static_map_release(staticMap);
+    staticMap = 0;
+
+    octaspire_vector_release(keys);
+    keys = 0;
+
+    PASS();
+}
+
+TEST octaspire_static_map_new_fails_on_duplicate_keys_test(void)
+{
+    char const * const words[] = { "a", "b", "c", "b" };
+    size_t const numWords = sizeof(words) / sizeof(words[0]);
+
+    octaspire_vector_t *keys = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireStaticMapTestAllocator);
+
+    ASSERT(keys);
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        octaspire_string_t *key =
+            octaspire_string_new(words[i], octaspireStaticMapTestAllocator);
+
+        ASSERT(key);
+        ASSERT(octaspire_vector_push_back_element(keys, &key));
+    }
+
+    ASSERT_FALSE(octaspire_static_map_new(keys, 0, octaspireStaticMapTestAllocator));
+
+    octaspire_vector_release(keys);
+    keys = 0;
+
+    PASS();
+}
+
+TEST octaspire_static_map_new_empty_test(void)
+{
+    octaspire_vector_t *keys = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireStaticMapTestAllocator);
+
+    ASSERT(keys);
+
+    octaspire_static_map_t *staticMap =
+        octaspire_static_map_new(keys, 0, octaspireStaticMapTestAllocator);
+
+    ASSERT(staticMap);
+    ASSERT_EQ(0, octaspire_static_map_get_number_of_elements(staticMap));
+
+    ASSERT_EQ(
+        -1,
+        octaspire_static_map_tables_get_index(
+            octaspire_static_map_get_tables(staticMap),
+            "a",
+            1));
+
+    octaspire_string_t *source = octaspire_static_map_to_c_source(
+        staticMap,
+        "empty",
+        octaspireStaticMapTestAllocator);
+
+    ASSERT(source);
+
+    ASSERT(strstr(
+        octaspire_string_get_c_string(source),
+        "    empty_pilots,\n    0,\n    0,\n    0\n};\n"));
+
+    octaspire_string_release(source);
+    source = 0;
+
+    octaspire_static_map_release(staticMap);
+    staticMap = 0;
+
+    octaspire_vector_release(keys);
+    keys = 0;
+
+    PASS();
+}
+
+// Emitted by octaspire_static_map_to_c_source for the keys and values
+// of octaspire_static_map_to_c_source_test.
+static uint8_t const keywords_seed[16] =
+{
+    0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static uint32_t const keywords_pilots[2] =
+{
+    3, 11,
+};
+
+static char const * const keywords_keys[5] =
+{
+    "else",
+    "for",
+    "ret\042urn\011",
+    "if",
+    "while",
+};
+
+static size_t const keywords_key_lengths[5] =
+{
+    4, 3, 8, 2, 5,
+};
+
+static uint8_t const keywords_values[5] =
+{
+    101, 102, 114, 105, 119,
+};
+
+static octaspire_static_map_tables_t const keywords =
+{
+    5,
+    2,
+    1,
+    keywords_seed,
+    keywords_pilots,
+    keywords_keys,
+    keywords_key_lengths,
+    keywords_values
+};
+
+TEST octaspire_static_map_to_c_source_test(void)
+{
+    char const * const words[] = { "if", "else", "while", "for", "ret\"urn\t" };
+    size_t const numWords = sizeof(words) / sizeof(words[0]);
+
+    octaspire_vector_t *keys = octaspire_vector_new(
+        sizeof(octaspire_string_t*),
+        true,
+        (octaspire_vector_element_callback_t)octaspire_string_release,
+        octaspireStaticMapTestAllocator);
+
+    ASSERT(keys);
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        octaspire_string_t *key =
+            octaspire_string_new(words[i], octaspireStaticMapTestAllocator);
+
+        ASSERT(key);
+        ASSERT(octaspire_vector_push_back_element(keys, &key));
+    }
+
+    octaspire_vector_t *values =
+        octaspire_vector_new(sizeof(char), false, 0, octaspireStaticMapTestAllocator);
+
+    ASSERT(values);
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        ASSERT(octaspire_vector_push_back_char(values, words[i][0]));
+    }
+
+    octaspire_static_map_t *staticMap =
+        octaspire_static_map_new(keys, values, octaspireStaticMapTestAllocator);
+
+    ASSERT(staticMap);
+
+    octaspire_string_t *source = octaspire_static_map_to_c_source(
+        staticMap,
+        "keywords",
+        octaspireStaticMapTestAllocator);
+
+    ASSERT(source);
+
+    char const * const text = octaspire_string_get_c_string(source);
+
+    ASSERT(strstr(text, "static uint32_t const keywords_pilots[2] =\n{\n"));
+    ASSERT(strstr(text, "    \"ret\\042urn\\011\",\n"));
+    ASSERT(strstr(text, "static octaspire_static_map_tables_t const keywords =\n{\n"));
+
+    // The same keys always give the same tables, so the ones emitted
+    // earlier and compiled into this test still work.
+    octaspire_static_map_tables_t const * const tables =
+        octaspire_static_map_get_tables(staticMap);
+
+    ASSERT_EQ(keywords.numBuckets, tables->numBuckets);
+    ASSERT_MEM_EQ(keywords_seed, tables->seed, sizeof(keywords_seed));
+    ASSERT_MEM_EQ(keywords_pilots, tables->pilots, sizeof(keywords_pilots));
+
+    for (size_t i = 0; i < numWords; ++i)
+    {
+        char const * const value = octaspire_static_map_tables_get_value_const(
+            &keywords,
+            words[i],
+            strlen(words[i]));
+
+        ASSERT(value);
+        ASSERT_EQ(words[i][0], *value);
+    }
+
+    ASSERT_FALSE(octaspire_static_map_tables_get_value_const(&keywords, "do", 2));
+
+    octaspire_string_release(source);
+    source = 0;
+
+    octaspire_static_map_release(staticMap);
+    staticMap = 0;
+
+    octaspire_vector_release(values);
+    values = 0;
+
+    octaspire_vector_release(keys);
+    keys = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_static_map_suite)
+{
+    octaspireStaticMapTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireStaticMapTestAllocator);
+
+    RUN_TEST(octaspire_static_map_new_test);
+    RUN_TEST(octaspire_static_map_new_without_values_test);
+    RUN_TEST(octaspire_static_map_new_fails_on_duplicate_keys_test);
+    RUN_TEST(octaspire_static_map_new_empty_test);
+    RUN_TEST(octaspire_static_map_to_c_source_test);
+
+    octaspire_allocator_release(octaspireStaticMapTestAllocator);
+    octaspireStaticMapTestAllocator = 0;
+}
+
@@ -193,6 +193,71 @@ TEST octaspire_string_new_from_buffer_with_some_multioctet_ucs_characters_test(v
     PASS();
 }
 
+TEST octaspire_string_new_from_buffer_with_long_multioctet_input_test(void)
+{
+    // Characters of every length fall on the borders of decoding blocks
+    char buffer[2048];
+
+    for (size_t offset = 0; offset < 4; ++offset)
+    {
+        size_t length = 0;
+
+        for (size_t i = 0; i < offset; ++i)
+        {
+            buffer[length++] = 'a';
+        }
+
+        for (size_t i = 0; i < 100; ++i)
+        {
+            memcpy(buffer + length, "\xC3\xA4" "\xE2\x82\xAC" "\xF0\x9F\x98\x80" "b", 10);
+            length += 10;
+        }
+
+        octaspire_string_t *str = octaspire_string_new_from_buffer(
+            buffer,
+            length,
+            octaspireContainerUtf8StringTestAllocator);
+
+        ASSERT(str);
+        ASSERT_FALSE(octaspire_string_is_error(str));
+        ASSERT_EQ(offset + 400, octaspire_string_get_length_in_ucs_characters(str));
+
+        for (size_t i = 0; i < 100; ++i)
+        {
+            ptrdiff_t const index = (ptrdiff_t)(offset + i * 4);
+
+            ASSERT_EQ(0xE4,    octaspire_string_get_ucs_character_at_index(str, index));
+            ASSERT_EQ(0x20AC,  octaspire_string_get_ucs_character_at_index(str, index + 1));
+            ASSERT_EQ(0x1F600, octaspire_string_get_ucs_character_at_index(str, index + 2));
+            ASSERT_EQ('b',     octaspire_string_get_ucs_character_at_index(str, index + 3));
+        }
+
+        ASSERT_EQ(length, octaspire_string_get_length_in_octets(str));
+        ASSERT_MEM_EQ(buffer, octaspire_string_get_c_string(str), length);
+
+        octaspire_string_release(str);
+        str = 0;
+
+        // Decoding stops at the first illegal octet
+        buffer[length - 3] = (char)0xFF;
+
+        str = octaspire_string_new_from_buffer(
+            buffer,
+            length,
+            octaspireContainerUtf8StringTestAllocator);
+
+        ASSERT(str);
+        ASSERT(octaspire_string_is_error(str));
+        ASSERT_EQ(length - 5, octaspire_string_get_error_position_in_octets(str));
+        ASSERT_EQ(offset + 398, octaspire_string_get_length_in_ucs_characters(str));
+
+        octaspire_string_release(str);
+        str = 0;
+    }
+
+    PASS();
+}
+
 TEST octaspire_string_new_from_buffer_allocation_failure_on_first_allocation_test(void)
 {
 #ifdef _MSC_VER
@@ -271,7 +336,7 @@ TEST octaspire_string_new_from_buffer_allocation_failure_on_third_allocation_tes
     PASS();
 }
 
-TEST octaspire_string_new_from_buffer_allocation_failure_on_sixth_2_allocation_test(void)
+TEST octaspire_string_new_from_buffer_does_not_allocate_while_decoding_test(void)
 {
 #ifdef _MSC_VER
     char const * const input = u8"©Hello World! © ≠𐀀How are you?";
@@ -281,15 +346,20 @@ TEST octaspire_string_new_from_buffer_allocation_failure_on_sixth_2_allocation_t
 
     size_t const       lengthInOctets      = strlen(input);
 
+    // The five allocations of the string and its vectors are all;
+    // the vector of characters is allocated large enough at once.
     octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(octaspireContainerUtf8StringTestAllocator, 6, 0x1F);
     ASSERT_EQ(6, octaspire_allocator_get_number_of_future_allocations_to_be_rigged(octaspireContainerUtf8StringTestAllocator));
 
     octaspire_string_t *str =
         octaspire_string_new_from_buffer(input, lengthInOctets, octaspireContainerUtf8StringTestAllocator);
 
+    ASSERT_EQ(1, octaspire_allocator_get_number_of_future_allocations_to_be_rigged(octaspireContainerUtf8StringTestAllocator));
+
     octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(octaspireContainerUtf8StringTestAllocator, 0, 0x00);
 
-    ASSERT_FALSE(str);
+    ASSERT(str);
+    ASSERT_EQ(30, octaspire_string_get_length_in_ucs_characters(str));
 
     octaspire_string_release(str);
     str = 0;
@@ -503,6 +573,115 @@ TEST octaspire_string_new_format_with_empty_format_string_test(void)
     PASS();
 }
 
+TEST octaspire_string_new_format_longer_than_stack_buffer_test(void)
+{
+    octaspire_string_t *expected =
+        octaspire_string_new("", octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(expected);
+
+    char text[1001];
+
+    for (size_t i = 0; i < 1000; i += 2)
+    {
+        // 'ä' in UTF-8
+        text[i]     = (char)0xC3;
+        text[i + 1] = (char)0xA4;
+        ASSERT(octaspire_string_push_back_ucs_character(expected, 0xE4));
+    }
+
+    text[1000] = '\0';
+
+    ASSERT(octaspire_string_concatenate_c_string(expected, "|12345"));
+
+    octaspire_string_t *str = octaspire_string_new_format(
+        octaspireContainerUtf8StringTestAllocator,
+        "%s|%d",
+        text,
+        12345);
+
+    ASSERT(str);
+    ASSERT_FALSE(octaspire_string_is_error(str));
+    ASSERT_EQ(1006, octaspire_string_get_length_in_octets(str));
+    ASSERT_EQ(506,  octaspire_string_get_length_in_ucs_characters(str));
+    ASSERT(octaspire_string_is_equal(expected, str));
+
+    octaspire_string_release(str);
+    str = 0;
+
+    octaspire_string_release(expected);
+    expected = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_new_format_with_invalid_utf8_test(void)
+{
+    octaspire_string_t *str = octaspire_string_new_format(
+        octaspireContainerUtf8StringTestAllocator,
+        "%s%s",
+        "ab",
+        "\xFF" "cd");
+
+    ASSERT(str);
+    ASSERT(octaspire_string_is_error(str));
+    ASSERT_EQ(OCTASPIRE_STRING_ERROR_STATUS_DECODING_ERROR, str->errorStatus);
+    ASSERT_EQ(2, octaspire_string_get_error_position_in_octets(str));
+    ASSERT_STR_EQ("ab", octaspire_string_get_c_string(str));
+
+    octaspire_string_release(str);
+    str = 0;
+
+    PASS();
+}
+
+static bool octaspire_string_test_concatenate_vformat(
+    octaspire_string_t * const self,
+    char const * const fmt,
+    ...)
+{
+    va_list arguments;
+    va_start(arguments, fmt);
+
+    bool const result = octaspire_string_concatenate_vformat(self, fmt, arguments);
+
+    va_end(arguments);
+
+    return result;
+}
+
+TEST octaspire_string_concatenate_vformat_test(void)
+{
+    octaspire_string_t *str =
+        octaspire_string_new("abc\xE2\x82\xAC", octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(str);
+
+    // Fills the octet cache, that must not be used after the concatenation
+    ASSERT_STR_EQ("abc\xE2\x82\xAC", octaspire_string_get_c_string(str));
+
+    ASSERT(octaspire_string_test_concatenate_vformat(str, "%s-%zu", "\xC2\xA9", (size_t)42));
+
+    ASSERT_FALSE(octaspire_string_is_error(str));
+    ASSERT_EQ(8, octaspire_string_get_length_in_ucs_characters(str));
+    ASSERT_EQ(0x20AC, octaspire_string_get_ucs_character_at_index(str, 3));
+    ASSERT_EQ(0xA9,   octaspire_string_get_ucs_character_at_index(str, 4));
+    ASSERT_STR_EQ("abc\xE2\x82\xAC\xC2\xA9-42", octaspire_string_get_c_string(str));
+
+    ASSERT(octaspire_string_test_concatenate_vformat(str, "%s", ""));
+    ASSERT_STR_EQ("abc\xE2\x82\xAC\xC2\xA9-42", octaspire_string_get_c_string(str));
+
+    ASSERT(octaspire_string_test_concatenate_vformat(str, "%0300d", 7));
+    ASSERT_EQ(308, octaspire_string_get_length_in_ucs_characters(str));
+    ASSERT_EQ('0', octaspire_string_get_ucs_character_at_index(str, 8));
+    ASSERT_EQ('7', octaspire_string_get_ucs_character_at_index(str, 307));
+
+    octaspire_string_release(str);
+    str = 0;
+
+    PASS();
+}
+
 TEST octaspire_string_new_copy_test(void)
 {
     char const * const input = "©Hello World! © ≠𐀀How are you?";
@@ -794,6 +973,67 @@ TEST octaspire_string_get_c_string_called_with_empty_string_test(void)
     PASS();
 }
 
+TEST octaspire_string_encode_to_buffer_test(void)
+{
+    octaspire_string_t *str = octaspire_string_new(
+        "a\xC3\xA4\xE2\x82\xAC" "b",
+        octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(str);
+
+    char buffer[16];
+    size_t lengthInOctets = 0;
+
+    ASSERT(octaspire_string_encode_to_buffer(str, buffer, sizeof(buffer), &lengthInOctets));
+    ASSERT_EQ(7, lengthInOctets);
+    ASSERT_STR_EQ("a\xC3\xA4\xE2\x82\xAC" "b", buffer);
+
+    // The euro sign does not fit
+    ASSERT(octaspire_string_encode_to_buffer(str, buffer, 6, &lengthInOctets));
+    ASSERT_EQ(7, lengthInOctets);
+    ASSERT_STR_EQ("a\xC3\xA4", buffer);
+
+    ASSERT(octaspire_string_encode_to_buffer(str, 0, 0, &lengthInOctets));
+    ASSERT_EQ(7, lengthInOctets);
+
+    ASSERT(octaspire_string_push_back_ucs_character(str, 0xD800));
+    ASSERT_FALSE(octaspire_string_encode_to_buffer(str, buffer, sizeof(buffer), &lengthInOctets));
+
+    octaspire_string_release(str);
+    str = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_get_c_string_of_long_string_test(void)
+{
+    // Longer than one encoding block
+    octaspire_string_t *str =
+        octaspire_string_new("", octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(str);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT(octaspire_string_push_back_ucs_character(str, (i % 2) ? 'x' : 0x20AC));
+    }
+
+    char const * const text = octaspire_string_get_c_string(str);
+
+    ASSERT_EQ(2000, octaspire_string_get_length_in_octets(str));
+    ASSERT_EQ(2000, strlen(text));
+
+    for (size_t i = 0; i < 1000; i += 2)
+    {
+        ASSERT_MEM_EQ("\xE2\x82\xAC" "x", text + i * 2, 4);
+    }
+
+    octaspire_string_release(str);
+    str = 0;
+
+    PASS();
+}
+
 TEST octaspire_string_is_error_false_case_test(void)
 {
     char const * const input    = "Hello World";
@@ -2484,6 +2724,126 @@ TEST octaspire_string_compare_with_string_abc_and_abca_test(void)
     PASS();
 }
 
+TEST octaspire_string_compare_with_embedded_zero_characters_test(void)
+{
+    // "a\0b", "a\0c" and "a"; strcmp would see all of them as "a"
+    octaspire_string_t *str1 =
+        octaspire_string_new("a", octaspireContainerUtf8StringTestAllocator);
+
+    octaspire_string_t *str2 =
+        octaspire_string_new("a", octaspireContainerUtf8StringTestAllocator);
+
+    octaspire_string_t *str3 =
+        octaspire_string_new("a", octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(str1 && str2 && str3);
+
+    ASSERT(octaspire_string_push_back_ucs_character(str1, 0));
+    ASSERT(octaspire_string_push_back_ucs_character(str1, 'b'));
+    ASSERT(octaspire_string_push_back_ucs_character(str2, 0));
+    ASSERT(octaspire_string_push_back_ucs_character(str2, 'c'));
+
+    for (size_t round = 0; round < 2; ++round)
+    {
+        // The second round compares the UTF-8 encodings
+        ASSERT(octaspire_string_compare(str1, str2) < 0);
+        ASSERT(octaspire_string_compare(str2, str1) > 0);
+        ASSERT(octaspire_string_compare(str3, str1) < 0);
+        ASSERT(octaspire_string_compare(str1, str3) > 0);
+        ASSERT_EQ(0, octaspire_string_compare(str1, str1));
+
+        ASSERT_FALSE(octaspire_string_is_equal(str1, str2));
+        ASSERT_FALSE(octaspire_string_is_equal(str1, str3));
+
+        octaspire_string_get_c_string(str1);
+        octaspire_string_get_c_string(str2);
+        octaspire_string_get_c_string(str3);
+    }
+
+    octaspire_string_release(str1);
+    str1 = 0;
+
+    octaspire_string_release(str2);
+    str2 = 0;
+
+    octaspire_string_release(str3);
+    str3 = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_compare_and_is_equal_random_test(void)
+{
+    uint32_t const alphabet[] = { 0, 'a', 'b', 0x7F, 0x80, 0xE4, 0xFFFF, 0x10000, 0x1F600 };
+    size_t const alphabetLength = sizeof(alphabet) / sizeof(alphabet[0]);
+    uint32_t seed = 5;
+
+    for (size_t round = 0; round < 1000; ++round)
+    {
+        octaspire_string_t *strings[2] = { 0, 0 };
+
+        for (size_t k = 0; k < 2; ++k)
+        {
+            strings[k] = octaspire_string_new("", octaspireContainerUtf8StringTestAllocator);
+            ASSERT(strings[k]);
+
+            seed = seed * 1103515245u + 12345u;
+            size_t const length = (seed >> 16) % 4;
+
+            for (size_t i = 0; i < length; ++i)
+            {
+                seed = seed * 1103515245u + 12345u;
+
+                ASSERT(octaspire_string_push_back_ucs_character(
+                    strings[k],
+                    alphabet[(seed >> 16) % alphabetLength]));
+            }
+        }
+
+        size_t const len1 = octaspire_string_get_length_in_ucs_characters(strings[0]);
+        size_t const len2 = octaspire_string_get_length_in_ucs_characters(strings[1]);
+
+        int expected = (len1 < len2) ? -1 : ((len1 > len2) ? 1 : 0);
+
+        for (size_t i = 0; i < len1 && i < len2; ++i)
+        {
+            uint32_t const c1 =
+                octaspire_string_get_ucs_character_at_index(strings[0], (ptrdiff_t)i);
+
+            uint32_t const c2 =
+                octaspire_string_get_ucs_character_at_index(strings[1], (ptrdiff_t)i);
+
+            if (c1 != c2)
+            {
+                expected = (c1 < c2) ? -1 : 1;
+                break;
+            }
+        }
+
+        // Without, with one and with both UTF-8 encodings at hand
+        for (size_t k = 0; k < 3; ++k)
+        {
+            int const result = octaspire_string_compare(strings[0], strings[1]);
+
+            ASSERT_EQ(expected, (result > 0) - (result < 0));
+            ASSERT_EQ(expected == 0, octaspire_string_is_equal(strings[0], strings[1]));
+
+            if (k < 2)
+            {
+                octaspire_string_get_c_string(strings[k]);
+            }
+        }
+
+        octaspire_string_release(strings[0]);
+        strings[0] = 0;
+
+        octaspire_string_release(strings[1]);
+        strings[1] = 0;
+    }
+
+    PASS();
+}
+
 TEST octaspire_string_levenshtein_distance_called_with_abc_and_empty_string_test(void)
 {
     octaspire_string_t *str1 =
@@ -2784,6 +3144,152 @@ TEST octaspire_string_levenshtein_distance_called_with_two_longer_strings_test(v
     PASS();
 }
 
+static size_t octaspire_string_test_naive_levenshtein_distance(
+    octaspire_string_t const * const a,
+    octaspire_string_t const * const b)
+{
+    size_t const n = octaspire_string_get_length_in_ucs_characters(a);
+    size_t const m = octaspire_string_get_length_in_ucs_characters(b);
+
+    size_t * const matrix = octaspire_allocator_malloc(
+        octaspireContainerUtf8StringTestAllocator,
+        (n + 1) * (m + 1) * sizeof(size_t));
+
+    assert(matrix);
+
+    for (size_t i = 0; i <= n; ++i)
+    {
+        for (size_t j = 0; j <= m; ++j)
+        {
+            size_t value = i + j;
+
+            if (i && j)
+            {
+                size_t const cost =
+                    (octaspire_string_get_ucs_character_at_index(a, (ptrdiff_t)(i - 1)) ==
+                     octaspire_string_get_ucs_character_at_index(b, (ptrdiff_t)(j - 1)))
+                    ? 0 : 1;
+
+                value = matrix[(i - 1) * (m + 1) + (j - 1)] + cost;
+                value = octaspire_helpers_min_size_t(value, matrix[(i - 1) * (m + 1) + j] + 1);
+                value = octaspire_helpers_min_size_t(value, matrix[i * (m + 1) + (j - 1)] + 1);
+            }
+
+            matrix[i * (m + 1) + j] = value;
+        }
+    }
+
+    size_t const result = matrix[n * (m + 1) + m];
+
+    octaspire_allocator_free(octaspireContainerUtf8StringTestAllocator, matrix);
+
+    return result;
+}
+
+TEST octaspire_string_levenshtein_distance_random_test(void)
+{
+    // Lengths on both sides of 64 exercise both algorithms
+    uint32_t const alphabet[] = { 'a', 'b', 'c', 0xE4, 0x20AC, 0x1F600 };
+    uint32_t seed = 3;
+
+    for (size_t round = 0; round < 300; ++round)
+    {
+        octaspire_string_t *strings[2] = { 0, 0 };
+
+        seed = seed * 1103515245u + 12345u;
+        size_t const baseLength = (seed >> 16) % 150;
+
+        for (size_t k = 0; k < 2; ++k)
+        {
+            strings[k] = octaspire_string_new("", octaspireContainerUtf8StringTestAllocator);
+            ASSERT(strings[k]);
+
+            seed = seed * 1103515245u + 12345u;
+            size_t const length = baseLength + (seed >> 16) % 5;
+
+            for (size_t i = 0; i < length; ++i)
+            {
+                seed = seed * 1103515245u + 12345u;
+
+                ASSERT(octaspire_string_push_back_ucs_character(
+                    strings[k],
+                    alphabet[(seed >> 16) % (2 + round % 5)]));
+            }
+        }
+
+        size_t const expected =
+            octaspire_string_test_naive_levenshtein_distance(strings[0], strings[1]);
+
+        ASSERT_EQ(expected, octaspire_string_levenshtein_distance(strings[0], strings[1]));
+        ASSERT_EQ(expected, octaspire_string_levenshtein_distance(strings[1], strings[0]));
+
+        size_t const bounds[] = { 0, 1, 2, 5, expected, expected + 1, SIZE_MAX };
+
+        for (size_t b = 0; b < sizeof(bounds) / sizeof(bounds[0]); ++b)
+        {
+            size_t const bound = bounds[b];
+
+            size_t const bounded = (expected <= bound) ? expected : (bound + 1);
+
+            ASSERT_EQ(
+                bounded,
+                octaspire_string_levenshtein_distance_bounded(
+                    strings[0],
+                    strings[1],
+                    bound));
+
+            ASSERT_EQ(
+                bounded,
+                octaspire_string_levenshtein_distance_bounded(
+                    strings[1],
+                    strings[0],
+                    bound));
+        }
+
+        octaspire_string_release(strings[0]);
+        strings[0] = 0;
+
+        octaspire_string_release(strings[1]);
+        strings[1] = 0;
+    }
+
+    PASS();
+}
+
+TEST octaspire_string_levenshtein_distance_bounded_test(void)
+{
+    octaspire_string_t *kitten =
+        octaspire_string_new("kitten", octaspireContainerUtf8StringTestAllocator);
+
+    octaspire_string_t *sitting =
+        octaspire_string_new("sitting", octaspireContainerUtf8StringTestAllocator);
+
+    octaspire_string_t *empty =
+        octaspire_string_new("", octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(kitten && sitting && empty);
+
+    ASSERT_EQ(1, octaspire_string_levenshtein_distance_bounded(kitten, sitting, 0));
+    ASSERT_EQ(3, octaspire_string_levenshtein_distance_bounded(kitten, sitting, 2));
+    ASSERT_EQ(3, octaspire_string_levenshtein_distance_bounded(kitten, sitting, 3));
+    ASSERT_EQ(3, octaspire_string_levenshtein_distance_bounded(kitten, sitting, 100));
+    ASSERT_EQ(0, octaspire_string_levenshtein_distance_bounded(kitten, kitten, 0));
+    ASSERT_EQ(3, octaspire_string_levenshtein_distance_bounded(empty, kitten, 2));
+    ASSERT_EQ(6, octaspire_string_levenshtein_distance_bounded(empty, kitten, 6));
+    ASSERT_EQ(0, octaspire_string_levenshtein_distance_bounded(empty, empty, 0));
+
+    octaspire_string_release(empty);
+    empty = 0;
+
+    octaspire_string_release(sitting);
+    sitting = 0;
+
+    octaspire_string_release(kitten);
+    kitten = 0;
+
+    PASS();
+}
+
 TEST octaspire_string_starts_with_c_string_test(void)
 {
     octaspire_string_t *str =
@@ -2935,7 +3441,8 @@ TEST octaspire_string_set_from_c_string_allocation_failure_on_first_allocation_t
         octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
             octaspireContainerUtf8StringTestAllocator));
 
-    ASSERT_FALSE(octaspire_string_set_from_c_string(str, "xy"));
+    // Longer than "abc", so that the vector of characters must grow
+    ASSERT_FALSE(octaspire_string_set_from_c_string(str, "wxyz"));
 
     octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(octaspireContainerUtf8StringTestAllocator, 0, 0x00);
 
@@ -2945,6 +3452,454 @@ TEST octaspire_string_set_from_c_string_allocation_failure_on_first_allocation_t
     PASS();
 }
 
+TEST octaspire_string_find_with_multioctet_characters_test(void)
+{
+    octaspire_string_t *str = octaspire_string_new(
+        "\xC3\xA4\xC3\xA4x\xE2\x82\xAC\xC3\xA4\xC3\xA4\xC3\xA4",
+        octaspireContainerUtf8StringTestAllocator);
+
+    octaspire_string_t *substring = octaspire_string_new(
+        "\xC3\xA4\xC3\xA4",
+        octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(str && substring);
+
+    ASSERT_EQ(0, octaspire_string_find_first_substring(str, 0, substring));
+    ASSERT_EQ(4, octaspire_string_find_first_substring(str, 1, substring));
+    ASSERT_EQ(5, octaspire_string_find_first_substring(str, 5, substring));
+    ASSERT_EQ(-1, octaspire_string_find_first_substring(str, 6, substring));
+    ASSERT_EQ(4, octaspire_string_find_first_substring(str, -4, substring));
+
+    octaspire_vector_t *indices = octaspire_string_find_string(str, substring, 0, 2);
+
+    ASSERT(indices);
+    ASSERT_EQ(3, octaspire_vector_get_length(indices));
+
+    size_t const expected[] = { 0, 4, 5 };
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(
+            expected[i],
+            *(size_t const *)octaspire_vector_get_element_at_const(indices, (ptrdiff_t)i));
+    }
+
+    octaspire_vector_release(indices);
+    indices = 0;
+
+    // Part of a string can be searched for, too
+    indices = octaspire_string_find_string(str, str, 2, 2);
+
+    ASSERT(indices);
+    ASSERT_EQ(1, octaspire_vector_get_length(indices));
+    ASSERT_EQ(2, *(size_t const *)octaspire_vector_get_element_at_const(indices, 0));
+
+    octaspire_vector_release(indices);
+    indices = 0;
+
+    octaspire_string_release(substring);
+    substring = 0;
+
+    octaspire_string_release(str);
+    str = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_remove_all_substrings_removes_new_occurrences_test(void)
+{
+    octaspire_string_t *str = octaspire_string_new(
+        "aaabbbxab",
+        octaspireContainerUtf8StringTestAllocator);
+
+    octaspire_string_t *substring =
+        octaspire_string_new("ab", octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(str && substring);
+
+    ASSERT_EQ(4, octaspire_string_remove_all_substrings(str, substring));
+    ASSERT_STR_EQ("x", octaspire_string_get_c_string(str));
+
+    ASSERT_EQ(0, octaspire_string_remove_all_substrings(str, substring));
+    ASSERT_STR_EQ("x", octaspire_string_get_c_string(str));
+
+    ASSERT_EQ(1, octaspire_string_remove_all_substrings(str, str));
+    ASSERT(octaspire_string_is_empty(str));
+
+    octaspire_string_release(substring);
+    substring = 0;
+
+    octaspire_string_release(str);
+    str = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_remove_all_substrings_matches_repeated_removal_test(void)
+{
+    // Compare against removing the first occurrence until none are left
+    char const * const substrings[] = { "ab", "aab", "aba", "abab", "b\xC3\xA4" };
+    uint32_t const alphabet[] = { 'a', 'b', 0xE4 };
+    uint32_t seed = 7;
+
+    for (size_t round = 0; round < 500; ++round)
+    {
+        octaspire_string_t *substring = octaspire_string_new(
+            substrings[round % (sizeof(substrings) / sizeof(substrings[0]))],
+            octaspireContainerUtf8StringTestAllocator);
+
+        octaspire_string_t *str =
+            octaspire_string_new("", octaspireContainerUtf8StringTestAllocator);
+
+        ASSERT(substring && str);
+
+        seed = seed * 1103515245u + 12345u;
+        size_t const length = (seed >> 16) % 40;
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+
+            ASSERT(octaspire_string_push_back_ucs_character(
+                str,
+                alphabet[(seed >> 16) % 3]));
+        }
+
+        octaspire_string_t *expected =
+            octaspire_string_new_copy(str, octaspireContainerUtf8StringTestAllocator);
+
+        ASSERT(expected);
+
+        size_t expectedCount = 0;
+
+        while (true)
+        {
+            ptrdiff_t const index =
+                octaspire_string_find_first_substring(expected, 0, substring);
+
+            if (index < 0)
+            {
+                break;
+            }
+
+            ASSERT_EQ(
+                octaspire_string_get_length_in_ucs_characters(substring),
+                octaspire_string_remove_characters_at(
+                    expected,
+                    index,
+                    octaspire_string_get_length_in_ucs_characters(substring)));
+
+            ++expectedCount;
+        }
+
+        ASSERT_EQ(expectedCount, octaspire_string_remove_all_substrings(str, substring));
+        ASSERT(octaspire_string_is_equal(expected, str));
+
+        octaspire_string_release(expected);
+        expected = 0;
+
+        octaspire_string_release(str);
+        str = 0;
+
+        octaspire_string_release(substring);
+        substring = 0;
+    }
+
+    PASS();
+}
+
+TEST octaspire_string_split_test(void)
+{
+    struct
+    {
+        char const *text;
+        char const *delimiter;
+        char const *expected;
+    }
+    const cases[] =
+    {
+        { "a,b,,c,",              ",",        "[a][b][c]"       },
+        { ",,",                   ",",        ""                },
+        { "",                     ",",        ""                },
+        { "one",                  ",",        "[one]"           },
+        { "a, b, c",              ", ",       "[a][b][c]"       },
+        { "\xC3\xA4x\xE2\x82\xACy",  "\xE2\x82\xAC", "[\xC3\xA4x][y]" },
+        { "a\xC3\xA4" "b",         "",         "[a][\xC3\xA4][b]"  },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+        octaspire_string_t *str =
+            octaspire_string_new(cases[i].text, octaspireContainerUtf8StringTestAllocator);
+
+        ASSERT(str);
+
+        octaspire_vector_t *parts = octaspire_string_split(str, cases[i].delimiter);
+
+        ASSERT(parts);
+
+        octaspire_string_t *collected =
+            octaspire_string_new("", octaspireContainerUtf8StringTestAllocator);
+
+        ASSERT(collected);
+
+        for (size_t j = 0; j < octaspire_vector_get_length(parts); ++j)
+        {
+            octaspire_string_t const * const part =
+                octaspire_vector_get_element_at_const(parts, (ptrdiff_t)j);
+
+            ASSERT(octaspire_string_concatenate_format(
+                collected,
+                "[%s]",
+                octaspire_string_get_c_string(part)));
+        }
+
+        ASSERT_STR_EQ(cases[i].expected, octaspire_string_get_c_string(collected));
+
+        octaspire_string_release(collected);
+        collected = 0;
+
+        octaspire_vector_release(parts);
+        parts = 0;
+
+        octaspire_string_release(str);
+        str = 0;
+    }
+
+    PASS();
+}
+
+TEST octaspire_string_builder_append_and_finish_test(void)
+{
+    octaspire_string_builder_t *builder =
+        octaspire_string_builder_new(octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(builder);
+
+    octaspire_string_t *str =
+        octaspire_string_new("str", octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(str);
+
+    ASSERT(octaspire_string_builder_append_c_string(builder, "abc "));
+    ASSERT(octaspire_string_builder_append_buffer(builder, "def", 2));
+    ASSERT(octaspire_string_builder_append_int64(builder, INT64_MIN));
+    ASSERT(octaspire_string_builder_append_uint64(builder, UINT64_MAX));
+    ASSERT(octaspire_string_builder_append_ucs_character(builder, 0x00E4));
+    ASSERT(octaspire_string_builder_append_ucs_character(builder, 0x1F600));
+    ASSERT(octaspire_string_builder_append_format(builder, "<%s|%d>", "x", 12));
+    ASSERT(octaspire_string_builder_append_string(builder, str));
+
+    ASSERT_FALSE(octaspire_string_builder_append_ucs_character(builder, 0x110000));
+
+    char const * const expected =
+        "abc de-922337203685477580818446744073709551615"
+        "\xC3\xA4\xF0\x9F\x98\x80<x|12>str";
+
+    size_t const expectedLength = 4 + 2 + 20 + 20 + 2 + 4 + 6 + 3;
+
+    ASSERT_EQ(
+        expectedLength,
+        octaspire_string_builder_get_length_in_octets(builder));
+
+    octaspire_string_t *result = octaspire_string_builder_finish(builder);
+
+    ASSERT(result);
+    ASSERT_FALSE(octaspire_string_is_error(result));
+    ASSERT_EQ(expectedLength, octaspire_string_get_length_in_octets(result));
+    ASSERT_EQ(expectedLength - 4, octaspire_string_get_length_in_ucs_characters(result));
+    ASSERT_MEM_EQ(expected, octaspire_string_get_c_string(result), expectedLength + 1);
+
+    ASSERT_EQ(
+        0x1F600,
+        octaspire_string_get_ucs_character_at_index(result, 47));
+
+    // The builder is empty and can be used again
+    ASSERT_EQ(0, octaspire_string_builder_get_length_in_octets(builder));
+    ASSERT(octaspire_string_builder_append_c_string(builder, "again"));
+
+    octaspire_string_t *second = octaspire_string_builder_finish(builder);
+
+    ASSERT(second);
+    ASSERT_STR_EQ("again", octaspire_string_get_c_string(second));
+
+    octaspire_string_t *empty = octaspire_string_builder_finish(builder);
+
+    ASSERT(empty);
+    ASSERT(octaspire_string_is_empty(empty));
+    ASSERT_STR_EQ("", octaspire_string_get_c_string(empty));
+
+    octaspire_string_release(empty);
+    empty = 0;
+
+    octaspire_string_release(second);
+    second = 0;
+
+    octaspire_string_release(result);
+    result = 0;
+
+    octaspire_string_release(str);
+    str = 0;
+
+    octaspire_string_builder_release(builder);
+    builder = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_builder_append_long_format_test(void)
+{
+    octaspire_string_builder_t *builder =
+        octaspire_string_builder_new(octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(builder);
+
+    octaspire_string_t *expected =
+        octaspire_string_new("", octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(expected);
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        ASSERT(octaspire_string_builder_append_format(
+            builder,
+            "%zu:%0*d;",
+            i,
+            (int)(i * 7),
+            0));
+
+        ASSERT(octaspire_string_concatenate_format(
+            expected,
+            "%zu:%0*d;",
+            i,
+            (int)(i * 7),
+            0));
+    }
+
+    octaspire_string_t *result = octaspire_string_builder_finish(builder);
+
+    ASSERT(result);
+    ASSERT(octaspire_string_is_equal(expected, result));
+
+    octaspire_string_release(result);
+    result = 0;
+
+    octaspire_string_release(expected);
+    expected = 0;
+
+    octaspire_string_builder_release(builder);
+    builder = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_builder_finish_with_invalid_utf8_test(void)
+{
+    octaspire_string_builder_t *builder =
+        octaspire_string_builder_new(octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(builder);
+
+    ASSERT(octaspire_string_builder_append_buffer(builder, "ab\xFF" "cd", 5));
+
+    octaspire_string_t *result = octaspire_string_builder_finish(builder);
+
+    ASSERT(result);
+    ASSERT(octaspire_string_is_error(result));
+    ASSERT_EQ(2, octaspire_string_get_error_position_in_octets(result));
+    ASSERT_STR_EQ("ab", octaspire_string_get_c_string(result));
+
+    octaspire_string_release(result);
+    result = 0;
+
+    octaspire_string_builder_release(builder);
+    builder = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_builder_finish_does_not_allocate_while_decoding_test(void)
+{
+    octaspire_string_builder_t *builder =
+        octaspire_string_builder_new(octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(builder);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT(octaspire_string_builder_append_c_string(builder, "a"));
+    }
+
+    size_t const numAllocations = 32;
+
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireContainerUtf8StringTestAllocator,
+        numAllocations,
+        0xFFFFFFFF);
+
+    octaspire_string_t *result = octaspire_string_builder_finish(builder);
+
+    size_t const numUsed = numAllocations -
+        octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+            octaspireContainerUtf8StringTestAllocator);
+
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireContainerUtf8StringTestAllocator,
+        0,
+        0x00);
+
+    ASSERT(result);
+    ASSERT_EQ(1000, octaspire_string_get_length_in_ucs_characters(result));
+
+    // The replacement vector, the string and its vector of characters,
+    // which is allocated large enough at once.
+    ASSERT_EQ(5, numUsed);
+
+    octaspire_string_release(result);
+    result = 0;
+
+    octaspire_string_builder_release(builder);
+    builder = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_builder_finish_allocation_failure_test(void)
+{
+    octaspire_string_builder_t *builder =
+        octaspire_string_builder_new(octaspireContainerUtf8StringTestAllocator);
+
+    ASSERT(builder);
+    ASSERT(octaspire_string_builder_append_c_string(builder, "abc"));
+
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireContainerUtf8StringTestAllocator,
+        2,
+        0x01);
+
+    ASSERT_FALSE(octaspire_string_builder_finish(builder));
+
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireContainerUtf8StringTestAllocator,
+        0,
+        0x00);
+
+    ASSERT_EQ(3, octaspire_string_builder_get_length_in_octets(builder));
+
+    octaspire_string_t *result = octaspire_string_builder_finish(builder);
+
+    ASSERT(result);
+    ASSERT_STR_EQ("abc", octaspire_string_get_c_string(result));
+
+    octaspire_string_release(result);
+    result = 0;
+
+    octaspire_string_builder_release(builder);
+    builder = 0;
+
+    PASS();
+}
+
 GREATEST_SUITE(octaspire_string_suite)
 {
     octaspireContainerUtf8StringTestAllocator = octaspire_allocator_new(0);
@@ -2956,19 +3911,23 @@ GREATEST_SUITE(octaspire_string_suite)
     RUN_TEST(octaspire_string_new_with_some_multioctet_ucs_characters_test);
     RUN_TEST(octaspire_string_new_with_simple_ascii_string_with_error_test);
     RUN_TEST(octaspire_string_new_from_buffer_with_some_multioctet_ucs_characters_test);
+    RUN_TEST(octaspire_string_new_from_buffer_with_long_multioctet_input_test);
     RUN_TEST(octaspire_string_new_from_buffer_allocation_failure_on_first_allocation_test);
     RUN_TEST(octaspire_string_new_from_buffer_allocation_failure_on_second_allocation_test);
     RUN_TEST(octaspire_string_new_from_buffer_allocation_failure_on_third_allocation_test);
 
 
 
-    RUN_TEST(octaspire_string_new_from_buffer_allocation_failure_on_sixth_2_allocation_test);
+    RUN_TEST(octaspire_string_new_from_buffer_does_not_allocate_while_decoding_test);
     RUN_TEST(octaspire_string_new_format_with_string_test);
     RUN_TEST(octaspire_string_new_format_with_size_t_test);
     RUN_TEST(octaspire_string_new_format_with_doubles_test);
     RUN_TEST(octaspire_string_new_format_with_string_and_size_t_test);
     RUN_TEST(octaspire_string_new_format_with_string_and_size_t_on_otherwise_empty_format_string_test);
     RUN_TEST(octaspire_string_new_format_with_empty_format_string_test);
+    RUN_TEST(octaspire_string_new_format_longer_than_stack_buffer_test);
+    RUN_TEST(octaspire_string_new_format_with_invalid_utf8_test);
+    RUN_TEST(octaspire_string_concatenate_vformat_test);
     RUN_TEST(octaspire_string_new_copy_test);
     RUN_TEST(octaspire_string_new_copy_failure_test);
     RUN_TEST(octaspire_string_get_length_in_ucs_characters_test);
@@ -2978,6 +3937,8 @@ GREATEST_SUITE(octaspire_string_suite)
     RUN_TEST(octaspire_string_get_ucs_character_at_index_test);
     RUN_TEST(octaspire_string_get_c_string_test);
     RUN_TEST(octaspire_string_get_c_string_called_with_empty_string_test);
+    RUN_TEST(octaspire_string_encode_to_buffer_test);
+    RUN_TEST(octaspire_string_get_c_string_of_long_string_test);
     RUN_TEST(octaspire_string_is_error_false_case_test);
     RUN_TEST(octaspire_string_is_error_true_case_test);
     RUN_TEST(octaspire_string_get_error_position_in_octets_called_when_has_error_test);
@@ -3040,6 +4001,8 @@ GREATEST_SUITE(octaspire_string_suite)
     RUN_TEST(octaspire_string_compare_with_string_abca_and_abc_test);
     RUN_TEST(octaspire_string_compare_with_string_abb_and_abc_test);
     RUN_TEST(octaspire_string_compare_with_string_abc_and_abca_test);
+    RUN_TEST(octaspire_string_compare_with_embedded_zero_characters_test);
+    RUN_TEST(octaspire_string_compare_and_is_equal_random_test);
 
     RUN_TEST(octaspire_string_levenshtein_distance_called_with_abc_and_empty_string_test);
     RUN_TEST(octaspire_string_levenshtein_distance_called_with_two_empty_strings_test);
@@ -3051,6 +4014,8 @@ GREATEST_SUITE(octaspire_string_suite)
     RUN_TEST(octaspire_string_levenshtein_distance_called_with_jfpaasdasd2d_and_askdfsferrr4_test);
     RUN_TEST(octaspire_string_levenshtein_distance_called_with_rosettacode_and_raisethysword_test);
     RUN_TEST(octaspire_string_levenshtein_distance_called_with_two_longer_strings_test);
+    RUN_TEST(octaspire_string_levenshtein_distance_random_test);
+    RUN_TEST(octaspire_string_levenshtein_distance_bounded_test);
 
     RUN_TEST(octaspire_string_starts_with_c_string_test);
     RUN_TEST(octaspire_string_ends_with_c_string_test);
@@ -3060,6 +4025,18 @@ GREATEST_SUITE(octaspire_string_suite)
     RUN_TEST(octaspire_string_set_from_c_string_test);
     RUN_TEST(octaspire_string_set_from_c_string_allocation_failure_on_first_allocation_test);
 
+    RUN_TEST(octaspire_string_find_with_multioctet_characters_test);
+    RUN_TEST(octaspire_string_remove_all_substrings_removes_new_occurrences_test);
+    RUN_TEST(octaspire_string_remove_all_substrings_matches_repeated_removal_test);
+
+    RUN_TEST(octaspire_string_split_test);
+
+    RUN_TEST(octaspire_string_builder_append_and_finish_test);
+    RUN_TEST(octaspire_string_builder_append_long_format_test);
+    RUN_TEST(octaspire_string_builder_finish_with_invalid_utf8_test);
+    RUN_TEST(octaspire_string_builder_finish_does_not_allocate_while_decoding_test);
+    RUN_TEST(octaspire_string_builder_finish_allocation_failure_test);
+
     octaspire_allocator_release(octaspireContainerUtf8StringTestAllocator);
     octaspireContainerUtf8StringTestAllocator = 0;
 }
@@ -0,0 +1,483 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_string_view.c"
+#include <assert.h>
+#include <inttypes.h>
+#include <math.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_string_view.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireStringViewTestAllocator = 0;
+
+TEST octaspire_string_view_init_test(void)
+{
+    char const * const text = "a\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80z";
+
+    octaspire_string_view_t view;
+    octaspire_string_view_init_from_c_string(&view, text);
+
+    ASSERT_EQ(text, octaspire_string_view_get_octets(&view));
+    ASSERT_EQ(11, octaspire_string_view_get_length_in_octets(&view));
+    ASSERT_FALSE(octaspire_string_view_is_empty(&view));
+    ASSERT_EQ(5, octaspire_string_view_get_length_in_ucs_characters(&view));
+    ASSERT_EQ(5, octaspire_string_view_get_length_in_ucs_characters(&view));
+
+    octaspire_string_view_t subview;
+    ASSERT(octaspire_string_view_get_subview(&view, 1, 5, &subview));
+    ASSERT_EQ(text + 1, octaspire_string_view_get_octets(&subview));
+    ASSERT_EQ(2, octaspire_string_view_get_length_in_ucs_characters(&subview));
+
+    ASSERT(octaspire_string_view_get_subview(&view, 11, 0, &subview));
+    ASSERT(octaspire_string_view_is_empty(&subview));
+    ASSERT_FALSE(octaspire_string_view_get_subview(&view, 10, 2, &subview));
+    ASSERT_FALSE(octaspire_string_view_get_subview(&view, 12, 0, &subview));
+
+    octaspire_string_t *str =
+        octaspire_string_new(text, octaspireStringViewTestAllocator);
+
+    ASSERT(str);
+
+    octaspire_string_view_t fromString;
+    octaspire_string_view_init_from_string(&fromString, str);
+
+    ASSERT(octaspire_string_view_is_equal(&view, &fromString));
+    ASSERT(octaspire_string_view_is_equal_to_string(&view, str));
+    ASSERT_EQ(5, octaspire_string_view_get_length_in_ucs_characters(&fromString));
+
+    octaspire_string_t *copy =
+        octaspire_string_view_to_string(&subview, octaspireStringViewTestAllocator);
+
+    ASSERT(copy);
+    ASSERT(octaspire_string_is_empty(copy));
+
+    octaspire_string_release(copy);
+    copy = 0;
+
+    ASSERT(octaspire_string_view_get_subview(&view, 3, 8, &subview));
+
+    copy = octaspire_string_view_to_string(&subview, octaspireStringViewTestAllocator);
+
+    ASSERT(copy);
+    ASSERT_STR_EQ("\xE2\x82\xAC\xF0\x9F\x98\x80z", octaspire_string_get_c_string(copy));
+
+    octaspire_string_release(copy);
+    copy = 0;
+
+    octaspire_string_release(str);
+    str = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_view_compare_and_hash_test(void)
+{
+    octaspire_string_view_t abc;
+    octaspire_string_view_t abcd;
+    octaspire_string_view_t abd;
+    octaspire_string_view_t empty;
+
+    octaspire_string_view_init(&abc, "abcd", 3);
+    octaspire_string_view_init_from_c_string(&abcd, "abcd");
+    octaspire_string_view_init_from_c_string(&abd, "abd");
+    octaspire_string_view_init(&empty, 0, 0);
+
+    ASSERT_EQ(0, octaspire_string_view_compare(&abc, &abc));
+    ASSERT(octaspire_string_view_compare(&abc, &abcd) < 0);
+    ASSERT(octaspire_string_view_compare(&abcd, &abc) > 0);
+    ASSERT(octaspire_string_view_compare(&abcd, &abd) < 0);
+    ASSERT(octaspire_string_view_compare(&empty, &abc) < 0);
+    ASSERT_EQ(0, octaspire_string_view_compare(&empty, &empty));
+
+    ASSERT(octaspire_string_view_is_equal_to_c_string(&abc, "abc"));
+    ASSERT_FALSE(octaspire_string_view_is_equal(&abc, &abcd));
+    ASSERT(octaspire_string_view_is_equal_to_c_string(&empty, ""));
+
+    char const * const texts[] = { "", "abc", "\xC3\xA4iti", "a longer text" };
+    uint8_t const seed[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+
+    for (size_t i = 0; i < sizeof(texts) / sizeof(texts[0]); ++i)
+    {
+        octaspire_string_t *str =
+            octaspire_string_new(texts[i], octaspireStringViewTestAllocator);
+
+        ASSERT(str);
+
+        octaspire_string_view_t view;
+        octaspire_string_view_init_from_c_string(&view, texts[i]);
+
+        ASSERT_EQ(octaspire_string_get_hash(str), octaspire_string_view_get_hash(&view));
+
+        ASSERT_EQ(
+            octaspire_string_get_keyed_hash(str, seed),
+            octaspire_string_view_get_keyed_hash(&view, seed));
+
+        octaspire_string_release(str);
+        str = 0;
+    }
+
+    PASS();
+}
+
+TEST octaspire_string_view_find_test(void)
+{
+    octaspire_string_view_t view;
+    octaspire_string_view_init_from_c_string(&view, "abababcab\xC3\xA4");
+
+    octaspire_string_view_t needle;
+
+    octaspire_string_view_init_from_c_string(&needle, "abc");
+    ASSERT_EQ(4, octaspire_string_view_find(&view, &needle, 0));
+    ASSERT_EQ(4, octaspire_string_view_find(&view, &needle, 4));
+    ASSERT_EQ(-1, octaspire_string_view_find(&view, &needle, 5));
+
+    octaspire_string_view_init_from_c_string(&needle, "ab\xC3\xA4");
+    ASSERT_EQ(7, octaspire_string_view_find(&view, &needle, 0));
+    ASSERT_EQ(-1, octaspire_string_view_find(&view, &needle, 8));
+
+    octaspire_string_view_init_from_c_string(&needle, "");
+    ASSERT_EQ(3, octaspire_string_view_find(&view, &needle, 3));
+    ASSERT_EQ(11, octaspire_string_view_find(&view, &needle, 11));
+    ASSERT_EQ(-1, octaspire_string_view_find(&view, &needle, 12));
+
+    octaspire_string_view_init_from_c_string(&needle, "abababcab\xC3\xA4!");
+    ASSERT_EQ(-1, octaspire_string_view_find(&view, &needle, 0));
+
+    ASSERT_EQ(2, octaspire_string_view_find_octet(&view, 'a', 1));
+    ASSERT_EQ(6, octaspire_string_view_find_octet(&view, 'c', 0));
+    ASSERT_EQ(-1, octaspire_string_view_find_octet(&view, 'c', 7));
+    ASSERT_EQ(-1, octaspire_string_view_find_octet(&view, 'a', 11));
+
+    octaspire_string_view_init_from_c_string(&needle, "abab");
+    ASSERT(octaspire_string_view_starts_with(&view, &needle));
+    ASSERT_FALSE(octaspire_string_view_ends_with(&view, &needle));
+
+    octaspire_string_view_init_from_c_string(&needle, "b\xC3\xA4");
+    ASSERT_FALSE(octaspire_string_view_starts_with(&view, &needle));
+    ASSERT(octaspire_string_view_ends_with(&view, &needle));
+
+    octaspire_string_view_init_from_c_string(&needle, "");
+    ASSERT(octaspire_string_view_starts_with(&view, &needle));
+    ASSERT(octaspire_string_view_ends_with(&view, &needle));
+
+    PASS();
+}
+
+static ptrdiff_t octaspire_string_view_test_naive_find(
+    char const * const haystack,
+    size_t const haystackLength,
+    char const * const needle,
+    size_t const needleLength,
+    size_t const start)
+{
+    for (size_t i = start; i + needleLength <= haystackLength; ++i)
+    {
+        if (memcmp(haystack + i, needle, needleLength) == 0)
+        {
+            return (ptrdiff_t)i;
+        }
+    }
+
+    return -1;
+}
+
+TEST octaspire_string_view_searcher_test(void)
+{
+    // Small alphabets and periodic needles make partial matches common,
+    // which is where the algorithms differ.
+    size_t const needleLengths[] = { 1, 2, 3, 8, 9, 31, 256, 257, 300, 700 };
+    size_t const haystackLength = 4000;
+
+    char *haystack = octaspire_allocator_malloc(
+        octaspireStringViewTestAllocator,
+        haystackLength);
+
+    char *needle = octaspire_allocator_malloc(octaspireStringViewTestAllocator, 700);
+
+    ASSERT(haystack && needle);
+
+    uint32_t seed = 12345;
+
+    for (size_t round = 0; round < 200; ++round)
+    {
+        size_t const numLetters = 2 + round % 3;
+
+        for (size_t i = 0; i < haystackLength; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            haystack[i] = (char)('a' + (seed >> 16) % numLetters);
+        }
+
+        size_t const needleLength =
+            needleLengths[round % (sizeof(needleLengths) / sizeof(needleLengths[0]))];
+
+        seed = seed * 1103515245u + 12345u;
+
+        if ((seed >> 16) % 2)
+        {
+            // Copy the needle from the haystack, so that it is found
+            size_t const from = (seed >> 8) % (haystackLength - needleLength);
+            memcpy(needle, haystack + from, needleLength);
+        }
+        else
+        {
+            // Periodic needle with a different last octet
+            size_t const period = 1 + (seed >> 8) % 3;
+
+            for (size_t i = 0; i < needleLength; ++i)
+            {
+                needle[i] = (char)('a' + (i % period) % numLetters);
+            }
+
+            needle[needleLength - 1] = 'b';
+        }
+
+        octaspire_string_view_t haystackView;
+        octaspire_string_view_init(&haystackView, haystack, haystackLength);
+
+        octaspire_string_view_t needleView;
+        octaspire_string_view_init(&needleView, needle, needleLength);
+
+        octaspire_string_view_searcher_t searcher;
+        octaspire_string_view_searcher_init(&searcher, &needleView);
+
+        size_t start = 0;
+
+        while (true)
+        {
+            ptrdiff_t const expected = octaspire_string_view_test_naive_find(
+                haystack,
+                haystackLength,
+                needle,
+                needleLength,
+                start);
+
+            ASSERT_EQ(
+                expected,
+                octaspire_string_view_searcher_find(&searcher, &haystackView, start));
+
+            if (expected < 0)
+            {
+                break;
+            }
+
+            start = (size_t)expected + 1;
+        }
+    }
+
+    octaspire_allocator_free(octaspireStringViewTestAllocator, needle);
+    needle = 0;
+
+    octaspire_allocator_free(octaspireStringViewTestAllocator, haystack);
+    haystack = 0;
+
+    PASS();
+}
+
+TEST octaspire_string_view_to_number_test(void)
+{
+    struct
+    {
+        char const *text;
+        bool        isInt64;
+        int64_t     int64Value;
+        bool        isUint64;
+        uint64_t    uint64Value;
+    }
+    const cases[] =
+    {
+        { "0",                      true,  0,             true,  0 },
+        { "-12",                    true,  -12,           false, 0 },
+        { "+12",                    true,  12,            true,  12 },
+        { "9223372036854775807",    true,  INT64_MAX,     true,  9223372036854775807u },
+        { "-9223372036854775808",   true,  INT64_MIN,     false, 0 },
+        { "9223372036854775808",    false, 0,             true,  9223372036854775808u },
+        { "18446744073709551615",   false, 0,             true,  UINT64_MAX },
+        { "18446744073709551616",   false, 0,             false, 0 },
+        { "-0",                     true,  0,             false, 0 },
+        { "",                       false, 0,             false, 0 },
+        { "-",                      false, 0,             false, 0 },
+        { " 1",                     false, 0,             false, 0 },
+        { "1 ",                     false, 0,             false, 0 },
+        { "1.5",                    false, 0,             false, 0 },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+        octaspire_string_view_t view;
+        octaspire_string_view_init_from_c_string(&view, cases[i].text);
+
+        int64_t int64Value = 0;
+        uint64_t uint64Value = 0;
+
+        ASSERT_EQ(cases[i].isInt64, octaspire_string_view_to_int64(&view, &int64Value));
+        ASSERT_EQ(cases[i].isUint64, octaspire_string_view_to_uint64(&view, &uint64Value));
+
+        if (cases[i].isInt64)
+        {
+            ASSERT_EQ(cases[i].int64Value, int64Value);
+        }
+
+        if (cases[i].isUint64)
+        {
+            ASSERT_EQ(cases[i].uint64Value, uint64Value);
+        }
+    }
+
+    // Only the viewed octets are parsed
+    octaspire_string_view_t view;
+    octaspire_string_view_init(&view, "12345", 3);
+
+    int64_t int64Value = 0;
+    ASSERT(octaspire_string_view_to_int64(&view, &int64Value));
+    ASSERT_EQ(123, int64Value);
+
+    double doubleValue = 0;
+    ASSERT(octaspire_string_view_to_double(&view, &doubleValue));
+    ASSERT_IN_RANGE(123.0, doubleValue, 0.000001);
+
+    octaspire_string_view_init(&view, "-2.5e3xyz", 6);
+    ASSERT(octaspire_string_view_to_double(&view, &doubleValue));
+    ASSERT_IN_RANGE(-2500.0, doubleValue, 0.000001);
+
+    octaspire_string_view_init_from_c_string(&view, "-2.5e3xyz");
+    ASSERT_FALSE(octaspire_string_view_to_double(&view, &doubleValue));
+
+    octaspire_string_view_init_from_c_string(&view, " 1.0");
+    ASSERT_FALSE(octaspire_string_view_to_double(&view, &doubleValue));
+
+    octaspire_string_view_init_from_c_string(&view, "");
+    ASSERT_FALSE(octaspire_string_view_to_double(&view, &doubleValue));
+
+    PASS();
+}
+
+TEST octaspire_string_view_split_iterator_test(void)
+{
+    struct
+    {
+        char const *text;
+        char const *delimiter;
+        bool        skipEmptyParts;
+        char const *expected;
+    }
+    const cases[] =
+    {
+        { "a,b,,c,",        ",",    false, "[a][b][][c][]" },
+        { "a,b,,c,",        ",",    true,  "[a][b][c]"     },
+        { "",               ",",    false, "[]"            },
+        { "",               ",",    true,  ""              },
+        { ",",              ",",    false, "[][]"          },
+        { "one",            ",",    false, "[one]"         },
+        { "a::b:c::::d",    "::",   false, "[a][b:c][][d]" },
+        { "::a::",          "::",   true,  "[a]"           },
+        { "x\xC3\xA4y\xC3\xA4", "\xC3\xA4", false, "[x][y][]" },
+        { "abababa",        "aba",  false, "[][b][]"       },
+        { "a\xC3\xA4\xF0\x9F\x98\x80", "", false, "[a][\xC3\xA4][\xF0\x9F\x98\x80]" },
+        { "",               "",     false, ""              },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+        octaspire_string_view_t view;
+        octaspire_string_view_init_from_c_string(&view, cases[i].text);
+
+        octaspire_string_view_t delimiter;
+        octaspire_string_view_init_from_c_string(&delimiter, cases[i].delimiter);
+
+        octaspire_string_view_split_iterator_t iterator;
+
+        octaspire_string_view_split_iterator_init(
+            &iterator,
+            &view,
+            &delimiter,
+            cases[i].skipEmptyParts);
+
+        octaspire_string_t *collected =
+            octaspire_string_new("", octaspireStringViewTestAllocator);
+
+        ASSERT(collected);
+
+        octaspire_string_view_t part;
+
+        while (octaspire_string_view_split_iterator_next(&iterator, &part))
+        {
+            ASSERT(octaspire_string_concatenate_format(
+                collected,
+                "[%.*s]",
+                (int)octaspire_string_view_get_length_in_octets(&part),
+                octaspire_string_view_get_octets(&part)));
+        }
+
+        ASSERT_FALSE(octaspire_string_view_split_iterator_next(&iterator, &part));
+        ASSERT_STR_EQ(cases[i].expected, octaspire_string_get_c_string(collected));
+
+        octaspire_string_release(collected);
+        collected = 0;
+    }
+
+    PASS();
+}
+
+TEST octaspire_string_view_split_iterator_init_from_string_test(void)
+{
+    octaspire_string_t *str = octaspire_string_new(
+        ";first;;second \xC3\xA4;",
+        octaspireStringViewTestAllocator);
+
+    ASSERT(str);
+
+    octaspire_string_view_split_iterator_t iterator;
+    octaspire_string_view_split_iterator_init_from_string(&iterator, str, ";");
+
+    octaspire_string_view_t part;
+
+    ASSERT(octaspire_string_view_split_iterator_next(&iterator, &part));
+    ASSERT(octaspire_string_view_is_equal_to_c_string(&part, "first"));
+    ASSERT_EQ(octaspire_string_get_c_string(str) + 1, octaspire_string_view_get_octets(&part));
+
+    ASSERT(octaspire_string_view_split_iterator_next(&iterator, &part));
+    ASSERT(octaspire_string_view_is_equal_to_c_string(&part, "second \xC3\xA4"));
+    ASSERT_EQ(8, octaspire_string_view_get_length_in_ucs_characters(&part));
+
+    ASSERT_FALSE(octaspire_string_view_split_iterator_next(&iterator, &part));
+
+    octaspire_string_release(str);
+    str = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_string_view_suite)
+{
+    octaspireStringViewTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireStringViewTestAllocator);
+
+    RUN_TEST(octaspire_string_view_init_test);
+    RUN_TEST(octaspire_string_view_compare_and_hash_test);
+    RUN_TEST(octaspire_string_view_find_test);
+    RUN_TEST(octaspire_string_view_searcher_test);
+    RUN_TEST(octaspire_string_view_to_number_test);
+    RUN_TEST(octaspire_string_view_split_iterator_test);
+    RUN_TEST(octaspire_string_view_split_iterator_init_from_string_test);
+
+    octaspire_allocator_release(octaspireStringViewTestAllocator);
+    octaspireStringViewTestAllocator = 0;
+}
+
@@ -0,0 +1,298 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_utf16.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_utf16.h"
+#include "octaspire/core/octaspire_utf8.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+TEST octaspire_utf16_decode_and_encode_buffer_test(void)
+{
+    uint16_t const units[] = { 'a', 0xE4, 0x20AC, 0xD83D, 0xDE00, 0xFFFF, 0xDBFF, 0xDFFF, 'z' };
+    uint32_t const characters[] = { 'a', 0xE4, 0x20AC, 0x1F600, 0xFFFF, 0x10FFFF, 'z' };
+
+    uint32_t decoded[9];
+    size_t numUnits = 0;
+    size_t numCharacters = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_decode_buffer(units, 9, decoded, &numUnits, &numCharacters));
+
+    ASSERT_EQ(9, numUnits);
+    ASSERT_EQ(7, numCharacters);
+    ASSERT_MEM_EQ(characters, decoded, sizeof(characters));
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_get_encoded_length(characters, 7, &numUnits));
+
+    ASSERT_EQ(9, numUnits);
+
+    uint16_t encoded[9];
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_encode_buffer(characters, 7, encoded, 9, &numUnits, &numCharacters));
+
+    ASSERT_EQ(9, numUnits);
+    ASSERT_EQ(7, numCharacters);
+    ASSERT_MEM_EQ(units, encoded, sizeof(units));
+
+    // The surrogate pair does not fit
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_encode_buffer(characters, 7, encoded, 4, &numUnits, &numCharacters));
+
+    ASSERT_EQ(3, numUnits);
+    ASSERT_EQ(3, numCharacters);
+
+    uint32_t const illegal[] = { 'a', 0xDC00 };
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_ILLEGAL_CHARACTER_NUMBER,
+        octaspire_utf16_encode_buffer(illegal, 2, encoded, 9, &numUnits, &numCharacters));
+
+    ASSERT_EQ(1, numUnits);
+
+    PASS();
+}
+
+TEST octaspire_utf16_decode_buffer_unpaired_surrogates_test(void)
+{
+    uint16_t const lowFirst[]   = { 'a', 'b', 0xDC00, 0xD800 };
+    uint16_t const highAlone[]  = { 'a', 0xD800, 'b' };
+    uint16_t const highAtEnd[]  = { 'a', 'b', 'c', 'd', 'e', 0xD800 };
+
+    uint32_t decoded[8];
+    size_t numUnits = 0;
+    size_t numCharacters = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_UNPAIRED_SURROGATE,
+        octaspire_utf16_decode_buffer(lowFirst, 4, decoded, &numUnits, &numCharacters));
+
+    ASSERT_EQ(2, numUnits);
+    ASSERT_EQ(2, numCharacters);
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_UNPAIRED_SURROGATE,
+        octaspire_utf16_decode_buffer(highAlone, 3, decoded, &numUnits, &numCharacters));
+
+    ASSERT_EQ(1, numUnits);
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_UNPAIRED_SURROGATE,
+        octaspire_utf16_decode_buffer(highAtEnd, 6, decoded, &numUnits, &numCharacters));
+
+    ASSERT_EQ(5, numUnits);
+    ASSERT_EQ(5, numCharacters);
+
+    size_t lengthInOctets = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_UNPAIRED_SURROGATE,
+        octaspire_utf16_get_length_in_utf8(highAtEnd, 6, &lengthInOctets));
+
+    ASSERT_EQ(5, lengthInOctets);
+
+    PASS();
+}
+
+TEST octaspire_utf16_from_and_to_utf8_test(void)
+{
+    char const text[] = "a\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80" "b";
+    uint16_t const units[] = { 'a', 0xE4, 0x20AC, 0xD83D, 0xDE00, 'b' };
+
+    size_t numUnits = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_get_length_of_utf8(text, sizeof(text) - 1, &numUnits));
+
+    ASSERT_EQ(6, numUnits);
+
+    uint16_t utf16[8];
+    size_t numOctets = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_from_utf8(text, sizeof(text) - 1, utf16, 8, &numOctets, &numUnits));
+
+    ASSERT_EQ(sizeof(text) - 1, numOctets);
+    ASSERT_EQ(6, numUnits);
+    ASSERT_MEM_EQ(units, utf16, sizeof(units));
+
+    // Only the first three characters fit
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_from_utf8(text, sizeof(text) - 1, utf16, 4, &numOctets, &numUnits));
+
+    ASSERT_EQ(6, numOctets);
+    ASSERT_EQ(3, numUnits);
+
+    size_t lengthInOctets = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_get_length_in_utf8(units, 6, &lengthInOctets));
+
+    ASSERT_EQ(sizeof(text) - 1, lengthInOctets);
+
+    char utf8[16];
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_to_utf8(units, 6, utf8, sizeof(utf8), &numUnits, &numOctets));
+
+    ASSERT_EQ(6, numUnits);
+    ASSERT_EQ(sizeof(text) - 1, numOctets);
+    ASSERT_MEM_EQ(text, utf8, numOctets);
+
+    // The surrogate pair does not fit
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_to_utf8(units, 6, utf8, 9, &numUnits, &numOctets));
+
+    ASSERT_EQ(3, numUnits);
+    ASSERT_EQ(6, numOctets);
+
+    // Illegal UTF-8, and a surrogate encoded as UTF-8
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_ILLEGAL_UTF8,
+        octaspire_utf16_from_utf8("ab\xC0\xAF", 4, utf16, 8, &numOctets, &numUnits));
+
+    ASSERT_EQ(2, numOctets);
+    ASSERT_EQ(2, numUnits);
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_ILLEGAL_CHARACTER_NUMBER,
+        octaspire_utf16_from_utf8("ab\xED\xA0\x80", 5, utf16, 8, &numOctets, &numUnits));
+
+    ASSERT_EQ(2, numOctets);
+    ASSERT_EQ(2, numUnits);
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_ILLEGAL_UTF8,
+        octaspire_utf16_get_length_of_utf8("ab\xC0\xAF", 4, &numUnits));
+
+    ASSERT_EQ(2, numUnits);
+
+    PASS();
+}
+
+TEST octaspire_utf16_long_random_round_trip_test(void)
+{
+    // Longer than one conversion block, with pairs on the block borders
+    enum { NUM_CHARACTERS = 2000 };
+
+    static uint32_t characters[NUM_CHARACTERS];
+    static uint16_t utf16[2 * NUM_CHARACTERS];
+    static uint16_t utf16Again[2 * NUM_CHARACTERS];
+    static char     utf8[4 * NUM_CHARACTERS];
+
+    uint32_t const alphabet[] = { 'a', 0x7F, 0xE4, 0x7FF, 0x20AC, 0xFFFF, 0x10000, 0x1F600 };
+    uint32_t seed = 17;
+
+    for (size_t i = 0; i < NUM_CHARACTERS; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        characters[i] = alphabet[(seed >> 16) % 8];
+    }
+
+    size_t numUnits = 0;
+    size_t numCharacters = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_encode_buffer(
+            characters,
+            NUM_CHARACTERS,
+            utf16,
+            2 * NUM_CHARACTERS,
+            &numUnits,
+            &numCharacters));
+
+    ASSERT_EQ(NUM_CHARACTERS, numCharacters);
+
+    size_t lengthInOctets = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_get_length_in_utf8(utf16, numUnits, &lengthInOctets));
+
+    size_t expectedLengthInOctets = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_ENCODE_STATUS_OK,
+        octaspire_utf8_get_encoded_length(characters, NUM_CHARACTERS, &expectedLengthInOctets));
+
+    ASSERT_EQ(expectedLengthInOctets, lengthInOctets);
+
+    size_t numUnitsConverted = 0;
+    size_t numOctets = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_to_utf8(
+            utf16,
+            numUnits,
+            utf8,
+            sizeof(utf8),
+            &numUnitsConverted,
+            &numOctets));
+
+    ASSERT_EQ(numUnits, numUnitsConverted);
+    ASSERT_EQ(lengthInOctets, numOctets);
+
+    size_t numUnitsAgain = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_get_length_of_utf8(utf8, numOctets, &numUnitsAgain));
+
+    ASSERT_EQ(numUnits, numUnitsAgain);
+
+    size_t numOctetsConverted = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF16_STATUS_OK,
+        octaspire_utf16_from_utf8(
+            utf8,
+            numOctets,
+            utf16Again,
+            2 * NUM_CHARACTERS,
+            &numOctetsConverted,
+            &numUnitsAgain));
+
+    ASSERT_EQ(numOctets, numOctetsConverted);
+    ASSERT_EQ(numUnits, numUnitsAgain);
+    ASSERT_MEM_EQ(utf16, utf16Again, numUnits * sizeof(uint16_t));
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_utf16_suite)
+{
+    RUN_TEST(octaspire_utf16_decode_and_encode_buffer_test);
+    RUN_TEST(octaspire_utf16_decode_buffer_unpaired_surrogates_test);
+    RUN_TEST(octaspire_utf16_from_and_to_utf8_test);
+    RUN_TEST(octaspire_utf16_long_random_round_trip_test);
+}
+
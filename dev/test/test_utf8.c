@@ -1209,6 +1209,400 @@ TEST octaspire_utf8_decode_character_illegal_octet_sequence_0xF0_0x80_0x80_0xAF_
     PASS();
 }
 
+TEST octaspire_utf8_decode_buffer_test(void)
+{
+    // "ab\xC3\xA4" "12345678" "\xE2\x82\xAC" "\xF0\x9F\x98\x80"
+    char const text[] =
+        "ab\xC3\xA4" "12345678" "\xE2\x82\xAC" "\xF0\x9F\x98\x80" "\xC0\xAF" "x";
+
+    uint32_t const expected[] =
+        { 'a', 'b', 0xE4, '1', '2', '3', '4', '5', '6', '7', '8', 0x20AC, 0x1F600 };
+
+    uint32_t result[sizeof(text)];
+    size_t numOctets = 0;
+    size_t numUcsCharacters = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_OVERLONG_REPRESENTATION_OF_CHARACTER,
+        octaspire_utf8_decode_buffer(
+            text,
+            sizeof(text) - 1,
+            result,
+            &numOctets,
+            &numUcsCharacters));
+
+    ASSERT_EQ(19, numOctets);
+    ASSERT_EQ(13, numUcsCharacters);
+    ASSERT_MEM_EQ(expected, result, sizeof(expected));
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_OK,
+        octaspire_utf8_decode_buffer(text, 19, result, &numOctets, &numUcsCharacters));
+
+    ASSERT_EQ(19, numOctets);
+    ASSERT_EQ(13, numUcsCharacters);
+
+    // The null octet at index 8 is not in the first eight
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_INPUT_IS_NULL,
+        octaspire_utf8_decode_buffer(
+            "abcdefgh\0ij",
+            12,
+            result,
+            &numOctets,
+            &numUcsCharacters));
+
+    ASSERT_EQ(8, numOctets);
+    ASSERT_EQ(8, numUcsCharacters);
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_OK,
+        octaspire_utf8_decode_buffer(text, 0, result, &numOctets, &numUcsCharacters));
+
+    ASSERT_EQ(0, numOctets);
+    ASSERT_EQ(0, numUcsCharacters);
+
+    PASS();
+}
+
+TEST octaspire_utf8_decode_buffer_random_test(void)
+{
+    // Results must be the same as when decoding one character at a time
+    char const * const pieces[] =
+    {
+        "a", "Z", "~", "\xC3\xA4", "\xDF\xBF", "\xE2\x82\xAC", "\xED\xA0\x80",
+        "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF", "\x80", "\xC0\x80", "\xC3",
+        "\xE0\x9F\xBF", "\xF0\x8F\xBF\xBF", "\xFF", "\0"
+    };
+
+    size_t const numPieces = sizeof(pieces) / sizeof(pieces[0]);
+    char text[128];
+    uint32_t result[128];
+    uint32_t seed = 7;
+
+    for (size_t round = 0; round < 3000; ++round)
+    {
+        size_t length = 0;
+
+        seed = seed * 1103515245u + 12345u;
+        size_t const numParts = (seed >> 16) % 30;
+
+        for (size_t i = 0; i < numParts; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+
+            // Mostly ASCII and valid characters, sometimes something else
+            size_t const piece = ((seed >> 16) % 8 == 0)
+                ? ((seed >> 8) % numPieces)
+                : ((seed >> 8) % 9);
+
+            size_t const pieceLength = (piece == numPieces - 1) ? 1 : strlen(pieces[piece]);
+
+            memcpy(text + length, pieces[piece], pieceLength);
+            length += pieceLength;
+        }
+
+        size_t expectedNumOctets = 0;
+        size_t expectedNumUcsCharacters = 0;
+        octaspire_utf8_decode_status_t expectedStatus = OCTASPIRE_UTF8_DECODE_STATUS_OK;
+
+        while (expectedNumOctets < length)
+        {
+            uint32_t character = 0;
+            int numOctets = 0;
+
+            expectedStatus = octaspire_utf8_decode_character(
+                text + expectedNumOctets,
+                length - expectedNumOctets,
+                &character,
+                &numOctets);
+
+            if (expectedStatus != OCTASPIRE_UTF8_DECODE_STATUS_OK)
+            {
+                break;
+            }
+
+            result[expectedNumUcsCharacters] = character;
+            expectedNumOctets += (size_t)numOctets;
+            ++expectedNumUcsCharacters;
+        }
+
+        uint32_t expected[128];
+        memcpy(expected, result, expectedNumUcsCharacters * sizeof(uint32_t));
+        memset(result, 0, sizeof(result));
+
+        size_t numOctets = 0;
+        size_t numUcsCharacters = 0;
+
+        ASSERT_EQ(
+            expectedStatus,
+            octaspire_utf8_decode_buffer(
+                text,
+                length,
+                result,
+                &numOctets,
+                &numUcsCharacters));
+
+        ASSERT_EQ(expectedNumOctets, numOctets);
+        ASSERT_EQ(expectedNumUcsCharacters, numUcsCharacters);
+        ASSERT_MEM_EQ(expected, result, numUcsCharacters * sizeof(uint32_t));
+    }
+
+    PASS();
+}
+
+TEST octaspire_utf8_encode_buffer_test(void)
+{
+    uint32_t const characters[] =
+        { 'a', 'b', 'c', 'd', 'e', 0xE4, 0x7FF, 0x800, 0x20AC, 0xFFFF, 0x10000, 0x10FFFF, 'z' };
+
+    size_t const numCharacters = sizeof(characters) / sizeof(characters[0]);
+
+    char expected[64];
+    size_t expectedLength = 0;
+
+    for (size_t i = 0; i < numCharacters; ++i)
+    {
+        octaspire_utf8_character_t encoded;
+
+        ASSERT_EQ(
+            OCTASPIRE_UTF8_ENCODE_STATUS_OK,
+            octaspire_utf8_encode_character(characters[i], &encoded));
+
+        memcpy(expected + expectedLength, encoded.octets + 4 - encoded.numoctets, encoded.numoctets);
+        expectedLength += encoded.numoctets;
+    }
+
+    size_t lengthInOctets = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_ENCODE_STATUS_OK,
+        octaspire_utf8_get_encoded_length(characters, numCharacters, &lengthInOctets));
+
+    ASSERT_EQ(expectedLength, lengthInOctets);
+
+    char result[64];
+    size_t numOctets = 0;
+    size_t numUcsCharacters = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_ENCODE_STATUS_OK,
+        octaspire_utf8_encode_buffer(
+            characters,
+            numCharacters,
+            result,
+            sizeof(result),
+            &numOctets,
+            &numUcsCharacters));
+
+    ASSERT_EQ(expectedLength, numOctets);
+    ASSERT_EQ(numCharacters, numUcsCharacters);
+    ASSERT_MEM_EQ(expected, result, expectedLength);
+
+    // Stops before the character that does not fit: 5 + 2 + 2 octets fit
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_ENCODE_STATUS_OK,
+        octaspire_utf8_encode_buffer(
+            characters,
+            numCharacters,
+            result,
+            11,
+            &numOctets,
+            &numUcsCharacters));
+
+    ASSERT_EQ(9, numOctets);
+    ASSERT_EQ(7, numUcsCharacters);
+
+    uint32_t const illegal[] = { 'a', 0xD800, 'b' };
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_ENCODE_STATUS_ILLEGAL_CHARACTER_NUMBER,
+        octaspire_utf8_get_encoded_length(illegal, 3, &lengthInOctets));
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_ENCODE_STATUS_ILLEGAL_CHARACTER_NUMBER,
+        octaspire_utf8_encode_buffer(illegal, 3, result, 64, &numOctets, &numUcsCharacters));
+
+    ASSERT_EQ(1, numOctets);
+    ASSERT_EQ(1, numUcsCharacters);
+
+    uint32_t const tooLarge[] = { 0x110000 };
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_ENCODE_STATUS_ILLEGAL_CHARACTER_NUMBER,
+        octaspire_utf8_get_encoded_length(tooLarge, 1, &lengthInOctets));
+
+    PASS();
+}
+
+TEST octaspire_utf8_decoder_test(void)
+{
+    // The euro sign is split between the chunks
+    octaspire_utf8_decoder_t decoder;
+    octaspire_utf8_decoder_init(&decoder);
+
+    uint32_t result[8];
+    size_t numUcsCharacters = 0;
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_OK,
+        octaspire_utf8_decoder_decode(&decoder, "a\xE2", 2, result, &numUcsCharacters));
+
+    ASSERT_EQ(1, numUcsCharacters);
+    ASSERT_EQ('a', result[0]);
+    ASSERT_EQ(1, octaspire_utf8_decoder_get_number_of_octets_decoded(&decoder));
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_OK,
+        octaspire_utf8_decoder_decode(&decoder, "\x82", 1, result, &numUcsCharacters));
+
+    ASSERT_EQ(0, numUcsCharacters);
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_OK,
+        octaspire_utf8_decoder_decode(&decoder, "\xAC" "b", 2, result, &numUcsCharacters));
+
+    ASSERT_EQ(2, numUcsCharacters);
+    ASSERT_EQ(0x20AC, result[0]);
+    ASSERT_EQ('b', result[1]);
+    ASSERT_EQ(5, octaspire_utf8_decoder_get_number_of_octets_decoded(&decoder));
+    ASSERT_EQ(OCTASPIRE_UTF8_DECODE_STATUS_OK, octaspire_utf8_decoder_finish(&decoder));
+
+    // Input that ends in the middle of a character
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_OK,
+        octaspire_utf8_decoder_decode(&decoder, "\xF0\x9F", 2, result, &numUcsCharacters));
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_INPUT_NOT_ENOUGH_OCTETS_AVAILABLE,
+        octaspire_utf8_decoder_finish(&decoder));
+
+    // Errors stay until the decoder is initialized again
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_INPUT_NOT_ENOUGH_OCTETS_AVAILABLE,
+        octaspire_utf8_decoder_decode(&decoder, "c", 1, result, &numUcsCharacters));
+
+    ASSERT_EQ(0, numUcsCharacters);
+
+    octaspire_utf8_decoder_init(&decoder);
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_OK,
+        octaspire_utf8_decoder_decode(&decoder, "\xC0", 1, result, &numUcsCharacters));
+
+    ASSERT_EQ(
+        OCTASPIRE_UTF8_DECODE_STATUS_OVERLONG_REPRESENTATION_OF_CHARACTER,
+        octaspire_utf8_decoder_decode(&decoder, "\xAF", 1, result, &numUcsCharacters));
+
+    ASSERT_EQ(0, octaspire_utf8_decoder_get_number_of_octets_decoded(&decoder));
+
+    PASS();
+}
+
+TEST octaspire_utf8_decoder_random_test(void)
+{
+    // Results must be the same as when decoding the whole input at once
+    char const * const pieces[] =
+    {
+        "a", "Z", "~", "\xC3\xA4", "\xDF\xBF", "\xE2\x82\xAC", "\xED\xA0\x80",
+        "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF", "\x80", "\xC0\x80", "\xC3",
+        "\xE0\x9F\xBF", "\xF0\x8F\xBF\xBF", "\xFF", "\xF0\x9F"
+    };
+
+    size_t const numPieces = sizeof(pieces) / sizeof(pieces[0]);
+    char text[128];
+    uint32_t expected[128];
+    uint32_t result[128];
+    uint32_t seed = 13;
+
+    for (size_t round = 0; round < 3000; ++round)
+    {
+        size_t length = 0;
+
+        seed = seed * 1103515245u + 12345u;
+        size_t const numParts = (seed >> 16) % 30;
+
+        for (size_t i = 0; i < numParts; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+
+            size_t const piece = ((seed >> 16) % 10 == 0)
+                ? ((seed >> 8) % numPieces)
+                : ((seed >> 8) % 9);
+
+            memcpy(text + length, pieces[piece], strlen(pieces[piece]));
+            length += strlen(pieces[piece]);
+        }
+
+        size_t expectedNumOctets = 0;
+        size_t expectedNumUcsCharacters = 0;
+
+        octaspire_utf8_decode_status_t const expectedStatus = octaspire_utf8_decode_buffer(
+            text,
+            length,
+            expected,
+            &expectedNumOctets,
+            &expectedNumUcsCharacters);
+
+        octaspire_utf8_decoder_t decoder;
+        octaspire_utf8_decoder_init(&decoder);
+
+        size_t numUcsCharacters = 0;
+        size_t index = 0;
+        octaspire_utf8_decode_status_t status = OCTASPIRE_UTF8_DECODE_STATUS_OK;
+
+        while (index < length && status == OCTASPIRE_UTF8_DECODE_STATUS_OK)
+        {
+            seed = seed * 1103515245u + 12345u;
+
+            size_t const chunkLength =
+                octaspire_helpers_min_size_t(length - index, (seed >> 16) % 6);
+
+            size_t numDecoded = 0;
+
+            status = octaspire_utf8_decoder_decode(
+                &decoder,
+                text + index,
+                chunkLength,
+                result + numUcsCharacters,
+                &numDecoded);
+
+            numUcsCharacters += numDecoded;
+            index += chunkLength;
+        }
+
+        if (status == OCTASPIRE_UTF8_DECODE_STATUS_OK)
+        {
+            status = octaspire_utf8_decoder_finish(&decoder);
+
+            // Only the end of the whole input can be missing octets
+            if (status == OCTASPIRE_UTF8_DECODE_STATUS_INPUT_NOT_ENOUGH_OCTETS_AVAILABLE)
+            {
+                ASSERT_EQ(OCTASPIRE_UTF8_DECODE_STATUS_ILLEGAL_NUMBER_OF_OCTETS, expectedStatus);
+                status = expectedStatus;
+            }
+        }
+
+        ASSERT_EQ(expectedStatus, status);
+        ASSERT_EQ(expectedNumOctets, octaspire_utf8_decoder_get_number_of_octets_decoded(&decoder));
+        ASSERT_EQ(expectedNumUcsCharacters, numUcsCharacters);
+        ASSERT_MEM_EQ(expected, result, numUcsCharacters * sizeof(uint32_t));
+    }
+
+    PASS();
+}
+
+TEST octaspire_utf8_count_ucs_characters_test(void)
+{
+    char const text[] = "ab\xC3\xA4\xE2\x82\xAC" "cdefgh\xF0\x9F\x98\x80\xC3\xA4" "ijklmnop";
+
+    ASSERT_EQ(20, octaspire_utf8_count_ucs_characters(text, sizeof(text) - 1));
+    ASSERT_EQ(0, octaspire_utf8_count_ucs_characters(text, 0));
+    ASSERT_EQ(3, octaspire_utf8_count_ucs_characters(text, 4));
+
+    PASS();
+}
+
 GREATEST_SUITE(octaspire_utf8_suite)
 {
     octaspireUtf8TestAllocator = octaspire_allocator_new(0);
@@ -1284,6 +1678,12 @@ GREATEST_SUITE(octaspire_utf8_suite)
     RUN_TEST(octaspire_utf8_decode_character_illegal_octet_sequence_0xC0_0xAF_test);
     RUN_TEST(octaspire_utf8_decode_character_illegal_octet_sequence_0xE0_0x80_0xAF_test);
     RUN_TEST(octaspire_utf8_decode_character_illegal_octet_sequence_0xF0_0x80_0x80_0xAF_test);
+    RUN_TEST(octaspire_utf8_decode_buffer_test);
+    RUN_TEST(octaspire_utf8_decode_buffer_random_test);
+    RUN_TEST(octaspire_utf8_count_ucs_characters_test);
+    RUN_TEST(octaspire_utf8_encode_buffer_test);
+    RUN_TEST(octaspire_utf8_decoder_test);
+    RUN_TEST(octaspire_utf8_decoder_random_test);
 
     octaspire_allocator_release(octaspireUtf8TestAllocator);
     octaspireUtf8TestAllocator = 0;
@@ -1988,6 +1988,90 @@ TEST octaspire_vector_push_back_element_test(void)
     PASS();
 }
 
+TEST octaspire_vector_push_back_elements_test(void)
+{
+    octaspire_vector_t *vec =
+        octaspire_vector_new(sizeof(size_t), false, 0, octaspireContainerVectorTestAllocator);
+
+    size_t elements[100];
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        elements[i] = i;
+    }
+
+    ASSERT(octaspire_vector_push_back_elements(vec, elements, 0));
+    ASSERT_EQ(0, octaspire_vector_get_length(vec));
+
+    size_t expectedLength = 0;
+
+    for (size_t i = 1; i <= 13; ++i)
+    {
+        ASSERT(octaspire_vector_push_back_elements(vec, elements, i * 7));
+
+        for (size_t j = 0; j < i * 7; ++j)
+        {
+            ASSERT_EQ(
+                j,
+                *(size_t*)octaspire_vector_get_element_at(
+                    vec,
+                    (ptrdiff_t)(expectedLength + j)));
+        }
+
+        expectedLength += i * 7;
+        ASSERT_EQ(expectedLength, octaspire_vector_get_length(vec));
+    }
+
+    octaspire_vector_release(vec);
+    vec = 0;
+
+    PASS();
+}
+
+TEST octaspire_vector_reserve_test(void)
+{
+    octaspire_vector_t *vec =
+        octaspire_vector_new(sizeof(uint32_t), false, 0, octaspireContainerVectorTestAllocator);
+
+    ASSERT(vec);
+    ASSERT(octaspire_vector_push_back_element(vec, &(uint32_t){7}));
+    ASSERT(octaspire_vector_reserve(vec, 1000));
+    ASSERT(octaspire_vector_reserve(vec, 10));
+    ASSERT_EQ(1, octaspire_vector_get_length(vec));
+
+    // No allocations are needed until there are 1000 elements
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireContainerVectorTestAllocator,
+        1,
+        0);
+
+    for (uint32_t i = 1; i < 1000; ++i)
+    {
+        ASSERT(octaspire_vector_push_back_element(vec, &i));
+    }
+
+    ASSERT_EQ(
+        1,
+        octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+            octaspireContainerVectorTestAllocator));
+
+    ASSERT_FALSE(octaspire_vector_push_back_element(vec, &(uint32_t){1000}));
+
+    octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+        octaspireContainerVectorTestAllocator,
+        0,
+        0);
+
+    ASSERT_EQ(1000, octaspire_vector_get_length(vec));
+    ASSERT_EQ(7, *(uint32_t const *)octaspire_vector_get_element_at_const(vec, 0));
+    ASSERT_EQ(999, *(uint32_t const *)octaspire_vector_get_element_at_const(vec, -1));
+
+    octaspire_vector_release(vec);
+    vec = 0;
+
+    PASS();
+}
+
 TEST octaspire_vector_push_back_char_test(void)
 {
     octaspire_vector_t *vec =
@@ -3242,6 +3326,8 @@ GREATEST_SUITE(octaspire_vector_suite)
     RUN_TEST(octaspire_vector_insert_element_at_failure_test);
     RUN_TEST(octaspire_vector_push_front_element_test);
     RUN_TEST(octaspire_vector_push_back_element_test);
+    RUN_TEST(octaspire_vector_push_back_elements_test);
+    RUN_TEST(octaspire_vector_reserve_test);
     RUN_TEST(octaspire_vector_push_back_char_test);
     RUN_TEST(octaspire_vector_push_back_char_to_vector_containing_floats_test);
     RUN_TEST(octaspire_vector_for_each_called_on_empty_vector_test);
@@ -0,0 +1,310 @@
+/******************************************************************************
+Octaspire Core - Containers and other utility libraries in standard C99
+Copyright 2017 www.octaspire.com
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+  http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+******************************************************************************/
+#include "../src/octaspire_xor_filter.c"
+#include <assert.h>
+#include <inttypes.h>
+#include "external/greatest.h"
+#include "octaspire/core/octaspire_xor_filter.h"
+#include "octaspire/core/octaspire_memory.h"
+#include "octaspire/core/octaspire_string.h"
+#include "octaspire/core/octaspire_helpers.h"
+#include "octaspire/core/octaspire_core_config.h"
+
+static octaspire_allocator_t *octaspireXorFilterTestAllocator = 0;
+
+static uint32_t octaspire_xor_filter_test_hash(size_t const value)
+{
+    return octaspire_helpers_calculate_hash_for_size_t_argument(value);
+}
+
+TEST octaspire_xor_filter_new_from_hashes_test(void)
+{
+    size_t const numElements = 10000;
+
+    uint32_t *hashes = octaspire_allocator_malloc(
+        octaspireXorFilterTestAllocator,
+        numElements * sizeof(uint32_t));
+
+    ASSERT(hashes);
+
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        hashes[i] = octaspire_xor_filter_test_hash(i);
+    }
+
+    octaspire_xor_filter_t *filter = octaspire_xor_filter_new_from_hashes(
+        hashes,
+        numElements,
+        octaspireXorFilterTestAllocator);
+
+    ASSERT(filter);
+    ASSERT_EQ(octaspireXorFilterTestAllocator, filter->allocator);
+    ASSERT(octaspire_xor_filter_get_length_in_octets(filter) <= 32 + 123 * numElements / 100 + 3);
+
+    // No false negatives
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        ASSERT(octaspire_xor_filter_may_contain(filter, hashes[i]));
+    }
+
+    // Fingerprints of 8 bits give about 0.4 percent of false positives
+    // among 10 * numElements misses.
+    size_t numFalsePositives = 0;
+
+    for (size_t i = numElements; i < 11 * numElements; ++i)
+    {
+        if (octaspire_xor_filter_may_contain(filter, octaspire_xor_filter_test_hash(i)))
+        {
+            ++numFalsePositives;
+        }
+    }
+
+    ASSERT(numFalsePositives < 10 * numElements / 100);
+
+    octaspire_xor_filter_release(filter);
+    filter = 0;
+
+    octaspire_allocator_free(octaspireXorFilterTestAllocator, hashes);
+    hashes = 0;
+
+    PASS();
+}
+
+TEST octaspire_xor_filter_new_from_hashes_of_many_sizes_test(void)
+{
+    size_t const maxNumElements = 40000;
+
+    uint32_t *hashes = octaspire_allocator_malloc(
+        octaspireXorFilterTestAllocator,
+        maxNumElements * sizeof(uint32_t));
+
+    ASSERT(hashes);
+
+    uint32_t seed = 1;
+
+    for (size_t numElements = 1000; numElements <= maxNumElements; numElements += 250)
+    {
+        // Consecutive hashes and random hashes
+        for (size_t round = 0; round < 2; ++round)
+        {
+            for (size_t i = 0; i < numElements; ++i)
+            {
+                seed = seed * 1103515245u + 12345u;
+                hashes[i] = round ? seed : (uint32_t)i;
+            }
+
+            octaspire_xor_filter_t *filter = octaspire_xor_filter_new_from_hashes(
+                hashes,
+                numElements,
+                octaspireXorFilterTestAllocator);
+
+            ASSERT(filter);
+
+            for (size_t i = 0; i < numElements; ++i)
+            {
+                ASSERT(octaspire_xor_filter_may_contain(filter, hashes[i]));
+            }
+
+            octaspire_xor_filter_release(filter);
+            filter = 0;
+        }
+    }
+
+    octaspire_allocator_free(octaspireXorFilterTestAllocator, hashes);
+    hashes = 0;
+
+    PASS();
+}
+
+TEST octaspire_xor_filter_new_from_hashes_with_duplicates_and_empty_test(void)
+{
+    uint32_t const hashes[] = {7, 3, 7, 7, 1, 3};
+
+    octaspire_xor_filter_t *filter = octaspire_xor_filter_new_from_hashes(
+        hashes,
+        sizeof(hashes) / sizeof(hashes[0]),
+        octaspireXorFilterTestAllocator);
+
+    ASSERT(filter);
+    ASSERT(octaspire_xor_filter_may_contain(filter, 1));
+    ASSERT(octaspire_xor_filter_may_contain(filter, 3));
+    ASSERT(octaspire_xor_filter_may_contain(filter, 7));
+
+    octaspire_xor_filter_release(filter);
+    filter = 0;
+
+    filter = octaspire_xor_filter_new_from_hashes(0, 0, octaspireXorFilterTestAllocator);
+    ASSERT(filter);
+    ASSERT(octaspire_xor_filter_get_length_in_octets(filter) > 0);
+
+    octaspire_xor_filter_release(filter);
+    filter = 0;
+
+    PASS();
+}
+
+TEST octaspire_xor_filter_new_from_vector_test(void)
+{
+    octaspire_vector_t *keys =
+        octaspire_vector_new_for_octaspire_string_elements(octaspireXorFilterTestAllocator);
+
+    ASSERT(keys);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        octaspire_string_t *key = octaspire_string_new_format(
+            octaspireXorFilterTestAllocator,
+            "key-%zu",
+            i);
+
+        ASSERT(key);
+        ASSERT(octaspire_vector_push_back_element(keys, &key));
+    }
+
+    octaspire_xor_filter_t *filter = octaspire_xor_filter_new_from_vector(
+        keys,
+        (octaspire_map_key_hash_function_t)octaspire_string_get_hash,
+        octaspireXorFilterTestAllocator);
+
+    ASSERT(filter);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        ASSERT(octaspire_xor_filter_may_contain(
+            filter,
+            octaspire_string_get_hash(octaspire_vector_get_element_at_const(
+                keys,
+                (ptrdiff_t)i))));
+    }
+
+    octaspire_xor_filter_release(filter);
+    filter = 0;
+
+    octaspire_vector_release(keys);
+    keys = 0;
+
+    PASS();
+}
+
+TEST octaspire_xor_filter_new_allocation_failure_test(void)
+{
+    uint32_t const hashes[] = {1, 2, 3, 4, 5};
+
+    // Every allocation of the build in turn
+    for (size_t i = 0; i < 6; ++i)
+    {
+        octaspire_allocator_set_number_and_type_of_future_allocations_to_be_rigged(
+            octaspireXorFilterTestAllocator,
+            i + 1,
+            ~((uint32_t)1 << i));
+
+        octaspire_xor_filter_t *filter = octaspire_xor_filter_new_from_hashes(
+            hashes,
+            5,
+            octaspireXorFilterTestAllocator);
+
+        ASSERT_FALSE(filter);
+
+        ASSERT_EQ(
+            0,
+            octaspire_allocator_get_number_of_future_allocations_to_be_rigged(
+                octaspireXorFilterTestAllocator));
+    }
+
+    PASS();
+}
+
+TEST octaspire_xor_filter_serialize_test(void)
+{
+    uint32_t hashes[100];
+
+    for (size_t i = 0; i < 100; ++i)
+    {
+        hashes[i] = octaspire_xor_filter_test_hash(i);
+    }
+
+    octaspire_xor_filter_t *filter =
+        octaspire_xor_filter_new_from_hashes(hashes, 100, octaspireXorFilterTestAllocator);
+
+    ASSERT(filter);
+
+    octaspire_vector_t *buffer =
+        octaspire_xor_filter_serialize(filter, octaspireXorFilterTestAllocator);
+
+    ASSERT(buffer);
+
+    size_t const length = octaspire_vector_get_length(buffer);
+    ASSERT_EQ(12 + octaspire_xor_filter_get_length_in_octets(filter), length);
+
+    uint8_t const * const octets = octaspire_vector_get_element_at_const(buffer, 0);
+    ASSERT_MEM_EQ("OXF2", octets, 4);
+    ASSERT_EQ(filter->seed & 0xFF, octets[4]);
+    ASSERT_EQ(filter->blockLength, octets[8]);
+
+    octaspire_xor_filter_t *copy =
+        octaspire_xor_filter_new_from_buffer(octets, length, octaspireXorFilterTestAllocator);
+
+    ASSERT(copy);
+    ASSERT_EQ(filter->seed,        copy->seed);
+    ASSERT_EQ(filter->blockLength, copy->blockLength);
+
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        uint32_t const hash = octaspire_xor_filter_test_hash(i);
+
+        ASSERT_EQ(
+            octaspire_xor_filter_may_contain(filter, hash),
+            octaspire_xor_filter_may_contain(copy, hash));
+    }
+
+    ASSERT_FALSE(octaspire_xor_filter_new_from_buffer(
+        octets, length - 1, octaspireXorFilterTestAllocator));
+
+    ASSERT_FALSE(octaspire_xor_filter_new_from_buffer(
+        octets + 1, length - 1, octaspireXorFilterTestAllocator));
+
+    ASSERT_FALSE(octaspire_xor_filter_new_from_buffer(
+        octets, 11, octaspireXorFilterTestAllocator));
+
+    octaspire_xor_filter_release(copy);
+    copy = 0;
+
+    octaspire_vector_release(buffer);
+    buffer = 0;
+
+    octaspire_xor_filter_release(filter);
+    filter = 0;
+
+    PASS();
+}
+
+GREATEST_SUITE(octaspire_xor_filter_suite)
+{
+    octaspireXorFilterTestAllocator = octaspire_allocator_new(0);
+    assert(octaspireXorFilterTestAllocator);
+
+    RUN_TEST(octaspire_xor_filter_new_from_hashes_test);
+    RUN_TEST(octaspire_xor_filter_new_from_hashes_of_many_sizes_test);
+    RUN_TEST(octaspire_xor_filter_new_from_hashes_with_duplicates_and_empty_test);
+    RUN_TEST(octaspire_xor_filter_new_from_vector_test);
+    RUN_TEST(octaspire_xor_filter_new_allocation_failure_test);
+    RUN_TEST(octaspire_xor_filter_serialize_test);
+
+    octaspire_allocator_release(octaspireXorFilterTestAllocator);
+    octaspireXorFilterTestAllocator = 0;
+}
+